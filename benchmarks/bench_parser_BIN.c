@@ -0,0 +1,76 @@
+/** @file bench_parser_BIN.c
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "bench_utils.h"
+
+int main(int argc, char **argv) {
+
+  // Local variables
+  Parser* parser;
+  Net* net[2];
+  char* json[2];
+  char filename[] = "bench_parser_BIN.pfb";
+  double time[2];
+  double start;
+  int num_periods;
+  int num_repeats;
+  int i;
+  int k;
+
+  // Check inputs
+  if (argc < 2) {
+    printf("usage: bench_parser_BIN case.mat [num_periods] [num_repeats]\n");
+    return -1;
+  }
+  num_periods = argc > 2 ? atoi(argv[2]) : 1;
+  num_repeats = argc > 3 ? atoi(argv[3]) : 5;
+  if (num_periods < 1 || num_repeats < 1) {
+    printf("invalid arguments\n");
+    return -1;
+  }
+
+  // Run (original format, then binary snapshot)
+  for (k = 0; k < 2; k++) {
+    net[k] = NULL;
+    start = BENCH_time();
+    for (i = 0; i < num_repeats; i++) {
+      NET_del(net[k]);
+      parser = PARSER_new_for_file(k == 0 ? argv[1] : filename);
+      net[k] = PARSER_parse(parser,k == 0 ? argv[1] : filename,num_periods);
+      if (PARSER_has_error(parser)) {
+	printf("%s\n",PARSER_get_error_string(parser));
+	return -1;
+      }
+      PARSER_del(parser);
+    }
+    time[k] = (BENCH_time()-start)/num_repeats;
+    json[k] = NET_get_json_string(net[k]);
+
+    // Snapshot
+    if (k == 0) {
+      parser = PARSER_new_for_file(filename);
+      PARSER_write(parser,net[k],filename);
+      PARSER_del(parser);
+    }
+  }
+  remove(filename);
+
+  // Results
+  printf("buses %d branches %d periods %d original %.4f s binary %.4f s speedup %.2f identical %s\n",
+	 NET_get_num_buses(net[1]),NET_get_num_branches(net[1]),num_periods,
+	 time[0],time[1],time[0]/time[1],
+	 strcmp(json[0],json[1]) == 0 ? "yes" : "no");
+
+  // Clean up
+  for (k = 0; k < 2; k++) {
+    free(json[k]);
+    NET_del(net[k]);
+  }
+  return 0;
+}
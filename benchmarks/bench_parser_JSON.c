@@ -0,0 +1,83 @@
+/** @file bench_parser_JSON.c
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "bench_utils.h"
+
+int main(int argc, char **argv) {
+
+  // Local variables
+  Parser* parser;
+  Net* net;
+  Net* net_json;
+  char* json[2];
+  char filename[] = "bench_parser_JSON.json";
+  double time[2];
+  double start;
+  int num_periods;
+  int num_repeats;
+  int i;
+
+  // Check inputs
+  if (argc < 2) {
+    printf("usage: bench_parser_JSON case.mat [num_periods] [num_repeats]\n");
+    return -1;
+  }
+  num_periods = argc > 2 ? atoi(argv[2]) : 1;
+  num_repeats = argc > 3 ? atoi(argv[3]) : 5;
+  if (num_periods < 1 || num_repeats < 1) {
+    printf("invalid arguments\n");
+    return -1;
+  }
+
+  // Network
+  parser = PARSER_new_for_file(argv[1]);
+  net = PARSER_parse(parser,argv[1],num_periods);
+  if (PARSER_has_error(parser)) {
+    printf("%s\n",PARSER_get_error_string(parser));
+    return -1;
+  }
+  PARSER_del(parser);
+  json[0] = NET_get_json_string(net);
+
+  // Write
+  parser = JSON_PARSER_new();
+  start = BENCH_time();
+  for (i = 0; i < num_repeats; i++)
+    PARSER_write(parser,net,filename);
+  time[0] = (BENCH_time()-start)/num_repeats;
+
+  // Parse
+  net_json = NULL;
+  start = BENCH_time();
+  for (i = 0; i < num_repeats; i++) {
+    NET_del(net_json);
+    net_json = PARSER_parse(parser,filename,0);
+    if (PARSER_has_error(parser)) {
+      printf("%s\n",PARSER_get_error_string(parser));
+      return -1;
+    }
+  }
+  time[1] = (BENCH_time()-start)/num_repeats;
+  json[1] = NET_get_json_string(net_json);
+  PARSER_del(parser);
+  remove(filename);
+
+  // Results
+  printf("buses %d branches %d periods %d write %.4f s parse %.4f s identical %s\n",
+	 NET_get_num_buses(net_json),NET_get_num_branches(net_json),num_periods,
+	 time[0],time[1],
+	 strcmp(json[0],json[1]) == 0 ? "yes" : "no");
+
+  // Clean up
+  for (i = 0; i < 2; i++)
+    free(json[i]);
+  NET_del(net_json);
+  NET_del(net);
+  return 0;
+}
@@ -0,0 +1,66 @@
+/** @file bench_parser_MAT.c
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "bench_utils.h"
+
+int main(int argc, char **argv) {
+
+  // Local variables
+  Parser* parser;
+  Net* net[2];
+  char* json[2];
+  double time[2];
+  double start;
+  int num_repeats;
+  int fast;
+  int i;
+
+  // Check inputs
+  if (argc < 2) {
+    printf("usage: bench_parser_MAT case.mat [num_repeats]\n");
+    return -1;
+  }
+  num_repeats = argc > 2 ? atoi(argv[2]) : 5;
+  if (num_repeats < 1) {
+    printf("invalid arguments\n");
+    return -1;
+  }
+
+  // Run (chunked reads with atof, then memory-mapped with fast conversion)
+  for (fast = 0; fast < 2; fast++) {
+    net[fast] = NULL;
+    start = BENCH_time();
+    for (i = 0; i < num_repeats; i++) {
+      NET_del(net[fast]);
+      parser = PARSER_new_for_file(argv[1]);
+      PARSER_set(parser,"fast",fast);
+      net[fast] = PARSER_parse(parser,argv[1],1);
+      if (PARSER_has_error(parser)) {
+	printf("%s\n",PARSER_get_error_string(parser));
+	return -1;
+      }
+      PARSER_del(parser);
+    }
+    time[fast] = (BENCH_time()-start)/num_repeats;
+    json[fast] = NET_get_json_string(net[fast]);
+  }
+
+  // Results
+  printf("buses %d branches %d chunked %.4f s mmap %.4f s speedup %.2f identical %s\n",
+	 NET_get_num_buses(net[1]),NET_get_num_branches(net[1]),
+	 time[0],time[1],time[0]/time[1],
+	 strcmp(json[0],json[1]) == 0 ? "yes" : "no");
+
+  // Clean up
+  for (fast = 0; fast < 2; fast++) {
+    free(json[fast]);
+    NET_del(net[fast]);
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+/** @file bench_problem_shift.c
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "bench_utils.h"
+
+int main(int argc, char **argv) {
+
+  // Local variables
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  double time[2];
+  double start;
+  int num_periods;
+  int num_repeats;
+  int i;
+
+  // Check inputs
+  if (argc < 2) {
+    printf("usage: bench_problem_shift case.mat [num_periods] [num_repeats]\n");
+    return -1;
+  }
+  num_periods = argc > 2 ? atoi(argv[2]) : 24;
+  num_repeats = argc > 3 ? atoi(argv[3]) : 5;
+  if (num_periods < 1 || num_repeats < 1) {
+    printf("invalid arguments\n");
+    return -1;
+  }
+
+  // Network
+  parser = PARSER_new_for_file(argv[1]);
+  net = PARSER_parse(parser,argv[1],num_periods);
+  if (PARSER_has_error(parser)) {
+    printf("%s\n",PARSER_get_error_string(parser));
+    return -1;
+  }
+  PARSER_del(parser);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS|FLAG_BOUNDED,GEN_PROP_ANY,GEN_VAR_P|GEN_VAR_Q);
+
+  // Problem
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_LBOUND_new(net));
+  PROB_add_constr(p,CONSTR_GEN_RAMP_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+
+  // Analyze
+  start = BENCH_time();
+  for (i = 0; i < num_repeats; i++)
+    PROB_analyze(p);
+  time[0] = (BENCH_time()-start)/num_repeats;
+
+  // Shift
+  start = BENCH_time();
+  for (i = 0; i < num_repeats; i++)
+    PROB_shift_periods(p,1,NULL);
+  time[1] = (BENCH_time()-start)/num_repeats;
+  if (PROB_has_error(p)) {
+    printf("%s\n",PROB_get_error_string(p));
+    return -1;
+  }
+
+  // Results
+  printf("buses %d periods %d vars %d analyze %.4f s shift %.4f s speedup %.2f\n",
+	 NET_get_num_buses(net),num_periods,NET_get_num_vars(net),
+	 time[0],time[1],time[0]/time[1]);
+
+  // Clean up
+  PROB_del(p);
+  NET_del(net);
+  return 0;
+}
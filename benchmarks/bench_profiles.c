@@ -0,0 +1,91 @@
+/** @file bench_profiles.c
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "bench_utils.h"
+
+int main(int argc, char **argv) {
+
+  // Local variables
+  Parser* parser;
+  Net* net;
+  Load* load;
+  FILE* file;
+  char filename[] = "bench_profiles.csv";
+  double time[2];
+  double start;
+  int num_periods;
+  int num_loads;
+  int i;
+  int t;
+
+  // Check inputs
+  if (argc < 2) {
+    printf("usage: bench_profiles case.mat [num_periods]\n");
+    return -1;
+  }
+  num_periods = argc > 2 ? atoi(argv[2]) : 8760;
+  if (num_periods < 1) {
+    printf("invalid arguments\n");
+    return -1;
+  }
+
+  // Network
+  parser = PARSER_new_for_file(argv[1]);
+  net = PARSER_parse(parser,argv[1],num_periods);
+  if (PARSER_has_error(parser)) {
+    printf("%s\n",PARSER_get_error_string(parser));
+    return -1;
+  }
+  PARSER_del(parser);
+  num_loads = NET_get_num_loads(net);
+
+  // Profiles file (active and reactive powers of all loads)
+  file = fopen(filename,"w");
+  fprintf(file,"t");
+  for (i = 0; i < num_loads; i++)
+    fprintf(file,",load:%d:P,load:%d:Q",i,i);
+  fprintf(file,"\n");
+  for (t = 0; t < num_periods; t++) {
+    fprintf(file,"%d",t);
+    for (i = 0; i < num_loads; i++)
+      fprintf(file,",%.6e,%.6e",1.+0.01*((i+t)%13),0.2+0.01*((i+t)%7));
+    fprintf(file,"\n");
+  }
+  fclose(file);
+
+  // Component setters
+  start = BENCH_time();
+  for (i = 0; i < num_loads; i++) {
+    load = NET_get_load(net,i);
+    for (t = 0; t < num_periods; t++) {
+      LOAD_set_P(load,1.+0.01*((i+t)%13),t);
+      LOAD_set_Q(load,0.2+0.01*((i+t)%7),t);
+    }
+  }
+  time[0] = BENCH_time()-start;
+
+  // Profiles
+  start = BENCH_time();
+  NET_load_profiles(net,filename);
+  time[1] = BENCH_time()-start;
+  remove(filename);
+  if (NET_has_error(net)) {
+    printf("%s\n",NET_get_error_string(net));
+    return -1;
+  }
+
+  // Results
+  printf("loads %d periods %d values %d setters %.4f s profiles %.4f s (%.1f Mvalues/s)\n",
+	 num_loads,num_periods,2*num_loads*num_periods,
+	 time[0],time[1],2.*num_loads*num_periods/time[1]/1e6);
+
+  // Clean up
+  NET_del(net);
+  return 0;
+}
@@ -0,0 +1,58 @@
+/** @file bench_utils.h
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __BENCH_UTILS_HEADER__
+#define __BENCH_UTILS_HEADER__
+
+#include <stdio.h>
+#include <time.h>
+#include <pfnet/pfnet.h>
+
+static inline double BENCH_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec+1e-9*ts.tv_nsec;
+}
+
+static inline Net* BENCH_create_feeder(int num_buses, int num_periods) {
+  /** Creates a synthetic radial network where bus i is
+   *  connected to bus (i-1)/3, with no devices.
+   */
+
+  // Local variables
+  Net* net;
+  Bus* bus_k;
+  Bus* bus_m;
+  Branch* br;
+  int i;
+
+  net = NET_new(num_periods);
+  NET_set_bus_array(net,BUS_array_new(num_buses,num_periods),num_buses);
+  NET_set_branch_array(net,BRANCH_array_new(num_buses-1,num_periods),num_buses-1);
+
+  for (i = 0; i < num_buses; i++) {
+    BUS_set_number(NET_get_bus(net,i),i+1);
+    NET_bus_hash_number_add(net,NET_get_bus(net,i));
+  }
+
+  for (i = 1; i < num_buses; i++) {
+    br = NET_get_branch(net,i-1);
+    bus_k = NET_get_bus(net,(i-1)/3);
+    bus_m = NET_get_bus(net,i);
+    BRANCH_set_bus_k(br,bus_k);
+    BRANCH_set_bus_m(br,bus_m);
+    BRANCH_set_b(br,-10.);
+    BUS_add_branch_k(bus_k,br);
+    BUS_add_branch_m(bus_m,br);
+  }
+
+  return net;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/** @file bench_vargen_P_sigma.c
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "bench_utils.h"
+
+int main(int argc, char **argv) {
+
+  // Local variables
+  Net* net;
+  Mat* sigma;
+  Vargen* vargen;
+  Bus* bus;
+  int num_buses;
+  int num_vargens;
+  int spread;
+  int num_periods;
+  double start;
+  int i;
+  int t;
+
+  // Check inputs
+  if (argc < 5) {
+    printf("usage: bench_vargen_P_sigma num_buses num_vargens spread num_periods\n");
+    return -1;
+  }
+  num_buses = atoi(argv[1]);
+  num_vargens = atoi(argv[2]);
+  spread = atoi(argv[3]);
+  num_periods = atoi(argv[4]);
+  if (num_buses < 2 || num_vargens < 1 || num_vargens > num_buses || num_periods < 1) {
+    printf("invalid arguments\n");
+    return -1;
+  }
+
+  // Network
+  net = BENCH_create_feeder(num_buses,num_periods);
+  NET_set_vargen_array(net,VARGEN_array_new(num_vargens,num_periods),num_vargens);
+  for (i = 0; i < num_vargens; i++) {
+    vargen = NET_get_vargen(net,i);
+    bus = NET_get_bus(net,(int)((double)i*num_buses/num_vargens));
+    VARGEN_set_bus(vargen,bus);
+    BUS_add_vargen(bus,vargen);
+    for (t = 0; t < num_periods; t++)
+      VARGEN_set_P_std(vargen,0.1,t);
+  }
+  NET_set_flags(net,OBJ_VARGEN,FLAG_VARS,VARGEN_PROP_ANY,VARGEN_VAR_P);
+
+  // Run
+  start = BENCH_time();
+  sigma = NET_create_vargen_P_sigma(net,spread,0.5);
+  printf("buses %d vargens %d spread %d periods %d nnz %d time %.3f s\n",
+	 num_buses,num_vargens,spread,num_periods,
+	 MAT_get_nnz(sigma),BENCH_time()-start);
+
+  // Clean up
+  MAT_del(sigma);
+  NET_del(net);
+  return 0;
+}
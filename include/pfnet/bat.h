@@ -15,6 +15,7 @@
 #include "types.h"
 #include "list.h"
 #include "vector.h"
+#include "json_writer.h"
 
 // Variables
 /** \defgroup bat_vars Battery Variable Masks 
@@ -64,6 +65,7 @@ char BAT_get_flags_sparse(Bat* bat);
 
 char* BAT_get_name(Bat* bat);
 int BAT_get_num_periods(Bat* bat);
+REAL* BAT_get_series(Bat* bat, char* name);
 char BAT_get_obj_type(void* bat);
 Bus* BAT_get_bus(Bat* bat);
 int BAT_get_index(Bat* bat);
@@ -92,6 +94,8 @@ Bat* BAT_list_add(Bat *bat_list, Bat* bat);
 int BAT_list_len(Bat* bat_list);
 Bat* BAT_new(int num_periods);
 void BAT_propagate_data_in_time(Bat* bat, int start, int end);
+void BAT_write_json(Bat* bat, JSON_Writer* writer);
+void BAT_shift_periods(Bat* bat, int k);
 void BAT_set_name(Bat* bat, char* name);
 void BAT_set_bus(Bat* bat, Bus* bus);
 void BAT_set_index(Bat* bat, int index);
@@ -14,6 +14,7 @@
 #include "types.h"
 #include "list.h"
 #include "vector.h"
+#include "json_writer.h"
 
 // Branch types
 #define BRANCH_TYPE_LINE 0       /**< @brief Type: transmission line */
@@ -92,6 +93,7 @@ char BRANCH_get_flags_sparse(Branch* br);
 
 char* BRANCH_get_name(Branch* br);
 int BRANCH_get_num_periods(Branch* br);
+REAL* BRANCH_get_series(Branch* br, char* name);
 char BRANCH_get_type(Branch* br);
 char BRANCH_get_obj_type(void* br);
 
@@ -185,6 +187,8 @@ Branch* BRANCH_list_m_del(Branch* m_br_list, Branch* br);
 int BRANCH_list_m_len(Branch* m_br_list);
 Branch* BRANCH_new(int num_periods);
 void BRANCH_propagate_data_in_time(Branch* br, int start, int end);
+void BRANCH_write_json(Branch* branch, JSON_Writer* writer);
+void BRANCH_shift_periods(Branch* branch, int k);
 void BRANCH_set_name(Branch* br, char* name);
 void BRANCH_set_outage(Branch* br, BOOL outage);
 void BRANCH_set_sens_P_u_bound(Branch* br, REAL value, int t);
@@ -195,6 +199,7 @@ void BRANCH_set_sens_phase_u_bound(Branch* br, REAL value, int t);
 void BRANCH_set_sens_phase_l_bound(Branch* br, REAL value, int t);
 void BRANCH_set_sens_i_mag_u_bound(Branch* br, REAL value, int t);
 void BRANCH_set_index(Branch* br, int index);
+void BRANCH_set_topology_version(Branch* br, int* version);
 void BRANCH_set_type(Branch* br, int type);
 void BRANCH_set_bus_k(Branch* br, Bus* bus_k);
 void BRANCH_set_bus_m(Branch* br, Bus* bus_m);
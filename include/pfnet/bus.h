@@ -15,6 +15,7 @@
 #include "types.h"
 #include "list.h"
 #include "vector.h"
+#include "json_writer.h"
 #include "uthash.h"
 
 // Limits
@@ -162,6 +163,7 @@ Bus* BUS_get_next(Bus* bus);
 int BUS_get_number(Bus* bus);
 char* BUS_get_name(Bus* bus);
 int BUS_get_num_periods(Bus* bus);
+REAL* BUS_get_series(Bus* bus, char* name);
 int BUS_get_num_gens(Bus* bus);
 int BUS_get_num_loads(Bus* bus);
 int BUS_get_num_shunts(Bus* bus);
@@ -255,6 +257,8 @@ Bus* BUS_list_add_sorting(Bus* bus_list, Bus* bus, int sort_by, int t);
 int BUS_list_len(Bus* bus_list);
 Bus* BUS_new(int num_periods);
 void BUS_propagate_data_in_time(Bus* bus, int start, int end);
+void BUS_write_json(Bus* bus, JSON_Writer* writer);
+void BUS_shift_periods(Bus* bus, int k);
 void BUS_set_next(Bus* bus, Bus* next_bus);
 void BUS_set_number(Bus* bus, int number);
 void BUS_set_name(Bus* bus, char* name);
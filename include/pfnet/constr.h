@@ -21,6 +21,9 @@
 #define CONSTR_BUFFER_SIZE 1024     /**< @brief Default constraint buffer size for general strings */
 #define CONSTR_INFO_BUFFER_SIZE 100 /**< @brife Default buffer size for row info strings */
 
+// Counters
+#define CONSTR_NUM_COUNTERS 6 /**< @brief Number of counters of nonzeros and rows of A, J and G */
+
 // Constraint
 typedef struct Constr Constr;
 
@@ -62,6 +65,7 @@ int CONSTR_get_G_row(Constr* c);
 int* CONSTR_get_G_row_ptr(Constr* c);
 int CONSTR_get_J_row(Constr* c);
 int* CONSTR_get_J_row_ptr(Constr* c);
+void CONSTR_get_counters(Constr* c, int* counters);
 char* CONSTR_get_bus_counted(Constr *c);
 int CONSTR_get_bus_counted_size(Constr* c);
 void* CONSTR_get_data(Constr* c);
@@ -79,13 +83,20 @@ Constr* CONSTR_list_add(Constr* clist, Constr* nc);
 int CONSTR_list_len(Constr* clist);
 void CONSTR_list_del(Constr* clist);
 void CONSTR_list_combine_H(Constr* clist, Vec* coeff, BOOL ensure_psd);
+void CONSTR_list_count_batch(Constr* clist);
 void CONSTR_list_count_step(Constr* clist, Branch* br, int t);
 void CONSTR_list_allocate(Constr* clist);
 void CONSTR_list_clear(Constr* clist);
+void CONSTR_list_analyze_batch(Constr* clist);
 void CONSTR_list_analyze_step(Constr* clist, Branch* br, int t);
+void CONSTR_list_eval_batch(Constr* clist, Vec* v, Vec* ve);
+void CONSTR_list_eval_period(Constr* clist, int t, Vec* v, Vec* ve);
 void CONSTR_list_eval_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_list_store_sens_batch(Constr* clist, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_list_store_sens_step(Constr* clist, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
+void CONSTR_list_store_sens_map(Constr* clist, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 Constr* CONSTR_new(Net* net);
+Constr* CONSTR_new_view(Constr* c);
 void CONSTR_set_name(Constr* c, char* name);
 void CONSTR_set_b(Constr* c, Vec* b);
 void CONSTR_set_A(Constr* c, Mat* A);
@@ -107,6 +118,7 @@ void CONSTR_set_H_nnz(Constr* c, int* nnz, int size);
 void CONSTR_set_A_row(Constr* c, int index);
 void CONSTR_set_G_row(Constr* c, int index);
 void CONSTR_set_J_row(Constr* c, int index);
+void CONSTR_set_counters(Constr* c, int* counters);
 void CONSTR_set_bus_counted(Constr* c, char* counted, int size);
 void CONSTR_set_data(Constr* c, void* data);
 void CONSTR_set_A_row_info_string(Constr* c, int index, char* obj, int obj_id, char* constr_info, int time);
@@ -114,24 +126,38 @@ void CONSTR_set_J_row_info_string(Constr* c, int index, char* obj, int obj_id, c
 void CONSTR_set_G_row_info_string(Constr* c, int index, char* obj, int obj_id, char* constr_info, int time);
 void CONSTR_init(Constr* c);
 void CONSTR_count(Constr* c);
+void CONSTR_count_batch(Constr* c);
 void CONSTR_count_step(Constr* c, Branch* br, int t);
 void CONSTR_allocate(Constr* c);
 void CONSTR_clear(Constr* c);
 void CONSTR_analyze(Constr* c);
+void CONSTR_analyze_batch(Constr* c);
 void CONSTR_analyze_step(Constr* c, Branch* br, int t);
 void CONSTR_eval(Constr* c, Vec* v, Vec* ve);
+void CONSTR_eval_batch(Constr* c, Vec* v, Vec* ve);
+void CONSTR_eval_Jv(Constr* c, Vec* v, Vec* ve, Vec* d, Vec* Jd);
+void CONSTR_eval_JTy(Constr* c, Vec* v, Vec* ve, Vec* y, Vec* JTy);
+void CONSTR_eval_Hv(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd);
+void CONSTR_add_H_product(int i, int j, REAL val, REAL* d, REAL* Hd);
+void CONSTR_eval_period(Constr* c, int t, Vec* v, Vec* ve);
 void CONSTR_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
 void CONSTR_store_sens(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
+void CONSTR_store_sens_batch(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
+BOOL CONSTR_is_branch_active(Constr* c, Branch* br, int t);
+BOOL CONSTR_is_island_safe(Constr* c);
 BOOL CONSTR_is_safe_to_count(Constr* c);
 BOOL CONSTR_is_safe_to_analyze(Constr* c);
 BOOL CONSTR_is_safe_to_eval(Constr* c, Vec* v, Vec* ve);
 void CONSTR_set_error(Constr* c, char* string);
 void CONSTR_clear_error(Constr* c);
 BOOL CONSTR_has_error(Constr* c);
+BOOL CONSTR_has_active_set(Constr* c);
+BOOL CONSTR_has_periodic_structure(Constr* c);
 char* CONSTR_get_error_string(Constr* c);
 void CONSTR_update_network(Constr* c);
 Net* CONSTR_get_network(Constr* c);
+int CONSTR_get_num_active_branches(Constr* c);
 int CONSTR_get_num_extra_vars(Constr* c);
 void CONSTR_set_num_extra_vars(Constr* c, int num);
 void CONSTR_set_func_init(Constr* c, void (*func)(Constr* c));
@@ -140,7 +166,23 @@ void CONSTR_set_func_allocate(Constr* c, void (*func)(Constr* c));
 void CONSTR_set_func_clear(Constr* c, void (*func)(Constr* c));
 void CONSTR_set_func_analyze_step(Constr* c, void (*func)(Constr* c, Branch* br, int t));
 void CONSTR_set_func_eval_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* v, Vec* ve));
+void CONSTR_set_func_eval_period(Constr* c, void (*func)(Constr* c, int t, Vec* v, Vec* ve));
 void CONSTR_set_func_store_sens_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl));
 void CONSTR_set_func_free(Constr* c, void (*func)(Constr* c));
+void CONSTR_set_func_count(Constr* c, void (*func)(Constr* c));
+void CONSTR_set_func_analyze(Constr* c, void (*func)(Constr* c));
+void CONSTR_set_func_eval(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve));
+void CONSTR_set_func_store_sens(Constr* c, void (*func)(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl));
+void CONSTR_set_func_analyze_data_step(Constr* c, void (*func)(Constr* c, Branch* br, int t));
+void CONSTR_set_active_set(Constr* c, BOOL flag);
+void CONSTR_set_func_get_branch_loading(Constr* c, REAL (*func)(Constr* c, Branch* br, int t, Vec* v));
+void CONSTR_set_func_eval_Jv(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve, Vec* d, Vec* Jd));
+void CONSTR_set_func_eval_JTy(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve, Vec* y, Vec* JTy));
+void CONSTR_set_func_eval_Hv(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd));
+void CONSTR_set_island_safe(Constr* c, BOOL flag);
+void CONSTR_set_periodic_structure(Constr* c, BOOL flag);
+int CONSTR_screen_branches(Constr* c, Vec* values, REAL fraction);
+void CONSTR_replicate_counts(Constr* c);
+void CONSTR_replicate_structure(Constr* c);
 
 #endif
@@ -27,5 +27,15 @@ void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t);
 void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
 void CONSTR_ACPF_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_ACPF_free(Constr* c);
+void CONSTR_ACPF_analyze(Constr* c);
+void CONSTR_ACPF_eval(Constr* c, Vec* v, Vec* ve);
+void CONSTR_ACPF_get_branch_flows(Branch* br, REAL* v, REAL* w, REAL a, REAL phi,
+				  REAL* P_km, REAL* Q_km, REAL* P_kk, REAL* Q_kk);
+BOOL CONSTR_ACPF_has_fixed_flows(Branch* br);
+void CONSTR_ACPF_add_J_product(int row, int col, REAL val, REAL* d, REAL* Jd, REAL* y, REAL* JTy);
+void CONSTR_ACPF_eval_J_products(Constr* c, Vec* values, Vec* d, Vec* Jd, Vec* y, Vec* JTy);
+void CONSTR_ACPF_eval_Jv(Constr* c, Vec* values, Vec* values_extra, Vec* d, Vec* Jd);
+void CONSTR_ACPF_eval_JTy(Constr* c, Vec* values, Vec* values_extra, Vec* y, Vec* JTy);
+void CONSTR_ACPF_eval_Hv(Constr* c, Vec* values, Vec* values_extra, Vec* lam, Vec* d, Vec* Hd);
 
 #endif
@@ -21,11 +21,14 @@
 Constr* CONSTR_AC_FLOW_LIM_new(Net* net);
 void CONSTR_AC_FLOW_LIM_init(Constr* c);
 void CONSTR_AC_FLOW_LIM_count_step(Constr* c, Branch* br, int t);
+void CONSTR_AC_FLOW_LIM_count(Constr* c);
 void CONSTR_AC_FLOW_LIM_allocate(Constr* c);
 void CONSTR_AC_FLOW_LIM_clear(Constr* c);
 void CONSTR_AC_FLOW_LIM_analyze_step(Constr* c, Branch* br, int t);
 void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_AC_FLOW_LIM_eval_Hv(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd);
 void CONSTR_AC_FLOW_LIM_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
+REAL CONSTR_AC_FLOW_LIM_get_branch_loading(Constr* c, Branch* br, int t, Vec* values);
 void CONSTR_AC_FLOW_LIM_free(Constr* c);
 
 #endif
@@ -21,6 +21,7 @@ void CONSTR_DCPF_count_step(Constr* c, Branch* br, int t);
 void CONSTR_DCPF_allocate(Constr* c);
 void CONSTR_DCPF_clear(Constr* c);
 void CONSTR_DCPF_analyze_step(Constr* c, Branch* br, int t);
+void CONSTR_DCPF_analyze_data_step(Constr* c, Branch* br, int t);
 void CONSTR_DCPF_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
 void CONSTR_DCPF_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_DCPF_free(Constr* c);
@@ -21,8 +21,10 @@ void CONSTR_DC_FLOW_LIM_count_step(Constr* c, Branch* br, int t);
 void CONSTR_DC_FLOW_LIM_allocate(Constr* c);
 void CONSTR_DC_FLOW_LIM_clear(Constr* c);
 void CONSTR_DC_FLOW_LIM_analyze_step(Constr* c, Branch* br, int t);
+void CONSTR_DC_FLOW_LIM_analyze_data_step(Constr* c, Branch* br, int t);
 void CONSTR_DC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
 void CONSTR_DC_FLOW_LIM_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
+REAL CONSTR_DC_FLOW_LIM_get_branch_loading(Constr* c, Branch* br, int t, Vec* values);
 void CONSTR_DC_FLOW_LIM_free(Constr* c);
 
 #endif
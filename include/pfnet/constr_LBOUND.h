@@ -14,6 +14,9 @@
 #include <math.h>
 #include "constr.h"
 
+// Data
+typedef struct Constr_LBOUND_Data Constr_LBOUND_Data;
+
 // Function prototypes
 Constr* CONSTR_LBOUND_new(Net* net);
 void CONSTR_LBOUND_init(Constr* c);
@@ -21,8 +24,10 @@ void CONSTR_LBOUND_count_step(Constr* c, Branch* br, int t);
 void CONSTR_LBOUND_allocate(Constr* c);
 void CONSTR_LBOUND_clear(Constr* c);
 void CONSTR_LBOUND_analyze_step(Constr* c, Branch* br, int t);
-void CONSTR_LBOUND_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
 void CONSTR_LBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_LBOUND_free(Constr* c);
+void CONSTR_LBOUND_get_bounds(Constr* c, Vec* l, Vec* u);
+BOOL CONSTR_LBOUND_has_simple_bounds(Constr* c);
+void CONSTR_LBOUND_set_simple_bounds(Constr* c, BOOL flag);
 
 #endif
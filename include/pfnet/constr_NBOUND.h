@@ -25,6 +25,8 @@ void CONSTR_NBOUND_allocate(Constr* c);
 void CONSTR_NBOUND_clear(Constr* c);
 void CONSTR_NBOUND_analyze_step(Constr* c, Branch* br, int t);
 void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_NBOUND_add_Hv_rows(int index, REAL umax, REAL umin, int* row, REAL* values, REAL* lam, REAL* d, REAL* Hd);
+void CONSTR_NBOUND_eval_Hv(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd);
 void CONSTR_NBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_NBOUND_free(Constr* c);
 
@@ -44,14 +44,19 @@ char* FUNC_list_get_error_string(Func* flist);
 Func* FUNC_list_add(Func* flist, Func* nf);
 int FUNC_list_len(Func* flist);
 void FUNC_list_del(Func* flist);
+void FUNC_list_count_batch(Func* flist);
 void FUNC_list_count_step(Func* f, Branch* br, int t);
 void FUNC_list_allocate(Func* f);
 void FUNC_list_clear(Func* f);
+void FUNC_list_analyze_batch(Func* flist);
 void FUNC_list_analyze_step(Func* f, Branch* br, int t);
+void FUNC_list_eval_batch(Func* flist, Vec* var_values);
+void FUNC_list_eval_period(Func* f, int t, Vec* var_values);
 void FUNC_list_eval_step(Func* f, Branch* br, int t, Vec* var_values);
 void FUNC_list_finalize_structure_of_Hessian(Func* flist);
 void FUNC_finalize_structure_of_Hessian(Func* f);
 Func* FUNC_new(REAL weight, Net* net);
+Func* FUNC_new_view(Func* f);
 void FUNC_set_name(Func* f, char* name);
 void FUNC_set_phi(Func* f, REAL phi);
 void FUNC_set_gphi(Func* f, Vec* gphi);
@@ -60,13 +65,19 @@ void FUNC_set_Hphi_nnz(Func* f, int nnz);
 void FUNC_set_bus_counted(Func* f, char* counted, int size);
 void FUNC_init(Func* f);
 void FUNC_count(Func* f);
+void FUNC_count_batch(Func* f);
 void FUNC_count_step(Func* f, Branch* br, int t);
 void FUNC_allocate(Func* f);
 void FUNC_clear(Func* f);
 void FUNC_analyze(Func* f);
+void FUNC_analyze_batch(Func* f);
 void FUNC_analyze_step(Func* f, Branch* br, int t);
 void FUNC_eval(Func* f, Vec* var_values);
+void FUNC_eval_batch(Func* f, Vec* var_values);
+void FUNC_eval_period(Func* f, int t, Vec* var_values);
 void FUNC_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd);
+BOOL FUNC_is_island_safe(Func* f);
 BOOL FUNC_is_safe_to_count(Func* f);
 BOOL FUNC_is_safe_to_analyze(Func* f);
 BOOL FUNC_is_safe_to_eval(Func* f, Vec* values);
@@ -75,13 +86,19 @@ BOOL FUNC_has_error(Func* f);
 char* FUNC_get_error_string(Func* f);
 void FUNC_update_network(Func* f);
 Net* FUNC_get_network(Func* f);
+void FUNC_set_island_safe(Func* f, BOOL flag);
 void FUNC_set_func_init(Func* f, void (*func)(Func* f));
 void FUNC_set_func_count_step(Func* f, void (*func)(Func* f, Branch* br, int t));
 void FUNC_set_func_allocate(Func* f, void (*func)(Func* f));
 void FUNC_set_func_clear(Func* f, void (*func)(Func* f));
 void FUNC_set_func_analyze_step(Func* f, void (*func)(Func* f, Branch* br, int t));
 void FUNC_set_func_eval_step(Func* f, void (*func)(Func* f, Branch* br, int t, Vec* v));
+void FUNC_set_func_eval_period(Func* f, void (*func)(Func* f, int t, Vec* v));
 void FUNC_set_func_free(Func* f, void (*func)(Func* f));
+void FUNC_set_func_count(Func* f, void (*func)(Func* f));
+void FUNC_set_func_analyze(Func* f, void (*func)(Func* f));
+void FUNC_set_func_eval(Func* f, void (*func)(Func* f, Vec* v));
+void FUNC_set_func_eval_Hv(Func* f, void (*func)(Func* f, Vec* v, Vec* d, Vec* Hd));
 void* FUNC_get_data(Func* f);
 void FUNC_set_data(Func* f, void* data);
 
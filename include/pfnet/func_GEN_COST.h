@@ -21,7 +21,8 @@ void FUNC_GEN_COST_count_step(Func* f, Branch* br, int t);
 void FUNC_GEN_COST_allocate(Func* f);
 void FUNC_GEN_COST_clear(Func* f);
 void FUNC_GEN_COST_analyze_step(Func* f, Branch* br, int t);
-void FUNC_GEN_COST_eval_step(Func* f, Branch* br, int t, Vec* v);
+void FUNC_GEN_COST_eval_period(Func* f, int t, Vec* v);
+void FUNC_GEN_COST_eval_Hv(Func* f, Vec* v, Vec* d, Vec* Hd);
 void FUNC_GEN_COST_free(Func* f);
 
 #endif
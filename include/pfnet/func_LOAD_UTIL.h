@@ -21,7 +21,8 @@ void FUNC_LOAD_UTIL_count_step(Func* f, Branch* br, int t);
 void FUNC_LOAD_UTIL_allocate(Func* f);
 void FUNC_LOAD_UTIL_clear(Func* f);
 void FUNC_LOAD_UTIL_analyze_step(Func* f, Branch* br, int t);
-void FUNC_LOAD_UTIL_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_LOAD_UTIL_eval_period(Func* f, int t, Vec* var_values);
+void FUNC_LOAD_UTIL_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd);
 void FUNC_LOAD_UTIL_free(Func* f);
 
 #endif
@@ -24,6 +24,7 @@ void FUNC_REG_VANG_allocate(Func* f);
 void FUNC_REG_VANG_clear(Func* f);
 void FUNC_REG_VANG_analyze_step(Func* f, Branch* br, int t);
 void FUNC_REG_VANG_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_REG_VANG_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd);
 void FUNC_REG_VANG_free(Func* f);
 
 #endif
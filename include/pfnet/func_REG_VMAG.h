@@ -23,7 +23,8 @@ void FUNC_REG_VMAG_count_step(Func* f, Branch* br, int t);
 void FUNC_REG_VMAG_allocate(Func* f);
 void FUNC_REG_VMAG_clear(Func* f);
 void FUNC_REG_VMAG_analyze_step(Func* f, Branch* br, int t);
-void FUNC_REG_VMAG_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_REG_VMAG_eval_period(Func* f, int t, Vec* var_values);
+void FUNC_REG_VMAG_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd);
 void FUNC_REG_VMAG_free(Func* f);
 
 #endif
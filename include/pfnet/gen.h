@@ -15,6 +15,7 @@
 #include "types.h"
 #include "list.h"
 #include "vector.h"
+#include "json_writer.h"
 
 // Variables
 /** \defgroup gen_vars Generator Variable Masks 
@@ -71,6 +72,7 @@ char GEN_get_flags_sparse(Gen* gen);
 
 char* GEN_get_name(Gen* gen);
 int GEN_get_num_periods(Gen* gen);
+REAL* GEN_get_series(Gen* gen, char* name);
 
 REAL GEN_get_sens_P_u_bound(Gen* gen, int t);
 REAL* GEN_get_sens_P_u_bound_array(Gen* gen);
@@ -123,6 +125,8 @@ Gen* GEN_list_reg_del(Gen* reg_gen_list, Gen* reg_gen);
 int GEN_list_reg_len(Gen* reg_gen_list);
 Gen* GEN_new(int num_periods);
 void GEN_propagate_data_in_time(Gen* gen, int start, int end);
+void GEN_write_json(Gen* gen, JSON_Writer* writer);
+void GEN_shift_periods(Gen* gen, int k);
 void GEN_set_name(Gen* gen, char* name);
 void GEN_set_sens_P_u_bound(Gen* gen, REAL value, int t);
 void GEN_set_sens_P_l_bound(Gen* gen, REAL value, int t);
@@ -12,162 +12,115 @@
 #define __JSON_MACROS_HEADER__
 
 #include <string.h>
+#include "json_writer.h"
 
-#define JSON_start(output) { \
-  strcpy(output,"{");        \
-  output += 1;		     \
+#define JSON_start(writer) {	   \
+  JSON_WRITER_write_char(writer,'{'); \
 }
 
-#define JSON_end(output) { \
-  strcpy(output,"}");      \
-  output += 1;		   \
+#define JSON_end(writer) {	   \
+  JSON_WRITER_write_char(writer,'}'); \
 }
 
-#define JSON_obj(temp,output,field_name,field,index_func,end) { \
-  if (field)							\
-    sprintf(temp,"\"%s\":%d",field_name,index_func(field));	\
-  else								\
-    sprintf(temp,"\"%s\":%s",field_name,"null");		\
-  strcpy(output,temp);						\
-  output += strlen(temp);					\
-  if (!end) {							\
-    strcpy(output,",");						\
-    output += 1;						\
-  }								\
+#define JSON_key(writer,field_name) {	   \
+  JSON_WRITER_write_char(writer,'"');	   \
+  JSON_WRITER_write_str(writer,field_name); \
+  JSON_WRITER_write(writer,"\":",2);	   \
 }
 
-#define JSON_int(temp,output,field_name,field,end) { \
-  sprintf(temp,"\"%s\":%d",field_name,field);	     \
-  strcpy(output,temp);				     \
-  output += strlen(temp);			     \
-  if (!end) {					     \
-    strcpy(output,",");				     \
-    output += 1;				     \
-  }						     \
+#define JSON_sep(writer,end) {		\
+  if (!end)				\
+    JSON_WRITER_write_char(writer,','); \
 }
 
-#define JSON_str(temp,output,field_name,field,end) { \
-  sprintf(temp,"\"%s\":\"%s\"",field_name,field);   \
-  strcpy(output,temp);				     \
-  output += strlen(temp);			     \
-  if (!end) {					     \
-    strcpy(output,",");				     \
-    output += 1;				     \
-  }						     \
+#define JSON_obj(writer,field_name,field,index_func,end) { \
+  JSON_key(writer,field_name);				  \
+  if (field)						  \
+    JSON_WRITER_write_int(writer,index_func(field));	  \
+  else							  \
+    JSON_WRITER_write(writer,"null",4);			  \
+  JSON_sep(writer,end);					  \
 }
 
-#define JSON_float(temp,output,field_name,field,end) {\
-  sprintf(temp,"\"%s\":%.10e",field_name,field);     \
-  strcpy(output,temp);				      \
-  output += strlen(temp);			      \
-  if (!end) {					      \
-    strcpy(output,",");				      \
-    output += 1;				      \
-  }						      \
+#define JSON_int(writer,field_name,field,end) { \
+  JSON_key(writer,field_name);		       \
+  JSON_WRITER_write_int(writer,field);	       \
+  JSON_sep(writer,end);			       \
 }
 
-#define JSON_bool(temp,output,field_name,field,end) {            \
-  sprintf(temp,"\"%s\":%s",field_name,field ? "true" : "false"); \
-  strcpy(output,temp);						 \
-  output += strlen(temp);					 \
-  if (!end) {							 \
-    strcpy(output,",");						 \
-    output += 1;						 \
-  }								 \
+#define JSON_str(writer,field_name,field,end) { \
+  JSON_key(writer,field_name);		       \
+  JSON_WRITER_write_char(writer,'"');	       \
+  JSON_WRITER_write_str(writer,field);	       \
+  JSON_WRITER_write_char(writer,'"');	       \
+  JSON_sep(writer,end);			       \
 }
 
-#define JSON_array_float(temp,output,field_name,field,num,end) { \
-  int i;							 \
-  sprintf(temp,"\"%s\":[",field_name);				 \
-  strcpy(output,temp);						 \
-  output += strlen(temp);					 \
-  for (i = 0; i < num; i++) {					 \
-    sprintf(temp,"%.10e",field[i]);     			 \
-    strcpy(output,temp);                                         \
-    output += strlen(temp);                                      \
-    if (i < num-1) {	                                         \
-      strcpy(output,",");					 \
-      output += 1;						 \
-    }								 \
-  }								 \
-  if (!end) {							 \
-    strcpy(output,"],");					 \
-    output += 2;						 \
-  }								 \
-  else {							 \
-    strcpy(output,"]");						 \
-    output += 1;						 \
-  }								 \
+#define JSON_float(writer,field_name,field,end) { \
+  JSON_key(writer,field_name);			 \
+  JSON_WRITER_write_float(writer,field);	 \
+  JSON_sep(writer,end);				 \
 }
 
-#define JSON_array_int(temp,output,field_name,field,num,end) { \
-  int i;						       \
-  sprintf(temp,"\"%s\":[",field_name);			       \
-  strcpy(output,temp);					       \
-  output += strlen(temp);				       \
-  for (i = 0; i < num; i++) {				       \
-    sprintf(temp,"%d",field[i]);			       \
-    strcpy(output,temp);                                       \
-    output += strlen(temp);                                    \
-    if (i < num-1) {	                                       \
-      strcpy(output,",");				       \
-      output += 1;					       \
-    }							       \
-  }							       \
-  if (!end) {						       \
-    strcpy(output,"],");				       \
-    output += 2;					       \
-  }							       \
-  else {						       \
-    strcpy(output,"]");					       \
-    output += 1;					       \
-  }							       \
+#define JSON_bool(writer,field_name,field,end) {		     \
+  JSON_key(writer,field_name);					     \
+  if (field)							     \
+    JSON_WRITER_write(writer,"true",4);				     \
+  else								     \
+    JSON_WRITER_write(writer,"false",5);			     \
+  JSON_sep(writer,end);						     \
 }
 
-#define JSON_list_int(temp,output,field_name,obj,iter_type,list_func,field_func,next_func,end) { \
-  iter_type* t;							                                 \
-  sprintf(temp,"\"%s\":[",field_name);					                         \
-  strcpy(output,temp);							                         \
-  output += strlen(temp);						                         \
-  for (t = list_func(obj); t != NULL; t = next_func(t)) {		                         \
-    sprintf(temp,"%d",field_func(t));                                                            \
-    strcpy(output,temp);                                                                         \
-    output += strlen(temp);                                                                      \
-    if (next_func(t) != NULL) {						                         \
-      strcpy(output,",");						                         \
-      output += 1;							                         \
-    }									                         \
-  }									                         \
-  if (!end) {								                         \
-    strcpy(output,"],");						                         \
-    output += 2;							                         \
-  }									                         \
-  else {								                         \
-    strcpy(output,"]");							                         \
-    output += 1;							                         \
-  }									                         \
+#define JSON_array_float(writer,field_name,field,num,end) { \
+  int i;						   \
+  JSON_key(writer,field_name);				   \
+  JSON_WRITER_write_char(writer,'[');			   \
+  for (i = 0; i < num; i++) {				   \
+    JSON_WRITER_write_float(writer,field[i]);		   \
+    if (i < num-1)					   \
+      JSON_WRITER_write_char(writer,',');		   \
+  }							   \
+  JSON_WRITER_write_char(writer,']');			   \
+  JSON_sep(writer,end);					   \
 }
 
-#define JSON_array_json(temp,output,field_name,array,array_get,array_size,json_func,end) { \
-  int i;								                   \
-  sprintf(temp,"\"%s\":[",field_name);					                   \
-  strcpy(output,temp);							                   \
-  output += strlen(temp);						                   \
-  for (i = 0; i < array_size; i++) {					                   \
-    output = json_func(array_get(array,i),output);			                   \
-    if (i < array_size-1) {						                   \
-      strcpy(output,",");						                   \
-      output += 1;							                   \
-    }									                   \
-  }									                   \
-  if (!end) {								                   \
-    strcpy(output,"],");						                   \
-    output += 2;							                   \
-  }									                   \
-  else {								                   \
-    strcpy(output,"]");							                   \
-    output += 1;							                   \
-  }									                   \
+#define JSON_array_int(writer,field_name,field,num,end) { \
+  int i;						 \
+  JSON_key(writer,field_name);				 \
+  JSON_WRITER_write_char(writer,'[');			 \
+  for (i = 0; i < num; i++) {				 \
+    JSON_WRITER_write_int(writer,field[i]);		 \
+    if (i < num-1)					 \
+      JSON_WRITER_write_char(writer,',');		 \
+  }							 \
+  JSON_WRITER_write_char(writer,']');			 \
+  JSON_sep(writer,end);					 \
 }
-  
+
+#define JSON_list_int(writer,field_name,obj,iter_type,list_func,field_func,next_func,end) { \
+  iter_type* t;									   \
+  JSON_key(writer,field_name);							   \
+  JSON_WRITER_write_char(writer,'[');						   \
+  for (t = list_func(obj); t != NULL; t = next_func(t)) {			   \
+    JSON_WRITER_write_int(writer,field_func(t));				   \
+    if (next_func(t) != NULL)							   \
+      JSON_WRITER_write_char(writer,',');					   \
+  }										   \
+  JSON_WRITER_write_char(writer,']');						   \
+  JSON_sep(writer,end);								   \
+}
+
+#define JSON_array_json(writer,field_name,array,array_get,array_size,json_func,end) { \
+  int i;									     \
+  JSON_key(writer,field_name);							     \
+  JSON_WRITER_write_char(writer,'[');						     \
+  for (i = 0; i < array_size; i++) {						     \
+    json_func(array_get(array,i),writer);					     \
+    if (i < array_size-1)							     \
+      JSON_WRITER_write_char(writer,',');					     \
+  }										     \
+  JSON_WRITER_write_char(writer,']');						     \
+  JSON_sep(writer,end);								     \
+}
+
 #endif
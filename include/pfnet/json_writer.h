@@ -0,0 +1,40 @@
+/** @file json_writer.h
+ *  @brief This file lists the constants and routines associated with the JSON_Writer data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __JSON_WRITER_HEADER__
+#define __JSON_WRITER_HEADER__
+
+#include <stdio.h>
+#include <string.h>
+#include "types.h"
+
+// Buffer
+#define JSON_WRITER_BUFFER_SIZE 65536 /**< @brief Size of chunks written to files */
+#define JSON_WRITER_NUMBER_SIZE 32    /**< @brief Max length of formatted number */
+
+// Writer
+typedef struct JSON_Writer JSON_Writer;
+
+void JSON_WRITER_del(JSON_Writer* w);
+void JSON_WRITER_flush(JSON_Writer* w);
+size_t JSON_WRITER_get_length(JSON_Writer* w);
+char* JSON_WRITER_get_string(JSON_Writer* w);
+BOOL JSON_WRITER_has_error(JSON_Writer* w);
+JSON_Writer* JSON_WRITER_new(void);
+JSON_Writer* JSON_WRITER_new_for_fd(int fd);
+JSON_Writer* JSON_WRITER_new_for_file(FILE* file);
+char* JSON_WRITER_release_string(JSON_Writer* w);
+void JSON_WRITER_write(JSON_Writer* w, char* data, size_t len);
+void JSON_WRITER_write_char(JSON_Writer* w, char c);
+void JSON_WRITER_write_float(JSON_Writer* w, REAL v);
+void JSON_WRITER_write_int(JSON_Writer* w, int v);
+void JSON_WRITER_write_str(JSON_Writer* w, char* s);
+
+#endif
@@ -15,6 +15,7 @@
 #include "types.h"
 #include "list.h"
 #include "vector.h"
+#include "json_writer.h"
 
 // Variables
 /** \defgroup load_vars Load Variable Masks 
@@ -68,6 +69,7 @@ char LOAD_get_flags_sparse(Load* load);
 
 char* LOAD_get_name(Load* load);
 int LOAD_get_num_periods(Load* load);
+REAL* LOAD_get_series(Load* load, char* name);
 
 REAL LOAD_get_sens_P_u_bound(Load* load, int t);
 REAL* LOAD_get_sens_P_u_bound_array(Load* load);
@@ -104,6 +106,8 @@ Load* LOAD_list_add(Load *load_list, Load* load);
 int LOAD_list_len(Load* load_list);
 Load* LOAD_new(int num_periods);
 void LOAD_propagate_data_in_time(Load* load, int start, int end);
+void LOAD_write_json(Load* load, JSON_Writer* writer);
+void LOAD_shift_periods(Load* load, int k);
 void LOAD_set_name(Load* load, char* name);
 void LOAD_set_target_power_factor(Load* load, REAL pf);
 void LOAD_set_sens_P_u_bound(Load* load, REAL value, int t);
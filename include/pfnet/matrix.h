@@ -20,10 +20,12 @@ typedef struct Vec Vec;
 
 // Function prototypes
 void MAT_add_to_dentry(Mat* m, int index, REAL value);
+void MAT_add_sym_mul_vec(Mat* m, REAL coeff, REAL* v, REAL* w);
 void MAT_array_del(Mat* m, int size);
 Mat* MAT_array_new(int size);
 Mat* MAT_array_get(Mat* m, int index);
 void MAT_array_set_zero_d(Mat* m, int size);
+int MAT_color_columns(Mat* m, int* colors);
 Mat* MAT_copy(Mat* m);
 void MAT_del(Mat* m);
 int MAT_get_i(Mat* m, int index);
@@ -38,6 +40,7 @@ REAL* MAT_get_data_array(Mat* m);
 BOOL MAT_get_owns_rowcol(Mat* m);
 void MAT_init(Mat* m);
 Mat* MAT_new(int size1, int size2, int nnz);
+Mat* MAT_new_compact(Mat* m, int* map);
 Mat* MAT_new_from_arrays(int size1, int size2, int nnz, int* row, int* col, REAL* data);
 Vec* MAT_rmul_by_vec(Mat* m, Vec* v);
 void MAT_set_i(Mat* m, int index, int value);
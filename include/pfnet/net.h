@@ -34,6 +34,11 @@
 // Buffer
 #define NET_BUFFER_SIZE 1024 /**< @brief Default network buffer size for strings */
 
+// Variable orderings
+#define NET_ORDER_NATURAL 0 /**< @brief Variable indices assigned in order of flag calls. */
+#define NET_ORDER_RCM 1     /**< @brief Variable indices grouped by bus in reverse Cuthill-McKee order. */
+#define NET_ORDER_AMD 2     /**< @brief Variable indices grouped by bus in minimum degree order. */
+
 // Net
 typedef struct Net Net;
 
@@ -48,6 +53,7 @@ Bus* NET_bus_hash_number_find(Net* net, int number);
 void NET_bus_hash_name_add(Net* net, Bus* bus);
 Bus* NET_bus_hash_name_find(Net* net, char* name);
 BOOL NET_check(Net* net, BOOL verbose);
+void NET_clear_adjacency(Net* net);
 void NET_clear_data(Net* net);
 void NET_clear_error(Net* net);
 void NET_clear_flags(Net* net);
@@ -55,12 +61,21 @@ void NET_clear_outages(Net* net);
 void NET_clear_properties(Net* net);
 void NET_clear_sensitivities(Net* net);
 Bus* NET_create_sorted_bus_list(Net* net, int sort_by, int t);
+int* NET_create_bus_ordering(Net* net, int ordering);
 Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr);
+int* NET_create_var_periods(Net* net);
+int* NET_create_var_strides(Net* net);
 void NET_copy_from_net(Net* net, Net* other);
 void NET_del(Net* net);
 void NET_init(Net* net, int num_periods);
 Net* NET_get_copy(Net* net);
 int NET_get_bus_neighbors(Net* net, Bus* bus, int spread, int* neighbors, char* queued);
+int* NET_get_adjacency_ptr(Net* net);
+int* NET_get_adjacency_branches(Net* net);
+int* NET_get_adjacency_buses(Net* net);
+int NET_get_bus_degree(Net* net, int index);
+int* NET_get_bus_islands(Net* net);
+int NET_get_bus_island(Net* net, int index);
 REAL NET_get_base_power(Net* net);
 Branch* NET_get_branch(Net* net, int index);
 Bus* NET_get_bus(Net* net, int index);
@@ -82,6 +97,7 @@ Load* NET_get_load_from_name_and_bus_number(Net* net, char* name, int number);
 Vargen* NET_get_vargen_from_name_and_bus_number(Net* net, char* name, int number);
 Bat* NET_get_bat_from_name_and_bus_number(Net* net, char* name, int number);
 
+int NET_get_num_components(Net* net, char obj_type);
 int NET_get_num_periods(Net* net);
 int NET_get_num_buses(Net* net);
 int NET_get_num_slack_buses(Net* net);
@@ -110,7 +126,10 @@ int NET_get_num_fixed_shunts(Net* net);
 int NET_get_num_switched_shunts(Net* net);
 int NET_get_num_vargens(Net* net);
 int NET_get_num_bats(Net* net);
+int NET_get_num_islands(Net* net);
 int NET_get_num_vars(Net* net);
+int NET_get_var_ordering(Net* net);
+int* NET_get_var_permutation(Net* net);
 int NET_get_num_fixed(Net* net);
 int NET_get_num_bounded(Net* net);
 int NET_get_num_sparse(Net* net);
@@ -118,6 +137,8 @@ REAL NET_get_total_gen_P(Net* net, int t);
 REAL NET_get_total_gen_Q(Net* net, int t);
 REAL NET_get_total_load_P(Net* net, int t);
 REAL NET_get_total_load_Q(Net* net, int t);
+void NET_get_series(Net* net, char obj_type, char* name, REAL* values);
+REAL* NET_get_series_of_component(Net* net, char obj_type, int index, char* name);
 Vec* NET_get_var_values(Net* net, int code);
 char* NET_get_var_info_string(Net* net, int index);
 Mat* NET_get_var_projection(Net* net, char obj_type, char prop_mask, unsigned char var, int t_start, int t_end);
@@ -142,6 +163,7 @@ REAL NET_get_vargen_corr_radius(Net* net);
 REAL NET_get_vargen_corr_value(Net* net);
 char* NET_get_json_string(Net* net);
 BOOL NET_has_error(Net* net);
+void NET_load_profiles(Net* net, char* filename);
 void NET_propagate_data_in_time(Net* net, int start, int end);
 Net* NET_new(int num_periods);
 void NET_set_base_power(Net* net, REAL base_power);
@@ -154,16 +176,22 @@ void NET_set_vargen_array(Net* net, Vargen* gen, int num);
 void NET_set_bat_array(Net* net, Bat* bat, int num);
 void NET_set_flags(Net* net, char obj_type, char flag_mask, char prop_mask, unsigned char val_mask);
 void NET_set_flags_of_component(Net* net, void* obj, char obj_type, char flag_mask, unsigned char val_mask);
+void NET_set_series(Net* net, char obj_type, char* name, REAL* values);
+void NET_set_var_ordering(Net* net, int ordering);
 void NET_set_var_values(Net* net, Vec* values);
 void NET_set_vargen_buses(Net* net, Bus* bus_list);
 void NET_set_bat_buses(Net* net, Bus* bus_list);
+void NET_shift_periods(Net* net, int k, char* profiles);
 void NET_show_components(Net* net);
 char* NET_get_show_components_str(Net* net);
 void NET_show_properties(Net* net, int t);
 char* NET_get_show_properties_str(Net* net, int t);
 void NET_show_buses(Net* net, int number, int sort_by, int t);
+void NET_update_adjacency(Net* net);
+void NET_update_var_ordering(Net* net);
 void NET_update_properties_step(Net* net, Branch* br, int t, Vec* values);
 void NET_update_properties(Net* net, Vec* values);
 void NET_update_set_points(Net* net);
+void NET_write_json(Net* net, JSON_Writer* writer);
 
 #endif
@@ -0,0 +1,48 @@
+/** @file parser_BIN.h
+ *  @brief This file list the constants and routines associated with the BIN_Parser data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __PARSER_BIN_HEADER__
+#define __PARSER_BIN_HEADER__
+
+#include <stdio.h>
+#include <string.h>
+#include "parser.h"
+
+// Buffer
+#define BIN_PARSER_BUFFER_SIZE 1024
+
+// Format
+#define BIN_PARSER_MAGIC "PFNETBIN" /**< @brief First 8 bytes of every snapshot */
+#define BIN_PARSER_VERSION 1        /**< @brief Version of snapshot format */
+#define BIN_PARSER_ENDIAN 0x01020304 /**< @brief Byte-order check value */
+#define BIN_PARSER_ALIGN 8          /**< @brief Alignment of data blocks (bytes) */
+#define BIN_PARSER_HEADER_SIZE 16   /**< @brief Number of integers in header */
+
+// Structs
+typedef struct BIN_Parser BIN_Parser;
+
+// Interface
+Parser* BIN_PARSER_new(void);
+void BIN_PARSER_init(Parser* p);
+Net* BIN_PARSER_parse(Parser* p, char* f, int num_periods);
+void BIN_PARSER_set(Parser* p, char* key, REAL value);
+void BIN_PARSER_show(Parser* p);
+void BIN_PARSER_write(Parser* p, Net* net, char* f);
+void BIN_PARSER_free(Parser* p);
+
+// BIN-specific
+void* BIN_PARSER_get_component(Net* net, char obj_type, int index);
+void* BIN_PARSER_read_block(Parser* p, size_t size);
+int* BIN_PARSER_read_ptr(Parser* p, int n);
+void BIN_PARSER_read_flags(Parser* p, Net* net, char obj_type, int num, int T_data, int* var_type, int* var_comp, char* var_mask, int num_vars);
+void BIN_PARSER_write_block(FILE* file, void* data, size_t size);
+void BIN_PARSER_write_flags(FILE* file, Net* net, char obj_type, int num);
+
+#endif
@@ -17,6 +17,7 @@
 #include "types.h"
 
 #define CSV_PARSER_BUFFER_SIZE 1024
+#define CSV_PARSER_MAX_SPECIAL 7
 
 // Structs
 typedef struct CSV_Parser CSV_Parser;
@@ -24,6 +25,7 @@ typedef struct CSV_Parser CSV_Parser;
 // Prototypes
 void CSV_PARSER_clear_field(CSV_Parser* p);
 CSV_Parser* CSV_PARSER_new(void);
+size_t CSV_PARSER_scan(char* buffer, size_t len, char* chars, int num_chars);
 size_t CSV_PARSER_parse(CSV_Parser* p, 
 			char* buffer,
 			size_t len,
@@ -14,7 +14,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <pfnet/parser.h>
-#include <pfnet/json.h>
+
+// Buffers
+#define JSON_PARSER_BUFFER_SIZE 1024 /**< @brief Max length of strings (longer strings are truncated) */
+#define JSON_PARSER_NUMBER_SIZE 64   /**< @brief Max length of numbers */
+
+// Arrays
+#define JSON_PARSER_NUM_ARRAYS 7     /**< @brief Number of component arrays */
 
 // Structs
 typedef struct JSON_Parser JSON_Parser;
@@ -28,13 +34,26 @@ void JSON_PARSER_show(Parser* parser);
 void JSON_PARSER_write(Parser* parser, Net* net, char* filename);
 void JSON_PARSER_free(Parser* parser);
 
-// Others
-void JSON_PARSER_process_json_bus_array(Parser* p, Net* net, json_value* json_bus_array);
-void JSON_PARSER_process_json_branch_array(Parser* p, Net* net, json_value* json_branch_array);
-void JSON_PARSER_process_json_gen_array(Parser* p, Net* net, json_value* json_gen_array);
-void JSON_PARSER_process_json_vargen_array(Parser* p, Net* net, json_value* json_vargen_array);
-void JSON_PARSER_process_json_shunt_array(Parser* p, Net* net, json_value* json_shunt_array);
-void JSON_PARSER_process_json_load_array(Parser* p, Net* net, json_value* json_load_array);
-void JSON_PARSER_process_json_bat_array(Parser* p, Net* net, json_value* json_bat_array);
+// Reading
+BOOL JSON_PARSER_next_item(Parser* p, int k, char close);
+char* JSON_PARSER_next_key(Parser* p, int k);
+char JSON_PARSER_peek(Parser* p);
+void JSON_PARSER_expect(Parser* p, char c);
+BOOL JSON_PARSER_read_bool(Parser* p);
+int JSON_PARSER_read_int(Parser* p);
+BOOL JSON_PARSER_read_null(Parser* p);
+REAL JSON_PARSER_read_real(Parser* p);
+char* JSON_PARSER_read_string(Parser* p);
+void JSON_PARSER_skip_value(Parser* p);
+int JSON_PARSER_count_items(Parser* p);
+
+// Components
+void JSON_PARSER_read_bus_array(Parser* p, Net* net);
+void JSON_PARSER_read_branch_array(Parser* p, Net* net);
+void JSON_PARSER_read_gen_array(Parser* p, Net* net);
+void JSON_PARSER_read_vargen_array(Parser* p, Net* net);
+void JSON_PARSER_read_shunt_array(Parser* p, Net* net);
+void JSON_PARSER_read_load_array(Parser* p, Net* net);
+void JSON_PARSER_read_bat_array(Parser* p, Net* net);
 
 #endif
@@ -66,6 +66,8 @@ void MAT_PARSER_free(Parser* p);
 // MAT-specific
 void MAT_PARSER_load(MAT_Parser* p, Net* net);
 void MAT_PARSER_clear_token(MAT_Parser* p);
+REAL MAT_PARSER_atof(MAT_Parser* p, char* s);
+int MAT_PARSER_atoi(MAT_Parser* p, char* s);
 BOOL MAT_PARSER_has_error(MAT_Parser* p);
 char* MAT_PARSER_get_error_string(MAT_Parser* p);
 void MAT_PARSER_callback_field(char* s, void* data);
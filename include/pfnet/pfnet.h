@@ -15,12 +15,15 @@
 #include "net.h"
 #include "problem.h"
 #include "graph.h"
+#include "reduction.h"
+#include "profiles.h"
 
 // Parsers
 #include "parser_MAT.h"
 #include "parser_ART.h"
 #include "parser_RAW.h"
 #include "parser_JSON.h"
+#include "parser_BIN.h"
 
 // Functions
 #include "func_GEN_COST.h"
@@ -22,6 +22,10 @@
 // Inf
 #define PROB_EXTRA_VAR_INF 1e8 /**< @brief Large constant for lower and upper bounds */
 
+// Periods
+#define PROB_PERIOD_NONE -1     /**< @brief Period of rows with no entries and of extra variables in no row with a period */
+#define PROB_PERIOD_COUPLING -2 /**< @brief Period of rows and extra variables that couple different periods */
+
 // Problem
 typedef struct Prob Prob;
 
@@ -35,9 +39,12 @@ void PROB_eval(Prob* p, Vec* point);
 void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void PROB_del(Prob* p);
 void PROB_del_matvec(Prob* p);
+void PROB_del_islands(Prob* p);
 void PROB_clear(Prob* p);
 void PROB_clear_error(Prob* p);
+BOOL PROB_copy_list_errors(Prob* p);
 void PROB_combine_H(Prob* p, Vec* coeff, BOOL ensure_psd);
+void PROB_compact_nonlin(Prob* p);
 Constr* PROB_find_constr(Prob* p, char* name);
 Constr* PROB_get_constr(Prob* p);
 char* PROB_get_error_string(Prob* p);
@@ -55,15 +62,55 @@ Mat* PROB_get_A(Prob* p);
 Vec* PROB_get_l(Prob* p);
 Vec* PROB_get_u(Prob* p);
 Mat* PROB_get_G(Prob* p);
+Vec* PROB_get_x_l(Prob* p);
+Vec* PROB_get_x_u(Prob* p);
 Vec* PROB_get_f(Prob* p);
 Mat* PROB_get_J(Prob* p);
 Mat* PROB_get_H_combined(Prob* p);
+int PROB_get_num_blocks(Prob* p);
+int* PROB_get_var_blocks(Prob* p);
+int* PROB_get_A_row_blocks(Prob* p);
+int* PROB_get_J_row_blocks(Prob* p);
+int* PROB_get_G_row_blocks(Prob* p);
+Mat* PROB_get_block_of_mat(Prob* p, Mat* M, int* row_block, int block);
+int* PROB_get_var_periods(Prob* p);
+int* PROB_get_A_row_periods(Prob* p);
+int* PROB_get_J_row_periods(Prob* p);
+int* PROB_get_G_row_periods(Prob* p);
+int PROB_get_num_J_colors(Prob* p);
+int* PROB_get_J_colors(Prob* p);
+int PROB_get_num_H_colors(Prob* p);
+int* PROB_get_H_colors(Prob* p);
+Mat* PROB_get_period_major_mat(Prob* p, Mat* M, int* row_period, int* nnz_ptr);
 BOOL PROB_has_error(Prob* p);
+BOOL PROB_has_island_steps(Prob* p);
+Vec* PROB_Jv(Prob* p, Vec* x, Vec* v);
+Vec* PROB_JTy(Prob* p, Vec* x, Vec* y);
+Vec* PROB_Hv(Prob* p, Vec* x, Vec* lam, Vec* v);
+Mat* PROB_new_H_pattern(Prob* p);
+Mat* PROB_estimate_J(Prob* p, Vec* point, REAL h);
+Mat* PROB_estimate_H(Prob* p, Vec* point, Vec* lam, REAL h);
 void PROB_init(Prob* p);
 Prob* PROB_new(Net* net);
 void PROB_show(Prob* p);
 char* PROB_get_show_str(Prob* p);
+BOOL PROB_run_island_steps(Prob* p, Vec* x, Vec** ve);
+void PROB_run_serial_steps(Prob* p, Branch* br, int t, Vec* x, Vec** ve);
+int PROB_screen_branches(Prob* p, Vec* values, REAL fraction);
+void PROB_set_coloring(Prob* p, BOOL flag);
+void PROB_set_duplicate_compaction(Prob* p, BOOL flag);
+void PROB_set_island_decomposition(Prob* p, BOOL flag);
+void PROB_set_period_decomposition(Prob* p, BOOL flag);
+void PROB_set_simple_bounds(Prob* p, BOOL flag);
+void PROB_shift_periods(Prob* p, int k, char* profiles);
+void PROB_store_island_counters(Prob* p, int slot);
+void PROB_update_blocks(Prob* p);
+void PROB_update_colors(Prob* p);
+void PROB_update_bounds(Prob* p);
+void PROB_update_data(Prob* p);
+void PROB_update_islands(Prob* p);
 void PROB_update_lin(Prob* p);
+void PROB_update_periods(Prob* p);
 void PROB_update_nonlin_struc(Prob* p);
 void PROB_update_nonlin_data(Prob* p, Vec* point);
 int PROB_get_num_primal_variables(Prob* p);
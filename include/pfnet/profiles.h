@@ -0,0 +1,44 @@
+/** @file profiles.h
+ *  @brief This file lists the constants and routines associated with the Profiles data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __PROFILES_HEADER__
+#define __PROFILES_HEADER__
+
+#include <stdio.h>
+#include "types.h"
+#include "net.h"
+
+// Buffer
+#define PROFILES_BUFFER_SIZE 1024 /**< @brief Default profiles buffer size for strings and file chunks */
+
+// Quantities
+#define PROFILES_P 0     /**< @brief Quantity: Active power (p.u.) */
+#define PROFILES_Q 1     /**< @brief Quantity: Reactive power (p.u.) */
+#define PROFILES_P_MAX 2 /**< @brief Quantity: Maximum active power (p.u.) */
+#define PROFILES_P_MIN 3 /**< @brief Quantity: Minimum active power (p.u.) */
+#define PROFILES_P_AVA 4 /**< @brief Quantity: Available active power (p.u.) */
+#define PROFILES_P_STD 5 /**< @brief Quantity: Standard deviation of active power (p.u.) */
+
+// Profiles
+typedef struct Profiles Profiles;
+
+void PROFILES_add_column(Profiles* prof, char* header);
+void PROFILES_callback_field(char* s, void* data);
+void PROFILES_callback_record(void* data);
+void PROFILES_del(Profiles* prof);
+char* PROFILES_get_error_string(Profiles* prof);
+int PROFILES_get_num_columns(Profiles* prof);
+int PROFILES_get_num_records(Profiles* prof);
+BOOL PROFILES_has_error(Profiles* prof);
+void PROFILES_load(Profiles* prof, char* filename);
+Profiles* PROFILES_new(Net* net);
+void PROFILES_set_error(Profiles* prof, char* string);
+
+#endif
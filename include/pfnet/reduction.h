@@ -0,0 +1,38 @@
+/** @file reduction.h
+ *  @brief This file lists the constants and routines associated with the Red data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __RED_HEADER__
+#define __RED_HEADER__
+
+#include "stdio.h"
+#include "types.h"
+#include "net.h"
+
+// Buffer
+#define RED_BUFFER_SIZE 100 /**< @brief Default reduction buffer size for strings */
+
+// Tolerance
+#define RED_EPS 1e-10 /**< @brief Smallest magnitude of self admittance of an eliminated bus (p.u.) */
+
+// Reduction
+typedef struct Red Red;
+
+void RED_del(Red* red);
+void RED_expand(Red* red);
+int* RED_get_bus_map(Red* red);
+int* RED_get_branch_map(Red* red);
+char* RED_get_error_string(Red* red);
+Net* RED_get_network(Red* red);
+int RED_get_num_eliminated_buses(Red* red);
+int* RED_get_eliminated_buses(Red* red);
+BOOL RED_has_error(Red* red);
+Red* RED_new(Net* net, int max_degree);
+
+#endif
@@ -14,6 +14,7 @@
 #include "stdio.h"
 #include "types.h"
 #include "vector.h"
+#include "json_writer.h"
 #include "list.h"
 
 // Variables
@@ -69,6 +70,7 @@ REAL* SHUNT_get_sens_b_l_bound_array(Shunt* shunt);
 
 char* SHUNT_get_name(Shunt* shunt);
 int SHUNT_get_num_periods(Shunt* shunt);
+REAL* SHUNT_get_series(Shunt* shunt, char* name);
 char SHUNT_get_obj_type(void* shunt);
 int SHUNT_get_index(Shunt* shunt);
 int SHUNT_get_index_b(Shunt* shunt, int t);
@@ -99,6 +101,8 @@ Shunt* SHUNT_list_reg_add(Shunt *reg_shunt_list, Shunt* reg_shunt);
 int SHUNT_list_reg_len(Shunt* reg_shunt_list);
 Shunt* SHUNT_new(int num_periods);
 void SHUNT_propagate_data_in_time(Shunt* shunt, int start, int end);
+void SHUNT_write_json(Shunt* shunt, JSON_Writer* writer);
+void SHUNT_shift_periods(Shunt* shunt, int k);
 void SHUNT_set_sens_b_u_bound(Shunt* shunt, REAL value, int t);
 void SHUNT_set_sens_b_l_bound(Shunt* shunt, REAL value, int t);
 void SHUNT_set_name(Shunt* shunt, char* name);
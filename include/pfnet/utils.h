@@ -12,8 +12,11 @@
 #define __UTILS_HEADER__
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
+#include <float.h>
 
 int imin(int a, int b);
 
@@ -21,4 +24,9 @@ char* trim(char* s);
 char* strtoupper(char s[]);
 char* strtolower(char s[]);
 
+double fast_atof(char* s);
+int fast_atoi(char* s);
+int fast_itoa(char* s, int v);
+int fast_ftoa(char* s, double x);
+
 #endif
@@ -15,6 +15,7 @@
 #include "types.h"
 #include "list.h"
 #include "vector.h"
+#include "json_writer.h"
 
 // Variables
 /** \defgroup vargen_vars Variable Generator Variable Masks 
@@ -68,6 +69,7 @@ char VARGEN_get_flags_bounded(Vargen* gen);
 char VARGEN_get_flags_sparse(Vargen* gen);
 
 int VARGEN_get_num_periods(Vargen* gen);
+REAL* VARGEN_get_series(Vargen* gen, char* name);
 char* VARGEN_get_name(Vargen* gen);
 Bus* VARGEN_get_bus(Vargen* gen);
 char VARGEN_get_obj_type(void* gen);
@@ -97,6 +99,8 @@ Vargen* VARGEN_list_add(Vargen* gen_list, Vargen* gen);
 int VARGEN_list_len(Vargen* gen_list);
 Vargen* VARGEN_new(int num_periods);
 void VARGEN_propagate_data_in_time(Vargen* gen, int start, int end);
+void VARGEN_write_json(Vargen* gen, JSON_Writer* writer);
+void VARGEN_shift_periods(Vargen* gen, int k);
 void VARGEN_set_name(Vargen* gen, char* name);
 void VARGEN_set_type(Vargen* gen, int type);
 void VARGEN_set_bus(Vargen* gen, Bus* bus);
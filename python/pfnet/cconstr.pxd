@@ -58,6 +58,10 @@ cdef extern from "pfnet/constr.h":
     char* CONSTR_get_error_string(Constr* c)
     void CONSTR_update_network(Constr* c)
     int CONSTR_get_num_extra_vars(Constr* c)
+    int CONSTR_get_num_active_branches(Constr* c)
+    bint CONSTR_has_active_set(Constr* c)
+    void CONSTR_set_active_set(Constr* c, bint flag)
+    int CONSTR_screen_branches(Constr* c, Vec* values, REAL fraction)
     Net* CONSTR_get_network(Constr* c)
     Mat* CONSTR_get_var_projection(Constr* c)
     Mat* CONSTR_get_extra_var_projection(Constr* c)
@@ -86,6 +90,10 @@ cdef extern from "pfnet/constr.h":
     void CONSTR_set_func_analyze_step(Constr* c, void (*func)(Constr* c, Branch* br, int t))
     void CONSTR_set_func_eval_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* v, Vec* ve))
     void CONSTR_set_func_store_sens_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl))
+    void CONSTR_set_func_count(Constr* c, void (*func)(Constr* c))
+    void CONSTR_set_func_analyze(Constr* c, void (*func)(Constr* c))
+    void CONSTR_set_func_eval(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve))
+    void CONSTR_set_func_store_sens(Constr* c, void (*func)(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl))
 
     Constr* CONSTR_ACPF_new(Net* net)
     Constr* CONSTR_DCPF_new(Net* net)
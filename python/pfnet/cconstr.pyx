@@ -95,6 +95,48 @@ cdef class ConstraintBase:
         if cconstr.CONSTR_has_error(self._c_constr):
             raise ConstraintError(cconstr.CONSTR_get_error_string(self._c_constr))
 
+    def set_active_set(self, flag):
+        """
+        Enables or disables the active-set mode of constraints with rows per branch
+        (e.g., branch flow limits). In this mode, rows are only created for the branches
+        and time periods added with :func:`screen_branches() <pfnet.ConstraintBase.screen_branches>`.
+
+        Parameters
+        ----------
+        flag : {``True``, ``False``}
+        """
+
+        cconstr.CONSTR_set_active_set(self._c_constr,flag)
+        if cconstr.CONSTR_has_error(self._c_constr):
+            raise ConstraintError(cconstr.CONSTR_get_error_string(self._c_constr))
+
+    def screen_branches(self, values=None, fraction=0.9):
+        """
+        Adds to the active set the branches and time periods whose flow exceeds the given
+        fraction of their rating. The constraint (or problem) must be analyzed again after
+        branches are added.
+
+        Parameters
+        ----------
+        values : |Array| (variable values, current network values if ``None``)
+        fraction : float
+
+        Returns
+        -------
+        num : int (number of added pairs of branch and time period)
+        """
+
+        cdef np.ndarray[double,mode='c'] x
+        cdef cvec.Vec* v = NULL
+        if values is not None:
+            x = values
+            v = cvec.VEC_new_from_array(<cconstr.REAL*>(x.data),x.size)
+        num = cconstr.CONSTR_screen_branches(self._c_constr,v,fraction)
+        free(v)
+        if cconstr.CONSTR_has_error(self._c_constr):
+            raise ConstraintError(cconstr.CONSTR_get_error_string(self._c_constr))
+        return num
+
     def combine_H(self, coeff, ensure_psd=False):
         """
         Forms and saves a linear combination of the individual constraint Hessians.
@@ -498,6 +540,14 @@ cdef class ConstraintBase:
             """ Number of extra variables (set during count) (int). """
             def __get__(self): return cconstr.CONSTR_get_num_extra_vars(self._c_constr)
 
+    property has_active_set:
+        """ Flag that indicates whether the constraint is in active-set mode (|TrueFalse|). """
+        def __get__(self): return cconstr.CONSTR_has_active_set(self._c_constr)
+
+    property num_active_branches:
+        """ Number of pairs of branch and time period in the active set (-1 if not in active-set mode) (int). """
+        def __get__(self): return cconstr.CONSTR_get_num_active_branches(self._c_constr)
+
     property network:
         """ |Network| associated with constraint. """
         def __get__(self): return new_Network(cconstr.CONSTR_get_network(self._c_constr))
@@ -591,15 +641,44 @@ cdef class CustomConstraint(ConstraintBase):
         self._c_constr = cconstr.CONSTR_new(net._c_net)
         cconstr.CONSTR_set_data(self._c_constr,<void*>self)
         cconstr.CONSTR_set_func_init(self._c_constr,constr_init)
-        cconstr.CONSTR_set_func_count_step(self._c_constr,constr_count_step)
         cconstr.CONSTR_set_func_allocate(self._c_constr,constr_allocate)
         cconstr.CONSTR_set_func_clear(self._c_constr,constr_clear)
-        cconstr.CONSTR_set_func_analyze_step(self._c_constr,constr_analyze_step)
-        cconstr.CONSTR_set_func_eval_step(self._c_constr,constr_eval_step)
-        cconstr.CONSTR_set_func_store_sens_step(self._c_constr,constr_store_sens_step)
+        if self._overrides('count_step'):
+            cconstr.CONSTR_set_func_count_step(self._c_constr,constr_count_step)
+        if self._overrides('analyze_step'):
+            cconstr.CONSTR_set_func_analyze_step(self._c_constr,constr_analyze_step)
+        if self._overrides('eval_step'):
+            cconstr.CONSTR_set_func_eval_step(self._c_constr,constr_eval_step)
+        if self._overrides('store_sens_step'):
+            cconstr.CONSTR_set_func_store_sens_step(self._c_constr,constr_store_sens_step)
+        if self._overrides('count_batch'):
+            cconstr.CONSTR_set_func_count(self._c_constr,constr_count)
+        if self._overrides('analyze_batch'):
+            cconstr.CONSTR_set_func_analyze(self._c_constr,constr_analyze)
+        if self._overrides('eval_batch'):
+            cconstr.CONSTR_set_func_eval(self._c_constr,constr_eval)
+        if self._overrides('store_sens_batch'):
+            cconstr.CONSTR_set_func_store_sens(self._c_constr,constr_store_sens)
         cconstr.CONSTR_init(self._c_constr)
         self._alloc = True
     
+    def _overrides(self, name):
+        """
+        Determines whether subclass overrides the given callback.
+        Only overridden callbacks are registered with the C core,
+        so unused steps cost no Python calls.
+
+        Parameters
+        ----------
+        name : string
+
+        Returns
+        -------
+        flag : |TrueFalse|
+        """
+
+        return getattr(type(self),name) is not getattr(CustomConstraint,name)
+
     def init(self):
         """
         Performs constraint initialization.
@@ -675,30 +754,92 @@ cdef class CustomConstraint(ConstraintBase):
  
         pass
 
-cdef void constr_init(cconstr.Constr* c):
+    def count_batch(self):
+        """
+        Performs count for all branches and time periods at once.
+        It is called after the count steps.
+        """
+
+        pass
+
+    def analyze_batch(self):
+        """
+        Performs analysis for all branches and time periods at once.
+        It is called after the analyze steps and can fill
+        :attr:`A <pfnet.ConstraintBase.A>`, :attr:`J <pfnet.ConstraintBase.J>`, etc.
+        with vectorized operations on their numpy arrays.
+        """
+
+        pass
+
+    def eval_batch(self, x, y=None):
+        """
+        Performs evaluation for all branches and time periods at once.
+        It is called after the eval steps.
+
+        Parameters
+        ----------
+        x : |Array|
+        y : |Array|
+        """
+
+        pass
+
+    def store_sens_batch(self, sA, sf, sGu, sGl):
+        """
+        Stores sensitivities for all branches and time periods at once.
+        It is called after the steps for storing sensitivities.
+
+        Parameters
+        ----------
+        sA : |Array|
+        sf : |Array|
+        sGu : |Array|
+        sGl : |Array|
+        """
+
+        pass
+
+cdef void constr_init(cconstr.Constr* c) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
     cc.init()
 
-cdef void constr_count_step(cconstr.Constr* c, cbranch.Branch* br, int t):
+cdef void constr_count_step(cconstr.Constr* c, cbranch.Branch* br, int t) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
     cc.count_step(new_Branch(br),t)
 
-cdef void constr_allocate(cconstr.Constr* c):
+cdef void constr_allocate(cconstr.Constr* c) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
     cc.allocate()
         
-cdef void constr_clear(cconstr.Constr* c):
+cdef void constr_clear(cconstr.Constr* c) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
     cc.clear()
 
-cdef void constr_analyze_step(cconstr.Constr* c, cbranch.Branch* br, int t):
+cdef void constr_analyze_step(cconstr.Constr* c, cbranch.Branch* br, int t) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
     cc.analyze_step(new_Branch(br),t)
 
-cdef void constr_eval_step(cconstr.Constr* c, cbranch.Branch* br, int t, cvec.Vec* v, cvec.Vec* ve):
+cdef void constr_eval_step(cconstr.Constr* c, cbranch.Branch* br, int t, cvec.Vec* v, cvec.Vec* ve) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
     cc.eval_step(new_Branch(br),t,Vector(v),Vector(ve))
 
-cdef void constr_store_sens_step(cconstr.Constr* c, cbranch.Branch* br, int t, cvec.Vec* sA, cvec.Vec* sf, cvec.Vec* sGu, cvec.Vec* sGl):
+cdef void constr_store_sens_step(cconstr.Constr* c, cbranch.Branch* br, int t, cvec.Vec* sA, cvec.Vec* sf, cvec.Vec* sGu, cvec.Vec* sGl) with gil:
+    cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
+    cc.store_sens_step(new_Branch(br),t,Vector(sA),Vector(sf),Vector(sGu),Vector(sGl))
+
+cdef void constr_count(cconstr.Constr* c) with gil:
+    cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
+    cc.count_batch()
+
+cdef void constr_analyze(cconstr.Constr* c) with gil:
+    cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
+    cc.analyze_batch()
+
+cdef void constr_eval(cconstr.Constr* c, cvec.Vec* v, cvec.Vec* ve) with gil:
+    cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
+    cc.eval_batch(Vector(v),Vector(ve))
+
+cdef void constr_store_sens(cconstr.Constr* c, cvec.Vec* sA, cvec.Vec* sf, cvec.Vec* sGu, cvec.Vec* sGl) with gil:
     cdef CustomConstraint cc = <CustomConstraint>cconstr.CONSTR_get_data(c)
-    cc.eval_step(new_Branch(br),t,Vector(sA),Vector(sf),Vector(sGu),Vector(sGl))
+    cc.store_sens_batch(Vector(sA),Vector(sf),Vector(sGu),Vector(sGl))
@@ -47,6 +47,9 @@ cdef extern from "pfnet/pfnet.h":
     void FUNC_set_func_clear(Func* f, void (*func)(Func* f))
     void FUNC_set_func_analyze_step(Func* f, void (*func)(Func* f, Branch* br, int t))
     void FUNC_set_func_eval_step(Func* f, void (*func)(Func* f, Branch* br, int t, Vec* v))
+    void FUNC_set_func_count(Func* f, void (*func)(Func* f))
+    void FUNC_set_func_analyze(Func* f, void (*func)(Func* f))
+    void FUNC_set_func_eval(Func* f, void (*func)(Func* f, Vec* v))
 
     Func* FUNC_GEN_COST_new(REAL w, Net* net)
     Func* FUNC_LOAD_UTIL_new(REAL w, Net* net)
@@ -248,14 +248,40 @@ cdef class CustomFunction(FunctionBase):
         self._c_func = cfunc.FUNC_new(weight,net._c_net)
         cfunc.FUNC_set_data(self._c_func,<void*>self)
         cfunc.FUNC_set_func_init(self._c_func,func_init)
-        cfunc.FUNC_set_func_count_step(self._c_func,func_count_step)
         cfunc.FUNC_set_func_allocate(self._c_func,func_allocate)
         cfunc.FUNC_set_func_clear(self._c_func,func_clear)
-        cfunc.FUNC_set_func_analyze_step(self._c_func,func_analyze_step)
-        cfunc.FUNC_set_func_eval_step(self._c_func,func_eval_step)
+        if self._overrides('count_step'):
+            cfunc.FUNC_set_func_count_step(self._c_func,func_count_step)
+        if self._overrides('analyze_step'):
+            cfunc.FUNC_set_func_analyze_step(self._c_func,func_analyze_step)
+        if self._overrides('eval_step'):
+            cfunc.FUNC_set_func_eval_step(self._c_func,func_eval_step)
+        if self._overrides('count_batch'):
+            cfunc.FUNC_set_func_count(self._c_func,func_count)
+        if self._overrides('analyze_batch'):
+            cfunc.FUNC_set_func_analyze(self._c_func,func_analyze)
+        if self._overrides('eval_batch'):
+            cfunc.FUNC_set_func_eval(self._c_func,func_eval)
         cfunc.FUNC_init(self._c_func)
         self._alloc = True
 
+    def _overrides(self, name):
+        """
+        Determines whether subclass overrides the given callback.
+        Only overridden callbacks are registered with the C core,
+        so unused steps cost no Python calls.
+
+        Parameters
+        ----------
+        name : string
+
+        Returns
+        -------
+        flag : |TrueFalse|
+        """
+
+        return getattr(type(self),name) is not getattr(CustomFunction,name)
+
     def init(self):
         """
         Performs function initialization.
@@ -314,28 +340,70 @@ cdef class CustomFunction(FunctionBase):
  
         pass
 
-cdef void func_init(cfunc.Func* f):
+    def count_batch(self):
+        """
+        Performs count for all branches and time periods at once.
+        It is called after the count steps.
+        """
+
+        pass
+
+    def analyze_batch(self):
+        """
+        Performs analysis for all branches and time periods at once.
+        It is called after the analyze steps and can fill
+        :attr:`Hphi <pfnet.FunctionBase.Hphi>`, etc. with vectorized
+        operations on their numpy arrays.
+        """
+
+        pass
+
+    def eval_batch(self, x):
+        """
+        Performs evaluation for all branches and time periods at once.
+        It is called after the eval steps.
+
+        Parameters
+        ----------
+        x : |Array|
+        """
+
+        pass
+
+cdef void func_init(cfunc.Func* f) with gil:
     cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
     fc.init()
 
-cdef void func_count_step(cfunc.Func* f, cbranch.Branch* br, int t):
+cdef void func_count_step(cfunc.Func* f, cbranch.Branch* br, int t) with gil:
     cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
     fc.count_step(new_Branch(br),t)
 
-cdef void func_allocate(cfunc.Func* f):
+cdef void func_allocate(cfunc.Func* f) with gil:
     cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
     fc.allocate()
         
-cdef void func_clear(cfunc.Func* f):
+cdef void func_clear(cfunc.Func* f) with gil:
     cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
     fc.clear()
 
-cdef void func_analyze_step(cfunc.Func* f, cbranch.Branch* br, int t):
+cdef void func_analyze_step(cfunc.Func* f, cbranch.Branch* br, int t) with gil:
     cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
     fc.analyze_step(new_Branch(br),t)
 
-cdef void func_eval_step(cfunc.Func* f, cbranch.Branch* br, int t, cvec.Vec* v):
+cdef void func_eval_step(cfunc.Func* f, cbranch.Branch* br, int t, cvec.Vec* v) with gil:
     cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
     fc.eval_step(new_Branch(br),t,Vector(v))
 
+cdef void func_count(cfunc.Func* f) with gil:
+    cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
+    fc.count_batch()
+
+cdef void func_analyze(cfunc.Func* f) with gil:
+    cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
+    fc.analyze_batch()
+
+cdef void func_eval(cfunc.Func* f, cvec.Vec* v) with gil:
+    cdef CustomFunction fc = <CustomFunction>cfunc.FUNC_get_data(f)
+    fc.eval_batch(Vector(v))
+
 
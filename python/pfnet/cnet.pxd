@@ -21,6 +21,10 @@ cdef extern from "pfnet/net.h":
     ctypedef struct Net
     ctypedef struct Bus
     ctypedef double REAL
+
+    cdef int NET_ORDER_NATURAL
+    cdef int NET_ORDER_RCM
+    cdef int NET_ORDER_AMD
  
     void NET_add_vargens(Net* net, cbus.Bus* bus_list, REAL power_capacity, REAL power_base, REAL power_std, REAL corr_radius, REAL corr_value)
     void NET_add_batteries(Net* net, cbus.Bus* bus_list, REAL power_capacity,  REAL energy_capacity, REAL eta_c, REAL eta_d)        
@@ -58,6 +62,7 @@ cdef extern from "pfnet/net.h":
     cbat.Bat* NET_get_bat_from_name_and_bus_number(Net* net, char* name, int number)
 
     REAL NET_get_total_load_P(Net* net, int t)
+    int NET_get_num_components(Net* net, char obj_type)
     int NET_get_num_periods(Net* net)
     int NET_get_num_buses(Net* net)
     int NET_get_num_slack_buses(Net* net)
@@ -86,7 +91,11 @@ cdef extern from "pfnet/net.h":
     int NET_get_num_switched_shunts(Net* net)
     int NET_get_num_vargens(Net* net)
     int NET_get_num_bats(Net* net)
+    int NET_get_num_islands(Net* net)
+    int* NET_get_bus_islands(Net* net)
     int NET_get_num_vars(Net* net)
+    int NET_get_var_ordering(Net* net)
+    int* NET_get_var_permutation(Net* net)
     int NET_get_num_fixed(Net* net)
     int NET_get_num_bounded(Net* net)
     int NET_get_num_sparse(Net* net)
@@ -109,22 +118,27 @@ cdef extern from "pfnet/net.h":
     int NET_get_num_actions(Net* net, int t)
     REAL NET_get_vargen_corr_radius(Net* net)
     REAL NET_get_vargen_corr_value(Net* net)
+    void NET_get_series(Net* net, char obj_type, char* name, REAL* values)
     cvec.Vec* NET_get_var_values(Net* net, int code)
     char* NET_get_var_info_string(Net* net, int index)
     cmat.Mat* NET_get_var_projection(Net* net, char obj_type, char prop_mask, char var, int t_start, int t_end)
     char* NET_get_json_string(Net* net)
     bint NET_has_error(Net* net)
+    void NET_load_profiles(Net* net, char* filename)
     Net* NET_new(int num_periods)
     void NET_set_base_power(Net* net, REAL base_power)
     void NET_set_flags(Net* net, char obj_type, char flag_mask, char prop_mask, char val_mask)
     void NET_set_flags_of_component(Net* net, void* obj, char obj_type, char flag_mask, char val_mask)
+    void NET_set_series(Net* net, char obj_type, char* name, REAL* values)
+    void NET_set_var_ordering(Net* net, int ordering)
     void NET_set_var_values(Net* net, cvec.Vec* values)
     void NET_show_components(Net* net)
     char* NET_get_show_components_str(Net* net)
     void NET_show_properties(Net* net, int t)
     char* NET_get_show_properties_str(Net* net, int t)
-    void NET_update_properties(Net* net, cvec.Vec* values)
+    void NET_update_properties(Net* net, cvec.Vec* values) nogil
     void NET_propagate_data_in_time(Net* net, int start, int end)
+    void NET_shift_periods(Net* net, int k, char* profiles)
     void NET_update_set_points(Net* net)
 
     void NET_set_bus_array(Net* net, cbus.Bus* bus_list, int num_buses)
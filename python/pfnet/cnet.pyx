@@ -22,6 +22,9 @@ class NetworkError(Exception):
 cdef class Network:
     """
     Network class.
+
+    Method :func:`update_properties() <pfnet.Network.update_properties>` releases the GIL.
+    A network must not be modified while another thread uses it or a problem built on it.
     """
 
     cdef cnet.Net* _c_net
@@ -630,6 +633,31 @@ cdef class Network:
         else:
             return m
 
+    def get_series(self, obj_type, name):
+        """
+        Gets time series with the given name of all components of the given type
+        with a single bulk copy, e.g., ``get_series('bus','v_mag')``. Series names
+        are the names of the component attributes that have one value per time
+        period, including sensitivities.
+
+        Parameters
+        ----------
+        obj_type : string (|RefObjects|)
+        name : string
+
+        Returns
+        -------
+        values : |Array| (number of components by number of time periods)
+        """
+
+        cdef int num = cnet.NET_get_num_components(self._c_net,str2obj[obj_type])
+        cdef np.ndarray[double,mode='c',ndim=2] x = np.zeros((num,self.num_periods))
+        name = name.encode('UTF-8')
+        cnet.NET_get_series(self._c_net,str2obj[obj_type],name,<cnet.REAL*>(x.data))
+        if cnet.NET_has_error(self._c_net):
+            raise NetworkError(cnet.NET_get_error_string(self._c_net))
+        return x
+
     def get_num_buses(self):
         """
         Gets number of buses in the network.
@@ -973,6 +1001,25 @@ cdef class Network:
 
         return cnet.NET_has_error(self._c_net)
 
+    def load_profiles(self, filename):
+        """
+        Loads time series of loads, variable generators and generators from a csv file
+        in one pass. The file has a header record with columns ``type:key:quantity``, where
+        type is ``load``, ``vargen`` or ``gen``, key is a component index or name, and quantity
+        is ``P``, ``Q``, ``P_max`` or ``P_min`` for loads, ``P``, ``P_ava`` or ``P_std`` for
+        variable generators, and ``P`` for generators. Each following record holds a time
+        period followed by the values (p.u.) of every column. Lines starting with ``#`` are ignored.
+
+        Parameters
+        ----------
+        filename : string
+        """
+
+        filename = filename.encode('UTF-8')
+        cnet.NET_load_profiles(self._c_net,filename)
+        if cnet.NET_has_error(self._c_net):
+            raise NetworkError(cnet.NET_get_error_string(self._c_net))
+
     def set_flags(self, obj_type, flags, props, q):
         """
         Sets flags of network components with specific properties.
@@ -1102,6 +1149,22 @@ cdef class Network:
         cdef cbat.Bat* array = cbat.BAT_array_new(size,self.num_periods)
         cnet.NET_set_bat_array(self._c_net,array,size)
 
+    def set_var_ordering(self, ordering):
+        """
+        Sets ordering of variable indices. With ``'rcm'`` (reverse Cuthill-McKee)
+        or ``'amd'`` (minimum degree), variables are renumbered bus by bus every
+        time flags of variables are set, which reduces the bandwidth or fill-in of
+        Jacobians and Hessians. See :attr:`var_permutation <pfnet.Network.var_permutation>`.
+
+        Parameters
+        ----------
+        ordering : string (``'natural'``, ``'rcm'``, ``'amd'``)
+        """
+
+        cnet.NET_set_var_ordering(self._c_net,str2ordering[ordering])
+        if cnet.NET_has_error(self._c_net):
+            raise NetworkError(cnet.NET_get_error_string(self._c_net))
+
     def set_var_values(self, values):
         """
         Sets network variable values.
@@ -1116,6 +1179,49 @@ cdef class Network:
         cnet.NET_set_var_values(self._c_net,v)
         free(v)
 
+    def set_series(self, obj_type, name, values):
+        """
+        Sets time series with the given name of all components of the given type
+        with a single bulk copy (see :meth:`get_series() <pfnet.Network.get_series>`).
+
+        Parameters
+        ----------
+        obj_type : string (|RefObjects|)
+        name : string
+        values : |Array| (number of components by number of time periods)
+        """
+
+        cdef int num = cnet.NET_get_num_components(self._c_net,str2obj[obj_type])
+        cdef np.ndarray[double,mode='c'] x = np.ascontiguousarray(values,dtype=np.double).reshape(-1)
+        if x.size != num*self.num_periods:
+            raise NetworkError('invalid values shape')
+        name = name.encode('UTF-8')
+        cnet.NET_set_series(self._c_net,str2obj[obj_type],name,<cnet.REAL*>(x.data))
+        if cnet.NET_has_error(self._c_net):
+            raise NetworkError(cnet.NET_get_error_string(self._c_net))
+
+    def shift_periods(self, k, profiles=None):
+        """
+        Moves time series of all components ``k`` periods back for rolling horizons.
+        The last ``k`` periods keep the data of the last period or, if given, are loaded
+        from a profiles file (see :meth:`load_profiles() <pfnet.Network.load_profiles>`).
+        Generator previous active powers and battery initial energy levels are carried over.
+        Flags and variable indices are unchanged.
+
+        Parameters
+        ----------
+        k : int
+        profiles : string
+        """
+
+        cdef char* cprofiles = NULL
+        if profiles is not None:
+            profiles = profiles.encode('UTF-8')
+            cprofiles = profiles
+        cnet.NET_shift_periods(self._c_net,k,cprofiles)
+        if cnet.NET_has_error(self._c_net):
+            raise NetworkError(cnet.NET_get_error_string(self._c_net))
+
     def show_components(self):
         """
         Shows information about the number of network components of each type.
@@ -1147,7 +1253,9 @@ cdef class Network:
 
         cdef np.ndarray[double,mode='c'] x = values
         cdef cvec.Vec* v = cvec.VEC_new_from_array(<cnet.REAL*>(x.data),x.size) if values is not None else NULL
-        cnet.NET_update_properties(self._c_net,v)
+        cdef cnet.Net* n = self._c_net
+        with nogil:
+            cnet.NET_update_properties(n,v)
         if v != NULL:
             free(v)
 
@@ -1267,10 +1375,31 @@ cdef class Network:
         """ Number of batteries in the network (int). """
         def __get__(self): return cnet.NET_get_num_bats(self._c_net)
 
+    property num_islands:
+        """ Number of connected components (islands) of the network, taking into account branch outages (int). """
+        def __get__(self): return cnet.NET_get_num_islands(self._c_net)
+
+    property bus_islands:
+        """ Island index of each bus (|Array|). """
+        def __get__(self): return IntArray(cnet.NET_get_bus_islands(self._c_net),
+                                           cnet.NET_get_num_buses(self._c_net))
+
     property num_vars:
         """ Number of network quantities that have been set to variable (int). """
         def __get__(self): return cnet.NET_get_num_vars(self._c_net)
 
+    property var_ordering:
+        """ Ordering of variable indices (``'natural'``, ``'rcm'``, ``'amd'``). """
+        def __get__(self): return ordering2str[cnet.NET_get_var_ordering(self._c_net)]
+
+    property var_permutation:
+        """ Array whose entry i is the current index of the variable that would have index i with natural ordering (|Array|). """
+        def __get__(self):
+            if cnet.NET_get_var_permutation(self._c_net) == NULL:
+                return np.arange(cnet.NET_get_num_vars(self._c_net),dtype='int')
+            return IntArray(cnet.NET_get_var_permutation(self._c_net),
+                            cnet.NET_get_num_vars(self._c_net))
+
     property num_fixed:
         """ Number of network quantities that have been set to fixed (int). """
         def __get__(self): return cnet.NET_get_num_fixed(self._c_net)
@@ -11,43 +11,104 @@ from scipy.sparse import coo_matrix
 from pfnet import CustomConstraint
 
 class DummyDCPF(CustomConstraint):
+    """
+    DC power balance written with batch callbacks. The network is swept
+    once per pass to build the pattern of a single time period, and numpy
+    replicates it over all time periods.
+    """
+
+    # Sources of constant terms of b (series stacked in this order)
+    SOURCES = [('bus','v_ang'),
+               ('branch','phase'),
+               ('generator','P'),
+               ('load','P'),
+               ('variable generator','P'),
+               ('battery','P')]
 
     def init(self):
 
         self.name = "dummy DC power balance"
 
-    def count_step(self,branch,t):
-
-        buses = [branch.bus_k,branch.bus_m]
-        
-        if branch.is_on_outage():
-            return
-
-        for k in range(2):
-            m = 1 if k == 0 else 0
-            if buses[k].has_flags('variable','voltage angle'):
-                self.A_nnz = self.A_nnz + 1
-            if buses[m].has_flags('variable','voltage angle'):
-                self.A_nnz = self.A_nnz + 1
-            if branch.has_flags('variable','phase shift'):
-                self.A_nnz = self.A_nnz + 1
-                
-        for bus in buses:
-            index = bus.index+t*self.network.num_buses
-            if not self.bus_counted[index]:
-                for gen in bus.generators:
-                    if gen.has_flags('variable','active power'):
-                        self.A_nnz = self.A_nnz + 1
-                for load in bus.loads:
-                    if load.has_flags('variable','active power'):
-                        self.A_nnz = self.A_nnz + 1
-                for vargen in bus.var_generators:
-                    if vargen.has_flags('variable','active power'):
-                        self.A_nnz = self.A_nnz + 1
-                for bat in bus.batteries:
-                    if bat.has_flags('variable','charging power'):
-                        self.A_nnz = self.A_nnz + 2
-            self.bus_counted[index] = True
+    def count_batch(self):
+
+        net = self.network
+        T = net.num_periods
+        offsets = np.cumsum([0,net.num_buses,net.num_branches,net.num_generators,
+                             net.num_loads,net.num_var_generators,net.num_batteries])
+        src = dict([(obj,offsets[i]) for i,(obj,name) in enumerate(self.SOURCES)])
+
+        # Pattern of A and b for one time period (same order as C DCPF)
+        A_rows, A_cols, A_data = [], [], []
+        b_rows, b_coeffs, b_srcs = [], [], []
+        counted = np.zeros(net.num_buses,dtype=bool)
+
+        def A_entry(row, index, value):
+            A_rows.append(row)
+            A_cols.append(index)
+            A_data.append(value)
+
+        def b_entry(row, coeff, obj, comp):
+            b_rows.append(row)
+            b_coeffs.append(coeff)
+            b_srcs.append(src[obj]+comp.index)
+
+        for branch in net.branches:
+
+            buses = [branch.bus_k,branch.bus_m]
+
+            if branch.is_on_outage():
+                continue
+
+            for k in range(2):
+                m = 1 if k == 0 else 0
+                sign_phi = 1. if k == 0 else -1.
+                index = buses[k].index
+                if buses[k].has_flags('variable','voltage angle'):
+                    A_entry(index,buses[k].index_v_ang,branch.b)
+                else:
+                    b_entry(index,-branch.b,'bus',buses[k])
+                if buses[m].has_flags('variable','voltage angle'):
+                    A_entry(index,buses[m].index_v_ang,-branch.b)
+                else:
+                    b_entry(index,branch.b,'bus',buses[m])
+                if branch.has_flags('variable','phase shift'):
+                    A_entry(index,branch.index_phase,-branch.b*sign_phi)
+                else:
+                    b_entry(index,branch.b*sign_phi,'branch',branch)
+
+            for bus in buses:
+                index = bus.index
+                if not counted[index]:
+                    for gen in bus.generators:
+                        if gen.has_flags('variable','active power'):
+                            A_entry(index,gen.index_P,1.)
+                        else:
+                            b_entry(index,-1.,'generator',gen)
+                    for load in bus.loads:
+                        if load.has_flags('variable','active power'):
+                            A_entry(index,load.index_P,-1.)
+                        else:
+                            b_entry(index,1.,'load',load)
+                    for vargen in bus.var_generators:
+                        if vargen.has_flags('variable','active power'):
+                            A_entry(index,vargen.index_P,1.)
+                        else:
+                            b_entry(index,-1.,'variable generator',vargen)
+                    for bat in bus.batteries:
+                        if bat.has_flags('variable','charging power'):
+                            A_entry(index,bat.index_Pc,-1.)
+                            A_entry(index,bat.index_Pd,1.)
+                        else:
+                            b_entry(index,1.,'battery',bat)
+                counted[index] = True
+
+        self.A_pattern = (np.array(A_rows,dtype=int),
+                          np.array(A_cols,dtype=int).reshape((len(A_rows),T)),
+                          np.array(A_data))
+        self.b_pattern = (np.array(b_rows,dtype=int),
+                          np.array(b_coeffs),
+                          np.array(b_srcs,dtype=int))
+        self.A_nnz = len(A_rows)*T
 
     def allocate(self):
         
@@ -68,87 +129,22 @@ class DummyDCPF(CustomConstraint):
     def clear(self):
 
         self.A_nnz = 0
-        self.bus_counted[:] = False
 
-    def analyze_step(self,branch,t):
-        
-        buses = [branch.bus_k,branch.bus_m]
-        
-        if branch.is_on_outage():
-            return
-
-        for k in range(2):
-            m = 1 if k == 0 else 0
-            sign_phi = 1. if k == 0 else -1.
-            index = buses[k].index+t*self.network.num_buses
-            if buses[k].has_flags('variable','voltage angle'):
-                self.A.row[self.A_nnz] = index
-                self.A.col[self.A_nnz] = buses[k].index_v_ang[t]
-                self.A.data[self.A_nnz] = branch.b
-                self.A_nnz = self.A_nnz + 1
-            else:
-                self.b[index] += -branch.b*buses[k].v_ang[t]
-            if buses[m].has_flags('variable','voltage angle'):
-                self.A.row[self.A_nnz] = index
-                self.A.col[self.A_nnz] = buses[m].index_v_ang[t]
-                self.A.data[self.A_nnz] = -branch.b
-                self.A_nnz = self.A_nnz + 1
-            else:
-                self.b[index] += branch.b*buses[m].v_ang[t]
-            if branch.has_flags('variable','phase shift'):
-                self.A.row[self.A_nnz] = index
-                self.A.col[self.A_nnz] = branch.index_phase[t]
-                self.A.data[self.A_nnz] = -branch.b*sign_phi
-                self.A_nnz = self.A_nnz + 1
-            else:
-                self.b[index] += branch.b*branch.phase[t]*sign_phi
-            
-        for bus in buses:
-            index = bus.index+t*self.network.num_buses
-            if not self.bus_counted[index]:
-                for gen in bus.generators:
-                    if gen.has_flags('variable','active power'):
-                        self.A.row[self.A_nnz] = index
-                        self.A.col[self.A_nnz] = gen.index_P[t]
-                        self.A.data[self.A_nnz] = 1.
-                        self.A_nnz = self.A_nnz + 1
-                    else:
-                        self.b[index] += -gen.P[t]
-                for load in bus.loads:
-                    if load.has_flags('variable','active power'):
-                        self.A.row[self.A_nnz] = index
-                        self.A.col[self.A_nnz] = load.index_P[t]
-                        self.A.data[self.A_nnz] = -1.
-                        self.A_nnz = self.A_nnz + 1
-                    else:
-                        self.b[index] += load.P[t]
-                for vargen in bus.var_generators:
-                    if vargen.has_flags('variable','active power'):
-                        self.A.row[self.A_nnz] = index
-                        self.A.col[self.A_nnz] = vargen.index_P[t]
-                        self.A.data[self.A_nnz] = 1.
-                        self.A_nnz = self.A_nnz + 1
-                    else:
-                        self.b[index] += -vargen.P[t]
-                for bat in bus.batteries:
-                    if bat.has_flags('variable','charging power'):
-                        self.A.row[self.A_nnz] = index
-                        self.A.col[self.A_nnz] = bat.index_Pc[t]
-                        self.A.data[self.A_nnz] = -1.
-                        self.A_nnz = self.A_nnz + 1
-                        self.A.row[self.A_nnz] = index
-                        self.A.col[self.A_nnz] = bat.index_Pd[t]
-                        self.A.data[self.A_nnz] = 1.
-                        self.A_nnz = self.A_nnz + 1
-                    else:
-                        self.b[index] += bat.P[t]
-            self.bus_counted[index] = True
-
-    def eval_step(self,branch,t,x,y=None):
- 
-        pass
-        
-    def store_sens_step(self,branch,t,sA,sf,sGu,sGl):
-        
-        pass
-        
+    def analyze_batch(self):
+
+        net = self.network
+        T = net.num_periods
+        shift = net.num_buses*np.arange(T)[:,np.newaxis]
+
+        # A (time period major)
+        rows, cols, data = self.A_pattern
+        A = self.A
+        A.row[:] = (rows+shift).ravel()
+        A.col[:] = cols.T.ravel()
+        A.data[:] = np.tile(data,T)
+        self.A_nnz = rows.size*T
+
+        # b (terms added in pattern order, as np.add.at is unbuffered)
+        rows, coeffs, srcs = self.b_pattern
+        values = np.vstack([net.get_series(obj,name) for obj,name in self.SOURCES])
+        np.add.at(self.b,(rows+shift).ravel(),(coeffs*values[srcs,:].T).ravel())
@@ -15,7 +15,7 @@ cdef extern from "pfnet/pfnet.h":
     Parser* PARSER_new()
     Parser* PARSER_new_for_file(char* f)
     void PARSER_init(Parser* p)
-    Net* PARSER_parse(Parser* p, char* f, int num_periods)
+    Net* PARSER_parse(Parser* p, char* f, int num_periods) nogil
     void PARSER_set(Parser* p, char* key, REAL value)
     void PARSER_show(Parser* p)
     void PARSER_write(Parser* p, Net* net, char* f)
@@ -39,6 +39,7 @@ cdef extern from "pfnet/pfnet.h":
     Parser* ART_PARSER_new()
     Parser* RAW_PARSER_new()
     Parser* JSON_PARSER_new()
+    Parser* BIN_PARSER_new()
     
     
 
@@ -20,6 +20,9 @@ class ParserError(Exception):
 cdef class ParserBase:
     """
     Base parser class.
+
+    Method :func:`parse() <pfnet.ParserBase.parse>` releases the GIL. A parser
+    must not be used by more than one thread at a time.
     """
 
     cdef cparser.Parser* _c_parser
@@ -71,7 +74,12 @@ cdef class ParserBase:
         if num_periods is None:
             num_periods = 0 # format-specific parser will use its default
         filename = filename.encode('UTF-8')
-        cdef cparser.Net* net = cparser.PARSER_parse(self._c_parser, filename, num_periods)
+        cdef char* f = filename
+        cdef int T = num_periods
+        cdef cparser.Parser* p = self._c_parser
+        cdef cparser.Net* net
+        with nogil:
+            net = cparser.PARSER_parse(p,f,T)
         if cparser.PARSER_has_error(self._c_parser):
             raise ParserError(cparser.PARSER_get_error_string(self._c_parser))
         cdef Network pnet = new_Network(net)
@@ -139,6 +147,8 @@ cdef class Parser(ParserBase):
             self._c_parser = cparser.RAW_PARSER_new()
         elif ext == 'json':
             self._c_parser = cparser.JSON_PARSER_new()
+        elif ext == 'pfb':
+            self._c_parser = cparser.BIN_PARSER_new()
         else:
             raise ParserError('invalid extension')
 
@@ -199,3 +209,17 @@ cdef class ParserJSON(ParserBase):
         
         self._c_parser = cparser.JSON_PARSER_new()
         self._alloc = True
+
+cdef class ParserBIN(ParserBase):
+
+    def __init__(self):
+        """
+        Binary snapshot parser class.
+        """
+    
+        pass
+        
+    def __cinit__(self):
+        
+        self._c_parser = cparser.BIN_PARSER_new()
+        self._alloc = True
@@ -23,7 +23,7 @@ cimport cgraph
 from scipy import misc
 import tempfile
 
-from scipy.sparse import coo_matrix
+from scipy.sparse import coo_matrix,csr_matrix,csc_matrix
 
 from libc.stdlib cimport free
 
@@ -189,6 +189,7 @@ include "cvargen.pyx"
 include "cbat.pyx"
 include "cnet.pyx"
 include "ccont.pyx"
+include "creduction.pyx"
 include "cgraph.pyx"
 include "cfunc.pyx"
 include "cconstr.pyx"
@@ -19,14 +19,14 @@ cdef extern from "pfnet/problem.h":
     void PROB_add_constr(Prob* p, Constr* c)
     void PROB_add_func(Prob* p, Func* f)
     void PROB_add_heur(Prob* p, int htype)
-    void PROB_analyze(Prob* p)
+    void PROB_analyze(Prob* p) nogil
     void PROB_apply_heuristics(Prob* p, Vec* point)
-    void PROB_eval(Prob* p, Vec* point)
+    void PROB_eval(Prob* p, Vec* point) nogil
     void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl)
     void PROB_del(Prob* p)
     void PROB_clear(Prob* p)
     void PROB_clear_error(Prob* p)
-    void PROB_combine_H(Prob* p, Vec* coeff, bint ensure_psd)
+    void PROB_combine_H(Prob* p, Vec* coeff, bint ensure_psd) nogil
     Constr* PROB_find_constr(Prob* p, char* name)
     Constr* PROB_get_constr(Prob* p)
     char* PROB_get_error_string(Prob* p)
@@ -43,15 +43,44 @@ cdef extern from "pfnet/problem.h":
     Vec* PROB_get_l(Prob* p)
     Vec* PROB_get_u(Prob* p)
     Mat* PROB_get_G(Prob* p)
+    Vec* PROB_get_x_l(Prob* p)
+    Vec* PROB_get_x_u(Prob* p)
     Vec* PROB_get_f(Prob* p)
     Mat* PROB_get_J(Prob* p)
     Mat* PROB_get_H_combined(Prob* p)
+    Vec* PROB_Jv(Prob* p, Vec* x, Vec* v)
+    Vec* PROB_JTy(Prob* p, Vec* x, Vec* y)
+    Vec* PROB_Hv(Prob* p, Vec* x, Vec* lam, Vec* v)
+    Mat* PROB_estimate_J(Prob* p, Vec* point, REAL h)
+    Mat* PROB_estimate_H(Prob* p, Vec* point, Vec* lam, REAL h)
     bint PROB_has_error(Prob* p)
     Prob* PROB_new(Net* net)
     void PROB_show(Prob* p)
     char* PROB_get_show_str(Prob* p)
+    void PROB_shift_periods(Prob* p, int k, char* profiles)
+    void PROB_update_data(Prob* p) nogil
     void PROB_update_lin(Prob* p)
     int PROB_get_num_primal_variables(Prob* p)
     int PROB_get_num_linear_equality_constraints(Prob* p)
     int PROB_get_num_nonlinear_equality_constraints(Prob* p)
     int PROB_get_num_extra_vars(Prob* p)
+    int PROB_get_num_blocks(Prob* p)
+    int* PROB_get_var_blocks(Prob* p)
+    int* PROB_get_A_row_blocks(Prob* p)
+    int* PROB_get_J_row_blocks(Prob* p)
+    int* PROB_get_G_row_blocks(Prob* p)
+    int PROB_screen_branches(Prob* p, Vec* values, REAL fraction)
+    void PROB_set_island_decomposition(Prob* p, bint flag)
+    int* PROB_get_var_periods(Prob* p)
+    int* PROB_get_A_row_periods(Prob* p)
+    int* PROB_get_J_row_periods(Prob* p)
+    int* PROB_get_G_row_periods(Prob* p)
+    Mat* PROB_get_period_major_mat(Prob* p, Mat* M, int* row_period, int* nnz_ptr)
+    int PROB_get_num_J_colors(Prob* p)
+    int* PROB_get_J_colors(Prob* p)
+    int PROB_get_num_H_colors(Prob* p)
+    int* PROB_get_H_colors(Prob* p)
+    void PROB_set_period_decomposition(Prob* p, bint flag)
+    void PROB_set_simple_bounds(Prob* p, bint flag)
+    void PROB_set_coloring(Prob* p, bint flag)
+    void PROB_set_duplicate_compaction(Prob* p, bint flag)
@@ -20,12 +20,19 @@ class ProblemError(Exception):
 cdef class Problem:
     """
     Optimization problem class.
+
+    Methods :func:`analyze() <pfnet.Problem.analyze>`, :func:`eval() <pfnet.Problem.eval>`,
+    :func:`combine_H() <pfnet.Problem.combine_H>` and :func:`update_data() <pfnet.Problem.update_data>`
+    release the GIL unless the problem has a |CustomConstraint| or |CustomFunction|. A problem
+    must not be used by more than one thread at a time, and problems used concurrently must
+    be built on different networks.
     """
 
     cdef cprob.Prob* _c_prob
     cdef bint alloc
     cdef list _functions
     cdef list _constraints
+    cdef dict _matrices
 
     def __init__(self, Network net):
         """
@@ -44,6 +51,7 @@ cdef class Problem:
         self.alloc = True
         self._functions = []
         self._constraints = []
+        self._matrices = {}
 
     def __dealloc__(self):
         """
@@ -54,6 +62,34 @@ cdef class Problem:
             cprob.PROB_del(self._c_prob)
             self._c_prob = NULL
 
+    cdef bint _has_custom(self):
+        """
+        Indicates whether the problem has Python constraints or functions,
+        whose callbacks need the GIL.
+        """
+
+        for c in self._constraints:
+            if isinstance(c,CustomConstraint):
+                return True
+        for f in self._functions:
+            if isinstance(f,CustomFunction):
+                return True
+        return False
+
+    cdef _cached_matrix(self, name, cmat.Mat* m):
+        """
+        Gets |CooMatrix| that wraps the arrays of the given C matrix. The wrapper
+        is created once per analysis, and values updated in place by eval are
+        seen without copies.
+        """
+
+        key = (<size_t>m,cmat.MAT_get_nnz(m) if m is not NULL else 0)
+        entry = self._matrices.get(name)
+        if entry is None or entry[0] != key:
+            entry = (key,Matrix(m),{})
+            self._matrices[name] = entry
+        return entry[1]
+
     def add_constraint(self, ConstraintBase constr):
         """
         Adds constraint to optimization problem.
@@ -108,7 +144,126 @@ cdef class Problem:
         required vectors and matrices.
         """
 
-        cprob.PROB_analyze(self._c_prob)
+        cdef cprob.Prob* p = self._c_prob
+        self._matrices = {}
+        if self._has_custom():
+            cprob.PROB_analyze(p)
+        else:
+            with nogil:
+                cprob.PROB_analyze(p)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+
+    def screen_branches(self, values=None, fraction=0.9):
+        """
+        Adds branches whose flow exceeds the given fraction of their rating to the
+        constraints in active-set mode (see :func:`screen_branches() <pfnet.ConstraintBase.screen_branches>`).
+        The problem must be analyzed again if branches are added.
+
+        Parameters
+        ----------
+        values : |Array| (variable values, current network values if ``None``)
+        fraction : float
+
+        Returns
+        -------
+        num : int (number of added pairs of branch and time period)
+        """
+
+        cdef np.ndarray[double,mode='c'] x
+        cdef cvec.Vec* v = NULL
+        if values is not None:
+            x = values
+            v = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
+        num = cprob.PROB_screen_branches(self._c_prob,v,fraction)
+        free(v)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return num
+
+    def set_island_decomposition(self, flag):
+        """
+        Enables or disables the computation of independent blocks of
+        variables and constraints (e.g., network islands) during analyze.
+        When enabled and the network has several islands, the steps of
+        the built-in constraints and functions run per island during
+        analyze and eval, on separate threads if OpenMP is available.
+
+        Parameters
+        ----------
+        flag : {``True``, ``False``}
+        """
+
+        cprob.PROB_set_island_decomposition(self._c_prob,flag)
+
+    def set_period_decomposition(self, flag):
+        """
+        Enables or disables the computation of the time periods of
+        variables and constraint rows during analyze.
+
+        Parameters
+        ----------
+        flag : {``True``, ``False``}
+        """
+
+        cprob.PROB_set_period_decomposition(self._c_prob,flag)
+
+    def set_coloring(self, flag):
+        """
+        Enables or disables the coloring of the columns of :attr:`J <pfnet.Problem.J>`
+        and of the Hessian of the Lagrangian during analyze (see
+        :meth:`estimate_J() <pfnet.Problem.estimate_J>`).
+
+        Parameters
+        ----------
+        flag : {``True``, ``False``}
+        """
+
+        cprob.PROB_set_coloring(self._c_prob,flag)
+
+    def set_duplicate_compaction(self, flag):
+        """
+        Enables or disables summing the entries of :attr:`J <pfnet.Problem.J>`,
+        :attr:`Hphi <pfnet.Problem.Hphi>` and :attr:`H_combined <pfnet.Problem.H_combined>`
+        that share a row and column during analyze, so that these matrices have no
+        duplicate entries.
+
+        Parameters
+        ----------
+        flag : {``True``, ``False``}
+        """
+
+        cprob.PROB_set_duplicate_compaction(self._c_prob,flag)
+
+    def set_simple_bounds(self, flag):
+        """
+        Enables or disables emitting the bounds of the "variable bounds" constraint
+        as vectors :attr:`x_l <pfnet.Problem.x_l>` and :attr:`x_u <pfnet.Problem.x_u>`
+        instead of as rows of :attr:`G <pfnet.Problem.G>` during analyze.
+
+        Parameters
+        ----------
+        flag : {``True``, ``False``}
+        """
+
+        cprob.PROB_set_simple_bounds(self._c_prob,flag)
+
+    def shift_periods(self, k, profiles=None):
+        """
+        Moves network data ``k`` periods back (see :meth:`Network.shift_periods() <pfnet.Network.shift_periods>`)
+        and refreshes problem data while keeping the structure from the last analysis.
+
+        Parameters
+        ----------
+        k : int
+        profiles : string
+        """
+
+        cdef char* cprofiles = NULL
+        if profiles is not None:
+            profiles = profiles.encode('UTF-8')
+            cprofiles = profiles
+        cprob.PROB_shift_periods(self._c_prob,k,cprofiles)
         if cprob.PROB_has_error(self._c_prob):
             raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
 
@@ -132,6 +287,8 @@ cdef class Problem:
         """
 
         self._functions = []
+        self._constraints = []
+        self._matrices = {}
         cprob.PROB_clear(self._c_prob)
 
     def clear_error(self):
@@ -153,7 +310,13 @@ cdef class Problem:
 
         cdef np.ndarray[double,mode='c'] x = coeff
         cdef cvec.Vec* v = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
-        cprob.PROB_combine_H(self._c_prob,v,ensure_psd)
+        cdef cprob.Prob* p = self._c_prob
+        cdef bint psd = ensure_psd
+        if self._has_custom():
+            cprob.PROB_combine_H(p,v,psd)
+        else:
+            with nogil:
+                cprob.PROB_combine_H(p,v,psd)
         free(v)
         if cprob.PROB_has_error(self._c_prob):
             raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
@@ -182,11 +345,166 @@ cdef class Problem:
 
         cdef np.ndarray[double,mode='c'] x = var_values
         cdef cvec.Vec* v = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
-        cprob.PROB_eval(self._c_prob,v)
+        cdef cprob.Prob* p = self._c_prob
+        if self._has_custom():
+            cprob.PROB_eval(p,v)
+        else:
+            with nogil:
+                cprob.PROB_eval(p,v)
         free(v)
         if cprob.PROB_has_error(self._c_prob):
             raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
 
+    def Jv(self, var_values, v):
+        """
+        Computes the product of the Jacobian :attr:`J <pfnet.Problem.J>` of the
+        nonlinear equality constraints and the vector ``v`` without assembling
+        the Jacobian. Constraints that provide no direct product are evaluated
+        and their own Jacobian is used.
+
+        Parameters
+        ----------
+        var_values : |Array|
+        v : |Array|
+
+        Returns
+        -------
+        Jv : |Array|
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef np.ndarray[double,mode='c'] d = v
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
+        cdef cvec.Vec* vd = cvec.VEC_new_from_array(<cprob.REAL*>(d.data),d.size)
+        cdef cvec.Vec* r = cprob.PROB_Jv(self._c_prob,vx,vd)
+        free(vx)
+        free(vd)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return Vector(r,owndata=True)
+
+    def JTy(self, var_values, y):
+        """
+        Computes the product of the transpose of the Jacobian :attr:`J <pfnet.Problem.J>`
+        of the nonlinear equality constraints and the vector ``y`` without assembling
+        the Jacobian (see :meth:`Jv() <pfnet.Problem.Jv>`).
+
+        Parameters
+        ----------
+        var_values : |Array|
+        y : |Array|
+
+        Returns
+        -------
+        JTy : |Array|
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef np.ndarray[double,mode='c'] w = y
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
+        cdef cvec.Vec* vw = cvec.VEC_new_from_array(<cprob.REAL*>(w.data),w.size)
+        cdef cvec.Vec* r = cprob.PROB_JTy(self._c_prob,vx,vw)
+        free(vx)
+        free(vw)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return Vector(r,owndata=True)
+
+    def Hv(self, var_values, lam, v):
+        """
+        Computes the product of the Hessian of the Lagrangian and the vector ``v``
+        without assembling the Hessian. The Hessian is that of the objective function
+        :attr:`phi <pfnet.Problem.phi>` plus the nonlinear equality constraints
+        weighted by ``lam`` (see :meth:`combine_H() <pfnet.Problem.combine_H>`).
+        Components that provide no direct product are evaluated and their own
+        Hessians are used.
+
+        Parameters
+        ----------
+        var_values : |Array|
+        lam : |Array|
+        v : |Array|
+
+        Returns
+        -------
+        Hv : |Array|
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef np.ndarray[double,mode='c'] l = lam
+        cdef np.ndarray[double,mode='c'] d = v
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
+        cdef cvec.Vec* vl = cvec.VEC_new_from_array(<cprob.REAL*>(l.data),l.size)
+        cdef cvec.Vec* vd = cvec.VEC_new_from_array(<cprob.REAL*>(d.data),d.size)
+        cdef cvec.Vec* r = cprob.PROB_Hv(self._c_prob,vx,vl,vd)
+        free(vx)
+        free(vl)
+        free(vd)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return Vector(r,owndata=True)
+
+    def estimate_J(self, var_values, h=1e-7):
+        """
+        Estimates the Jacobian :attr:`J <pfnet.Problem.J>` of the nonlinear equality
+        constraints with forward differences along one direction per color of its columns,
+        i.e., with as many evaluations as colors (see :attr:`num_J_colors <pfnet.Problem.num_J_colors>`)
+        besides the ones at ``var_values``. The problem is left evaluated at ``var_values``.
+
+        Parameters
+        ----------
+        var_values : |Array|
+        h : float (step)
+
+        Returns
+        -------
+        J : |CooMatrix| (pattern of J without duplicates)
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
+        cdef cmat.Mat* m = <cmat.Mat*>cprob.PROB_estimate_J(self._c_prob,vx,h)
+        free(vx)
+        if cprob.PROB_has_error(self._c_prob) or m is NULL:
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        M = Matrix(m,owndata=True)
+        free(m)
+        return M
+
+    def estimate_H(self, var_values, lam, h=1e-7):
+        """
+        Estimates the lower triangle of the Hessian of the Lagrangian, *i.e.*,
+        :attr:`Hphi <pfnet.Problem.Hphi>` plus :attr:`H_combined <pfnet.Problem.H_combined>`
+        for coefficients ``lam``, with forward differences of its gradient along one direction
+        per color of its columns (see :attr:`num_H_colors <pfnet.Problem.num_H_colors>`).
+        Its pattern includes every pair of columns of :attr:`J <pfnet.Problem.J>` that share
+        a row, so constraints without Hessians are also covered.
+        The problem is left evaluated at ``var_values``.
+
+        Parameters
+        ----------
+        var_values : |Array|
+        lam : |Array|
+        h : float (step)
+
+        Returns
+        -------
+        H : |CooMatrix| (lower triangular)
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef np.ndarray[double,mode='c'] l = lam
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<cprob.REAL*>(x.data),x.size)
+        cdef cvec.Vec* vl = cvec.VEC_new_from_array(<cprob.REAL*>(l.data),l.size)
+        cdef cmat.Mat* m = <cmat.Mat*>cprob.PROB_estimate_H(self._c_prob,vx,vl,h)
+        free(vx)
+        free(vl)
+        if cprob.PROB_has_error(self._c_prob) or m is NULL:
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        M = Matrix(m,owndata=True)
+        free(m)
+        return M
+
     def store_sensitivities(self, sA, sf, sGu, sGl):
         """
         Stores Lagrange multiplier estimates of the constraints in
@@ -295,14 +613,135 @@ cdef class Problem:
 
         print(cprob.PROB_get_show_str(self._c_prob).decode('UTF-8'))
 
+    def update_data(self):
+        """
+        Refreshes data of constraints and functions after changes of network
+        data that leave flags unchanged, keeping the structure from the last analysis.
+        """
+
+        cdef cprob.Prob* p = self._c_prob
+        if self._has_custom():
+            cprob.PROB_update_data(p)
+        else:
+            with nogil:
+                cprob.PROB_update_data(p)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+
     def update_lin(self):
         """
         Updates linear equality constraints.
         """
 
+        self._matrices = {}
         cprob.PROB_update_lin(self._c_prob)
 
+    def get_matrix(self, name, format='coo'):
+        """
+        Gets sparse matrix of the problem in the given format. Matrices are created
+        once per analysis. The |CooMatrix| wraps the C arrays and is updated in place
+        by :func:`eval() <pfnet.Problem.eval>`. For formats 'csr' and 'csc', the index arrays
+        and the map from coordinate entries are cached, and only the values are
+        refreshed by this method (repeated entries are added).
+
+        Parameters
+        ----------
+        name : string ('A', 'G', 'J', 'Hphi', 'H_combined')
+        format : string ('coo', 'csr', 'csc')
+
+        Returns
+        -------
+        M : scipy sparse matrix
+        """
+
+        if name not in ['A','G','J','Hphi','H_combined']:
+            raise ProblemError('invalid matrix name')
+        if format not in ['coo','csr','csc']:
+            raise ProblemError('invalid matrix format')
+
+        coo = getattr(self,name)
+        if format == 'coo':
+            return coo
+
+        compressed = self._matrices[name][2]
+        if format not in compressed:
+            if format == 'csr':
+                major,minor,n = coo.row,coo.col,coo.shape[0]
+            else:
+                major,minor,n = coo.col,coo.row,coo.shape[1]
+            order = np.lexsort((minor,major))
+            major = major[order]
+            minor = minor[order]
+            first = np.ones(order.size,dtype=bool)
+            first[1:] = (major[1:] != major[:-1]) | (minor[1:] != minor[:-1])
+            entry_map = np.empty(order.size,dtype=np.intp)
+            entry_map[order] = np.cumsum(first)-1
+            indptr = np.zeros(n+1,dtype=np.int32)
+            indptr[1:] = np.cumsum(np.bincount(major[first],minlength=n))
+            indices = minor[first].astype(np.int32)
+            values = np.zeros(indices.size)
+            if format == 'csr':
+                M = csr_matrix((values,indices,indptr),shape=coo.shape)
+            else:
+                M = csc_matrix((values,indices,indptr),shape=coo.shape)
+            compressed[format] = (M,entry_map)
+
+        M,entry_map = compressed[format]
+        M.data[:] = np.bincount(entry_map,weights=coo.data,minlength=M.data.size)
+        return M
+
+    def get_period_major_matrix(self, name):
+        """
+        Gets copy of matrix with rows and columns in period-major order, i.e., those of
+        period 0 first, then those of period 1, and so on, followed by coupling rows and
+        extra variables without a period. Entries of the diagonal block of period ``t`` are in positions
+        ``nnz_ptr[t]`` to ``nnz_ptr[t+1]-1`` and coupling entries follow, so that the
+        arrays of each period's subproblem can be sliced without copies. Requires
+        period decomposition (see :func:`set_period_decomposition() <pfnet.Problem.set_period_decomposition>`).
+
+        Parameters
+        ----------
+        name : string ('A', 'G', 'J', 'Hphi', 'H_combined')
+
+        Returns
+        -------
+        M : |CooMatrix|
+        nnz_ptr : |Array| (size num_periods+2)
+        """
+
+        cdef cmat.Mat* m
+        cdef int* row_period = NULL
+        cdef np.ndarray[int,mode='c'] nnz_ptr
+
+        if name == 'A':
+            m = <cmat.Mat*>cprob.PROB_get_A(self._c_prob)
+            row_period = cprob.PROB_get_A_row_periods(self._c_prob)
+        elif name == 'J':
+            m = <cmat.Mat*>cprob.PROB_get_J(self._c_prob)
+            row_period = cprob.PROB_get_J_row_periods(self._c_prob)
+        elif name == 'G':
+            m = <cmat.Mat*>cprob.PROB_get_G(self._c_prob)
+            row_period = cprob.PROB_get_G_row_periods(self._c_prob)
+        elif name == 'Hphi':
+            m = <cmat.Mat*>cprob.PROB_get_Hphi(self._c_prob)
+        elif name == 'H_combined':
+            m = <cmat.Mat*>cprob.PROB_get_H_combined(self._c_prob)
+        else:
+            raise ProblemError('invalid matrix name')
+
+        nnz_ptr = np.zeros(self.network.num_periods+2,dtype=np.intc)
+        if name in ['A','J','G'] and row_period is NULL:
+            m = NULL
+        else:
+            m = <cmat.Mat*>cprob.PROB_get_period_major_mat(self._c_prob,<cprob.Mat*>m,row_period,<int*>nnz_ptr.data)
+        if m is NULL:
+            raise ProblemError('period decomposition not available')
+        M = Matrix(m,owndata=True)
+        free(m)
+        return M,nnz_ptr
+
     def get_num_primal_variables(self):
+
         """ 
         Gets number of primal variables. 
 
@@ -361,7 +800,7 @@ cdef class Problem:
 
     property A:
         """ Constraint matrix of linear equality constraints (|CooMatrix|). """
-        def __get__(self): return Matrix(cprob.PROB_get_A(self._c_prob))
+        def __get__(self): return self._cached_matrix('A',cprob.PROB_get_A(self._c_prob))
 
     property b:
         """ Right hand side vectors of the linear equality constraints (|Array|). """
@@ -369,7 +808,7 @@ cdef class Problem:
 
     property G:
         """ Constraint matrix of linear inequality constraints (|CooMatrix|). """
-        def __get__(self): return Matrix(cprob.PROB_get_G(self._c_prob))
+        def __get__(self): return self._cached_matrix('G',cprob.PROB_get_G(self._c_prob))
 
     property l:
         """ Lower bound for linear inequality constraints (|Array|). """
@@ -379,9 +818,17 @@ cdef class Problem:
         """ Upper bound for linear inequality constraints (|Array|). """
         def __get__(self): return Vector(cprob.PROB_get_u(self._c_prob))
 
+    property x_l:
+        """ Lower bounds of primal variables in simple-bounds mode (|Array|). """
+        def __get__(self): return Vector(cprob.PROB_get_x_l(self._c_prob))
+
+    property x_u:
+        """ Upper bounds of primal variables in simple-bounds mode (|Array|). """
+        def __get__(self): return Vector(cprob.PROB_get_x_u(self._c_prob))
+
     property J:
         """ Jacobian matrix of the nonlinear equality constraints (|CooMatrix|). """
-        def __get__(self): return Matrix(cprob.PROB_get_J(self._c_prob))
+        def __get__(self): return self._cached_matrix('J',cprob.PROB_get_J(self._c_prob))
 
     property f:
         """ Vector of nonlinear equality constraints violations (|Array|). """
@@ -397,11 +844,11 @@ cdef class Problem:
 
     property Hphi:
         """ Objective function Hessian matrix (only the lower triangular part) (|CooMatrix|). """
-        def __get__(self): return Matrix(cprob.PROB_get_Hphi(self._c_prob))
+        def __get__(self): return self._cached_matrix('Hphi',cprob.PROB_get_Hphi(self._c_prob))
 
     property H_combined:
         """ Linear combination of Hessian matrices of individual nonlinear equality constraints (only the lower triangular part) (|CooMatrix|). """
-        def __get__(self): return Matrix(cprob.PROB_get_H_combined(self._c_prob))
+        def __get__(self): return self._cached_matrix('H_combined',cprob.PROB_get_H_combined(self._c_prob))
 
     property x:
         """ Initial primal point (|Array|). """
@@ -430,3 +877,83 @@ cdef class Problem:
     property num_extra_vars:
         """ Number of extra varaibles (set during analyze) (int). """
         def __get__(self): return cprob.PROB_get_num_extra_vars(self._c_prob)
+
+    property num_blocks:
+        """ Number of independent blocks (set during analyze if island decomposition is enabled) (int). """
+        def __get__(self): return cprob.PROB_get_num_blocks(self._c_prob)
+
+    property var_blocks:
+        """ Block index of each primal variable (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_var_blocks(self._c_prob),
+                                           cprob.PROB_get_num_primal_variables(self._c_prob))
+
+    property A_row_blocks:
+        """ Block index of each row of A (-1 for empty rows) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_A_row_blocks(self._c_prob),
+                                           cprob.PROB_get_num_linear_equality_constraints(self._c_prob))
+
+    property J_row_blocks:
+        """ Block index of each row of J (-1 for empty rows) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_J_row_blocks(self._c_prob),
+                                           cprob.PROB_get_num_nonlinear_equality_constraints(self._c_prob))
+
+    property var_periods:
+        """ Time period of each primal variable (-1 for extra variables without a period, -2 for coupling extra variables) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_var_periods(self._c_prob),
+                                           cprob.PROB_get_num_primal_variables(self._c_prob))
+
+    property A_row_periods:
+        """ Time period of each row of A (-1 for empty rows, -2 for coupling rows) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_A_row_periods(self._c_prob),
+                                           cprob.PROB_get_num_linear_equality_constraints(self._c_prob))
+
+    property J_row_periods:
+        """ Time period of each row of J (-1 for empty rows, -2 for coupling rows) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_J_row_periods(self._c_prob),
+                                           cprob.PROB_get_num_nonlinear_equality_constraints(self._c_prob))
+
+    property G_row_periods:
+        """ Time period of each row of G (-1 for empty rows, -2 for coupling rows) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_G_row_periods(self._c_prob),
+                                           cmat.MAT_get_size1(<cmat.Mat*>cprob.PROB_get_G(self._c_prob)))
+
+    property num_J_colors:
+        """ Number of colors of the columns of J (set during analyze if coloring is enabled) (int). """
+        def __get__(self): return cprob.PROB_get_num_J_colors(self._c_prob)
+
+    property J_colors:
+        """ Color of each column of J (-1 for empty columns) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_J_colors(self._c_prob),
+                                           cprob.PROB_get_num_primal_variables(self._c_prob))
+
+    property num_H_colors:
+        """ Number of colors of the columns of the Hessian of the Lagrangian (set during analyze if coloring is enabled) (int). """
+        def __get__(self): return cprob.PROB_get_num_H_colors(self._c_prob)
+
+    property H_colors:
+        """ Color of each column of the Hessian of the Lagrangian (-1 for empty columns) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_H_colors(self._c_prob),
+                                           cprob.PROB_get_num_primal_variables(self._c_prob))
+
+    property coupling_constraints:
+        """ Names of constraints with rows that couple different time periods (set during analyze if period decomposition is enabled) (list). """
+        def __get__(self):
+            if cprob.PROB_get_var_periods(self._c_prob) is NULL:
+                return []
+            names = []
+            offset = {'A': 0, 'J': 0, 'G': 0}
+            periods = {'A': self.A_row_periods, 'J': self.J_row_periods, 'G': self.G_row_periods}
+            for c in self.constraints:
+                coupling = False
+                for key in ['A','J','G']:
+                    n = getattr(c,key).shape[0]
+                    coupling |= bool(np.any(periods[key][offset[key]:offset[key]+n] == -2))
+                    offset[key] += n
+                if coupling:
+                    names.append(c.name)
+            return names
+
+    property G_row_blocks:
+        """ Block index of each row of G (-1 for empty rows) (|Array|). """
+        def __get__(self): return IntArray(cprob.PROB_get_G_row_blocks(self._c_prob),
+                                           cmat.MAT_get_size1(<cmat.Mat*>cprob.PROB_get_G(self._c_prob)))
@@ -0,0 +1,24 @@
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015, Tomas Tinoco De Rubira.       #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cnet
+
+cdef extern from "pfnet/reduction.h":
+
+    ctypedef struct Red
+
+    void RED_del(Red* red)
+    void RED_expand(Red* red)
+    int* RED_get_bus_map(Red* red)
+    int* RED_get_branch_map(Red* red)
+    char* RED_get_error_string(Red* red)
+    cnet.Net* RED_get_network(Red* red)
+    int RED_get_num_eliminated_buses(Red* red)
+    int* RED_get_eliminated_buses(Red* red)
+    bint RED_has_error(Red* red)
+    Red* RED_new(cnet.Net* net, int max_degree)
@@ -0,0 +1,91 @@
+#cython: embedsignature=True
+
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015, Tomas Tinoco De Rubira.       #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport creduction
+
+class ReductionError(Exception):
+    """
+    Reduction error exception.
+    """
+
+    pass
+
+cdef class Reduction:
+    """
+    Network reduction class.
+    """
+
+    cdef creduction.Red* _c_red
+    cdef object _net
+    cdef object _red_net
+
+    def __init__(self, net, max_degree=3):
+        """
+        Network reduction class. Eliminates zero-injection buses
+        of degree between 2 and max_degree that are connected only by
+        lines or fixed transformers without phase shift.
+
+        Parameters
+        ----------
+        net : |Network|
+        max_degree : int
+        """
+
+        pass
+
+    def __cinit__(self, Network net, max_degree=3):
+
+        self._net = net
+        self._c_red = creduction.RED_new(net._c_net,max_degree)
+        if creduction.RED_has_error(self._c_red):
+            raise ReductionError(creduction.RED_get_error_string(self._c_red))
+        self._red_net = new_Network(creduction.RED_get_network(self._c_red))
+
+    def __dealloc__(self):
+        """
+        Frees reduction C data structure.
+        """
+
+        creduction.RED_del(self._c_red)
+        self._c_red = NULL
+
+    def expand(self):
+        """
+        Updates the original network with the state of the reduced network.
+        Voltages of eliminated buses are recovered from those of their neighbors.
+        """
+
+        creduction.RED_expand(self._c_red)
+
+    property network:
+        """ Reduced network, valid while the reduction exists (|Network|). """
+        def __get__(self): return self._red_net
+
+    property bus_map:
+        """ Index in reduced network of each bus of the original network, -1 if eliminated (|Array|). """
+        def __get__(self):
+            return IntArray(creduction.RED_get_bus_map(self._c_red),
+                            cnet.NET_get_num_buses((<Network>self._net)._c_net))
+
+    property branch_map:
+        """ Index in reduced network of each branch of the original network, -1 if merged or on outage (|Array|). """
+        def __get__(self):
+            return IntArray(creduction.RED_get_branch_map(self._c_red),
+                            cnet.NET_get_num_branches((<Network>self._net)._c_net))
+
+    property num_eliminated_buses:
+        """ Number of eliminated buses (int). """
+        def __get__(self): return creduction.RED_get_num_eliminated_buses(self._c_red)
+
+    property eliminated_buses:
+        """ Indices of eliminated buses in order of elimination (|Array|). """
+        def __get__(self):
+            return IntArray(creduction.RED_get_eliminated_buses(self._c_red),
+                            creduction.RED_get_num_eliminated_buses(self._c_red))
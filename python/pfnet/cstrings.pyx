@@ -18,6 +18,7 @@ cimport cshunt
 cimport cload
 cimport cvargen
 cimport cbat
+cimport cnet
 
 # Objects
 str2obj = {'all' : cobjs.OBJ_ALL,
@@ -32,6 +33,13 @@ str2obj = {'all' : cobjs.OBJ_ALL,
 
 obj2str = dict([(v,k) for k,v in str2obj.items()])
 
+# Variable orderings
+str2ordering = {'natural' : cnet.NET_ORDER_NATURAL,
+                'rcm' : cnet.NET_ORDER_RCM,
+                'amd' : cnet.NET_ORDER_AMD}
+
+ordering2str = dict([(v,k) for k,v in str2ordering.items()])
+
 # Flags
 str2flag = {'variable' : cflags.FLAG_VARS,
             'fixed' : cflags.FLAG_FIXED,
@@ -11,26 +11,37 @@ from scipy.sparse import coo_matrix
 from pfnet import CustomFunction
 
 class DummyGenCost(CustomFunction):
+    """
+    Quadratic generation cost written with batch callbacks. Generators are
+    collected once per pass and numpy evaluates all time periods at once.
+    """
 
     def init(self):
         
         self.name = "dummy generation cost"
     
-    def count_step(self,branch,t):
+    def count_batch(self):
 
-        T = self.network.num_periods
-        buses = [branch.bus_k,branch.bus_m]
-        
-        if branch.is_on_outage():
-            return
+        net = self.network
+        T = net.num_periods
 
-        for bus in buses:
-            index = bus.index*T+t
-            if not self.bus_counted[index]:
-                for gen in bus.generators:
-                    if gen.has_flags('variable','active power'):
-                        self.Hphi_nnz = self.Hphi_nnz+1
-            self.bus_counted[index] = True
+        # Generators in the order visited by C GEN_COST
+        gens = []
+        counted = np.zeros(net.num_buses,dtype=bool)
+        for branch in net.branches:
+            if branch.is_on_outage():
+                continue
+            for bus in [branch.bus_k,branch.bus_m]:
+                if not counted[bus.index]:
+                    gens.extend(bus.generators)
+                counted[bus.index] = True
+
+        self.gen_indices = np.array([gen.index for gen in gens],dtype=int)
+        self.gen_var = np.array([gen.has_flags('variable','active power') for gen in gens],dtype=bool)
+        self.gen_index_P = np.array([gen.index_P for gen in gens],dtype=int).reshape((len(gens),T))
+        self.gen_Q = np.array([[gen.cost_coeff_Q0,gen.cost_coeff_Q1,gen.cost_coeff_Q2]
+                               for gen in gens]).reshape((len(gens),3))
+        self.Hphi_nnz = np.sum(self.gen_var)*T
         
     def allocate(self):
 
@@ -45,46 +56,26 @@ class DummyGenCost(CustomFunction):
         self.phi = 0
         self.gphi[:] = 0
         self.Hphi_nnz = 0
-        self.bus_counted[:] = False
                 
-    def analyze_step(self,branch,t):
-        
+    def analyze_batch(self):
+
         T = self.network.num_periods
-        buses = [branch.bus_k,branch.bus_m]
-        
-        if branch.is_on_outage():
-            return
+        index_P = self.gen_index_P[self.gen_var,:].T.ravel()
+        Q2 = self.gen_Q[self.gen_var,2]
 
-        for bus in buses:
-            index = bus.index*T+t
-            if not self.bus_counted[index]:
-                for gen in bus.generators:
-                    if gen.has_flags('variable','active power'):
-                        self.Hphi.row[self.Hphi_nnz] = gen.index_P[t]
-                        self.Hphi.col[self.Hphi_nnz] = gen.index_P[t]
-                        self.Hphi.data[self.Hphi_nnz] = 2.*gen.cost_coeff_Q2
-                        self.Hphi_nnz = self.Hphi_nnz+1
-            self.bus_counted[index] = True
+        Hphi = self.Hphi
+        Hphi.row[:] = index_P
+        Hphi.col[:] = index_P
+        Hphi.data[:] = np.tile(2.*Q2,T)
+        self.Hphi_nnz = index_P.size
 
-    def eval_step(self,branch,t,x):
+    def eval_batch(self,x):
 
-        T = self.network.num_periods
-        buses = [branch.bus_k,branch.bus_m]
-        
-        if branch.is_on_outage():
-            return
+        var = self.gen_var
+        index_P = self.gen_index_P[var,:]
+        Q0,Q1,Q2 = [q[:,np.newaxis] for q in self.gen_Q.T]
 
-        for bus in buses:
-            index = bus.index*T+t
-            if not self.bus_counted[index]:
-                for gen in bus.generators:
-                    Q0 = gen.cost_coeff_Q0
-                    Q1 = gen.cost_coeff_Q1
-                    Q2 = gen.cost_coeff_Q2
-                    if gen.has_flags('variable','active power'):
-                        P = x[gen.index_P[t]]
-                        self.gphi[gen.index_P[t]] = Q1+2.*Q2*P
-                    else:
-                        P = gen.P[t]
-                    self.phi = self.phi + Q0+Q1*P+Q2*(P**2.)
-            self.bus_counted[index] = True
+        P = self.network.get_series('generator','P')[self.gen_indices,:]
+        P[var,:] = x[index_P]
+        self.gphi[index_P] = (Q1+2.*Q2*P)[var,:]
+        self.phi = self.phi + np.sum(Q0+Q1*P+Q2*(P**2.))
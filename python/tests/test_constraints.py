@@ -5138,6 +5138,42 @@ class TestConstraints(unittest.TestCase):
             constr.H_nnz[10] = 2
             self.assertEqual(H_nnz[10],2)
             
+    def test_constr_FLOW_LIM_active_set(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,2)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            x = net.get_var_values()
+
+            for name in ['AC branch flow limits','DC branch flow limits']:
+
+                full = pf.Constraint(name,net)
+                full.analyze()
+
+                p = pf.Problem(net)
+                constr = pf.Constraint(name,net)
+                constr.set_active_set(True)
+                self.assertTrue(constr.has_active_set)
+                p.add_constraint(constr)
+                p.analyze()
+                self.assertEqual(p.G.shape[0],0)
+                self.assertEqual(p.num_extra_vars,0)
+
+                # Outer iterations
+                num = p.screen_branches(x,0.5)
+                self.assertEqual(constr.num_active_branches,num)
+                p.analyze()
+                self.assertLessEqual(p.G.shape[0],full.G.shape[0])
+                p.screen_branches(fraction=-1.)
+                self.assertEqual(p.screen_branches(fraction=-1.),0)
+                p.analyze()
+                self.assertTupleEqual(p.G.shape,full.G.shape)
+                self.assertEqual(p.J.nnz,full.J.nnz)
+                self.assertLess(norm(p.u-full.u),1e-12)
+
+            self.assertRaises(pf.ConstraintError,pf.Constraint('DC power balance',net).set_active_set,True)
+
     def tearDown(self):
 
         pass
@@ -615,7 +615,7 @@ class TestContingency(unittest.TestCase):
             phi_base = func.phi
             gphi_base = func.gphi.copy()
             Hphi_base = func.Hphi.copy()
-            self.assertEqual(phi_base,gen_cost_base)
+            self.assertLess(np.abs(phi_base-gen_cost_base),1e-8)
             self.assertTupleEqual(gphi_base.shape,(net.num_vars,))
             self.assertEqual(Hphi_base.nnz,net.num_vars)
 
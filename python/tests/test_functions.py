@@ -2195,6 +2195,67 @@ class TestFunctions(unittest.TestCase):
                     phi += gen.cost_coeff_Q0+gen.cost_coeff_Q1*P+gen.cost_coeff_Q2*P*P
             self.assertLess(abs(func.phi-phi),1e-8*(1.+np.abs(phi)))
 
+    def test_func_DUMMY_steps(self):
+
+        class StepGenCost(pf.CustomFunction):
+
+            def init(self):
+                self.name = "step generation cost"
+
+            def count_step(self,branch,t):
+                if branch.is_on_outage():
+                    return
+                for bus in [branch.bus_k,branch.bus_m]:
+                    index = bus.index*self.network.num_periods+t
+                    if not self.bus_counted[index]:
+                        self.Hphi_nnz = self.Hphi_nnz+len(bus.generators)
+                    self.bus_counted[index] = True
+
+            def allocate(self):
+                nnz = self.Hphi_nnz
+                num_vars = self.network.num_vars
+                self.set_gphi(np.zeros(num_vars))
+                self.set_Hphi(coo_matrix((np.zeros(nnz),(nnz*[0],nnz*[0])),
+                                         shape=(num_vars,num_vars)))
+
+            def clear(self):
+                self.phi = 0
+                self.gphi[:] = 0
+                self.Hphi_nnz = 0
+                self.bus_counted[:] = False
+
+            def eval_step(self,branch,t,x):
+                if branch.is_on_outage():
+                    return
+                for bus in [branch.bus_k,branch.bus_m]:
+                    index = bus.index*self.network.num_periods+t
+                    if not self.bus_counted[index]:
+                        for gen in bus.generators:
+                            P = x[gen.index_P[t]]
+                            self.gphi[gen.index_P[t]] = gen.cost_coeff_Q1+2.*gen.cost_coeff_Q2*P
+                            self.phi = self.phi+gen.cost_coeff_Q0+gen.cost_coeff_Q1*P+gen.cost_coeff_Q2*(P**2.)
+                    self.bus_counted[index] = True
+
+        # Multiperiod
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,self.T)
+            net.set_flags('generator',
+                          'variable',
+                          'any',
+                          'active power')
+            x0 = net.get_var_values()+np.random.randn(net.num_vars)*1e-2
+
+            # Step and batch protocols
+            funcS = StepGenCost(1.,net)
+            funcB = pf.functions.DummyGenCost(1.,net)
+            for func in [funcS,funcB]:
+                func.analyze()
+                func.eval(x0)
+            self.assertEqual(funcS.Hphi_nnz,funcB.Hphi_nnz)
+            self.assertLess(abs(funcS.phi-funcB.phi),1e-8*(1.+abs(funcB.phi)))
+            self.assertTrue(np.all(funcS.gphi == funcB.gphi))
+
     def tearDown(self):
 
         pass
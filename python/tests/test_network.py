@@ -4315,7 +4315,134 @@ class TestNetwork(unittest.TestCase):
 
             # Compare
             pf.tests.utils.compare_networks(self, orig_net, copy_net)            
+
+    def test_var_ordering(self):
+
+        for case in test_cases.CASES:
+
+            net_nat = pf.Parser(case).parse(case,self.T)
+            self.assertEqual(net_nat.var_ordering,'natural')
+
+            for ordering in ['rcm','amd']:
+
+                net = pf.Parser(case).parse(case,self.T)
+                net.set_var_ordering(ordering)
+                self.assertEqual(net.var_ordering,ordering)
+
+                for n in [net,net_nat]:
+                    n.clear_flags()
+                    n.set_flags('generator','variable','any','active power')
+                    n.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+
+                self.assertEqual(net.num_vars,net_nat.num_vars)
+                perm = net.var_permutation
+                self.assertEqual(perm.size,net.num_vars)
+                self.assertTrue(np.all(np.sort(perm) == np.arange(net.num_vars)))
+
+                x = net.get_var_values()
+                x_nat = net_nat.get_var_values()
+                self.assertTrue(np.all(x[perm] == x_nat))
+
+                for bus, bus_nat in zip(net.buses,net_nat.buses):
+                    self.assertTrue(np.all(perm[bus_nat.index_v_mag] == bus.index_v_mag))
+                    self.assertTrue(np.all(perm[bus_nat.index_v_ang] == bus.index_v_ang))
+
+                self.assertRaises(KeyError,net.set_var_ordering,'foo')
+
+    def test_reduction(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,self.T)
+
+            red = pf.Reduction(net,3)
+            rnet = red.network
+            self.assertEqual(rnet.num_buses+red.num_eliminated_buses,net.num_buses)
+            self.assertEqual(rnet.num_generators,net.num_generators)
+            self.assertEqual(rnet.num_loads,net.num_loads)
+            self.assertTrue(np.all(red.bus_map[red.eliminated_buses] == -1))
+
+            for bus in rnet.buses:
+                bus.v_mag = 1.+0.01*((bus.index+np.arange(self.T))%7)
+                bus.v_ang = 0.02*((3*bus.index+np.arange(self.T))%5)
+            red.expand()
+            net.update_properties()
+            rnet.update_properties()
+
+            for bus in net.buses:
+                i = red.bus_map[bus.index]
+                if i < 0:
+                    self.assertLess(np.max(np.abs(bus.P_mismatch)),1e-8)
+                    self.assertLess(np.max(np.abs(bus.Q_mismatch)),1e-8)
+                else:
+                    rbus = rnet.get_bus(i)
+                    self.assertLess(np.max(np.abs(bus.P_mismatch-rbus.P_mismatch)),1e-8)
+                    self.assertLess(np.max(np.abs(bus.Q_mismatch-rbus.Q_mismatch)),1e-8)
             
+    def test_load_profiles(self):
+
+        import os
+        import tempfile
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,self.T)
+            if net.num_loads == 0 or net.num_generators == 0:
+                continue
+            net.add_var_generators(net.get_load_buses(),50.,30.,5.)
+
+            load = net.get_load(0)
+            gen = net.get_generator(net.num_generators-1)
+            vargen = net.get_var_generator(0)
+            P = np.arange(self.T)+1.
+            Q = np.arange(self.T)+2.
+
+            f = tempfile.NamedTemporaryFile(mode='w',suffix='.csv',delete=False)
+            f.write('# profiles\n')
+            f.write('t,load:%d:P,load:%d:Q,vargen:%d:P_ava,gen:%d:P\n' %(load.index,load.index,vargen.index,gen.index))
+            for t in range(self.T):
+                f.write('%d,%.4f,%.4f,%.4f,%.4f\n' %(t,P[t],Q[t],0.5*P[t],0.1*P[t]))
+            f.close()
+
+            net.load_profiles(f.name)
+            self.assertTrue(np.all(load.P == P))
+            self.assertTrue(np.all(load.Q == Q))
+            self.assertTrue(np.all(vargen.P_ava == 0.5*P))
+            self.assertLess(np.max(np.abs(gen.P-0.1*P)),1e-12)
+
+            f = open(f.name,'w')
+            f.write('t,gen:0:Q\n0,1.\n')
+            f.close()
+            self.assertRaises(pf.NetworkError,net.load_profiles,f.name)
+            net.clear_error()
+            os.remove(f.name)
+            self.assertRaises(pf.NetworkError,net.load_profiles,f.name)
+            net.clear_error()
+
+    def test_series(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,self.T)
+
+            v_mag = net.get_series('bus','v_mag')
+            self.assertTupleEqual(v_mag.shape,(net.num_buses,self.T))
+            for bus in net.buses:
+                self.assertTrue(np.all(v_mag[bus.index,:] == bus.v_mag))
+
+            sens = net.get_series('bus','sens_P_balance')
+            self.assertTupleEqual(sens.shape,(net.num_buses,self.T))
+
+            Q = np.random.randn(net.num_generators,self.T)
+            net.set_series('generator','Q',Q)
+            for gen in net.generators:
+                self.assertTrue(np.all(gen.Q == Q[gen.index,:]))
+            self.assertTrue(np.all(net.get_series('generator','Q') == Q))
+
+            self.assertRaises(pf.NetworkError,net.get_series,'generator','v_mag')
+            net.clear_error()
+            self.assertRaises(pf.NetworkError,net.set_series,'generator','Q',np.zeros(1))
+
     def tearDown(self):
 
         pass
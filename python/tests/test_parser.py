@@ -584,3 +584,42 @@ class TestParser(unittest.TestCase):
             finally:
                 
                 os.remove("temp_json.json")
+
+    def test_bin_parser(self):
+
+        import os
+
+        for case in test_cases.CASES:
+
+            T = 3
+
+            net = pf.Parser(case).parse(case,T)
+            self.assertEqual(net.num_periods,T)
+
+            # Set flags
+            net.set_flags('generator','variable','any','active power')
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            net.set_flags('bus','fixed','slack','voltage angle')
+
+            # Add vargens and betteries
+            net.add_var_generators(net.get_load_buses(),100.,50.,30.,5,0.05)
+            net.add_batteries(net.get_generator_buses(),20.,50.)
+
+            try:
+
+                bin_parser = pf.ParserBIN()
+
+                bin_parser.write(net,"temp_bin.pfb")
+
+                new_net = bin_parser.parse("temp_bin.pfb")
+                self.assertEqual(new_net.num_periods,T)
+
+                # Compare
+                pf.tests.utils.compare_networks(self, net, new_net)
+                self.assertEqual(new_net.num_vars,net.num_vars)
+                self.assertEqual(new_net.num_fixed,net.num_fixed)
+                self.assertTrue(np.all(new_net.get_var_values() == net.get_var_values()))
+
+            finally:
+
+                os.remove("temp_bin.pfb")
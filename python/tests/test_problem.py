@@ -17,6 +17,47 @@ NUM_TRIALS = 25
 EPS = 3.5 # %
 TOL = 1e-4
 
+class BilinearConstraint(pf.CustomConstraint):
+    """
+    Products of voltage magnitudes and angles of buses, with J but no H.
+    """
+
+    def init(self):
+
+        self.name = "bilinear"
+
+    def count_batch(self):
+
+        net = self.network
+        self.i_mag = np.array([bus.index_v_mag for bus in net.buses],dtype=int)
+        self.i_ang = np.array([bus.index_v_ang for bus in net.buses],dtype=int)
+
+    def allocate(self):
+
+        n = self.i_mag.size
+        rows = np.concatenate((np.arange(n),np.arange(n)))
+        cols = np.concatenate((self.i_mag,self.i_ang))
+        num_vars = self.network.num_vars
+
+        self.set_b(np.zeros(0))
+        self.set_A(coo_matrix((0,num_vars)))
+        self.set_f(np.zeros(n))
+        self.set_J(coo_matrix((np.zeros(2*n),(rows,cols)),shape=(n,num_vars)))
+        self.set_l(np.zeros(0))
+        self.set_u(np.zeros(0))
+        self.set_G(coo_matrix((0,num_vars)))
+
+    def clear(self):
+
+        pass
+
+    def eval_batch(self, x, y=None):
+
+        n = self.i_mag.size
+        self.f[:] = x[self.i_mag]*x[self.i_ang]
+        self.J.data[:n] = x[self.i_ang]
+        self.J.data[n:] = x[self.i_mag]
+
 class TestProblem(unittest.TestCase):
     
     def setUp(self):
@@ -1371,6 +1412,385 @@ class TestProblem(unittest.TestCase):
             self.assertTupleEqual(A.shape,(A_size,net.num_vars))
             self.assertEqual(A.nnz,A_nnz)
 
+    def test_problem_shift_periods(self):
+
+        T = 4
+        for case in test_cases.CASES:
+
+            nets = [pf.Parser(case).parse(case,T) for i in range(2)]
+            probs = []
+            for i, net in enumerate(nets):
+                for load in net.loads:
+                    load.P = load.P*(1.+0.1*np.minimum(np.arange(T)+i,T-1))
+                net.set_flags('bus','variable','not slack','voltage angle')
+                net.set_flags('generator',['variable','bounded'],'any','active power')
+                p = pf.Problem(net)
+                p.add_constraint(pf.Constraint('DC power balance',net))
+                p.add_constraint(pf.Constraint('variable bounds',net))
+                p.add_function(pf.Function('generation cost',1.,net))
+                p.analyze()
+                probs.append(p)
+
+            A_nnz = probs[0].A.nnz
+            probs[0].shift_periods(1)
+            for load0, load1 in zip(nets[0].loads,nets[1].loads):
+                self.assertLess(np.max(np.abs(load0.P-load1.P)),1e-12)
+            self.assertEqual(probs[0].A.nnz,A_nnz)
+            self.assertLess(np.max(np.abs(probs[0].b-probs[1].b)),1e-10)
+            self.assertLess(np.max(np.abs(probs[0].l-probs[1].l)),1e-10)
+            self.assertLess(np.max(np.abs(probs[0].u-probs[1].u)),1e-10)
+
+    def test_problem_threads(self):
+
+        import threading
+
+        for case in test_cases.CASES:
+
+            nets = [pf.Parser(case).parse(case) for i in range(2)]
+            probs = []
+            for net in nets:
+                net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+                p = pf.Problem(net)
+                p.add_constraint(pf.Constraint('AC power balance',net))
+                p.add_function(pf.Function('voltage magnitude regularization',1.,net))
+                probs.append(p)
+            x = nets[0].get_var_values()
+
+            def work(p):
+                p.analyze()
+                for i in range(5):
+                    p.eval(x)
+                    p.combine_H(np.ones(p.f.size))
+                p.network.update_properties(x)
+
+            threads = [threading.Thread(target=work,args=(p,)) for p in probs]
+            for th in threads:
+                th.start()
+            for th in threads:
+                th.join()
+
+            self.assertLess(norm(probs[0].f-probs[1].f),1e-12)
+            self.assertLess(abs(probs[0].phi-probs[1].phi),1e-12)
+            self.assertEqual(probs[0].H_combined.nnz,probs[1].H_combined.nnz)
+            self.assertLess(norm(probs[0].H_combined.data-probs[1].H_combined.data),1e-12)
+
+    def test_problem_cached_matrices(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            net.set_flags('generator','variable','any',['active power','reactive power'])
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_constraint(pf.Constraint('DC power balance',net))
+            p.add_function(pf.Function('generation cost',1.,net))
+            p.analyze()
+
+            # Same objects until next analysis
+            J = p.J
+            self.assertTrue(J is p.J)
+            self.assertTrue(p.A is p.A)
+            self.assertTrue(p.get_matrix('J') is J)
+            x = p.get_init_point()+np.random.randn(p.get_num_primal_variables())*1e-2
+            p.eval(x)
+            p.combine_H(np.ones(p.f.size))
+            self.assertTrue(J is p.J)
+            self.assertTrue(np.all(J.data == p.get_matrix('J').data))
+
+            # Compressed formats
+            for name in ['A','J','Hphi','H_combined']:
+                M = getattr(p,name)
+                for fmt in ['csr','csc']:
+                    C = p.get_matrix(name,fmt)
+                    self.assertEqual(C.format,fmt)
+                    self.assertTrue(C is p.get_matrix(name,fmt))
+                    self.assertTupleEqual(C.shape,M.shape)
+                    self.assertLess(np.max(np.abs((C-M).toarray()),initial=0.),1e-8)
+            p.eval(x+1e-2)
+            C = p.get_matrix('J','csr')
+            self.assertLess(np.max(np.abs((C-p.J).toarray()),initial=0.),1e-8)
+            self.assertRaises(pf.ProblemError,p.get_matrix,'K')
+            self.assertRaises(pf.ProblemError,p.get_matrix,'J','dok')
+
+            # New objects after analysis
+            p.analyze()
+            self.assertFalse(J is p.J)
+
+    def test_problem_periods(self):
+
+        T = 3
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,T)
+            net.add_batteries(net.get_generator_buses(),20.,40.,0.8,0.7)
+            net.set_flags('bus','variable','not slack','voltage angle')
+            net.set_flags('generator',['variable','bounded'],'any','active power')
+            net.set_flags('battery','variable','any',['charging power','energy level'])
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('DC power balance',net))
+            p.add_constraint(pf.Constraint('variable bounds',net))
+            p.add_constraint(pf.Constraint('generator ramp limits',net))
+            p.add_constraint(pf.Constraint('battery dynamics',net))
+            p.add_function(pf.Function('generation cost',1.,net))
+            p.analyze()
+            self.assertEqual(p.coupling_constraints,[])
+            self.assertRaises(pf.ProblemError,p.get_period_major_matrix,'A')
+
+            p.set_period_decomposition(True)
+            p.analyze()
+            self.assertEqual(p.coupling_constraints,['generator ramp limits','battery dynamics'])
+            for gen in net.generators:
+                self.assertTrue(np.all(p.var_periods[gen.index_P] == np.arange(T)))
+            col_ptr = np.concatenate(([0],np.cumsum(np.bincount(p.var_periods,minlength=T))))
+
+            # Diagonal blocks
+            for name in ['A','G','Hphi']:
+                M,nnz_ptr = p.get_period_major_matrix(name)
+                self.assertEqual(nnz_ptr.size,T+2)
+                self.assertEqual(nnz_ptr[-1],getattr(p,name).nnz)
+                self.assertLess(abs(np.sum(M.data)-np.sum(getattr(p,name).data)),1e-8)
+                for t in range(T):
+                    col = M.col[nnz_ptr[t]:nnz_ptr[t+1]]
+                    self.assertTrue(np.all((col >= col_ptr[t]) & (col < col_ptr[t+1])))
+                self.assertEqual(nnz_ptr[T+1] > nnz_ptr[T],name != 'Hphi')
+            self.assertRaises(pf.ProblemError,p.get_period_major_matrix,'K')
+
+            # Extra variables
+            net.set_flags('bus','variable','not slack','voltage magnitude')
+            net.set_flags('generator','variable','regulator','reactive power')
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_constraint(pf.Constraint('voltage regulation by generators',net))
+            p.set_period_decomposition(True)
+            p.analyze()
+            self.assertEqual(p.coupling_constraints,[])
+            self.assertTrue(np.all(p.J_row_periods >= 0))
+            self.assertTrue(np.all(p.var_periods[net.num_vars:] >= 0))
+            self.assertTrue(np.all(p.J_row_periods[p.J.row] == p.var_periods[p.J.col]))
+
+    def test_problem_simple_bounds(self):
+
+        T = 2
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,T)
+            net.add_batteries(net.get_generator_buses(),20.,40.,0.8,0.7)
+            net.set_flags('bus',['variable','bounded'],'any','voltage magnitude')
+            net.set_flags('bus','variable','any','voltage angle')
+            net.set_flags('generator',['variable','bounded'],'any',['active power','reactive power'])
+            net.set_flags('branch','variable','tap changer','tap ratio')
+            net.set_flags('battery',['variable','bounded'],'any',['charging power','energy level'])
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('variable bounds',net))
+            p.add_constraint(pf.Constraint('AC branch flow limits',net))
+            p.analyze()
+            self.assertEqual(p.x_l.size,0)
+            self.assertEqual(p.x_u.size,0)
+            G = p.G.copy()
+            l = p.l.copy()
+            u = p.u.copy()
+
+            p.set_simple_bounds(True)
+            p.analyze()
+            n = p.get_num_primal_variables()
+            self.assertEqual(p.G.shape[0],G.shape[0]-net.num_vars)
+            self.assertEqual(p.G.nnz,G.nnz-net.num_vars)
+            self.assertEqual(p.x_l.size,n)
+            self.assertEqual(p.x_u.size,n)
+            self.assertTrue(np.all(p.x_l <= p.x_u))
+
+            # Same bounds as rows of G
+            rows = G.row[G.data == 1.]
+            cols = G.col[G.data == 1.]
+            self.assertTrue(np.all(p.x_l[cols] == l[rows]))
+            self.assertTrue(np.all(p.x_u[cols] == u[rows]))
+
+    def test_problem_duplicate_compaction(self):
+
+        T = 2
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,T)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            net.set_flags('generator','variable','any',['active power','reactive power'])
+            net.set_flags('branch','variable','any',['tap ratio','phase shift'])
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_function(pf.Function('generation cost',1.,net))
+            p.add_function(pf.Function('voltage angle regularization',1.,net))
+            p.analyze()
+
+            n = p.get_num_primal_variables()
+            x = p.get_init_point()+np.random.randn(n)*1e-2
+            lam = np.random.randn(p.J.shape[0])
+            p.eval(x)
+            p.combine_H(lam)
+            J = p.J.copy()
+            Hphi = p.Hphi.copy()
+            H = p.H_combined.copy()
+
+            p.set_duplicate_compaction(True)
+            p.analyze()
+            p.eval(x)
+            p.combine_H(lam)
+            self.assertLess(p.H_combined.nnz,H.nnz)
+            for M,M0 in [(p.J,J),(p.Hphi,Hphi),(p.H_combined,H)]:
+                self.assertEqual(M.shape,M0.shape)
+                self.assertLessEqual(M.nnz,M0.nnz)
+                self.assertEqual(M.nnz,M.tocsr().nnz)
+                self.assertLess(norm((M-M0).tocsr().data),1e-10*(1.+norm(M0.data)))
+
+    def test_problem_estimates(self):
+
+        T = 2
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,T)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            net.set_flags('generator','variable','any',['active power','reactive power'])
+            net.set_flags('branch','variable','any','tap ratio')
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_function(pf.Function('generation cost',1.,net))
+            p.add_function(pf.Function('voltage angle regularization',3.,net))
+            p.set_coloring(True)
+            p.set_duplicate_compaction(True)
+            p.analyze()
+
+            n = p.get_num_primal_variables()
+            self.assertEqual(p.J_colors.size,n)
+            self.assertEqual(p.H_colors.size,n)
+            self.assertGreater(p.num_J_colors,0)
+            self.assertLess(p.num_J_colors,n)
+            self.assertGreater(p.num_H_colors,0)
+            self.assertLess(p.num_H_colors,n)
+            self.assertEqual(np.max(p.J_colors),p.num_J_colors-1)
+            self.assertEqual(np.max(p.H_colors),p.num_H_colors-1)
+
+            # No two columns of the same color in a row
+            J = p.J.tocsr()
+            for i in range(0,J.shape[0],10):
+                cols = J.indices[J.indptr[i]:J.indptr[i+1]]
+                self.assertEqual(np.unique(p.J_colors[cols]).size,cols.size)
+
+            x = p.get_init_point()+np.random.randn(n)*1e-2
+            lam = np.random.randn(p.J.shape[0])
+            v = np.random.randn(n)
+
+            Jest = p.estimate_J(x)
+            Hest = p.estimate_H(x,lam)
+            p.combine_H(lam)
+            self.assertTrue(np.all(Jest.row == p.J.row))
+            self.assertTrue(np.all(Jest.col == p.J.col))
+            self.assertLess(np.max(np.abs(Jest.data-p.J.data)/(1.+np.abs(p.J.data))),1e-3)
+            self.assertTrue(np.all(Hest.row >= Hest.col))
+            H = p.Hphi+p.H_combined
+            H = H + H.T - triu(H)
+            Hest = Hest + Hest.T - triu(Hest)
+            self.assertLess(norm(Hest*v-H*v),1e-3*(1.+norm(H*v)))
+
+            # Bad sizes
+            self.assertRaises(pf.ProblemError,p.estimate_H,x,lam[:-1])
+            p.clear_error()
+
+            # Constraint with J but no H
+            net = pf.Parser(case).parse(case)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            p = pf.Problem(net)
+            p.add_constraint(BilinearConstraint(net))
+            p.set_coloring(True)
+            p.analyze()
+            self.assertEqual(p.H_combined.nnz,0)
+            self.assertEqual(p.num_H_colors,2)
+
+            n = p.get_num_primal_variables()
+            x = p.get_init_point()+np.random.randn(n)*1e-2
+            lam = np.random.randn(p.J.shape[0])
+            v = np.random.randn(n)
+
+            Hest = p.estimate_H(x,lam)
+            rows = np.array([bus.index_v_mag for bus in net.buses])
+            cols = np.array([bus.index_v_ang for bus in net.buses])
+            H = coo_matrix((lam,(rows,cols)),shape=(n,n))
+            H = H + H.T
+            Hest = Hest + Hest.T - triu(Hest)
+            self.assertLess(norm(Hest*v-H*v),1e-4*(1.+norm(H*v)))
+
+    def test_problem_Jv(self):
+
+        T = 2
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,T)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            net.set_flags('generator','variable','any',['active power','reactive power'])
+            net.set_flags('branch','variable','tap changer','tap ratio')
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_constraint(pf.Constraint('AC branch flow limits',net))
+            p.analyze()
+
+            n = p.get_num_primal_variables()
+            x = p.get_init_point()+np.random.randn(n)*1e-2
+            v = np.random.randn(n)
+            y = np.random.randn(p.J.shape[0])
+
+            Jv = p.Jv(x,v)
+            JTy = p.JTy(x,y)
+            p.eval(x)
+            self.assertEqual(Jv.size,p.J.shape[0])
+            self.assertEqual(JTy.size,n)
+            self.assertLess(np.linalg.norm(Jv-p.J*v),1e-8*(1.+np.linalg.norm(Jv)))
+            self.assertLess(np.linalg.norm(JTy-p.J.T*y),1e-8*(1.+np.linalg.norm(JTy)))
+
+            # Bad sizes
+            self.assertRaises(pf.ProblemError,p.Jv,x,v[:-1])
+            p.clear_error()
+            self.assertRaises(pf.ProblemError,p.JTy,x,y[:-1])
+            p.clear_error()
+
+    def test_problem_Hv(self):
+
+        T = 2
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,T)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+            net.set_flags('generator','variable','any',['active power','reactive power'])
+            net.set_flags('load','variable','any','active power')
+            net.set_flags('branch','variable','any',['tap ratio','phase shift'])
+            for br in net.branches:
+                if br.ratingA == 0.:
+                    br.ratingA = 1.
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_constraint(pf.Constraint('AC branch flow limits',net))
+            p.add_function(pf.Function('generation cost',1.,net))
+            p.add_function(pf.Function('consumption utility',0.5,net))
+            p.add_function(pf.Function('voltage magnitude regularization',2.,net))
+            p.add_function(pf.Function('voltage angle regularization',3.,net))
+            p.analyze()
+
+            n = p.get_num_primal_variables()
+            x = p.get_init_point()+np.random.randn(n)*1e-2
+            lam = np.random.randn(p.J.shape[0])
+            v = np.random.randn(n)
+
+            Hv = p.Hv(x,lam,v)
+            p.eval(x)
+            p.combine_H(lam)
+            H = p.Hphi+p.H_combined
+            H = H + H.T - triu(H)
+            self.assertEqual(Hv.size,n)
+            self.assertLess(np.linalg.norm(Hv-H*v),1e-8*(1.+np.linalg.norm(Hv)))
+
+            # Bad sizes
+            self.assertRaises(pf.ProblemError,p.Hv,x,lam[:-1],v)
+            p.clear_error()
+            self.assertRaises(pf.ProblemError,p.Hv,x,lam,v[:-1])
+            p.clear_error()
+
     def tearDown(self):
         
         pass
@@ -30,6 +30,28 @@ void MAT_add_to_dentry(Mat* m, int index, REAL value) {
     m->data[index] += value;
 }
 
+void MAT_add_sym_mul_vec(Mat* m, REAL coeff, REAL* v, REAL* w) {
+  /** Adds to w the product of coeff, the symmetric matrix with
+   *  triangular part m, and v. Off-diagonal entries of m count for
+   *  both (i,j) and (j,i).
+   */
+
+  int k;
+  int i;
+  int j;
+
+  if (!m || !v || !w || coeff == 0.)
+    return;
+
+  for (k = 0; k < m->nnz; k++) {
+    i = m->row[k];
+    j = m->col[k];
+    w[i] += coeff*m->data[k]*v[j];
+    if (i != j)
+      w[j] += coeff*m->data[k]*v[i];
+  }
+}
+
 void MAT_array_del(Mat* m, int size) {
   int i;
   if (m) {
@@ -67,6 +89,92 @@ void MAT_array_set_zero_d(Mat* m, int size) {
   }
 }
 
+int MAT_color_columns(Mat* m, int* colors) {
+  /** Colors the columns of m greedily so that columns with entries in
+   *  a common row have different colors (distance-2 coloring of the
+   *  bipartite graph of rows and columns). Fills colors (of size size2
+   *  of m) with the color of each column, or -1 for columns without
+   *  entries, and returns the number of colors.
+   */
+
+  // Local variables
+  int* row_ptr;
+  int* row_cols;
+  int* col_ptr;
+  int* col_rows;
+  int* forbidden;
+  int num_colors;
+  int color;
+  int i;
+  int j;
+  int k;
+  int r;
+  int q;
+
+  // Check
+  if (!m || !colors)
+    return 0;
+
+  // Allocate
+  ARRAY_zalloc(row_ptr,int,m->size1+1);
+  ARRAY_alloc(row_cols,int,m->nnz);
+  ARRAY_zalloc(col_ptr,int,m->size2+1);
+  ARRAY_alloc(col_rows,int,m->nnz);
+  ARRAY_alloc(forbidden,int,m->size2+1);
+
+  // Compressed rows and columns
+  for (k = 0; k < m->nnz; k++) {
+    row_ptr[m->row[k]+1]++;
+    col_ptr[m->col[k]+1]++;
+  }
+  for (i = 0; i < m->size1; i++)
+    row_ptr[i+1] += row_ptr[i];
+  for (j = 0; j < m->size2; j++)
+    col_ptr[j+1] += col_ptr[j];
+  for (k = 0; k < m->nnz; k++) {
+    row_cols[row_ptr[m->row[k]]++] = m->col[k];
+    col_rows[col_ptr[m->col[k]]++] = m->row[k];
+  }
+  for (i = m->size1; i > 0; i--)
+    row_ptr[i] = row_ptr[i-1];
+  row_ptr[0] = 0;
+  for (j = m->size2; j > 0; j--)
+    col_ptr[j] = col_ptr[j-1];
+  col_ptr[0] = 0;
+
+  // Greedy
+  num_colors = 0;
+  for (j = 0; j < m->size2+1; j++)
+    forbidden[j] = -1;
+  for (j = 0; j < m->size2; j++)
+    colors[j] = -1;
+  for (j = 0; j < m->size2; j++) {
+    if (col_ptr[j] == col_ptr[j+1])
+      continue;
+    for (r = col_ptr[j]; r < col_ptr[j+1]; r++) {
+      i = col_rows[r];
+      for (q = row_ptr[i]; q < row_ptr[i+1]; q++) {
+	if (colors[row_cols[q]] >= 0)
+	  forbidden[colors[row_cols[q]]] = j;
+      }
+    }
+    for (color = 0; forbidden[color] == j; color++);
+    colors[j] = color;
+    if (color+1 > num_colors)
+      num_colors = color+1;
+  }
+
+  // Clean up
+  free(row_ptr);
+  free(row_cols);
+  free(col_ptr);
+  free(col_rows);
+  free(forbidden);
+
+  // Return
+  return num_colors;
+}
+
 Mat* MAT_copy(Mat* m) {
 
   Mat* newm;
@@ -181,6 +289,91 @@ Mat* MAT_new(int size1, int size2, int nnz) {
   return m;
 }
 
+Mat* MAT_new_compact(Mat* m, int* map) {
+  /** Creates matrix with the distinct (i,j) pairs of m in order of
+   *  first appearance and data equal to the sum of the duplicates.
+   *  Fills map (of size nnz of m) with the index in the new matrix
+   *  of each entry of m.
+   */
+
+  // Local variables
+  Mat* newm;
+  int* row_ptr;
+  int* slots;
+  int* first;
+  int* mark_row;
+  int* mark_slot;
+  int nnz;
+  int i;
+  int j;
+  int k;
+  int r;
+
+  // Check
+  if (!m || !map)
+    return NULL;
+
+  // Allocate
+  ARRAY_zalloc(row_ptr,int,m->size1+1);
+  ARRAY_alloc(slots,int,m->nnz);
+  ARRAY_alloc(first,int,m->nnz);
+  ARRAY_alloc(mark_row,int,m->size2);
+  ARRAY_alloc(mark_slot,int,m->size2);
+  for (j = 0; j < m->size2; j++)
+    mark_row[j] = -1;
+
+  // Group entries by row (stable)
+  for (k = 0; k < m->nnz; k++)
+    row_ptr[m->row[k]+1]++;
+  for (i = 0; i < m->size1; i++)
+    row_ptr[i+1] += row_ptr[i];
+  for (k = 0; k < m->nnz; k++)
+    slots[row_ptr[m->row[k]]++] = k;
+  for (i = m->size1; i > 0; i--)
+    row_ptr[i] = row_ptr[i-1];
+  row_ptr[0] = 0;
+
+  // First appearance of each pair
+  for (i = 0; i < m->size1; i++) {
+    for (r = row_ptr[i]; r < row_ptr[i+1]; r++) {
+      k = slots[r];
+      j = m->col[k];
+      if (mark_row[j] != i) {
+	mark_row[j] = i;
+	mark_slot[j] = k;
+      }
+      first[k] = mark_slot[j];
+    }
+  }
+
+  // Map
+  nnz = 0;
+  for (k = 0; k < m->nnz; k++) {
+    if (first[k] == k)
+      map[k] = nnz++;
+    else
+      map[k] = map[first[k]];
+  }
+
+  // New matrix
+  newm = MAT_new(m->size1,m->size2,nnz);
+  for (k = 0; k < m->nnz; k++) {
+    newm->row[map[k]] = m->row[k];
+    newm->col[map[k]] = m->col[k];
+    newm->data[map[k]] += m->data[k];
+  }
+
+  // Clean up
+  free(row_ptr);
+  free(slots);
+  free(first);
+  free(mark_row);
+  free(mark_slot);
+
+  // Return
+  return newm;
+}
+
 Mat* MAT_new_from_arrays(int size1, int size2, int nnz, int* row, int* col, REAL* data) {
   Mat* m = (Mat*)malloc(sizeof(Mat));
   MAT_init(m);
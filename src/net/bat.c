@@ -216,6 +216,20 @@ int BAT_get_num_periods(Bat* bat) {
     return 0;
 }
 
+REAL* BAT_get_series(Bat* bat, char* name) {
+  /** Returns the battery time series (array of length num_periods)
+   *  with the given name, e.g. "P", or NULL if there is no such series.
+   */
+  if (!bat || !name)
+    return NULL;
+  if (strcmp(name,"P") == 0)
+    return bat->P;
+  else if (strcmp(name,"E") == 0)
+    return bat->E;
+  else
+    return NULL;
+}
+
 char BAT_get_obj_type(void* bat) {
   if (bat)
     return OBJ_BAT;
@@ -507,48 +521,56 @@ Vec* BAT_get_var_indices(void* vbat, unsigned char var, int t_start, int t_end)
 char* BAT_get_json_string(Bat* bat, char* output) {
 
   // Local variables
-  char temp[BAT_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;
+  JSON_Writer* writer;
+  size_t len;
 
   // No battery
   if (!bat)
     return NULL;
 
+  // Write
+  writer = JSON_WRITER_new();
+  BAT_write_json(bat,writer);
+
   // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*BAT_BUFFER_SIZE*BAT_NUM_JSON_FIELDS*bat->num_periods);
-    resize = TRUE;
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
   }
-  output_start = output;
-
-  // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",bat->index,FALSE);
-  JSON_obj(temp,output,"bus",bat->bus,BUS_get_index,FALSE);
-  JSON_int(temp,output,"num_periods",bat->num_periods,FALSE);
-  JSON_str(temp,output,"name",bat->name,FALSE);
-  JSON_array_float(temp,output,"P",bat->P,bat->num_periods,FALSE);
-  JSON_float(temp,output,"P_max",bat->P_max,FALSE);
-  JSON_float(temp,output,"P_min",bat->P_min,FALSE);
-  JSON_float(temp,output,"eta_c",bat->eta_c,FALSE);
-  JSON_float(temp,output,"eta_d",bat->eta_d,FALSE);
-  JSON_array_float(temp,output,"E",bat->E,bat->num_periods,FALSE);
-  JSON_float(temp,output,"E_init",bat->E_init,FALSE);
-  JSON_float(temp,output,"E_final",bat->E_final,FALSE);
-  JSON_float(temp,output,"E_max",bat->E_max,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void BAT_write_json(Bat* bat, JSON_Writer* writer) {
+  /** Writes battery as json object. */
+
+  // No battery
+  if (!bat)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",bat->index,FALSE);
+  JSON_obj(writer,"bus",bat->bus,BUS_get_index,FALSE);
+  JSON_int(writer,"num_periods",bat->num_periods,FALSE);
+  JSON_str(writer,"name",bat->name,FALSE);
+  JSON_array_float(writer,"P",bat->P,bat->num_periods,FALSE);
+  JSON_float(writer,"P_max",bat->P_max,FALSE);
+  JSON_float(writer,"P_min",bat->P_min,FALSE);
+  JSON_float(writer,"eta_c",bat->eta_c,FALSE);
+  JSON_float(writer,"eta_d",bat->eta_d,FALSE);
+  JSON_array_float(writer,"E",bat->E,bat->num_periods,FALSE);
+  JSON_float(writer,"E_init",bat->E_init,FALSE);
+  JSON_float(writer,"E_final",bat->E_final,FALSE);
+  JSON_float(writer,"E_max",bat->E_max,TRUE);
+  JSON_end(writer);
+}
+
 BOOL BAT_has_flags(void* vbat, char flag_type, unsigned char mask) {
   Bat* bat = (Bat*)vbat;
   if (bat) {
@@ -781,3 +803,20 @@ void BAT_propagate_data_in_time(Bat* bat, int start, int end) {
   }
 }
 
+void BAT_shift_periods(Bat* bat, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period. The energy level at
+   *  the beginning of the new first period becomes the initial energy level.
+   */
+  int t;
+  int s;
+  if (bat && k > 0 && bat->num_periods > 0) {
+    bat->E_init = bat->E[k < bat->num_periods ? k : bat->num_periods-1];
+    for (t = 0; t < bat->num_periods; t++) {
+      s = t+k < bat->num_periods ? t+k : bat->num_periods-1;
+      bat->P[t] = bat->P[s];
+      bat->E[t] = bat->E[s];
+    }
+  }
+}
+
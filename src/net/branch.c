@@ -68,6 +68,9 @@ struct Branch {
   char bounded;          /**< @brief Flags for indicating which quantities should be bounded */
   char sparse;           /**< @brief Flags for indicating which control adjustments should be sparse */
 
+  // Network
+  int* topology_version; /**< @brief Topology version of the network of the branch (NULL if none) */
+
   // Indices
   int index;          /**< @brief Branch index */
   int* index_ratio;   /**< @brief Taps ratio index */
@@ -293,6 +296,34 @@ int BRANCH_get_num_periods(Branch* br) {
     return 0;
 }
 
+REAL* BRANCH_get_series(Branch* br, char* name) {
+  /** Returns the branch time series (array of length num_periods)
+   *  with the given name, e.g. "ratio", or NULL if there is no such series.
+   */
+  if (!br || !name)
+    return NULL;
+  if (strcmp(name,"ratio") == 0)
+    return br->ratio;
+  else if (strcmp(name,"phase") == 0)
+    return br->phase;
+  else if (strcmp(name,"sens_P_u_bound") == 0)
+    return br->sens_P_u_bound;
+  else if (strcmp(name,"sens_P_l_bound") == 0)
+    return br->sens_P_l_bound;
+  else if (strcmp(name,"sens_ratio_u_bound") == 0)
+    return br->sens_ratio_u_bound;
+  else if (strcmp(name,"sens_ratio_l_bound") == 0)
+    return br->sens_ratio_l_bound;
+  else if (strcmp(name,"sens_phase_u_bound") == 0)
+    return br->sens_phase_u_bound;
+  else if (strcmp(name,"sens_phase_l_bound") == 0)
+    return br->sens_phase_l_bound;
+  else if (strcmp(name,"sens_i_mag_u_bound") == 0)
+    return br->sens_i_mag_u_bound;
+  else
+    return NULL;
+}
+
 char BRANCH_get_type(Branch* br) {
   if (br)
     return br->type;
@@ -1183,59 +1214,67 @@ Vec* BRANCH_get_var_indices(void* vbr, unsigned char var, int t_start, int t_end
 char* BRANCH_get_json_string(Branch* branch, char* output) {
 
   // Local variables
-  char temp[BRANCH_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;
+  JSON_Writer* writer;
+  size_t len;
 
   // No branch
   if (!branch)
     return NULL;
 
+  // Write
+  writer = JSON_WRITER_new();
+  BRANCH_write_json(branch,writer);
+
   // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*BRANCH_BUFFER_SIZE*BRANCH_NUM_JSON_FIELDS*branch->num_periods);
-    resize = TRUE;
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
   }
-  output_start = output;
-  
-  // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",branch->index,FALSE);
-  JSON_int(temp,output,"type",branch->type,FALSE);
-  JSON_int(temp,output,"num_periods",branch->num_periods,FALSE);
-  JSON_str(temp,output,"name",branch->name,FALSE);
-  JSON_obj(temp,output,"bus_k",branch->bus_k,BUS_get_index,FALSE);
-  JSON_obj(temp,output,"bus_m",branch->bus_m,BUS_get_index,FALSE);
-  JSON_obj(temp,output,"reg_bus",branch->reg_bus,BUS_get_index,FALSE);
-  JSON_float(temp,output,"g",branch->g,FALSE);
-  JSON_float(temp,output,"g_k",branch->g_k,FALSE);
-  JSON_float(temp,output,"g_m",branch->g_m,FALSE);
-  JSON_float(temp,output,"b",branch->b,FALSE);
-  JSON_float(temp,output,"b_k",branch->b_k,FALSE);
-  JSON_float(temp,output,"b_m",branch->b_m,FALSE);
-  JSON_array_float(temp,output,"ratio",branch->ratio,branch->num_periods,FALSE);
-  JSON_float(temp,output,"ratio_max",branch->ratio_max,FALSE);
-  JSON_float(temp,output,"ratio_min",branch->ratio_min,FALSE);
-  JSON_array_float(temp,output,"phase",branch->phase,branch->num_periods,FALSE);
-  JSON_float(temp,output,"phase_max",branch->phase_max,FALSE);
-  JSON_float(temp,output,"phase_min",branch->phase_min,FALSE);
-  JSON_float(temp,output,"ratingA",branch->ratingA,FALSE);
-  JSON_float(temp,output,"ratingB",branch->ratingB,FALSE);
-  JSON_float(temp,output,"ratingC",branch->ratingC,FALSE);
-  JSON_bool(temp,output,"outage",branch->outage,FALSE);
-  JSON_bool(temp,output,"pos_ratio_v_sens",branch->pos_ratio_v_sens,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void BRANCH_write_json(Branch* branch, JSON_Writer* writer) {
+  /** Writes branch as json object. */
+
+  // No branch
+  if (!branch)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",branch->index,FALSE);
+  JSON_int(writer,"type",branch->type,FALSE);
+  JSON_int(writer,"num_periods",branch->num_periods,FALSE);
+  JSON_str(writer,"name",branch->name,FALSE);
+  JSON_obj(writer,"bus_k",branch->bus_k,BUS_get_index,FALSE);
+  JSON_obj(writer,"bus_m",branch->bus_m,BUS_get_index,FALSE);
+  JSON_obj(writer,"reg_bus",branch->reg_bus,BUS_get_index,FALSE);
+  JSON_float(writer,"g",branch->g,FALSE);
+  JSON_float(writer,"g_k",branch->g_k,FALSE);
+  JSON_float(writer,"g_m",branch->g_m,FALSE);
+  JSON_float(writer,"b",branch->b,FALSE);
+  JSON_float(writer,"b_k",branch->b_k,FALSE);
+  JSON_float(writer,"b_m",branch->b_m,FALSE);
+  JSON_array_float(writer,"ratio",branch->ratio,branch->num_periods,FALSE);
+  JSON_float(writer,"ratio_max",branch->ratio_max,FALSE);
+  JSON_float(writer,"ratio_min",branch->ratio_min,FALSE);
+  JSON_array_float(writer,"phase",branch->phase,branch->num_periods,FALSE);
+  JSON_float(writer,"phase_max",branch->phase_max,FALSE);
+  JSON_float(writer,"phase_min",branch->phase_min,FALSE);
+  JSON_float(writer,"ratingA",branch->ratingA,FALSE);
+  JSON_float(writer,"ratingB",branch->ratingB,FALSE);
+  JSON_float(writer,"ratingC",branch->ratingC,FALSE);
+  JSON_bool(writer,"outage",branch->outage,FALSE);
+  JSON_bool(writer,"pos_ratio_v_sens",branch->pos_ratio_v_sens,TRUE);
+  JSON_end(writer);
+}
+
 BOOL BRANCH_has_pos_ratio_v_sens(Branch* branch) {
   if (branch)
     return branch->pos_ratio_v_sens;
@@ -1322,6 +1361,7 @@ void BRANCH_init(Branch* br, int num_periods) {
 
   br->outage = FALSE;
   br->pos_ratio_v_sens = TRUE;
+  br->topology_version = NULL;
   br->vars = 0x00;
   br->fixed = 0x00;
   br->bounded = 0x00;
@@ -1507,19 +1547,35 @@ void BRANCH_set_index(Branch* br, int index) {
     br->index = index;
 }
 
+void BRANCH_set_topology_version(Branch* br, int* version) {
+  /** Sets the topology version counter of the network of the branch.
+   *  It is incremented whenever the outage flag or the buses of the
+   *  branch change, so the network can tell that its adjacency index
+   *  is out of date.
+   */
+  if (br)
+    br->topology_version = version;
+}
+
 void BRANCH_set_type(Branch* br, int type) {
   if (br)
     br->type = type;
 }
 
 void BRANCH_set_bus_k(Branch* br, Bus* bus_k) {
-  if (br)
+  if (br) {
+    if (br->bus_k != bus_k && br->topology_version)
+      (*(br->topology_version))++;
     br->bus_k = bus_k;
+  }
 }
 
 void BRANCH_set_bus_m(Branch* br, Bus* bus_m) {
-  if (br)
+  if (br) {
+    if (br->bus_m != bus_m && br->topology_version)
+      (*(br->topology_version))++;
     br->bus_m = bus_m;
+  }
 }
 
 void BRANCH_set_reg_bus(Branch* br, Bus* reg_bus) {
@@ -1578,8 +1634,11 @@ void BRANCH_set_pos_ratio_v_sens(Branch* br, BOOL flag) {
 }
 
 void BRANCH_set_outage(Branch* br, BOOL outage) {
-  if (br)
+  if (br) {
+    if (br->outage != outage && br->topology_version)
+      (*(br->topology_version))++;
     br->outage = outage;
+  }
 }
 
 void BRANCH_set_phase(Branch* br, REAL phase, int t) {
@@ -1715,3 +1774,18 @@ void BRANCH_propagate_data_in_time(Branch* br, int start, int end) {
     }
   }
 }
+
+void BRANCH_shift_periods(Branch* br, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period.
+   */
+  int t;
+  int s;
+  if (br && k > 0 && br->num_periods > 0) {
+    for (t = 0; t < br->num_periods; t++) {
+      s = t+k < br->num_periods ? t+k : br->num_periods-1;
+      br->ratio[t] = br->ratio[s];
+      br->phase[t] = br->phase[s];
+    }
+  }
+}
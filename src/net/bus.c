@@ -542,6 +542,46 @@ int BUS_get_num_periods(Bus* bus) {
     return 0;
 }
 
+REAL* BUS_get_series(Bus* bus, char* name) {
+  /** Returns the bus time series (array of length num_periods)
+   *  with the given name, e.g. "v_mag", or NULL if there is no such series.
+   */
+  if (!bus || !name)
+    return NULL;
+  if (strcmp(name,"v_mag") == 0)
+    return bus->v_mag;
+  else if (strcmp(name,"v_ang") == 0)
+    return bus->v_ang;
+  else if (strcmp(name,"v_set") == 0)
+    return bus->v_set;
+  else if (strcmp(name,"price") == 0)
+    return bus->price;
+  else if (strcmp(name,"sens_P_balance") == 0)
+    return bus->sens_P_balance;
+  else if (strcmp(name,"sens_Q_balance") == 0)
+    return bus->sens_Q_balance;
+  else if (strcmp(name,"sens_v_mag_u_bound") == 0)
+    return bus->sens_v_mag_u_bound;
+  else if (strcmp(name,"sens_v_mag_l_bound") == 0)
+    return bus->sens_v_mag_l_bound;
+  else if (strcmp(name,"sens_v_ang_u_bound") == 0)
+    return bus->sens_v_ang_u_bound;
+  else if (strcmp(name,"sens_v_ang_l_bound") == 0)
+    return bus->sens_v_ang_l_bound;
+  else if (strcmp(name,"sens_v_reg_by_gen") == 0)
+    return bus->sens_v_reg_by_gen;
+  else if (strcmp(name,"sens_v_reg_by_tran") == 0)
+    return bus->sens_v_reg_by_tran;
+  else if (strcmp(name,"sens_v_reg_by_shunt") == 0)
+    return bus->sens_v_reg_by_shunt;
+  else if (strcmp(name,"P_mis") == 0)
+    return bus->P_mis;
+  else if (strcmp(name,"Q_mis") == 0)
+    return bus->Q_mis;
+  else
+    return NULL;
+}
+
 int BUS_get_num_gens(Bus* bus) {
   if (bus)
     return GEN_list_len(bus->gen);
@@ -1277,63 +1317,71 @@ REAL BUS_get_quantity(Bus* bus, int qtype, int t) {
 }
 
 char* BUS_get_json_string(Bus* bus, char* output) {
-  
+
   // Local variables
-  char temp[BUS_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;
+  JSON_Writer* writer;
+  size_t len;
 
   // No bus
   if (!bus)
     return NULL;
 
+  // Write
+  writer = JSON_WRITER_new();
+  BUS_write_json(bus,writer);
+
   // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*BUS_BUFFER_SIZE*BUS_NUM_JSON_FIELDS*bus->num_periods);
-    resize = TRUE;
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
   }
-  output_start = output;
-  
-  // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",bus->index,FALSE);
-  JSON_int(temp,output,"number",bus->number,FALSE);
-  JSON_str(temp,output,"name",bus->name,FALSE);
-  JSON_int(temp,output,"num_periods",bus->num_periods,FALSE);
-  JSON_float(temp,output,"v_base",bus->v_base,FALSE);
-  JSON_array_float(temp,output,"v_mag",bus->v_mag,bus->num_periods,FALSE);
-  JSON_array_float(temp,output,"v_ang",bus->v_ang,bus->num_periods,FALSE);
-  JSON_array_float(temp,output,"v_set",bus->v_set,bus->num_periods,FALSE);
-  JSON_float(temp,output,"v_max_reg",bus->v_max_reg,FALSE);
-  JSON_float(temp,output,"v_min_reg",bus->v_min_reg,FALSE);
-  JSON_float(temp,output,"v_max_norm",bus->v_max_norm,FALSE);
-  JSON_float(temp,output,"v_min_norm",bus->v_min_norm,FALSE);
-  JSON_float(temp,output,"v_max_emer",bus->v_max_emer,FALSE);
-  JSON_float(temp,output,"v_min_emer",bus->v_min_emer,FALSE);
-  JSON_bool(temp,output,"slack",bus->slack,FALSE);
-  JSON_array_float(temp,output,"price",bus->price,bus->num_periods,FALSE);
-  JSON_list_int(temp,output,"generators",bus,Gen,BUS_get_gen,GEN_get_index,GEN_get_next,FALSE);
-  JSON_list_int(temp,output,"reg_generators",bus,Gen,BUS_get_reg_gen,GEN_get_index,GEN_get_reg_next,FALSE);
-  JSON_list_int(temp,output,"loads",bus,Load,BUS_get_load,LOAD_get_index,LOAD_get_next,FALSE);
-  JSON_list_int(temp,output,"shunts",bus,Shunt,BUS_get_shunt,SHUNT_get_index,SHUNT_get_next,FALSE);
-  JSON_list_int(temp,output,"reg_shunts",bus,Shunt,BUS_get_reg_shunt,SHUNT_get_index,SHUNT_get_reg_next,FALSE);
-  JSON_list_int(temp,output,"branches_k",bus,Branch,BUS_get_branch_k,BRANCH_get_index,BRANCH_get_next_k,FALSE);
-  JSON_list_int(temp,output,"branches_m",bus,Branch,BUS_get_branch_m,BRANCH_get_index,BRANCH_get_next_m,FALSE);
-  JSON_list_int(temp,output,"reg_transformers",bus,Branch,BUS_get_reg_tran,BRANCH_get_index,BRANCH_get_reg_next,FALSE);
-  JSON_list_int(temp,output,"var_generators",bus,Vargen,BUS_get_vargen,VARGEN_get_index,VARGEN_get_next,FALSE);
-  JSON_list_int(temp,output,"batteries",bus,Bat,BUS_get_bat,BAT_get_index,BAT_get_next,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void BUS_write_json(Bus* bus, JSON_Writer* writer) {
+  /** Writes bus as json object. */
+
+  // No bus
+  if (!bus)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",bus->index,FALSE);
+  JSON_int(writer,"number",bus->number,FALSE);
+  JSON_str(writer,"name",bus->name,FALSE);
+  JSON_int(writer,"num_periods",bus->num_periods,FALSE);
+  JSON_float(writer,"v_base",bus->v_base,FALSE);
+  JSON_array_float(writer,"v_mag",bus->v_mag,bus->num_periods,FALSE);
+  JSON_array_float(writer,"v_ang",bus->v_ang,bus->num_periods,FALSE);
+  JSON_array_float(writer,"v_set",bus->v_set,bus->num_periods,FALSE);
+  JSON_float(writer,"v_max_reg",bus->v_max_reg,FALSE);
+  JSON_float(writer,"v_min_reg",bus->v_min_reg,FALSE);
+  JSON_float(writer,"v_max_norm",bus->v_max_norm,FALSE);
+  JSON_float(writer,"v_min_norm",bus->v_min_norm,FALSE);
+  JSON_float(writer,"v_max_emer",bus->v_max_emer,FALSE);
+  JSON_float(writer,"v_min_emer",bus->v_min_emer,FALSE);
+  JSON_bool(writer,"slack",bus->slack,FALSE);
+  JSON_array_float(writer,"price",bus->price,bus->num_periods,FALSE);
+  JSON_list_int(writer,"generators",bus,Gen,BUS_get_gen,GEN_get_index,GEN_get_next,FALSE);
+  JSON_list_int(writer,"reg_generators",bus,Gen,BUS_get_reg_gen,GEN_get_index,GEN_get_reg_next,FALSE);
+  JSON_list_int(writer,"loads",bus,Load,BUS_get_load,LOAD_get_index,LOAD_get_next,FALSE);
+  JSON_list_int(writer,"shunts",bus,Shunt,BUS_get_shunt,SHUNT_get_index,SHUNT_get_next,FALSE);
+  JSON_list_int(writer,"reg_shunts",bus,Shunt,BUS_get_reg_shunt,SHUNT_get_index,SHUNT_get_reg_next,FALSE);
+  JSON_list_int(writer,"branches_k",bus,Branch,BUS_get_branch_k,BRANCH_get_index,BRANCH_get_next_k,FALSE);
+  JSON_list_int(writer,"branches_m",bus,Branch,BUS_get_branch_m,BRANCH_get_index,BRANCH_get_next_m,FALSE);
+  JSON_list_int(writer,"reg_transformers",bus,Branch,BUS_get_reg_tran,BRANCH_get_index,BRANCH_get_reg_next,FALSE);
+  JSON_list_int(writer,"var_generators",bus,Vargen,BUS_get_vargen,VARGEN_get_index,VARGEN_get_next,FALSE);
+  JSON_list_int(writer,"batteries",bus,Bat,BUS_get_bat,BAT_get_index,BAT_get_next,TRUE);
+  JSON_end(writer);
+}
+
 BOOL BUS_has_flags(void* vbus, char flag_type, unsigned char mask) {
   Bus* bus = (Bus*)vbus;
   if (bus) {
@@ -1791,3 +1839,20 @@ void BUS_propagate_data_in_time(Bus* bus, int start, int end) {
     }
   }
 }
+
+void BUS_shift_periods(Bus* bus, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period.
+   */
+  int t;
+  int s;
+  if (bus && k > 0 && bus->num_periods > 0) {
+    for (t = 0; t < bus->num_periods; t++) {
+      s = t+k < bus->num_periods ? t+k : bus->num_periods-1;
+      bus->v_mag[t] = bus->v_mag[s];
+      bus->v_ang[t] = bus->v_ang[s];
+      bus->v_set[t] = bus->v_set[s];
+      bus->price[t] = bus->price[s];
+    }
+  }
+}
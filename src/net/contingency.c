@@ -135,6 +135,9 @@ void CONT_apply(Cont* cont, Net* net) {
       if (BRANCH_get_type(br) != BRANCH_TYPE_LINE)
 	BRANCH_set_type(br,BRANCH_TYPE_TRAN_FIXED);
     }
+
+    // Topology
+    NET_clear_adjacency(net);
   }
 }
 
@@ -214,6 +217,9 @@ void CONT_clear(Cont* cont, Net* net) {
       // Clear flag
       bo->applied = FALSE;
     }
+
+    // Topology
+    NET_clear_adjacency(net);
   }
 }
 
@@ -385,9 +391,8 @@ char* CONT_get_json_string(Cont* cont) {
   // Local vars
   Gen_outage* go;
   Branch_outage* bo;
+  JSON_Writer* writer;
   char* output;
-  char* output_start;
-  char temp[CONT_BUFFER_SIZE];
   int* indices;
   int num;
 
@@ -395,12 +400,9 @@ char* CONT_get_json_string(Cont* cont) {
   if (!cont)
     return NULL;
 
-  // Output
-  output = (char*)malloc(sizeof(char)*CONT_BUFFER_SIZE*5);
-  output_start = output;
-
   // Write
-  JSON_start(output);
+  writer = JSON_WRITER_new();
+  JSON_start(writer);
 
   // Gen outages
   num = 0;
@@ -412,7 +414,7 @@ char* CONT_get_json_string(Cont* cont) {
     indices[num] = go->gen_index;
     num++;
   }
-  JSON_array_int(temp,output,"generator_outages",indices,num,FALSE);
+  JSON_array_int(writer,"generator_outages",indices,num,FALSE);
   free(indices);
 
   // Branch outages
@@ -425,14 +427,15 @@ char* CONT_get_json_string(Cont* cont) {
     indices[num] = bo->br_index;
     num++;
   }
-  JSON_array_int(temp,output,"branch_outages",indices,num,TRUE);
+  JSON_array_int(writer,"branch_outages",indices,num,TRUE);
   free(indices);
 
   // End
-  JSON_end(output);
+  JSON_end(writer);
 
-  // Resize
-  output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  // Output
+  output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
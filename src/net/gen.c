@@ -244,6 +244,28 @@ int GEN_get_num_periods(Gen* gen) {
     return 0;
 }
 
+REAL* GEN_get_series(Gen* gen, char* name) {
+  /** Returns the generator time series (array of length num_periods)
+   *  with the given name, e.g. "P", or NULL if there is no such series.
+   */
+  if (!gen || !name)
+    return NULL;
+  if (strcmp(name,"P") == 0)
+    return gen->P;
+  else if (strcmp(name,"Q") == 0)
+    return gen->Q;
+  else if (strcmp(name,"sens_P_u_bound") == 0)
+    return gen->sens_P_u_bound;
+  else if (strcmp(name,"sens_P_l_bound") == 0)
+    return gen->sens_P_l_bound;
+  else if (strcmp(name,"sens_Q_u_bound") == 0)
+    return gen->sens_Q_u_bound;
+  else if (strcmp(name,"sens_Q_l_bound") == 0)
+    return gen->sens_Q_l_bound;
+  else
+    return NULL;
+}
+
 REAL GEN_get_sens_P_u_bound(Gen* gen, int t) {
   if (gen && t >= 0 && t < gen->num_periods)
     return gen->sens_P_u_bound[t];
@@ -599,52 +621,60 @@ Vec* GEN_get_var_indices(void* vgen, unsigned char var, int t_start, int t_end)
 char* GEN_get_json_string(Gen* gen, char* output) {
 
   // Local variables
-  char temp[GEN_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;
+  JSON_Writer* writer;
+  size_t len;
 
   // No gen
   if (!gen)
     return NULL;
 
+  // Write
+  writer = JSON_WRITER_new();
+  GEN_write_json(gen,writer);
+
   // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*GEN_BUFFER_SIZE*GEN_NUM_JSON_FIELDS*gen->num_periods);
-    resize = TRUE;
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
   }
-  output_start = output;
-
-  // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",gen->index,FALSE);
-  JSON_obj(temp,output,"bus",gen->bus,BUS_get_index,FALSE);
-  JSON_obj(temp,output,"reg_bus",gen->reg_bus,BUS_get_index,FALSE);
-  JSON_int(temp,output,"num_periods",gen->num_periods,FALSE);
-  JSON_str(temp,output,"name",gen->name,FALSE);
-  JSON_bool(temp,output,"outage",gen->outage,FALSE);
-  JSON_array_float(temp,output,"P",gen->P,gen->num_periods,FALSE);
-  JSON_float(temp,output,"P_max",gen->P_max,FALSE);
-  JSON_float(temp,output,"P_min",gen->P_min,FALSE);
-  JSON_float(temp,output,"dP_max",gen->dP_max,FALSE);
-  JSON_float(temp,output,"P_prev",gen->P_prev,FALSE);
-  JSON_array_float(temp,output,"Q",gen->Q,gen->num_periods,FALSE);
-  JSON_float(temp,output,"Q_max",gen->Q_max,FALSE);
-  JSON_float(temp,output,"Q_min",gen->Q_min,FALSE);
-  JSON_float(temp,output,"cost_coeff_Q0",gen->cost_coeff_Q0,FALSE);
-  JSON_float(temp,output,"cost_coeff_Q1",gen->cost_coeff_Q1,FALSE);
-  JSON_float(temp,output,"cost_coeff_Q2",gen->cost_coeff_Q2,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void GEN_write_json(Gen* gen, JSON_Writer* writer) {
+  /** Writes generator as json object. */
+
+  // No gen
+  if (!gen)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",gen->index,FALSE);
+  JSON_obj(writer,"bus",gen->bus,BUS_get_index,FALSE);
+  JSON_obj(writer,"reg_bus",gen->reg_bus,BUS_get_index,FALSE);
+  JSON_int(writer,"num_periods",gen->num_periods,FALSE);
+  JSON_str(writer,"name",gen->name,FALSE);
+  JSON_bool(writer,"outage",gen->outage,FALSE);
+  JSON_array_float(writer,"P",gen->P,gen->num_periods,FALSE);
+  JSON_float(writer,"P_max",gen->P_max,FALSE);
+  JSON_float(writer,"P_min",gen->P_min,FALSE);
+  JSON_float(writer,"dP_max",gen->dP_max,FALSE);
+  JSON_float(writer,"P_prev",gen->P_prev,FALSE);
+  JSON_array_float(writer,"Q",gen->Q,gen->num_periods,FALSE);
+  JSON_float(writer,"Q_max",gen->Q_max,FALSE);
+  JSON_float(writer,"Q_min",gen->Q_min,FALSE);
+  JSON_float(writer,"cost_coeff_Q0",gen->cost_coeff_Q0,FALSE);
+  JSON_float(writer,"cost_coeff_Q1",gen->cost_coeff_Q1,FALSE);
+  JSON_float(writer,"cost_coeff_Q2",gen->cost_coeff_Q2,TRUE);
+  JSON_end(writer);
+}
+
 BOOL GEN_has_flags(void* vgen, char flag_type, unsigned char mask) {
   Gen* gen = (Gen*)vgen;
   if (gen) {
@@ -987,3 +1017,20 @@ void GEN_propagate_data_in_time(Gen* gen, int start, int end) {
   }
 }
 
+void GEN_shift_periods(Gen* gen, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period. The active power of
+   *  the period before the new first one becomes the previous active power.
+   */
+  int t;
+  int s;
+  if (gen && k > 0 && gen->num_periods > 0) {
+    gen->P_prev = gen->P[(k < gen->num_periods ? k : gen->num_periods)-1];
+    for (t = 0; t < gen->num_periods; t++) {
+      s = t+k < gen->num_periods ? t+k : gen->num_periods-1;
+      gen->P[t] = gen->P[s];
+      gen->Q[t] = gen->Q[s];
+    }
+  }
+}
+
@@ -232,6 +232,28 @@ int LOAD_get_num_periods(Load* load) {
     return 0;
 }
 
+REAL* LOAD_get_series(Load* load, char* name) {
+  /** Returns the load time series (array of length num_periods)
+   *  with the given name, e.g. "P", or NULL if there is no such series.
+   */
+  if (!load || !name)
+    return NULL;
+  if (strcmp(name,"P") == 0)
+    return load->P;
+  else if (strcmp(name,"P_max") == 0)
+    return load->P_max;
+  else if (strcmp(name,"P_min") == 0)
+    return load->P_min;
+  else if (strcmp(name,"Q") == 0)
+    return load->Q;
+  else if (strcmp(name,"sens_P_u_bound") == 0)
+    return load->sens_P_u_bound;
+  else if (strcmp(name,"sens_P_l_bound") == 0)
+    return load->sens_P_l_bound;
+  else
+    return NULL;
+}
+
 REAL LOAD_get_power_factor(Load* load, int t) {
   REAL S;
   if (load && t >= 0 && t < load->num_periods) {
@@ -532,47 +554,55 @@ Vec* LOAD_get_var_indices(void* vload, unsigned char var, int t_start, int t_end
 char* LOAD_get_json_string(Load* load, char* output) {
 
   // Local variables
-  char temp[LOAD_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;
+  JSON_Writer* writer;
+  size_t len;
 
   // No load
   if (!load)
     return NULL;
 
+  // Write
+  writer = JSON_WRITER_new();
+  LOAD_write_json(load,writer);
+
   // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*LOAD_BUFFER_SIZE*LOAD_NUM_JSON_FIELDS*load->num_periods);
-    resize = TRUE;
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
   }
-  output_start = output;
-  
-  // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",load->index,FALSE);
-  JSON_obj(temp,output,"bus",load->bus,BUS_get_index,FALSE);
-  JSON_int(temp,output,"num_periods",load->num_periods,FALSE);
-  JSON_str(temp,output,"name",load->name,FALSE);
-  JSON_array_float(temp,output,"P",load->P,load->num_periods,FALSE);
-  JSON_array_float(temp,output,"P_max",load->P_max,load->num_periods,FALSE);
-  JSON_array_float(temp,output,"P_min",load->P_min,load->num_periods,FALSE);
-  JSON_array_float(temp,output,"Q",load->Q,load->num_periods,FALSE);
-  JSON_float(temp,output,"target_power_factor",load->target_power_factor,FALSE);
-  JSON_float(temp,output,"util_coeff_Q0",load->util_coeff_Q0,FALSE);
-  JSON_float(temp,output,"util_coeff_Q1",load->util_coeff_Q1,FALSE);
-  JSON_float(temp,output,"util_coeff_Q2",load->util_coeff_Q2,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void LOAD_write_json(Load* load, JSON_Writer* writer) {
+  /** Writes load as json object. */
+
+  // No load
+  if (!load)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",load->index,FALSE);
+  JSON_obj(writer,"bus",load->bus,BUS_get_index,FALSE);
+  JSON_int(writer,"num_periods",load->num_periods,FALSE);
+  JSON_str(writer,"name",load->name,FALSE);
+  JSON_array_float(writer,"P",load->P,load->num_periods,FALSE);
+  JSON_array_float(writer,"P_max",load->P_max,load->num_periods,FALSE);
+  JSON_array_float(writer,"P_min",load->P_min,load->num_periods,FALSE);
+  JSON_array_float(writer,"Q",load->Q,load->num_periods,FALSE);
+  JSON_float(writer,"target_power_factor",load->target_power_factor,FALSE);
+  JSON_float(writer,"util_coeff_Q0",load->util_coeff_Q0,FALSE);
+  JSON_float(writer,"util_coeff_Q1",load->util_coeff_Q1,FALSE);
+  JSON_float(writer,"util_coeff_Q2",load->util_coeff_Q2,TRUE);
+  JSON_end(writer);
+}
+
 BOOL LOAD_has_flags(void* vload, char flag_type, unsigned char mask) {
   Load* load = (Load*)vload;
   if (load) {
@@ -832,3 +862,20 @@ void LOAD_propagate_data_in_time(Load* load, int start, int end) {
   }
 }
 
+void LOAD_shift_periods(Load* load, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period.
+   */
+  int t;
+  int s;
+  if (load && k > 0 && load->num_periods > 0) {
+    for (t = 0; t < load->num_periods; t++) {
+      s = t+k < load->num_periods ? t+k : load->num_periods-1;
+      load->P[t] = load->P[s];
+      load->P_max[t] = load->P_max[s];
+      load->P_min[t] = load->P_min[s];
+      load->Q[t] = load->Q[s];
+    }
+  }
+}
+
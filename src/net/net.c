@@ -11,6 +11,7 @@
 #include <pfnet/net.h>
 #include <pfnet/array.h>
 #include <pfnet/json_macros.h>
+#include <pfnet/profiles.h>
 #include <pfnet/pfnet_config.h>
 
 struct Net {
@@ -84,6 +85,21 @@ struct Net {
   REAL vargen_corr_radius; /**< @brief Correlation radius for variable generators. **/
   REAL vargen_corr_value;  /**< @brief Correlation value for variable generators. **/
 
+  // Topology
+  int* adj_ptr;       /**< @brief Offsets of each bus into the adjacency arrays (size num_buses+1). */
+  int* adj_branch;    /**< @brief Indices of branches incident to each bus (not on outage). */
+  int* adj_bus;       /**< @brief Indices of buses adjacent to each bus through adj_branch. */
+  BOOL adj_valid;     /**< @brief Flag for indicating that the adjacency arrays are up to date. */
+  int topology_version; /**< @brief Counter incremented by branches when their outage flag or buses change. */
+  int adj_version;    /**< @brief Value of topology_version when the adjacency arrays were built. */
+  int* bus_island;    /**< @brief Connected component (island) index of each bus. */
+  int num_islands;    /**< @brief Number of connected components (islands). */
+
+  // Variable ordering
+  int var_ordering;   /**< @brief Ordering of variable indices (NET_ORDER_*). */
+  int* var_perm;      /**< @brief Current index of each variable given its index in order of flag calls. */
+  int num_var_perm;   /**< @brief Size of the var_perm array. */
+
   // Utils
   char* bus_counted;  /**< @brief Flags for processing buses */
 };
@@ -357,6 +373,14 @@ BOOL NET_check(Net* net, BOOL verbose) {
 
 }
 
+void NET_clear_adjacency(Net* net) {
+  /** Marks the bus-branch adjacency arrays as out of date.
+   *  They are rebuilt the next time they are needed.
+   */
+  if (net)
+    net->adj_valid = FALSE;
+}
+
 void NET_clear_data(Net* net) {
 
   // No net
@@ -395,6 +419,15 @@ void NET_clear_data(Net* net) {
   free(net->load_P_vio);
   free(net->num_actions);
 
+  // Free topology
+  free(net->adj_ptr);
+  free(net->adj_branch);
+  free(net->adj_bus);
+  free(net->bus_island);
+
+  // Free variable ordering
+  free(net->var_perm);
+
   // Free utils
   free(net->bus_counted);
 
@@ -491,6 +524,11 @@ void NET_clear_flags(Net* net) {
   net->num_fixed = 0;
   net->num_bounded = 0;
   net->num_sparse = 0;
+
+  // Clear variable permutation
+  free(net->var_perm);
+  net->var_perm = NULL;
+  net->num_var_perm = 0;
 }
 
 void NET_clear_outages(Net* net) {
@@ -509,6 +547,9 @@ void NET_clear_outages(Net* net) {
   // Branches
   for (i = 0; i < net->num_branches; i++)
     BRANCH_set_outage(NET_get_branch(net,i),FALSE);
+
+  // Topology
+  NET_clear_adjacency(net);
 }
 
 void NET_clear_properties(Net* net) {
@@ -664,6 +705,16 @@ void NET_copy_from_net(Net* net, Net* other_net) {
   net->num_bounded = other_net->num_bounded;
   net->num_sparse = other_net->num_sparse;  
 
+  // Variable ordering
+  free(net->var_perm);
+  net->var_ordering = other_net->var_ordering;
+  net->num_var_perm = other_net->num_var_perm;
+  net->var_perm = NULL;
+  if (other_net->var_perm) {
+    ARRAY_alloc(net->var_perm,int,net->num_var_perm);
+    memcpy(net->var_perm,other_net->var_perm,net->num_var_perm*sizeof(int));
+  }
+
   // Buses
   for (i = 0; i < net->num_buses; i++) {
     bus = NET_get_bus(net,i);
@@ -680,6 +731,9 @@ void NET_copy_from_net(Net* net, Net* other_net) {
     BRANCH_copy_from_branch(branch,other_branch);
   }
 
+  // Topology (outages may have changed)
+  net->adj_valid = FALSE;
+
   // Generators
   for (i = 0; i < net->num_gens; i++) {  
     gen = NET_get_gen(net,i);
@@ -876,18 +930,21 @@ int NET_get_bus_neighbors(Net* net, Bus* bus, int spread, int* neighbors, char*
    */
 
   // Local variables
-  Bus* bus1;
-  Bus* bus2;
-  Branch* br;
   int neighbors_total;
   int neighbors_curr;
   int num_new;
+  int bus1;
+  int bus2;
   int i;
+  int j;
 
   // Check
-  if (!neighbors || !queued)
+  if (!net || !bus || !neighbors || !queued)
     return -1;
 
+  // Adjacency
+  NET_update_adjacency(net);
+
   // Add self to be processed
   neighbors_total = 1;
   neighbors[0] = BUS_get_index(bus);
@@ -898,28 +955,12 @@ int NET_get_bus_neighbors(Net* net, Bus* bus, int spread, int* neighbors, char*
   for (i = 0; i < spread; i++) {
     num_new = 0;
     while (neighbors_curr < neighbors_total) {
-      bus1 = NET_get_bus(net,neighbors[neighbors_curr]);
-      for (br = BUS_get_branch_k(bus1); br != NULL; br = BRANCH_get_next_k(br)) {
-	if (bus1 != BRANCH_get_bus_k(br)) {
-	  sprintf(net->error_string,"unable to construct covariance matrix");
-	  net->error_flag = TRUE;
-	}
-	bus2 = BRANCH_get_bus_m(br);
-	if (!queued[BUS_get_index(bus2)]) {
-	  neighbors[neighbors_total+num_new] = BUS_get_index(bus2);
-	  queued[BUS_get_index(bus2)] = TRUE;
-	  num_new++;
-	}
-      }
-      for (br = BUS_get_branch_m(bus1); br != NULL; br = BRANCH_get_next_m(br)) {
-	if (bus1 != BRANCH_get_bus_m(br)) {
-	  sprintf(net->error_string,"unable to construct covariance matrix");
-	  net->error_flag = TRUE;
-	}
-	bus2 = BRANCH_get_bus_k(br);
-	if (!queued[BUS_get_index(bus2)]) {
-	  neighbors[neighbors_total+num_new] = BUS_get_index(bus2);
-	  queued[BUS_get_index(bus2)] = TRUE;
+      bus1 = neighbors[neighbors_curr];
+      for (j = net->adj_ptr[bus1]; j < net->adj_ptr[bus1+1]; j++) {
+	bus2 = net->adj_bus[j];
+	if (!queued[bus2]) {
+	  neighbors[neighbors_total+num_new] = bus2;
+	  queued[bus2] = TRUE;
 	  num_new++;
 	}
       }
@@ -932,6 +973,360 @@ int NET_get_bus_neighbors(Net* net, Bus* bus, int spread, int* neighbors, char*
   return neighbors_total;
 }
 
+int* NET_get_adjacency_ptr(Net* net) {
+  if (!net)
+    return NULL;
+  NET_update_adjacency(net);
+  return net->adj_ptr;
+}
+
+int* NET_get_adjacency_branches(Net* net) {
+  if (!net)
+    return NULL;
+  NET_update_adjacency(net);
+  return net->adj_branch;
+}
+
+int* NET_get_adjacency_buses(Net* net) {
+  if (!net)
+    return NULL;
+  NET_update_adjacency(net);
+  return net->adj_bus;
+}
+
+int* NET_get_bus_islands(Net* net) {
+  if (!net)
+    return NULL;
+  NET_update_adjacency(net);
+  return net->bus_island;
+}
+
+int NET_get_bus_island(Net* net, int index) {
+  if (!net || index < 0 || index >= net->num_buses)
+    return -1;
+  NET_update_adjacency(net);
+  return net->bus_island[index];
+}
+
+int NET_get_num_islands(Net* net) {
+  if (!net)
+    return 0;
+  NET_update_adjacency(net);
+  return net->num_islands;
+}
+
+int NET_get_bus_degree(Net* net, int index) {
+  if (!net || index < 0 || index >= net->num_buses)
+    return 0;
+  NET_update_adjacency(net);
+  return net->adj_ptr[index+1]-net->adj_ptr[index];
+}
+
+int* NET_create_bus_ordering(Net* net, int ordering) {
+  /** Creates an ordering of the buses computed on the bus graph
+   *  (parallel branches merged, branches on outage excluded). Entry p of
+   *  the returned array is the index of the bus in position p. With
+   *  NET_ORDER_RCM, buses are ordered with reverse Cuthill-McKee starting
+   *  from a pseudo-peripheral bus of each island, which reduces the
+   *  bandwidth. With NET_ORDER_AMD, buses are ordered by minimum degree
+   *  on the elimination graph, which reduces fill-in. The caller is
+   *  responsible for freeing the array.
+   */
+
+  // Local variables
+  int* order;
+  int* ptr;
+  int* adj;
+  int* mark;
+  int* degree;
+  int* cand;
+  int* dist;
+  char* placed;
+  int** nb;
+  int* len;
+  int* cap;
+  int* head;
+  int* next;
+  int* prev;
+  int num_buses;
+  int root;
+  int ecc;
+  int x;
+  int head_q;
+  int tail_q;
+  int start;
+  int mindeg;
+  int num;
+  int c;
+  int d;
+  int i;
+  int j;
+  int k;
+  int u;
+  int v;
+  int w;
+
+  // Check
+  if (!net)
+    return NULL;
+
+  // Natural
+  num_buses = net->num_buses;
+  ARRAY_alloc(order,int,num_buses);
+  for (i = 0; i < num_buses; i++)
+    order[i] = i;
+  if (ordering != NET_ORDER_RCM && ordering != NET_ORDER_AMD)
+    return order;
+
+  // Simple bus graph
+  NET_update_adjacency(net);
+  ARRAY_alloc(ptr,int,num_buses+1);
+  ARRAY_alloc(adj,int,net->adj_ptr[num_buses]);
+  ARRAY_alloc(mark,int,num_buses);
+  for (i = 0; i < num_buses; i++)
+    mark[i] = -1;
+  ptr[0] = 0;
+  for (i = 0; i < num_buses; i++) {
+    ptr[i+1] = ptr[i];
+    mark[i] = i;
+    for (j = net->adj_ptr[i]; j < net->adj_ptr[i+1]; j++) {
+      k = net->adj_bus[j];
+      if (mark[k] != i) {
+	mark[k] = i;
+	adj[ptr[i+1]++] = k;
+      }
+    }
+  }
+  ARRAY_alloc(degree,int,num_buses);
+  for (i = 0; i < num_buses; i++)
+    degree[i] = ptr[i+1]-ptr[i];
+
+  // Reverse Cuthill-McKee
+  if (ordering == NET_ORDER_RCM) {
+
+    // Candidate roots sorted by degree
+    ARRAY_zalloc(head,int,num_buses+1);
+    ARRAY_alloc(cand,int,num_buses);
+    for (i = 0; i < num_buses; i++)
+      head[degree[i]+1]++;
+    for (d = 0; d < num_buses; d++)
+      head[d+1] += head[d];
+    for (i = 0; i < num_buses; i++)
+      cand[head[degree[i]]++] = i;
+
+    ARRAY_alloc(dist,int,num_buses);
+    ARRAY_zalloc(placed,char,num_buses);
+    for (i = 0; i < num_buses; i++)
+      dist[i] = -1;
+
+    num = 0;
+    c = 0;
+    while (num < num_buses) {
+
+      // Root of new island
+      while (placed[cand[c]])
+	c++;
+      root = cand[c];
+
+      // Pseudo-peripheral bus (George-Liu)
+      ecc = -1;
+      x = root;
+      while (TRUE) {
+
+	// Level structure from x (queue stored in free part of order)
+	head_q = num;
+	tail_q = num;
+	order[tail_q++] = x;
+	dist[x] = 0;
+	while (head_q < tail_q) {
+	  v = order[head_q++];
+	  for (j = ptr[v]; j < ptr[v+1]; j++) {
+	    u = adj[j];
+	    if (dist[u] < 0) {
+	      dist[u] = dist[v]+1;
+	      order[tail_q++] = u;
+	    }
+	  }
+	}
+	d = dist[order[tail_q-1]];
+
+	// Min degree bus in last level
+	w = order[tail_q-1];
+	for (k = tail_q-1; k >= num && dist[order[k]] == d; k--) {
+	  if (degree[order[k]] < degree[w])
+	    w = order[k];
+	}
+
+	// Reset
+	for (k = num; k < tail_q; k++)
+	  dist[order[k]] = -1;
+
+	// Update
+	if (d <= ecc)
+	  break;
+	ecc = d;
+	root = x;
+	x = w;
+      }
+
+      // Cuthill-McKee from root
+      head_q = num;
+      tail_q = num;
+      order[tail_q++] = root;
+      placed[root] = TRUE;
+      while (head_q < tail_q) {
+	v = order[head_q++];
+	start = tail_q;
+	for (j = ptr[v]; j < ptr[v+1]; j++) {
+	  u = adj[j];
+	  if (!placed[u]) {
+	    placed[u] = TRUE;
+	    order[tail_q++] = u;
+	  }
+	}
+
+	// Sort new buses by degree
+	for (k = start+1; k < tail_q; k++) {
+	  u = order[k];
+	  for (j = k; j > start && degree[order[j-1]] > degree[u]; j--)
+	    order[j] = order[j-1];
+	  order[j] = u;
+	}
+      }
+      num = tail_q;
+    }
+
+    // Reverse
+    for (i = 0; i < num_buses/2; i++) {
+      k = order[i];
+      order[i] = order[num_buses-1-i];
+      order[num_buses-1-i] = k;
+    }
+
+    // Clean up
+    free(head);
+    free(cand);
+    free(dist);
+    free(placed);
+  }
+
+  // Minimum degree
+  else {
+
+    // Elimination graph
+    ARRAY_alloc(nb,int*,num_buses);
+    ARRAY_alloc(len,int,num_buses);
+    ARRAY_alloc(cap,int,num_buses);
+    for (i = 0; i < num_buses; i++) {
+      len[i] = degree[i];
+      cap[i] = degree[i] > 0 ? degree[i] : 1;
+      ARRAY_alloc(nb[i],int,cap[i]);
+      for (j = 0; j < degree[i]; j++)
+	nb[i][j] = adj[ptr[i]+j];
+      mark[i] = -1;
+    }
+
+    // Degree buckets
+    ARRAY_alloc(head,int,num_buses);
+    ARRAY_alloc(next,int,num_buses);
+    ARRAY_alloc(prev,int,num_buses);
+    for (d = 0; d < num_buses; d++)
+      head[d] = -1;
+    for (i = num_buses-1; i >= 0; i--) {
+      prev[i] = -1;
+      next[i] = head[len[i]];
+      if (next[i] >= 0)
+	prev[next[i]] = i;
+      head[len[i]] = i;
+    }
+
+    // Eliminate
+    mindeg = 0;
+    for (num = 0; num < num_buses; num++) {
+
+      // Bus of minimum degree
+      while (head[mindeg] < 0)
+	mindeg++;
+      v = head[mindeg];
+      head[mindeg] = next[v];
+      if (next[v] >= 0)
+	prev[next[v]] = -1;
+      order[num] = v;
+
+      // Neighbors of v become a clique
+      for (j = 0; j < len[v]; j++) {
+	u = nb[v][j];
+
+	// Remove u from bucket
+	if (prev[u] >= 0)
+	  next[prev[u]] = next[u];
+	else
+	  head[len[u]] = next[u];
+	if (next[u] >= 0)
+	  prev[next[u]] = prev[u];
+
+	// Remove v from neighbors of u and mark the rest
+	for (k = 0; k < len[u]; k++) {
+	  if (nb[u][k] == v)
+	    nb[u][k--] = nb[u][--len[u]];
+	  else
+	    mark[nb[u][k]] = u;
+	}
+	mark[u] = u;
+
+	// Add missing neighbors of v
+	for (k = 0; k < len[v]; k++) {
+	  w = nb[v][k];
+	  if (mark[w] == u)
+	    continue;
+	  mark[w] = u;
+	  if (len[u] == cap[u]) {
+	    cap[u] *= 2;
+	    nb[u] = (int*)realloc(nb[u],cap[u]*sizeof(int));
+	  }
+	  nb[u][len[u]++] = w;
+	}
+
+	// Insert u in bucket
+	prev[u] = -1;
+	next[u] = head[len[u]];
+	if (next[u] >= 0)
+	  prev[next[u]] = u;
+	head[len[u]] = u;
+	if (len[u] < mindeg)
+	  mindeg = len[u];
+      }
+
+      // Unmark
+      for (j = 0; j < len[v]; j++) {
+	u = nb[v][j];
+	for (k = 0; k < len[u]; k++)
+	  mark[nb[u][k]] = -1;
+	mark[u] = -1;
+      }
+    }
+
+    // Clean up
+    for (i = 0; i < num_buses; i++)
+      free(nb[i]);
+    free(nb);
+    free(len);
+    free(cap);
+    free(head);
+    free(next);
+    free(prev);
+  }
+
+  // Clean up
+  free(ptr);
+  free(adj);
+  free(mark);
+  free(degree);
+
+  // Return
+  return order;
+}
+
 Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr) {
   /** This function constructs a "spatial" covariance matrix for the active powers of
    *  variable generators. The matrix is constructed such that the correlation
@@ -939,6 +1334,11 @@ Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr) {
    *  "spread" branches away is equal to "corr". Only the lower triangular part
    *  of the covaraicen matrix is stored. The resulting matrix should be checked
    *  to make sure it is a valid covariance matrix.
+   *
+   *  The neighbor search is done once per vargen and its result is kept until
+   *  the matrix is filled. Work arrays are only reset at the entries touched by
+   *  each search, and searches of different vargens run in parallel if OpenMP
+   *  is available.
    */
 
   // Local variables
@@ -949,95 +1349,129 @@ Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr) {
   Vargen* vg;
   char* queued;
   int* neighbors;
+  int** vg_neighbors;
+  int* vg_num_neighbors;
+  int* vg_nnz;
   int nnz_counter;
   int num_neighbors;
+  int num_vargens;
+  BOOL error;
   int i;
   int j;
+  int k;
   int t;
 
   // Check
   if (!net)
     return NULL;
 
-  // Allocate arrays
-  ARRAY_alloc(queued,char,net->num_buses);
-  ARRAY_alloc(neighbors,int,net->num_buses);
-
-  // Count nnz
-  //**********
-  nnz_counter = 0;
-  for (i = 0; i < net->num_vargens; i++) {
-
-    // Clear arrays
-    for (j = 0; j < net->num_buses; j++) {
-      neighbors[j] = 0;
-      queued[j] = FALSE;
-    }
-
-    // Main
-    vgen_main = NET_get_vargen(net,i);
-    bus_main = VARGEN_get_bus(vgen_main);
+  // Adjacency (built here so that searches below only read it)
+  NET_update_adjacency(net);
 
-    // Check variable
-    if (!VARGEN_has_flags(vgen_main,FLAG_VARS,VARGEN_VAR_P))
-      continue;
+  // Allocate arrays
+  num_vargens = net->num_vargens;
+  ARRAY_zalloc(vg_neighbors,int*,num_vargens);
+  ARRAY_zalloc(vg_num_neighbors,int,num_vargens);
+  ARRAY_zalloc(vg_nnz,int,num_vargens+1);
+  error = FALSE;
+
+  // Neighbors and nnz
+  //******************
+#ifdef _OPENMP
+#pragma omp parallel private(queued,neighbors,vgen_main,bus_main,bus,vg,num_neighbors,i,j,k,t) reduction(|:error)
+#endif
+  {
+    ARRAY_zalloc(queued,char,net->num_buses);
+    ARRAY_alloc(neighbors,int,net->num_buses);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,16)
+#endif
+    for (i = 0; i < num_vargens; i++) {
+
+      // Main
+      vgen_main = NET_get_vargen(net,i);
+      bus_main = VARGEN_get_bus(vgen_main);
+
+      // Check variable
+      if (!VARGEN_has_flags(vgen_main,FLAG_VARS,VARGEN_VAR_P))
+	continue;
+
+      // Neighbors
+      num_neighbors = NET_get_bus_neighbors(net,bus_main,spread,neighbors,queued);
+      if (num_neighbors < 0) {
+	error = TRUE;
+	continue;
+      }
 
-    // Neighbors
-    num_neighbors = NET_get_bus_neighbors(net,bus_main,spread,neighbors,queued);
-    if (num_neighbors < 0) {
-      sprintf(net->error_string,"unable to construct covariance matrix");
-      net->error_flag = TRUE;
-    }
+      // Vargens at neighbor buses
+      for (j = 0; j < num_neighbors; j++) {
+	bus = NET_get_bus(net,neighbors[j]);
+	for (vg = BUS_get_vargen(bus); vg != NULL; vg = VARGEN_get_next(vg)) {
+	  if (VARGEN_has_flags(vg,FLAG_VARS,VARGEN_VAR_P))
+	    vg_num_neighbors[i]++;
+	}
+      }
+      ARRAY_alloc(vg_neighbors[i],int,vg_num_neighbors[i]);
+      k = 0;
+      for (j = 0; j < num_neighbors; j++) {
+	bus = NET_get_bus(net,neighbors[j]);
+	for (vg = BUS_get_vargen(bus); vg != NULL; vg = VARGEN_get_next(vg)) {
+	  if (VARGEN_has_flags(vg,FLAG_VARS,VARGEN_VAR_P))
+	    vg_neighbors[i][k++] = VARGEN_get_index(vg);
+	}
+      }
 
-    // Diagonals
-    nnz_counter += net->num_periods;
+      // Reset touched entries
+      for (j = 0; j < num_neighbors; j++)
+	queued[neighbors[j]] = FALSE;
 
-    // Off diagonals
-    for (j = 0; j < num_neighbors; j++) {
-      bus = NET_get_bus(net,neighbors[j]);
-      for (vg = BUS_get_vargen(bus); vg != NULL; vg = VARGEN_get_next(vg)) {
+      // Count nnz (diagonals and off diagonals)
+      vg_nnz[i+1] = net->num_periods;
+      for (k = 0; k < vg_num_neighbors[i]; k++) {
+	vg = NET_get_vargen(net,vg_neighbors[i][k]);
 	for (t = 0; t < net->num_periods; t++) {
-	  if (VARGEN_has_flags(vg,FLAG_VARS,VARGEN_VAR_P) &&
-	      VARGEN_get_index_P(vgen_main,t) > VARGEN_get_index_P(vg,t)) {
-	    nnz_counter++;
-	  }
+	  if (VARGEN_get_index_P(vgen_main,t) > VARGEN_get_index_P(vg,t))
+	    vg_nnz[i+1]++;
 	}
       }
     }
+
+    free(queued);
+    free(neighbors);
   }
 
+  // Check
+  if (error) {
+    sprintf(net->error_string,"unable to construct covariance matrix");
+    net->error_flag = TRUE;
+  }
+
+  // Offsets
+  for (i = 0; i < num_vargens; i++)
+    vg_nnz[i+1] += vg_nnz[i];
+
   // Allocate
   //*********
   sigma = MAT_new(net->num_vars,
 		  net->num_vars,
-		  nnz_counter);
+		  vg_nnz[num_vargens]);
 
   // Fill
   //*****
-  nnz_counter = 0;
-  for (i = 0; i < net->num_vargens; i++) {
-
-    // Clear arrays
-    for (j = 0; j < net->num_buses; j++) {
-      neighbors[j] = 0;
-      queued[j] = FALSE;
-    }
+#ifdef _OPENMP
+#pragma omp parallel for private(vgen_main,vg,nnz_counter,k,t) schedule(dynamic,16)
+#endif
+  for (i = 0; i < num_vargens; i++) {
 
     // Main
     vgen_main = NET_get_vargen(net,i);
-    bus_main = VARGEN_get_bus(vgen_main);
+    nnz_counter = vg_nnz[i];
 
-    // Check variable
-    if (!VARGEN_has_flags(vgen_main,FLAG_VARS,VARGEN_VAR_P))
+    // Check variable (or failed neighbor search)
+    if (vg_nnz[i] == vg_nnz[i+1])
       continue;
 
-    // Neighbors
-    num_neighbors = NET_get_bus_neighbors(net,bus_main,spread,neighbors,queued);
-    if (num_neighbors < 0) {
-      sprintf(net->error_string,"unable to construct covariance matrix");
-      net->error_flag = TRUE;
-    }
-
     // Diagonal
     for (t = 0; t < net->num_periods; t++) {
       MAT_set_i(sigma,nnz_counter,VARGEN_get_index_P(vgen_main,t));
@@ -1047,36 +1481,167 @@ Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr) {
     }
 
     // Off diagonals
-    for (j = 0; j < num_neighbors; j++) {
-      bus = NET_get_bus(net,neighbors[j]);
-      for (vg = BUS_get_vargen(bus); vg != NULL; vg = VARGEN_get_next(vg)) {
-	for (t = 0; t < net->num_periods; t++) {
-	  if (VARGEN_has_flags(vg,FLAG_VARS,VARGEN_VAR_P) &&
-	      VARGEN_get_index_P(vgen_main,t) > VARGEN_get_index_P(vg,t)) {
-	    MAT_set_i(sigma,nnz_counter,VARGEN_get_index_P(vgen_main,t));
-	    MAT_set_j(sigma,nnz_counter,VARGEN_get_index_P(vg,t));
-	    MAT_set_d(sigma,nnz_counter,VARGEN_get_P_std(vgen_main,t)*VARGEN_get_P_std(vg,t)*corr);
-	    nnz_counter++;
-	  }
+    for (k = 0; k < vg_num_neighbors[i]; k++) {
+      vg = NET_get_vargen(net,vg_neighbors[i][k]);
+      for (t = 0; t < net->num_periods; t++) {
+	if (VARGEN_get_index_P(vgen_main,t) > VARGEN_get_index_P(vg,t)) {
+	  MAT_set_i(sigma,nnz_counter,VARGEN_get_index_P(vgen_main,t));
+	  MAT_set_j(sigma,nnz_counter,VARGEN_get_index_P(vg,t));
+	  MAT_set_d(sigma,nnz_counter,VARGEN_get_P_std(vgen_main,t)*VARGEN_get_P_std(vg,t)*corr);
+	  nnz_counter++;
 	}
       }
     }
   }
 
-  // Check
-  if (nnz_counter != MAT_get_nnz(sigma)) {
-    sprintf(net->error_string,"unable to construct covariance matrix");
-    net->error_flag = TRUE;
-  }
-
   // Clean up
-  free(queued);
-  free(neighbors);
+  for (i = 0; i < num_vargens; i++)
+    free(vg_neighbors[i]);
+  free(vg_neighbors);
+  free(vg_num_neighbors);
+  free(vg_nnz);
 
   // Return
   return sigma;
 }
 
+int* NET_create_var_periods(Net* net) {
+  /** Creates an array with the time period of each variable of the
+   *  network. Variables are found through the per-period indices of the
+   *  components, so the array is valid for any variable ordering. The
+   *  caller is responsible for freeing the array.
+   */
+
+  // Local variables
+  int* periods;
+  Bus* bus;
+  Branch* br;
+  Gen* gen;
+  Shunt* shunt;
+  Load* load;
+  Vargen* vargen;
+  Bat* bat;
+  int i;
+  int t;
+
+  // No net
+  if (!net)
+    return NULL;
+
+  // Allocate
+  ARRAY_alloc(periods,int,net->num_vars);
+  for (i = 0; i < net->num_vars; i++)
+    periods[i] = -1;
+
+  // Fill
+  for (t = 0; t < net->num_periods; t++) {
+
+    // Buses
+    for (i = 0; i < net->num_buses; i++) {
+      bus = BUS_array_get(net->bus,i);
+      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG))
+	periods[BUS_get_index_v_mag(bus,t)] = t;
+      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG))
+	periods[BUS_get_index_v_ang(bus,t)] = t;
+    }
+
+    // Branches
+    for (i = 0; i < net->num_branches; i++) {
+      br = BRANCH_array_get(net->branch,i);
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO))
+	periods[BRANCH_get_index_ratio(br,t)] = t;
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE))
+	periods[BRANCH_get_index_phase(br,t)] = t;
+    }
+
+    // Generators
+    for (i = 0; i < net->num_gens; i++) {
+      gen = GEN_array_get(net->gen,i);
+      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+	periods[GEN_get_index_P(gen,t)] = t;
+      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q))
+	periods[GEN_get_index_Q(gen,t)] = t;
+    }
+
+    // Shunts
+    for (i = 0; i < net->num_shunts; i++) {
+      shunt = SHUNT_array_get(net->shunt,i);
+      if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC))
+	periods[SHUNT_get_index_b(shunt,t)] = t;
+    }
+
+    // Loads
+    for (i = 0; i < net->num_loads; i++) {
+      load = LOAD_array_get(net->load,i);
+      if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
+	periods[LOAD_get_index_P(load,t)] = t;
+      if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q))
+	periods[LOAD_get_index_Q(load,t)] = t;
+    }
+
+    // Variable generators
+    for (i = 0; i < net->num_vargens; i++) {
+      vargen = VARGEN_array_get(net->vargen,i);
+      if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
+	periods[VARGEN_get_index_P(vargen,t)] = t;
+      if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q))
+	periods[VARGEN_get_index_Q(vargen,t)] = t;
+    }
+
+    // Batteries
+    for (i = 0; i < net->num_bats; i++) {
+      bat = BAT_array_get(net->bat,i);
+      if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {
+	periods[BAT_get_index_Pc(bat,t)] = t;
+	periods[BAT_get_index_Pd(bat,t)] = t;
+      }
+      if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_E))
+	periods[BAT_get_index_E(bat,t)] = t;
+    }
+  }
+
+  // Return
+  return periods;
+}
+
+int* NET_create_var_strides(Net* net) {
+  /** Creates an array with the difference between the indices of
+   *  each variable in consecutive time periods. This is one for all
+   *  variables except for the charging and discharging powers of
+   *  batteries, which are interleaved. The caller is responsible for
+   *  freeing the array.
+   */
+
+  // Local variables
+  int* strides;
+  Bat* bat;
+  int i;
+  int t;
+
+  // No net
+  if (!net)
+    return NULL;
+
+  // Allocate
+  ARRAY_alloc(strides,int,net->num_vars);
+  for (i = 0; i < net->num_vars; i++)
+    strides[i] = 1;
+
+  // Batteries
+  for (i = 0; i < net->num_bats; i++) {
+    bat = BAT_array_get(net->bat,i);
+    if (!BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P))
+      continue;
+    for (t = 0; t < net->num_periods; t++) {
+      strides[BAT_get_index_Pc(bat,t)] = 2;
+      strides[BAT_get_index_Pd(bat,t)] = 2;
+    }
+  }
+
+  // Return
+  return strides;
+}
+
 void NET_del(Net* net) {
   if (net) {
     NET_clear_data(net);
@@ -1163,6 +1728,21 @@ void NET_init(Net* net, int num_periods) {
 
   ARRAY_zalloc(net->num_actions,int,T);
 
+  // Topology
+  net->adj_ptr = NULL;
+  net->adj_branch = NULL;
+  net->adj_bus = NULL;
+  net->adj_valid = FALSE;
+  net->topology_version = 0;
+  net->adj_version = 0;
+  net->bus_island = NULL;
+  net->num_islands = 0;
+
+  // Variable ordering
+  net->var_ordering = NET_ORDER_NATURAL;
+  net->var_perm = NULL;
+  net->num_var_perm = 0;
+
   // Utils
   net->bus_counted = NULL;
 }
@@ -1345,6 +1925,84 @@ Bat* NET_get_bat_from_name_and_bus_number(Net* net, char* name, int number) {
   return NULL;
 }
 
+int NET_get_num_components(Net* net, char obj_type) {
+  if (!net)
+    return 0;
+  switch (obj_type) {
+  case OBJ_BUS:
+    return net->num_buses;
+  case OBJ_GEN:
+    return net->num_gens;
+  case OBJ_BRANCH:
+    return net->num_branches;
+  case OBJ_SHUNT:
+    return net->num_shunts;
+  case OBJ_LOAD:
+    return net->num_loads;
+  case OBJ_VARGEN:
+    return net->num_vargens;
+  case OBJ_BAT:
+    return net->num_bats;
+  default:
+    return 0;
+  }
+}
+
+void NET_get_series(Net* net, char obj_type, char* name, REAL* values) {
+  /** Copies the time series with the given name of all components of
+   *  the given type to values, which must have room for
+   *  num_components*num_periods entries. Values are stored row-major,
+   *  i.e., row i holds the series of the component with index i.
+   */
+
+  // Local variables
+  REAL* series;
+  int num;
+  int i;
+
+  // Check
+  if (!net || !values)
+    return;
+
+  // Copy
+  num = NET_get_num_components(net,obj_type);
+  for (i = 0; i < num; i++) {
+    series = NET_get_series_of_component(net,obj_type,i,name);
+    if (!series) {
+      sprintf(net->error_string,"invalid series name %s",name ? name : "");
+      net->error_flag = TRUE;
+      return;
+    }
+    memcpy(values+i*net->num_periods,series,sizeof(REAL)*net->num_periods);
+  }
+}
+
+REAL* NET_get_series_of_component(Net* net, char obj_type, int index, char* name) {
+  /** Returns the time series with the given name of the component of
+   *  the given type and index, or NULL if there is no such series.
+   */
+  if (!net || index < 0 || index >= NET_get_num_components(net,obj_type))
+    return NULL;
+  switch (obj_type) {
+  case OBJ_BUS:
+    return BUS_get_series(NET_get_bus(net,index),name);
+  case OBJ_GEN:
+    return GEN_get_series(NET_get_gen(net,index),name);
+  case OBJ_BRANCH:
+    return BRANCH_get_series(NET_get_branch(net,index),name);
+  case OBJ_SHUNT:
+    return SHUNT_get_series(NET_get_shunt(net,index),name);
+  case OBJ_LOAD:
+    return LOAD_get_series(NET_get_load(net,index),name);
+  case OBJ_VARGEN:
+    return VARGEN_get_series(NET_get_vargen(net,index),name);
+  case OBJ_BAT:
+    return BAT_get_series(NET_get_bat(net,index),name);
+  default:
+    return NULL;
+  }
+}
+
 int NET_get_num_periods(Net* net) {
   if (net)
     return net->num_periods;
@@ -1670,6 +2328,25 @@ int NET_get_num_fixed(Net* net) {
     return 0;
 }
 
+int NET_get_var_ordering(Net* net) {
+  if (net)
+    return net->var_ordering;
+  else
+    return NET_ORDER_NATURAL;
+}
+
+int* NET_get_var_permutation(Net* net) {
+  /** Returns array p such that p[i] is the current index of the
+   *  variable that would have index i with natural ordering, i.e., in
+   *  order of flag calls. NULL is returned if variables have not been
+   *  reordered. The array has size equal to the number of variables.
+   */
+  if (net)
+    return net->var_perm;
+  else
+    return NULL;
+}
+
 int NET_get_num_vars(Net* net) {
   if (net)
     return net->num_vars;
@@ -2145,46 +2822,19 @@ REAL NET_get_vargen_corr_value(Net* net) {
 
 char* NET_get_json_string(Net* net) {
 
-   // Local variables
-  char temp[NET_BUFFER_SIZE];
+  // Local variables
+  JSON_Writer* writer;
   char* output;
-  char* output_start;
-  int max_size;
 
   // No network
   if (!net)
     return NULL;
 
-  // Max size
-  max_size = (2*NET_BUFFER_SIZE +
-	      BUS_BUFFER_SIZE*BUS_NUM_JSON_FIELDS*net->num_buses +
-	      BRANCH_BUFFER_SIZE*BRANCH_NUM_JSON_FIELDS*net->num_branches +
-	      GEN_BUFFER_SIZE*GEN_NUM_JSON_FIELDS*net->num_gens +
-	      LOAD_BUFFER_SIZE*LOAD_NUM_JSON_FIELDS*net->num_loads +
-	      SHUNT_BUFFER_SIZE*SHUNT_NUM_JSON_FIELDS*net->num_shunts +
-	      VARGEN_BUFFER_SIZE*VARGEN_NUM_JSON_FIELDS*net->num_vargens +
-	      BAT_BUFFER_SIZE*BAT_NUM_JSON_FIELDS*net->num_bats)*net->num_periods;
-
-  // Output
-  output = (char*)malloc(sizeof(char)*max_size);
-  output_start = output;
-  
   // Write
-  JSON_start(output);
-  JSON_int(temp,output,"num_periods",net->num_periods,FALSE);
-  JSON_float(temp,output,"base_power",net->base_power,FALSE);
-  JSON_str(temp,output,"version",VERSION,FALSE);
-  JSON_array_json(temp,output,"buses",net->bus,BUS_array_get,net->num_buses,BUS_get_json_string,FALSE);
-  JSON_array_json(temp,output,"branches",net->branch,BRANCH_array_get,net->num_branches,BRANCH_get_json_string,FALSE);
-  JSON_array_json(temp,output,"generators",net->gen,GEN_array_get,net->num_gens,GEN_get_json_string,FALSE);
-  JSON_array_json(temp,output,"loads",net->load,LOAD_array_get,net->num_loads,LOAD_get_json_string,FALSE);
-  JSON_array_json(temp,output,"shunts",net->shunt,SHUNT_array_get,net->num_shunts,SHUNT_get_json_string,FALSE);
-  JSON_array_json(temp,output,"var_generators",net->vargen,VARGEN_array_get,net->num_vargens,VARGEN_get_json_string,FALSE);
-  JSON_array_json(temp,output,"batteries",net->bat,BAT_array_get,net->num_bats,BAT_get_json_string,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  writer = JSON_WRITER_new();
+  NET_write_json(net,writer);
+  output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
@@ -2197,6 +2847,28 @@ BOOL NET_has_error(Net* net) {
     return FALSE;
 }
 
+void NET_load_profiles(Net* net, char* filename) {
+  /** Loads load, variable generator and generator time series
+   *  from csv profiles file (see profiles.c for the format).
+   */
+
+  // Local variables
+  Profiles* prof;
+
+  // Check
+  if (!net)
+    return;
+
+  // Load
+  prof = PROFILES_new(net);
+  PROFILES_load(prof,filename);
+  if (PROFILES_has_error(prof)) {
+    strcpy(net->error_string,PROFILES_get_error_string(prof));
+    net->error_flag = TRUE;
+  }
+  PROFILES_del(prof);
+}
+
 Net* NET_new(int num_periods) {
   if (num_periods > 0) {
     Net* net = (Net*)malloc(sizeof(Net));
@@ -2213,9 +2885,13 @@ void NET_set_base_power(Net* net, REAL base_power) {
 }
 
 void NET_set_branch_array(Net* net, Branch* branch, int num) {
+  int i;
   if (net) {
     net->branch = branch;
     net->num_branches = num;
+    net->adj_valid = FALSE;
+    for (i = 0; i < num; i++)
+      BRANCH_set_topology_version(BRANCH_array_get(branch,i),&(net->topology_version));
   }
 }
 
@@ -2237,6 +2913,7 @@ void NET_set_bus_array(Net* net, Bus* bus, int num) {
   if (net) {
     net->bus = bus;
     net->num_buses = num;
+    net->adj_valid = FALSE;
     ARRAY_zalloc(net->bus_counted,char,net->num_buses*net->num_periods);
   }
 }
@@ -2415,6 +3092,10 @@ void NET_set_flags(Net* net, char obj_type, char flag_mask, char prop_mask, unsi
 	net->num_sparse = set_flags(obj,FLAG_SPARSE,val_mask,net->num_sparse);
     }
   }
+
+  // Ordering
+  if (flag_mask & FLAG_VARS)
+    NET_update_var_ordering(net);
 }
 
 void NET_set_flags_of_component(Net* net, void* obj, char obj_type, char flag_mask, unsigned char val_mask) {
@@ -2479,6 +3160,64 @@ void NET_set_flags_of_component(Net* net, void* obj, char obj_type, char flag_ma
     net->num_bounded = set_flags(obj,FLAG_BOUNDED,val_mask,net->num_bounded);
   if (flag_mask & FLAG_SPARSE)
     net->num_sparse = set_flags(obj,FLAG_SPARSE,val_mask,net->num_sparse);
+
+  // Ordering
+  if (flag_mask & FLAG_VARS)
+    NET_update_var_ordering(net);
+}
+
+void NET_set_series(Net* net, char obj_type, char* name, REAL* values) {
+  /** Sets the time series with the given name of all components of
+   *  the given type from values, which holds num_components*num_periods
+   *  entries stored row-major (see NET_get_series).
+   */
+
+  // Local variables
+  REAL* series;
+  int num;
+  int i;
+
+  // Check
+  if (!net || !values)
+    return;
+
+  // Copy
+  num = NET_get_num_components(net,obj_type);
+  for (i = 0; i < num; i++) {
+    series = NET_get_series_of_component(net,obj_type,i,name);
+    if (!series) {
+      sprintf(net->error_string,"invalid series name %s",name ? name : "");
+      net->error_flag = TRUE;
+      return;
+    }
+    memcpy(series,values+i*net->num_periods,sizeof(REAL)*net->num_periods);
+  }
+}
+
+void NET_set_var_ordering(Net* net, int ordering) {
+  /** Sets the ordering of variable indices. With NET_ORDER_RCM or
+   *  NET_ORDER_AMD, variables are renumbered bus by bus following an
+   *  ordering of the bus graph every time flags of variables are set,
+   *  and right away if variables already exist. Setting the natural
+   *  ordering keeps the current indices and stops further reordering.
+   */
+
+  // Check
+  if (!net)
+    return;
+
+  // Check ordering
+  if (ordering != NET_ORDER_NATURAL &&
+      ordering != NET_ORDER_RCM &&
+      ordering != NET_ORDER_AMD) {
+    sprintf(net->error_string,"invalid variable ordering");
+    net->error_flag = TRUE;
+    return;
+  }
+
+  // Set
+  net->var_ordering = ordering;
+  NET_update_var_ordering(net);
 }
 
 void NET_set_var_values(Net* net, Vec* values) {
@@ -2556,6 +3295,54 @@ char* NET_get_show_components_str(Net* net) {
   return out;
 }
 
+void NET_shift_periods(Net* net, int k, char* profiles) {
+  /** Moves the time series of all components k periods back for
+   *  rolling horizons. The last k periods keep the data of the last
+   *  period or, if profiles is not NULL, are loaded from that profiles
+   *  file (see NET_load_profiles). Flags, variable indices and
+   *  topology are unchanged.
+   */
+
+  // Local variables
+  int i;
+
+  // No net
+  if (!net || k <= 0)
+    return;
+
+  // Buses
+  for (i = 0; i < net->num_buses; i++)
+    BUS_shift_periods(BUS_array_get(net->bus,i),k);
+
+  // Branches
+  for (i = 0; i < net->num_branches; i++)
+    BRANCH_shift_periods(BRANCH_array_get(net->branch,i),k);
+
+  // Generators
+  for (i = 0; i < net->num_gens; i++)
+    GEN_shift_periods(GEN_array_get(net->gen,i),k);
+
+  // Loads
+  for (i = 0; i < net->num_loads; i++)
+    LOAD_shift_periods(LOAD_array_get(net->load,i),k);
+
+  // Vargens
+  for (i = 0; i < net->num_vargens; i++)
+    VARGEN_shift_periods(VARGEN_array_get(net->vargen,i),k);
+
+  // Shunts
+  for (i = 0; i < net->num_shunts; i++)
+    SHUNT_shift_periods(SHUNT_array_get(net->shunt,i),k);
+
+  // Batteries
+  for (i = 0; i < net->num_bats; i++)
+    BAT_shift_periods(BAT_array_get(net->bat,i),k);
+
+  // New data
+  if (profiles)
+    NET_load_profiles(net,profiles);
+}
+
 void NET_show_components(Net* net) {
 
   printf("%s",NET_get_show_components_str(net));
@@ -2706,6 +3493,334 @@ void NET_show_buses(Net* net, int number, int sort_by, int t) {
   }
 }
 
+void NET_update_adjacency(Net* net) {
+  /** Builds compressed bus-branch incidence arrays (CSR). For bus i,
+   *  entries adj_ptr[i] to adj_ptr[i+1]-1 of adj_branch and adj_bus
+   *  hold the incident branches and the buses on their other side.
+   *  Branches on outage are skipped. Entries of each bus are ordered
+   *  with branches having the bus on the "k" side first, each group
+   *  ordered by branch index. Connected components (islands) are also
+   *  labeled here with a breadth-first search, numbered in order of their
+   *  lowest bus index. Nothing is done if the arrays are up to date,
+   *  i.e., if no branch outage flag or bus has changed since they were
+   *  built (see BRANCH_set_topology_version).
+   */
+
+  // Local variables
+  Branch* br;
+  Bus* bus_k;
+  Bus* bus_m;
+  int* pos;
+  int* queue;
+  int head;
+  int tail;
+  int k;
+  int m;
+  int i;
+  int j;
+
+  // Check
+  if (!net || (net->adj_valid && net->adj_version == net->topology_version))
+    return;
+
+  // Free
+  free(net->adj_ptr);
+  free(net->adj_branch);
+  free(net->adj_bus);
+  free(net->bus_island);
+
+  // Count
+  ARRAY_zalloc(net->adj_ptr,int,net->num_buses+1);
+  for (i = 0; i < net->num_branches; i++) {
+    br = BRANCH_array_get(net->branch,i);
+    bus_k = BRANCH_get_bus_k(br);
+    bus_m = BRANCH_get_bus_m(br);
+    if (BRANCH_is_on_outage(br) || !bus_k || !bus_m)
+      continue;
+    net->adj_ptr[BUS_get_index(bus_k)+1]++;
+    net->adj_ptr[BUS_get_index(bus_m)+1]++;
+  }
+  for (i = 0; i < net->num_buses; i++)
+    net->adj_ptr[i+1] += net->adj_ptr[i];
+
+  // Allocate
+  ARRAY_alloc(net->adj_branch,int,net->adj_ptr[net->num_buses]);
+  ARRAY_alloc(net->adj_bus,int,net->adj_ptr[net->num_buses]);
+  ARRAY_alloc(pos,int,net->num_buses);
+  for (i = 0; i < net->num_buses; i++)
+    pos[i] = net->adj_ptr[i];
+
+  // Fill "k" side then "m" side
+  for (k = 0; k < 2; k++) {
+    for (i = 0; i < net->num_branches; i++) {
+      br = BRANCH_array_get(net->branch,i);
+      bus_k = BRANCH_get_bus_k(br);
+      bus_m = BRANCH_get_bus_m(br);
+      if (BRANCH_is_on_outage(br) || !bus_k || !bus_m)
+	continue;
+      if (k == 0) {
+	m = BUS_get_index(bus_k);
+	net->adj_bus[pos[m]] = BUS_get_index(bus_m);
+      }
+      else {
+	m = BUS_get_index(bus_m);
+	net->adj_bus[pos[m]] = BUS_get_index(bus_k);
+      }
+      net->adj_branch[pos[m]] = i;
+      pos[m]++;
+    }
+  }
+
+  // Islands
+  net->num_islands = 0;
+  ARRAY_alloc(net->bus_island,int,net->num_buses);
+  for (i = 0; i < net->num_buses; i++)
+    net->bus_island[i] = -1;
+  queue = pos;
+  for (i = 0; i < net->num_buses; i++) {
+    if (net->bus_island[i] >= 0)
+      continue;
+    head = 0;
+    tail = 0;
+    queue[tail++] = i;
+    net->bus_island[i] = net->num_islands;
+    while (head < tail) {
+      m = queue[head++];
+      for (j = net->adj_ptr[m]; j < net->adj_ptr[m+1]; j++) {
+	k = net->adj_bus[j];
+	if (net->bus_island[k] < 0) {
+	  net->bus_island[k] = net->num_islands;
+	  queue[tail++] = k;
+	}
+      }
+    }
+    net->num_islands++;
+  }
+
+  // Clean up
+  free(pos);
+
+  // Valid
+  net->adj_valid = TRUE;
+  net->adj_version = net->topology_version;
+}
+
+void NET_update_var_ordering(Net* net) {
+  /** Renumbers the variables following the variable ordering of the
+   *  network. Buses are visited in the order given by
+   *  NET_create_bus_ordering, and the variables of each bus are followed
+   *  by those of its generators, loads, shunts, variable generators,
+   *  batteries and branches (on the "k" side). Components without bus
+   *  come last. The indices of each component stay contiguous and in the
+   *  order assigned by its set_flags routine. The permutation from
+   *  natural indices (order of flag calls) is updated accordingly.
+   */
+
+  // Local variables
+  char obj_types[7] = {OBJ_BUS,OBJ_GEN,OBJ_LOAD,OBJ_SHUNT,OBJ_VARGEN,OBJ_BAT,OBJ_BRANCH};
+  int nums[7];
+  void* obj;
+  Bus* bus;
+  Vec* old_indices;
+  Vec* new_indices;
+  int* order;
+  int* pos;
+  int* ptr;
+  int* comp_type;
+  int* comp_index;
+  int* natural;
+  int* var_perm;
+  int num_comps;
+  unsigned char mask;
+  int index;
+  int n;
+  int i;
+  int j;
+  int k;
+  int T;
+  BOOL (*has_flags)(void*,char,unsigned char);
+  int (*set_flags)(void*,char,unsigned char,int);
+  Vec* (*get_var_indices)(void*,unsigned char,int,int);
+
+  // Check
+  if (!net || net->var_ordering == NET_ORDER_NATURAL || net->num_vars == 0)
+    return;
+
+  // Bus positions
+  order = NET_create_bus_ordering(net,net->var_ordering);
+  ARRAY_alloc(pos,int,net->num_buses);
+  for (i = 0; i < net->num_buses; i++)
+    pos[order[i]] = i;
+
+  // Components sorted by position of their bus (stable)
+  nums[0] = net->num_buses;
+  nums[1] = net->num_gens;
+  nums[2] = net->num_loads;
+  nums[3] = net->num_shunts;
+  nums[4] = net->num_vargens;
+  nums[5] = net->num_bats;
+  nums[6] = net->num_branches;
+  num_comps = 0;
+  for (k = 0; k < 7; k++)
+    num_comps += nums[k];
+  ARRAY_zalloc(ptr,int,net->num_buses+2);
+  ARRAY_alloc(comp_type,int,num_comps);
+  ARRAY_alloc(comp_index,int,num_comps);
+  for (n = 0; n < 2; n++) {
+    for (k = 0; k < 7; k++) {
+      for (i = 0; i < nums[k]; i++) {
+	switch (obj_types[k]) {
+	case OBJ_BUS:
+	  bus = NET_get_bus(net,i);
+	  break;
+	case OBJ_GEN:
+	  bus = GEN_get_bus(NET_get_gen(net,i));
+	  break;
+	case OBJ_LOAD:
+	  bus = LOAD_get_bus(NET_get_load(net,i));
+	  break;
+	case OBJ_SHUNT:
+	  bus = SHUNT_get_bus(NET_get_shunt(net,i));
+	  break;
+	case OBJ_VARGEN:
+	  bus = VARGEN_get_bus(NET_get_vargen(net,i));
+	  break;
+	case OBJ_BAT:
+	  bus = BAT_get_bus(NET_get_bat(net,i));
+	  break;
+	default:
+	  bus = BRANCH_get_bus_k(NET_get_branch(net,i));
+	}
+	j = bus ? pos[BUS_get_index(bus)] : net->num_buses;
+	if (n == 0)
+	  ptr[j+1]++;
+	else {
+	  comp_type[ptr[j]] = k;
+	  comp_index[ptr[j]] = i;
+	  ptr[j]++;
+	}
+      }
+    }
+    if (n == 0) {
+      for (j = 0; j < net->num_buses+1; j++)
+	ptr[j+1] += ptr[j];
+    }
+  }
+
+  // Natural index of each current index
+  ARRAY_alloc(natural,int,net->num_vars);
+  for (i = 0; i < net->num_vars; i++)
+    natural[i] = i;
+  for (i = 0; i < net->num_var_perm; i++)
+    natural[net->var_perm[i]] = i;
+
+  // Renumber
+  T = net->num_periods;
+  ARRAY_alloc(var_perm,int,net->num_vars);
+  index = 0;
+  for (n = 0; n < num_comps; n++) {
+    i = comp_index[n];
+    switch (obj_types[comp_type[n]]) {
+    case OBJ_BUS:
+      obj = NET_get_bus(net,i);
+      has_flags = &BUS_has_flags;
+      set_flags = &BUS_set_flags;
+      get_var_indices = &BUS_get_var_indices;
+      break;
+    case OBJ_GEN:
+      obj = NET_get_gen(net,i);
+      has_flags = &GEN_has_flags;
+      set_flags = &GEN_set_flags;
+      get_var_indices = &GEN_get_var_indices;
+      break;
+    case OBJ_LOAD:
+      obj = NET_get_load(net,i);
+      has_flags = &LOAD_has_flags;
+      set_flags = &LOAD_set_flags;
+      get_var_indices = &LOAD_get_var_indices;
+      break;
+    case OBJ_SHUNT:
+      obj = NET_get_shunt(net,i);
+      has_flags = &SHUNT_has_flags;
+      set_flags = &SHUNT_set_flags;
+      get_var_indices = &SHUNT_get_var_indices;
+      break;
+    case OBJ_VARGEN:
+      obj = NET_get_vargen(net,i);
+      has_flags = &VARGEN_has_flags;
+      set_flags = &VARGEN_set_flags;
+      get_var_indices = &VARGEN_get_var_indices;
+      break;
+    case OBJ_BAT:
+      obj = NET_get_bat(net,i);
+      has_flags = &BAT_has_flags;
+      set_flags = &BAT_set_flags;
+      get_var_indices = &BAT_get_var_indices;
+      break;
+    default:
+      obj = NET_get_branch(net,i);
+      has_flags = &BRANCH_has_flags;
+      set_flags = &BRANCH_set_flags;
+      get_var_indices = &BRANCH_get_var_indices;
+    }
+
+    // Variables of component
+    mask = 0;
+    for (k = 0; k < 8; k++) {
+      if (has_flags(obj,FLAG_VARS,(unsigned char)(1 << k)))
+	mask |= (unsigned char)(1 << k);
+    }
+    if (!mask)
+      continue;
+
+    // New indices
+    old_indices = get_var_indices(obj,mask,0,T-1);
+    switch (obj_types[comp_type[n]]) {
+    case OBJ_BUS:
+      BUS_clear_flags((Bus*)obj,FLAG_VARS);
+      break;
+    case OBJ_GEN:
+      GEN_clear_flags((Gen*)obj,FLAG_VARS);
+      break;
+    case OBJ_LOAD:
+      LOAD_clear_flags((Load*)obj,FLAG_VARS);
+      break;
+    case OBJ_SHUNT:
+      SHUNT_clear_flags((Shunt*)obj,FLAG_VARS);
+      break;
+    case OBJ_VARGEN:
+      VARGEN_clear_flags((Vargen*)obj,FLAG_VARS);
+      break;
+    case OBJ_BAT:
+      BAT_clear_flags((Bat*)obj,FLAG_VARS);
+      break;
+    default:
+      BRANCH_clear_flags((Branch*)obj,FLAG_VARS);
+    }
+    index = set_flags(obj,FLAG_VARS,mask,index);
+    new_indices = get_var_indices(obj,mask,0,T-1);
+
+    // Permutation
+    for (k = 0; k < VEC_get_size(old_indices); k++)
+      var_perm[natural[(int)VEC_get(old_indices,k)]] = (int)VEC_get(new_indices,k);
+    VEC_del(old_indices);
+    VEC_del(new_indices);
+  }
+
+  // Save
+  free(net->var_perm);
+  net->var_perm = var_perm;
+  net->num_var_perm = net->num_vars;
+
+  // Clean up
+  free(order);
+  free(pos);
+  free(ptr);
+  free(comp_type);
+  free(comp_index);
+  free(natural);
+}
+
 void NET_update_properties(Net* net, Vec* values) {
 
   // Local variables
@@ -3142,3 +4257,28 @@ void NET_propagate_data_in_time(Net* net, int start, int end) {
   for (i = 0; i < net->num_bats; i++)
     BAT_propagate_data_in_time(BAT_array_get(net->bat,i),start,end);
 }
+
+void NET_write_json(Net* net, JSON_Writer* writer) {
+  /** Writes network as json object. Components are written one at a
+   *  time so that file and file descriptor writers only hold one chunk
+   *  of output in memory.
+   */
+
+  // No network
+  if (!net)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"num_periods",net->num_periods,FALSE);
+  JSON_float(writer,"base_power",net->base_power,FALSE);
+  JSON_str(writer,"version",VERSION,FALSE);
+  JSON_array_json(writer,"buses",net->bus,BUS_array_get,net->num_buses,BUS_write_json,FALSE);
+  JSON_array_json(writer,"branches",net->branch,BRANCH_array_get,net->num_branches,BRANCH_write_json,FALSE);
+  JSON_array_json(writer,"generators",net->gen,GEN_array_get,net->num_gens,GEN_write_json,FALSE);
+  JSON_array_json(writer,"loads",net->load,LOAD_array_get,net->num_loads,LOAD_write_json,FALSE);
+  JSON_array_json(writer,"shunts",net->shunt,SHUNT_array_get,net->num_shunts,SHUNT_write_json,FALSE);
+  JSON_array_json(writer,"var_generators",net->vargen,VARGEN_array_get,net->num_vargens,VARGEN_write_json,FALSE);
+  JSON_array_json(writer,"batteries",net->bat,BAT_array_get,net->num_bats,BAT_write_json,TRUE);
+  JSON_end(writer);
+}
@@ -0,0 +1,463 @@
+/** @file profiles.c
+ *  @brief This file defines the Profiles data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ *
+ * Profiles are read from a csv file with one column per component
+ * quantity and one record per time period:
+ *
+ *   # comment
+ *   t, load:0:P, load:0:Q, vargen:wind 1:P_ava, gen:3:P
+ *   0, 1.20,     0.30,     0.55,                0.90
+ *   1, 1.15,     0.28,     0.61,                0.85
+ *
+ * Column headers are "type:key:quantity", where type is load, vargen
+ * or gen, key is a component index or name, and quantity is P, Q, P_max
+ * or P_min for loads, P, P_ava or P_std for variable generators, and P
+ * for generators. The first field of each record is its time period.
+ * Values are in per unit and every field must be present.
+ */
+
+#include <pfnet/array.h>
+#include <pfnet/profiles.h>
+#include <pfnet/parser_CSV.h>
+#include <pfnet/pfnet_config.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Profiles
+struct Profiles {
+
+  // Error
+  BOOL error_flag;                         /**< @brief Error flag */
+  char error_string[PROFILES_BUFFER_SIZE]; /**< @brief Error string */
+
+  // Network
+  Net* net;         /**< @brief Network (not owned) */
+
+  // Columns
+  int num_cols;     /**< @brief Number of columns */
+  int max_cols;     /**< @brief Allocated number of columns */
+  char* col_type;   /**< @brief Object type of each column */
+  char* col_qty;    /**< @brief Quantity of each column */
+  void** col_obj;   /**< @brief Component of each column */
+
+  // State
+  int num_records;  /**< @brief Number of records processed (header excluded) */
+  int field;        /**< @brief Index of current field in record */
+  int t;            /**< @brief Time period of current record */
+};
+
+void PROFILES_add_column(Profiles* prof, char* header) {
+  /** Resolves column header "type:key:quantity" to a component
+   *  and quantity.
+   */
+
+  // Local variables
+  Net* net;
+  char* key;
+  char* qty;
+  char* end;
+  char type;
+  char q;
+  void* obj;
+  int index;
+  int num;
+  int i;
+
+  // Check
+  if (!prof || prof->error_flag)
+    return;
+  net = prof->net;
+
+  // Trim
+  while (isspace((unsigned char)*header))
+    header++;
+  end = header+strlen(header);
+  while (end > header && isspace((unsigned char)*(end-1)))
+    *(--end) = '\0';
+
+  // Split
+  key = strchr(header,':');
+  qty = strrchr(header,':');
+  if (!key || key == qty) {
+    snprintf(prof->error_string,PROFILES_BUFFER_SIZE,"invalid profile column %s",header);
+    prof->error_flag = TRUE;
+    return;
+  }
+  *key = '\0';
+  *qty = '\0';
+  key++;
+  qty++;
+
+  // Type
+  if (strcmp(header,"load") == 0) {
+    type = OBJ_LOAD;
+    num = NET_get_num_loads(net);
+  }
+  else if (strcmp(header,"vargen") == 0) {
+    type = OBJ_VARGEN;
+    num = NET_get_num_vargens(net);
+  }
+  else if (strcmp(header,"gen") == 0) {
+    type = OBJ_GEN;
+    num = NET_get_num_gens(net);
+  }
+  else {
+    snprintf(prof->error_string,PROFILES_BUFFER_SIZE,"invalid profile component type %s",header);
+    prof->error_flag = TRUE;
+    return;
+  }
+
+  // Quantity
+  q = -1;
+  if (strcmp(qty,"P") == 0)
+    q = PROFILES_P;
+  else if (strcmp(qty,"Q") == 0 && type == OBJ_LOAD)
+    q = PROFILES_Q;
+  else if (strcmp(qty,"P_max") == 0 && type == OBJ_LOAD)
+    q = PROFILES_P_MAX;
+  else if (strcmp(qty,"P_min") == 0 && type == OBJ_LOAD)
+    q = PROFILES_P_MIN;
+  else if (strcmp(qty,"P_ava") == 0 && type == OBJ_VARGEN)
+    q = PROFILES_P_AVA;
+  else if (strcmp(qty,"P_std") == 0 && type == OBJ_VARGEN)
+    q = PROFILES_P_STD;
+  if (q < 0) {
+    snprintf(prof->error_string,PROFILES_BUFFER_SIZE,"invalid profile quantity %s for %s",qty,header);
+    prof->error_flag = TRUE;
+    return;
+  }
+
+  // Component (index, or else name)
+  obj = NULL;
+  index = (int)strtol(key,&end,10);
+  if (end != key && *end == '\0') {
+    if (type == OBJ_LOAD)
+      obj = NET_get_load(net,index);
+    else if (type == OBJ_VARGEN)
+      obj = NET_get_vargen(net,index);
+    else
+      obj = NET_get_gen(net,index);
+  }
+  else {
+    for (i = 0; i < num && !obj; i++) {
+      if (type == OBJ_LOAD && strcmp(LOAD_get_name(NET_get_load(net,i)),key) == 0)
+	obj = NET_get_load(net,i);
+      else if (type == OBJ_VARGEN && strcmp(VARGEN_get_name(NET_get_vargen(net,i)),key) == 0)
+	obj = NET_get_vargen(net,i);
+      else if (type == OBJ_GEN && strcmp(GEN_get_name(NET_get_gen(net,i)),key) == 0)
+	obj = NET_get_gen(net,i);
+    }
+  }
+  if (!obj) {
+    snprintf(prof->error_string,PROFILES_BUFFER_SIZE,"profile %s %s not found",header,key);
+    prof->error_flag = TRUE;
+    return;
+  }
+
+  // Add
+  if (prof->num_cols == prof->max_cols) {
+    prof->max_cols = prof->max_cols > 0 ? 2*prof->max_cols : 16;
+    prof->col_type = (char*)realloc(prof->col_type,sizeof(char)*prof->max_cols);
+    prof->col_qty = (char*)realloc(prof->col_qty,sizeof(char)*prof->max_cols);
+    prof->col_obj = (void**)realloc(prof->col_obj,sizeof(void*)*prof->max_cols);
+  }
+  prof->col_type[prof->num_cols] = type;
+  prof->col_qty[prof->num_cols] = q;
+  prof->col_obj[prof->num_cols] = obj;
+  prof->num_cols++;
+}
+
+void PROFILES_callback_field(char* s, void* data) {
+
+  // Local variables
+  Profiles* prof = (Profiles*)data;
+  void* obj;
+  REAL value;
+  int j;
+
+  // Check
+  if (prof->error_flag)
+    return;
+
+  // Field index
+  j = prof->field-1;
+  prof->field++;
+
+  // Header
+  if (prof->num_records < 0) {
+    if (j >= 0)
+      PROFILES_add_column(prof,s);
+    return;
+  }
+
+  // Time period
+  if (j < 0) {
+    prof->t = fast_atoi(s);
+    if (prof->t < 0) {
+      sprintf(prof->error_string,"invalid profile time period %d",prof->t);
+      prof->error_flag = TRUE;
+    }
+    return;
+  }
+
+  // Value
+  if (j >= prof->num_cols) {
+    sprintf(prof->error_string,"too many profile values for time period %d",prof->t);
+    prof->error_flag = TRUE;
+    return;
+  }
+  if (prof->t >= NET_get_num_periods(prof->net))
+    return;
+  value = fast_atof(s);
+  obj = prof->col_obj[j];
+  switch (prof->col_type[j]) {
+
+  case OBJ_LOAD:
+    switch (prof->col_qty[j]) {
+    case PROFILES_P:
+      LOAD_set_P((Load*)obj,value,prof->t);
+      break;
+    case PROFILES_Q:
+      LOAD_set_Q((Load*)obj,value,prof->t);
+      break;
+    case PROFILES_P_MAX:
+      LOAD_set_P_max((Load*)obj,value,prof->t);
+      break;
+    case PROFILES_P_MIN:
+      LOAD_set_P_min((Load*)obj,value,prof->t);
+      break;
+    }
+    break;
+
+  case OBJ_VARGEN:
+    switch (prof->col_qty[j]) {
+    case PROFILES_P:
+      VARGEN_set_P((Vargen*)obj,value,prof->t);
+      break;
+    case PROFILES_P_AVA:
+      VARGEN_set_P_ava((Vargen*)obj,value,prof->t);
+      break;
+    case PROFILES_P_STD:
+      VARGEN_set_P_std((Vargen*)obj,value,prof->t);
+      break;
+    }
+    break;
+
+  case OBJ_GEN:
+    GEN_set_P((Gen*)obj,value,prof->t);
+    break;
+  }
+}
+
+void PROFILES_callback_record(void* data) {
+
+  // Local variables
+  Profiles* prof = (Profiles*)data;
+
+  // Empty record
+  if (prof->field == 0)
+    return;
+
+  // Check
+  if (!prof->error_flag && prof->num_records >= 0 && prof->field != prof->num_cols+1) {
+    sprintf(prof->error_string,"missing profile values for time period %d",prof->t);
+    prof->error_flag = TRUE;
+  }
+
+  // Next
+  prof->num_records++;
+  prof->field = 0;
+}
+
+void PROFILES_del(Profiles* prof) {
+  if (prof) {
+    free(prof->col_type);
+    free(prof->col_qty);
+    free(prof->col_obj);
+    free(prof);
+  }
+}
+
+char* PROFILES_get_error_string(Profiles* prof) {
+  if (prof)
+    return prof->error_string;
+  else
+    return NULL;
+}
+
+int PROFILES_get_num_columns(Profiles* prof) {
+  if (prof)
+    return prof->num_cols;
+  else
+    return 0;
+}
+
+int PROFILES_get_num_records(Profiles* prof) {
+  if (prof && prof->num_records > 0)
+    return prof->num_records;
+  else
+    return 0;
+}
+
+BOOL PROFILES_has_error(Profiles* prof) {
+  if (prof)
+    return prof->error_flag;
+  else
+    return FALSE;
+}
+
+void PROFILES_load(Profiles* prof, char* filename) {
+  /** Loads profiles from csv file into the time series of the
+   *  components of the network in one sequential pass. Records of
+   *  time periods beyond those of the network are ignored.
+   */
+
+  // Local variables
+  CSV_Parser* csv;
+  FILE* file;
+  size_t bytes_read;
+  BOOL mapped;
+  char buffer[PROFILES_BUFFER_SIZE];
+#ifdef HAVE_SYS_MMAN_H
+  int fd;
+  struct stat st;
+  char* data;
+#endif
+
+  // Check
+  if (!prof)
+    return;
+
+  // Reset
+  prof->num_cols = 0;
+  prof->num_records = -1;
+  prof->field = 0;
+  prof->t = 0;
+
+  // CSV parser
+  csv = CSV_PARSER_new();
+
+  // Memory-mapped file
+  mapped = FALSE;
+#ifdef HAVE_SYS_MMAN_H
+  fd = open(filename,O_RDONLY);
+  if (fd < 0) {
+    PROFILES_set_error(prof,"unable to open file");
+    CSV_PARSER_del(csv);
+    return;
+  }
+  if (fstat(fd,&st) == 0 && st.st_size > 0) {
+    data = (char*)mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if (data != MAP_FAILED) {
+      mapped = TRUE;
+      if (CSV_PARSER_parse(csv,
+			   data,
+			   (size_t)st.st_size,
+			   TRUE,
+			   ',',
+			   '\n',
+			   '#',
+			   PROFILES_callback_field,
+			   PROFILES_callback_record,
+			   prof) != (size_t)st.st_size && !prof->error_flag)
+	PROFILES_set_error(prof,"error parsing buffer");
+      munmap(data,(size_t)st.st_size);
+    }
+  }
+  close(fd);
+#endif
+
+  // Read file in chunks
+  if (!mapped) {
+
+    // Open file
+    file = fopen(filename,"rb");
+    if (!file) {
+      PROFILES_set_error(prof,"unable to open file");
+      CSV_PARSER_del(csv);
+      return;
+    }
+
+    // Parse
+    while ((bytes_read=fread(buffer,1,PROFILES_BUFFER_SIZE,file)) > 0) {
+      if (CSV_PARSER_parse(csv,
+			   buffer,
+			   bytes_read,
+			   feof(file),
+			   ',',
+			   '\n',
+			   '#',
+			   PROFILES_callback_field,
+			   PROFILES_callback_record,
+			   prof) != bytes_read) {
+	if (!prof->error_flag)
+	  PROFILES_set_error(prof,"error parsing buffer");
+	break;
+      }
+      if (prof->error_flag)
+	break;
+    }
+
+    // Close
+    fclose(file);
+  }
+
+  // Free
+  CSV_PARSER_del(csv);
+
+  // Check header
+  if (!prof->error_flag && prof->num_records < 0)
+    PROFILES_set_error(prof,"missing profile header");
+}
+
+Profiles* PROFILES_new(Net* net) {
+
+  // Local variables
+  Profiles* prof;
+
+  // Check
+  if (!net)
+    return NULL;
+
+  // Allocate
+  prof = (Profiles*)malloc(sizeof(Profiles));
+
+  // Error
+  prof->error_flag = FALSE;
+  strcpy(prof->error_string,"");
+
+  // Network
+  prof->net = net;
+
+  // Columns
+  prof->num_cols = 0;
+  prof->max_cols = 0;
+  prof->col_type = NULL;
+  prof->col_qty = NULL;
+  prof->col_obj = NULL;
+
+  // State
+  prof->num_records = -1;
+  prof->field = 0;
+  prof->t = 0;
+
+  return prof;
+}
+
+void PROFILES_set_error(Profiles* prof, char* string) {
+  if (prof) {
+    prof->error_flag = TRUE;
+    strcpy(prof->error_string,string);
+  }
+}
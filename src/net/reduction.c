@@ -0,0 +1,745 @@
+/** @file reduction.c
+ *  @brief This file defines the Red data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <math.h>
+#include <pfnet/array.h>
+#include <pfnet/reduction.h>
+
+// Reduction
+struct Red {
+
+  // Error
+  BOOL error_flag;                    /**< @brief Error flag */
+  char error_string[RED_BUFFER_SIZE]; /**< @brief Error string */
+
+  // Networks
+  Net* net;        /**< @brief Original network (not owned) */
+  Net* red_net;    /**< @brief Reduced network */
+
+  // Maps
+  int* bus_map;    /**< @brief Index in reduced network of each bus of original network (-1 if eliminated) */
+  int* branch_map; /**< @brief Index in reduced network of each branch of original network (-1 if merged or on outage) */
+
+  // Eliminated buses
+  int num_elim;    /**< @brief Number of eliminated buses */
+  int* elim_bus;   /**< @brief Eliminated buses in order of elimination */
+  int* elim_ptr;   /**< @brief Offsets of each eliminated bus into elim_nbr and elim_c (size num_elim+1) */
+  int* elim_nbr;   /**< @brief Neighbors of eliminated buses at the time of elimination */
+  REAL* elim_c_re; /**< @brief Real part of voltage recovery coefficients */
+  REAL* elim_c_im; /**< @brief Imaginary part of voltage recovery coefficients */
+};
+
+void RED_del(Red* red) {
+  if (red) {
+    NET_del(red->red_net);
+    free(red->bus_map);
+    free(red->branch_map);
+    free(red->elim_bus);
+    free(red->elim_ptr);
+    free(red->elim_nbr);
+    free(red->elim_c_re);
+    free(red->elim_c_im);
+    free(red);
+  }
+}
+
+void RED_expand(Red* red) {
+  /** Updates the original network with the state of the reduced network.
+   *  Voltages of kept buses, power injections, shunt susceptances, and
+   *  transformer ratios and phases are copied. Voltages of eliminated
+   *  buses are recovered from those of their neighbors in reverse order
+   *  of elimination (V_z = sum_i c_zi V_i, with c_zi = -Y_zi/Y_zz).
+   */
+
+  // Local variables
+  Net* net;
+  Net* red_net;
+  Bus* bus;
+  Bus* red_bus;
+  Branch* br;
+  Branch* red_br;
+  REAL v_re;
+  REAL v_im;
+  REAL vi_mag;
+  REAL vi_ang;
+  int i;
+  int j;
+  int k;
+  int t;
+
+  // Check
+  if (!red || !red->net || !red->red_net)
+    return;
+
+  // Networks
+  net = red->net;
+  red_net = red->red_net;
+
+  // Kept buses
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    if (red->bus_map[i] < 0)
+      continue;
+    bus = NET_get_bus(net,i);
+    red_bus = NET_get_bus(red_net,red->bus_map[i]);
+    for (t = 0; t < NET_get_num_periods(net); t++) {
+      BUS_set_v_mag(bus,BUS_get_v_mag(red_bus,t),t);
+      BUS_set_v_ang(bus,BUS_get_v_ang(red_bus,t),t);
+    }
+  }
+
+  // Eliminated buses
+  for (k = red->num_elim-1; k >= 0; k--) {
+    bus = NET_get_bus(net,red->elim_bus[k]);
+    for (t = 0; t < NET_get_num_periods(net); t++) {
+      v_re = 0;
+      v_im = 0;
+      for (j = red->elim_ptr[k]; j < red->elim_ptr[k+1]; j++) {
+	vi_mag = BUS_get_v_mag(NET_get_bus(net,red->elim_nbr[j]),t);
+	vi_ang = BUS_get_v_ang(NET_get_bus(net,red->elim_nbr[j]),t);
+	v_re += red->elim_c_re[j]*vi_mag*cos(vi_ang)-red->elim_c_im[j]*vi_mag*sin(vi_ang);
+	v_im += red->elim_c_re[j]*vi_mag*sin(vi_ang)+red->elim_c_im[j]*vi_mag*cos(vi_ang);
+      }
+      BUS_set_v_mag(bus,sqrt(v_re*v_re+v_im*v_im),t);
+      BUS_set_v_ang(bus,atan2(v_im,v_re),t);
+    }
+  }
+
+  // Components
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_gens(net); i++) {
+      GEN_set_P(NET_get_gen(net,i),GEN_get_P(NET_get_gen(red_net,i),t),t);
+      GEN_set_Q(NET_get_gen(net,i),GEN_get_Q(NET_get_gen(red_net,i),t),t);
+    }
+    for (i = 0; i < NET_get_num_loads(net); i++) {
+      LOAD_set_P(NET_get_load(net,i),LOAD_get_P(NET_get_load(red_net,i),t),t);
+      LOAD_set_Q(NET_get_load(net,i),LOAD_get_Q(NET_get_load(red_net,i),t),t);
+    }
+    for (i = 0; i < NET_get_num_shunts(net); i++)
+      SHUNT_set_b(NET_get_shunt(net,i),SHUNT_get_b(NET_get_shunt(red_net,i),t),t);
+    for (i = 0; i < NET_get_num_vargens(net); i++) {
+      VARGEN_set_P(NET_get_vargen(net,i),VARGEN_get_P(NET_get_vargen(red_net,i),t),t);
+      VARGEN_set_Q(NET_get_vargen(net,i),VARGEN_get_Q(NET_get_vargen(red_net,i),t),t);
+    }
+    for (i = 0; i < NET_get_num_bats(net); i++) {
+      BAT_set_P(NET_get_bat(net,i),BAT_get_P(NET_get_bat(red_net,i),t),t);
+      BAT_set_E(NET_get_bat(net,i),BAT_get_E(NET_get_bat(red_net,i),t),t);
+    }
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+      if (red->branch_map[i] < 0)
+	continue;
+      br = NET_get_branch(net,i);
+      red_br = NET_get_branch(red_net,red->branch_map[i]);
+      BRANCH_set_ratio(br,BRANCH_get_ratio(red_br,t),t);
+      BRANCH_set_phase(br,BRANCH_get_phase(red_br,t),t);
+    }
+  }
+}
+
+int* RED_get_bus_map(Red* red) {
+  if (red)
+    return red->bus_map;
+  else
+    return NULL;
+}
+
+int* RED_get_branch_map(Red* red) {
+  if (red)
+    return red->branch_map;
+  else
+    return NULL;
+}
+
+char* RED_get_error_string(Red* red) {
+  if (red)
+    return red->error_string;
+  else
+    return NULL;
+}
+
+Net* RED_get_network(Red* red) {
+  if (red)
+    return red->red_net;
+  else
+    return NULL;
+}
+
+int RED_get_num_eliminated_buses(Red* red) {
+  if (red)
+    return red->num_elim;
+  else
+    return 0;
+}
+
+int* RED_get_eliminated_buses(Red* red) {
+  if (red)
+    return red->elim_bus;
+  else
+    return NULL;
+}
+
+BOOL RED_has_error(Red* red) {
+  if (red)
+    return red->error_flag;
+  else
+    return FALSE;
+}
+
+Red* RED_new(Net* net, int max_degree) {
+  /** Creates a reduced equivalent of the network. Zero-injection buses,
+   *  i.e., buses without generators, loads, shunts, variable generators or
+   *  batteries that are not slack and not regulated, are eliminated from
+   *  the bus admittance matrix (Kron reduction) if they have between 2 and
+   *  max_degree neighbors and all their branches are lines or fixed
+   *  transformers without phase shift. Buses of degree 2 give series
+   *  merges. The reduction is exact for power flow. Eliminated branches
+   *  are replaced by equivalent lines between the neighbors of each
+   *  eliminated bus. Branches on outage are not included in the reduced
+   *  network. The original network must not be modified structurally
+   *  while the reduction is in use.
+   */
+
+  // Local variables
+  Red* red;
+  Net* red_net;
+  Branch* br;
+  Branch* red_br;
+  Bus* bus;
+  Bus* bus_k;
+  Bus* bus_m;
+  Gen* gen;
+  Load* load;
+  Shunt* shunt;
+  Vargen* vargen;
+  Bat* bat;
+  char* cand;
+  char* elim;
+  char* placed;
+  int** inc;
+  int* inc_len;
+  int* inc_cap;
+  int* w_k;
+  int* w_m;
+  int* w_orig;
+  char* w_alive;
+  char* w_simple;
+  REAL* w_g;
+  REAL* w_b;
+  REAL* w_gk;
+  REAL* w_bk;
+  REAL* w_gm;
+  REAL* w_bm;
+  int num_w;
+  int cap_w;
+  int cap_elim;
+  int* pos;
+  int* nbr;
+  REAL* Yzi_re;
+  REAL* Yzi_im;
+  REAL* sh_re;
+  REAL* sh_im;
+  REAL Yzz_re;
+  REAL Yzz_im;
+  REAL Ysh_re;
+  REAL Ysh_im;
+  REAL den;
+  REAL re;
+  REAL im;
+  REAL a;
+  BOOL simple;
+  BOOL changed;
+  int num_buses;
+  int num_branches;
+  int num_red_buses;
+  int num_red_branches;
+  int T;
+  int nn;
+  int z;
+  int e;
+  int f;
+  int i;
+  int j;
+  int k;
+  int m;
+  int t;
+
+  // Allocate
+  red = (Red*)malloc(sizeof(Red));
+  red->error_flag = FALSE;
+  strcpy(red->error_string,"");
+  red->net = net;
+  red->red_net = NULL;
+  red->bus_map = NULL;
+  red->branch_map = NULL;
+  red->num_elim = 0;
+  red->elim_bus = NULL;
+  red->elim_ptr = NULL;
+  red->elim_nbr = NULL;
+  red->elim_c_re = NULL;
+  red->elim_c_im = NULL;
+
+  // Check
+  if (!net) {
+    sprintf(red->error_string,"invalid network");
+    red->error_flag = TRUE;
+    return red;
+  }
+
+  // Sizes
+  num_buses = NET_get_num_buses(net);
+  num_branches = NET_get_num_branches(net);
+  T = NET_get_num_periods(net);
+
+  // Candidate buses
+  ARRAY_zalloc(cand,char,num_buses);
+  ARRAY_zalloc(elim,char,num_buses);
+  for (i = 0; i < num_buses; i++) {
+    bus = NET_get_bus(net,i);
+    cand[i] = (!BUS_is_slack(bus) &&
+	       !BUS_get_gen(bus) &&
+	       !BUS_get_load(bus) &&
+	       !BUS_get_shunt(bus) &&
+	       !BUS_get_vargen(bus) &&
+	       !BUS_get_bat(bus) &&
+	       !BUS_is_regulated_by_gen(bus) &&
+	       !BUS_is_regulated_by_tran(bus) &&
+	       !BUS_is_regulated_by_shunt(bus));
+  }
+
+  // Working branches (pi equivalents)
+  cap_w = num_branches+1;
+  ARRAY_alloc(w_k,int,cap_w);
+  ARRAY_alloc(w_m,int,cap_w);
+  ARRAY_alloc(w_orig,int,cap_w);
+  ARRAY_alloc(w_alive,char,cap_w);
+  ARRAY_alloc(w_simple,char,cap_w);
+  ARRAY_alloc(w_g,REAL,cap_w);
+  ARRAY_alloc(w_b,REAL,cap_w);
+  ARRAY_alloc(w_gk,REAL,cap_w);
+  ARRAY_alloc(w_bk,REAL,cap_w);
+  ARRAY_alloc(w_gm,REAL,cap_w);
+  ARRAY_alloc(w_bm,REAL,cap_w);
+  ARRAY_alloc(inc,int*,num_buses);
+  ARRAY_zalloc(inc_len,int,num_buses);
+  ARRAY_alloc(inc_cap,int,num_buses);
+  for (i = 0; i < num_buses; i++) {
+    inc_cap[i] = 4;
+    ARRAY_alloc(inc[i],int,inc_cap[i]);
+  }
+  num_w = 0;
+  for (i = 0; i < num_branches; i++) {
+    br = NET_get_branch(net,i);
+    bus_k = BRANCH_get_bus_k(br);
+    bus_m = BRANCH_get_bus_m(br);
+    if (BRANCH_is_on_outage(br) || !bus_k || !bus_m)
+      continue;
+
+    // Simple
+    simple = ((BRANCH_is_line(br) || BRANCH_is_fixed_tran(br)) &&
+	      !BRANCH_get_reg_bus(br) &&
+	      bus_k != bus_m);
+    a = BRANCH_get_ratio(br,0);
+    for (t = 0; t < T; t++) {
+      if (BRANCH_get_phase(br,t) != 0. || BRANCH_get_ratio(br,t) != a)
+	simple = FALSE;
+    }
+
+    // Pi equivalent (y' = a*y, yk' = a^2*(y+yk)-a*y, ym' = y+ym-a*y)
+    e = num_w++;
+    w_k[e] = BUS_get_index(bus_k);
+    w_m[e] = BUS_get_index(bus_m);
+    w_orig[e] = i;
+    w_alive[e] = TRUE;
+    w_simple[e] = simple;
+    w_g[e] = a*BRANCH_get_g(br);
+    w_b[e] = a*BRANCH_get_b(br);
+    w_gk[e] = a*a*(BRANCH_get_g(br)+BRANCH_get_g_k(br))-a*BRANCH_get_g(br);
+    w_bk[e] = a*a*(BRANCH_get_b(br)+BRANCH_get_b_k(br))-a*BRANCH_get_b(br);
+    w_gm[e] = BRANCH_get_g_m(br)+(1.-a)*BRANCH_get_g(br);
+    w_bm[e] = BRANCH_get_b_m(br)+(1.-a)*BRANCH_get_b(br);
+    for (k = 0; k < 2; k++) {
+      m = (k == 0) ? w_k[e] : w_m[e];
+      if (inc_len[m] == inc_cap[m]) {
+	inc_cap[m] *= 2;
+	inc[m] = (int*)realloc(inc[m],inc_cap[m]*sizeof(int));
+      }
+      inc[m][inc_len[m]++] = e;
+    }
+  }
+
+  // Elimination data
+  cap_elim = num_buses+1;
+  ARRAY_alloc(red->elim_bus,int,num_buses+1);
+  ARRAY_alloc(red->elim_ptr,int,num_buses+1);
+  ARRAY_alloc(red->elim_nbr,int,cap_elim);
+  ARRAY_alloc(red->elim_c_re,REAL,cap_elim);
+  ARRAY_alloc(red->elim_c_im,REAL,cap_elim);
+  red->elim_ptr[0] = 0;
+
+  // Local work arrays
+  ARRAY_alloc(pos,int,num_buses);
+  for (i = 0; i < num_buses; i++)
+    pos[i] = -1;
+  ARRAY_alloc(nbr,int,num_buses+1);
+  ARRAY_alloc(placed,char,num_buses+1);
+  ARRAY_alloc(Yzi_re,REAL,num_buses+1);
+  ARRAY_alloc(Yzi_im,REAL,num_buses+1);
+  ARRAY_alloc(sh_re,REAL,num_buses+1);
+  ARRAY_alloc(sh_im,REAL,num_buses+1);
+
+  // Eliminate
+  changed = (max_degree >= 2);
+  while (changed) {
+    changed = FALSE;
+    for (z = 0; z < num_buses; z++) {
+
+      if (!cand[z] || elim[z])
+	continue;
+
+      // Neighbors and admittances
+      simple = TRUE;
+      nn = 0;
+      Yzz_re = 0;
+      Yzz_im = 0;
+      Ysh_re = 0;
+      Ysh_im = 0;
+      for (j = 0; j < inc_len[z]; j++) {
+	e = inc[z][j];
+	if (!w_alive[e])
+	  continue;
+	if (!w_simple[e]) {
+	  simple = FALSE;
+	  break;
+	}
+	i = (w_k[e] == z) ? w_m[e] : w_k[e];
+	if (pos[i] < 0) {
+	  pos[i] = nn;
+	  nbr[nn] = i;
+	  Yzi_re[nn] = 0;
+	  Yzi_im[nn] = 0;
+	  sh_re[nn] = 0;
+	  sh_im[nn] = 0;
+	  nn++;
+	}
+	Yzi_re[pos[i]] -= w_g[e];
+	Yzi_im[pos[i]] -= w_b[e];
+	Yzz_re += w_g[e];
+	Yzz_im += w_b[e];
+	if (w_k[e] == z) {
+	  Ysh_re += w_gk[e];
+	  Ysh_im += w_bk[e];
+	  sh_re[pos[i]] += w_gm[e];
+	  sh_im[pos[i]] += w_bm[e];
+	}
+	else {
+	  Ysh_re += w_gm[e];
+	  Ysh_im += w_bm[e];
+	  sh_re[pos[i]] += w_gk[e];
+	  sh_im[pos[i]] += w_bk[e];
+	}
+      }
+      Yzz_re += Ysh_re;
+      Yzz_im += Ysh_im;
+      den = Yzz_re*Yzz_re+Yzz_im*Yzz_im;
+      for (k = 0; k < nn; k++)
+	pos[nbr[k]] = -1;
+      if (!simple || nn < 2 || nn > max_degree || sqrt(den) < RED_EPS)
+	continue;
+
+      // Recovery coefficients (c_i = -Y_zi/Y_zz)
+      if (red->elim_ptr[red->num_elim]+nn > cap_elim) {
+	cap_elim = 2*(red->elim_ptr[red->num_elim]+nn);
+	red->elim_nbr = (int*)realloc(red->elim_nbr,cap_elim*sizeof(int));
+	red->elim_c_re = (REAL*)realloc(red->elim_c_re,cap_elim*sizeof(REAL));
+	red->elim_c_im = (REAL*)realloc(red->elim_c_im,cap_elim*sizeof(REAL));
+      }
+      for (k = 0; k < nn; k++) {
+	j = red->elim_ptr[red->num_elim]+k;
+	red->elim_nbr[j] = nbr[k];
+	red->elim_c_re[j] = -(Yzi_re[k]*Yzz_re+Yzi_im[k]*Yzz_im)/den;
+	red->elim_c_im[j] = -(Yzi_im[k]*Yzz_re-Yzi_re[k]*Yzz_im)/den;
+      }
+      red->elim_bus[red->num_elim] = z;
+      red->elim_ptr[red->num_elim+1] = red->elim_ptr[red->num_elim]+nn;
+      red->num_elim++;
+
+      // Shunts of neighbors (sh_i = ysh_i - Y_zi*Ysh_z/Y_zz)
+      re = (Ysh_re*Yzz_re+Ysh_im*Yzz_im)/den;
+      im = (Ysh_im*Yzz_re-Ysh_re*Yzz_im)/den;
+      for (k = 0; k < nn; k++) {
+	sh_re[k] -= Yzi_re[k]*re-Yzi_im[k]*im;
+	sh_im[k] -= Yzi_re[k]*im+Yzi_im[k]*re;
+	placed[k] = FALSE;
+      }
+
+      // Remove branches of z
+      for (j = 0; j < inc_len[z]; j++)
+	w_alive[inc[z][j]] = FALSE;
+      elim[z] = TRUE;
+
+      // Equivalent branches (y_ij = Y_zi*Y_zj/Y_zz)
+      for (i = 0; i < nn; i++) {
+	for (k = i+1; k < nn; k++) {
+
+	  // Existing equivalent branch
+	  e = -1;
+	  for (j = 0; j < inc_len[nbr[i]]; j++) {
+	    f = inc[nbr[i]][j];
+	    if (w_alive[f] && w_orig[f] < 0 &&
+		(w_k[f] == nbr[k] || w_m[f] == nbr[k])) {
+	      e = f;
+	      break;
+	    }
+	  }
+
+	  // New equivalent branch
+	  if (e < 0) {
+	    if (num_w == cap_w) {
+	      cap_w *= 2;
+	      w_k = (int*)realloc(w_k,cap_w*sizeof(int));
+	      w_m = (int*)realloc(w_m,cap_w*sizeof(int));
+	      w_orig = (int*)realloc(w_orig,cap_w*sizeof(int));
+	      w_alive = (char*)realloc(w_alive,cap_w*sizeof(char));
+	      w_simple = (char*)realloc(w_simple,cap_w*sizeof(char));
+	      w_g = (REAL*)realloc(w_g,cap_w*sizeof(REAL));
+	      w_b = (REAL*)realloc(w_b,cap_w*sizeof(REAL));
+	      w_gk = (REAL*)realloc(w_gk,cap_w*sizeof(REAL));
+	      w_bk = (REAL*)realloc(w_bk,cap_w*sizeof(REAL));
+	      w_gm = (REAL*)realloc(w_gm,cap_w*sizeof(REAL));
+	      w_bm = (REAL*)realloc(w_bm,cap_w*sizeof(REAL));
+	    }
+	    e = num_w++;
+	    w_k[e] = nbr[i];
+	    w_m[e] = nbr[k];
+	    w_orig[e] = -1;
+	    w_alive[e] = TRUE;
+	    w_simple[e] = TRUE;
+	    w_g[e] = 0;
+	    w_b[e] = 0;
+	    w_gk[e] = 0;
+	    w_bk[e] = 0;
+	    w_gm[e] = 0;
+	    w_bm[e] = 0;
+	    for (j = 0; j < 2; j++) {
+	      m = (j == 0) ? w_k[e] : w_m[e];
+	      if (inc_len[m] == inc_cap[m]) {
+		inc_cap[m] *= 2;
+		inc[m] = (int*)realloc(inc[m],inc_cap[m]*sizeof(int));
+	      }
+	      inc[m][inc_len[m]++] = e;
+	    }
+	  }
+
+	  // Series admittance
+	  re = (Yzi_re[i]*Yzi_re[k]-Yzi_im[i]*Yzi_im[k]);
+	  im = (Yzi_re[i]*Yzi_im[k]+Yzi_im[i]*Yzi_re[k]);
+	  w_g[e] += (re*Yzz_re+im*Yzz_im)/den;
+	  w_b[e] += (im*Yzz_re-re*Yzz_im)/den;
+
+	  // Shunts
+	  for (j = 0; j < 2; j++) {
+	    m = (j == 0) ? i : k;
+	    if (placed[m])
+	      continue;
+	    placed[m] = TRUE;
+	    if (w_k[e] == nbr[m]) {
+	      w_gk[e] += sh_re[m];
+	      w_bk[e] += sh_im[m];
+	    }
+	    else {
+	      w_gm[e] += sh_re[m];
+	      w_bm[e] += sh_im[m];
+	    }
+	  }
+	}
+      }
+      changed = TRUE;
+    }
+  }
+
+  // Bus map
+  ARRAY_alloc(red->bus_map,int,num_buses);
+  num_red_buses = 0;
+  for (i = 0; i < num_buses; i++)
+    red->bus_map[i] = elim[i] ? -1 : num_red_buses++;
+
+  // Branch map
+  ARRAY_alloc(red->branch_map,int,num_branches);
+  for (i = 0; i < num_branches; i++)
+    red->branch_map[i] = -1;
+  num_red_branches = 0;
+  for (e = 0; e < num_w; e++) {
+    if (w_alive[e] && w_orig[e] >= 0)
+      red->branch_map[w_orig[e]] = num_red_branches++;
+  }
+  for (e = 0; e < num_w; e++) {
+    if (w_alive[e] && w_orig[e] < 0)
+      num_red_branches++;
+  }
+
+  // Reduced network
+  red_net = NET_new(T);
+  red->red_net = red_net;
+  NET_set_base_power(red_net,NET_get_base_power(net));
+  NET_set_bus_array(red_net,BUS_array_new(num_red_buses,T),num_red_buses);
+  NET_set_branch_array(red_net,BRANCH_array_new(num_red_branches,T),num_red_branches);
+  NET_set_gen_array(red_net,GEN_array_new(NET_get_num_gens(net),T),NET_get_num_gens(net));
+  NET_set_load_array(red_net,LOAD_array_new(NET_get_num_loads(net),T),NET_get_num_loads(net));
+  NET_set_shunt_array(red_net,SHUNT_array_new(NET_get_num_shunts(net),T),NET_get_num_shunts(net));
+  NET_set_vargen_array(red_net,VARGEN_array_new(NET_get_num_vargens(net),T),NET_get_num_vargens(net));
+  NET_set_bat_array(red_net,BAT_array_new(NET_get_num_bats(net),T),NET_get_num_bats(net));
+
+  // Buses
+  for (i = 0; i < num_buses; i++) {
+    if (red->bus_map[i] < 0)
+      continue;
+    bus = NET_get_bus(red_net,red->bus_map[i]);
+    BUS_copy_from_bus(bus,NET_get_bus(net,i));
+    NET_bus_hash_number_add(red_net,bus);
+    NET_bus_hash_name_add(red_net,bus);
+  }
+
+  // Branches
+  for (e = 0; e < num_w; e++) {
+    if (!w_alive[e])
+      continue;
+    bus_k = NET_get_bus(red_net,red->bus_map[w_k[e]]);
+    bus_m = NET_get_bus(red_net,red->bus_map[w_m[e]]);
+    if (w_orig[e] >= 0) {
+      br = NET_get_branch(net,w_orig[e]);
+      red_br = NET_get_branch(red_net,red->branch_map[w_orig[e]]);
+      BRANCH_copy_from_branch(red_br,br);
+      bus = BRANCH_get_reg_bus(br);
+      if (bus) {
+	bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+	BRANCH_set_reg_bus(red_br,bus);
+	BUS_add_reg_tran(bus,red_br);
+      }
+    }
+    else {
+      red_br = NET_get_branch(red_net,--num_red_branches);
+      BRANCH_set_type(red_br,BRANCH_TYPE_LINE);
+      BRANCH_set_g(red_br,w_g[e]);
+      BRANCH_set_b(red_br,w_b[e]);
+      BRANCH_set_g_k(red_br,w_gk[e]);
+      BRANCH_set_b_k(red_br,w_bk[e]);
+      BRANCH_set_g_m(red_br,w_gm[e]);
+      BRANCH_set_b_m(red_br,w_bm[e]);
+    }
+    BRANCH_set_bus_k(red_br,bus_k);
+    BRANCH_set_bus_m(red_br,bus_m);
+    BUS_add_branch_k(bus_k,red_br);
+    BUS_add_branch_m(bus_m,red_br);
+  }
+
+  // Generators
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(red_net,i);
+    GEN_copy_from_gen(gen,NET_get_gen(net,i));
+    bus = GEN_get_bus(NET_get_gen(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      GEN_set_bus(gen,bus);
+      BUS_add_gen(bus,gen);
+    }
+    bus = GEN_get_reg_bus(NET_get_gen(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      GEN_set_reg_bus(gen,bus);
+      BUS_add_reg_gen(bus,gen);
+    }
+  }
+
+  // Loads
+  for (i = 0; i < NET_get_num_loads(net); i++) {
+    load = NET_get_load(red_net,i);
+    LOAD_copy_from_load(load,NET_get_load(net,i));
+    bus = LOAD_get_bus(NET_get_load(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      LOAD_set_bus(load,bus);
+      BUS_add_load(bus,load);
+    }
+  }
+
+  // Shunts
+  for (i = 0; i < NET_get_num_shunts(net); i++) {
+    shunt = NET_get_shunt(red_net,i);
+    SHUNT_copy_from_shunt(shunt,NET_get_shunt(net,i));
+    bus = SHUNT_get_bus(NET_get_shunt(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      SHUNT_set_bus(shunt,bus);
+      BUS_add_shunt(bus,shunt);
+    }
+    bus = SHUNT_get_reg_bus(NET_get_shunt(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      SHUNT_set_reg_bus(shunt,bus);
+      BUS_add_reg_shunt(bus,shunt);
+    }
+  }
+
+  // Variable generators
+  for (i = 0; i < NET_get_num_vargens(net); i++) {
+    vargen = NET_get_vargen(red_net,i);
+    VARGEN_copy_from_vargen(vargen,NET_get_vargen(net,i));
+    bus = VARGEN_get_bus(NET_get_vargen(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      VARGEN_set_bus(vargen,bus);
+      BUS_add_vargen(bus,vargen);
+    }
+  }
+
+  // Batteries
+  for (i = 0; i < NET_get_num_bats(net); i++) {
+    bat = NET_get_bat(red_net,i);
+    BAT_copy_from_bat(bat,NET_get_bat(net,i));
+    bus = BAT_get_bus(NET_get_bat(net,i));
+    if (bus) {
+      bus = NET_get_bus(red_net,red->bus_map[BUS_get_index(bus)]);
+      BAT_set_bus(bat,bus);
+      BUS_add_bat(bus,bat);
+    }
+  }
+
+  // Flags
+  NET_clear_flags(red_net);
+
+  // Clean up
+  for (i = 0; i < num_buses; i++)
+    free(inc[i]);
+  free(inc);
+  free(inc_len);
+  free(inc_cap);
+  free(w_k);
+  free(w_m);
+  free(w_orig);
+  free(w_alive);
+  free(w_simple);
+  free(w_g);
+  free(w_b);
+  free(w_gk);
+  free(w_bk);
+  free(w_gm);
+  free(w_bm);
+  free(cand);
+  free(elim);
+  free(pos);
+  free(nbr);
+  free(placed);
+  free(Yzi_re);
+  free(Yzi_im);
+  free(sh_re);
+  free(sh_im);
+
+  // Return
+  return red;
+}
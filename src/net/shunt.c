@@ -247,6 +247,22 @@ int SHUNT_get_num_periods(Shunt* shunt) {
     return 0;
 }
 
+REAL* SHUNT_get_series(Shunt* shunt, char* name) {
+  /** Returns the shunt time series (array of length num_periods)
+   *  with the given name, e.g. "b", or NULL if there is no such series.
+   */
+  if (!shunt || !name)
+    return NULL;
+  if (strcmp(name,"b") == 0)
+    return shunt->b;
+  else if (strcmp(name,"sens_b_u_bound") == 0)
+    return shunt->sens_b_u_bound;
+  else if (strcmp(name,"sens_b_l_bound") == 0)
+    return shunt->sens_b_l_bound;
+  else
+    return NULL;
+}
+
 char SHUNT_get_obj_type(void* shunt) {
   if (shunt)
     return OBJ_SHUNT;
@@ -448,45 +464,53 @@ Vec* SHUNT_get_var_indices(void* vshunt, unsigned char var, int t_start, int t_e
 char* SHUNT_get_json_string(Shunt* shunt, char* output) {
 
   // Local variables
-  char temp[SHUNT_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;
+  JSON_Writer* writer;
+  size_t len;
 
   // No shunt
   if (!shunt)
     return NULL;
 
-  // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*SHUNT_BUFFER_SIZE*SHUNT_NUM_JSON_FIELDS*shunt->num_periods);
-    resize = TRUE;
-  }
-  output_start = output;
-
   // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",shunt->index,FALSE);
-  JSON_obj(temp,output,"bus",shunt->bus,BUS_get_index,FALSE);
-  JSON_obj(temp,output,"reg_bus",shunt->reg_bus,BUS_get_index,FALSE);
-  JSON_int(temp,output,"num_periods",shunt->num_periods,FALSE);
-  JSON_str(temp,output,"name",shunt->name,FALSE);
-  JSON_float(temp,output,"g",shunt->g,FALSE);
-  JSON_array_float(temp,output,"b",shunt->b,shunt->num_periods,FALSE);
-  JSON_float(temp,output,"b_max",shunt->b_max,FALSE);
-  JSON_float(temp,output,"b_min",shunt->b_min,FALSE);
-  JSON_array_float(temp,output,"b_values",shunt->b_values,shunt->num_b_values,TRUE);
-  JSON_end(output);
-  
+  writer = JSON_WRITER_new();
+  SHUNT_write_json(shunt,writer);
+
   // Output
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
+  }
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void SHUNT_write_json(Shunt* shunt, JSON_Writer* writer) {
+  /** Writes shunt as json object. */
+
+  // No shunt
+  if (!shunt)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",shunt->index,FALSE);
+  JSON_obj(writer,"bus",shunt->bus,BUS_get_index,FALSE);
+  JSON_obj(writer,"reg_bus",shunt->reg_bus,BUS_get_index,FALSE);
+  JSON_int(writer,"num_periods",shunt->num_periods,FALSE);
+  JSON_str(writer,"name",shunt->name,FALSE);
+  JSON_float(writer,"g",shunt->g,FALSE);
+  JSON_array_float(writer,"b",shunt->b,shunt->num_periods,FALSE);
+  JSON_float(writer,"b_max",shunt->b_max,FALSE);
+  JSON_float(writer,"b_min",shunt->b_min,FALSE);
+  JSON_array_float(writer,"b_values",shunt->b_values,shunt->num_b_values,TRUE);
+  JSON_end(writer);
+}
+
 BOOL SHUNT_has_flags(void* vshunt, char flag_type, unsigned char mask) {
   Shunt* shunt = (Shunt*)vshunt;
   if (shunt) {
@@ -727,3 +751,17 @@ void SHUNT_propagate_data_in_time(Shunt* shunt, int start, int end) {
       shunt->b[t] = shunt->b[start];
   }
 }
+
+void SHUNT_shift_periods(Shunt* shunt, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period.
+   */
+  int t;
+  int s;
+  if (shunt && k > 0 && shunt->num_periods > 0) {
+    for (t = 0; t < shunt->num_periods; t++) {
+      s = t+k < shunt->num_periods ? t+k : shunt->num_periods-1;
+      shunt->b[t] = shunt->b[s];
+    }
+  }
+}
@@ -204,6 +204,24 @@ int VARGEN_get_num_periods(Vargen* gen) {
     return 0;
 }
 
+REAL* VARGEN_get_series(Vargen* gen, char* name) {
+  /** Returns the variable generator time series (array of length num_periods)
+   *  with the given name, e.g. "P", or NULL if there is no such series.
+   */
+  if (!gen || !name)
+    return NULL;
+  if (strcmp(name,"P") == 0)
+    return gen->P;
+  else if (strcmp(name,"P_ava") == 0)
+    return gen->P_ava;
+  else if (strcmp(name,"P_std") == 0)
+    return gen->P_std;
+  else if (strcmp(name,"Q") == 0)
+    return gen->Q;
+  else
+    return NULL;
+}
+
 char* VARGEN_get_name(Vargen* gen) {
   if (gen)
     return gen->name;
@@ -462,47 +480,55 @@ Vec* VARGEN_get_var_indices(void* vgen, unsigned char var, int t_start, int t_en
 char* VARGEN_get_json_string(Vargen* gen, char* output) {
 
   // Local variables
-  char temp[VARGEN_BUFFER_SIZE];
-  char* output_start;
-  BOOL resize;  
+  JSON_Writer* writer;
+  size_t len;
 
   // No gen
   if (!gen)
     return NULL;
 
+  // Write
+  writer = JSON_WRITER_new();
+  VARGEN_write_json(gen,writer);
+
   // Output
-  if (output)
-    resize = FALSE;
-  else {
-    output = (char*)malloc(sizeof(char)*VARGEN_BUFFER_SIZE*VARGEN_NUM_JSON_FIELDS*gen->num_periods);
-    resize = TRUE;
+  if (output) {
+    len = JSON_WRITER_get_length(writer);
+    memcpy(output,JSON_WRITER_get_string(writer),len+1);
+    output += len;
   }
-  output_start = output;
-
-  // Write
-  JSON_start(output);
-  JSON_int(temp,output,"index",gen->index,FALSE);
-  JSON_obj(temp,output,"bus",gen->bus,BUS_get_index,FALSE);
-  JSON_int(temp,output,"num_periods",gen->num_periods,FALSE);
-  JSON_str(temp,output,"name",gen->name,FALSE);
-  JSON_array_float(temp,output,"P",gen->P,gen->num_periods,FALSE);
-  JSON_array_float(temp,output,"P_ava",gen->P_ava,gen->num_periods,FALSE)
-  JSON_float(temp,output,"P_max",gen->P_max,FALSE);
-  JSON_float(temp,output,"P_min",gen->P_min,FALSE);
-  JSON_array_float(temp,output,"P_std",gen->P_std,gen->num_periods,FALSE);
-  JSON_array_float(temp,output,"Q",gen->Q,gen->num_periods,FALSE);
-  JSON_float(temp,output,"Q_max",gen->Q_max,FALSE);
-  JSON_float(temp,output,"Q_min",gen->Q_min,TRUE);
-  JSON_end(output);
-  
-  // Resize
-  if (resize)
-    output = (char*)realloc(output_start,sizeof(char)*(strlen(output_start)+1)); // +1 important!
+  else
+    output = JSON_WRITER_release_string(writer);
+  JSON_WRITER_del(writer);
 
   // Return
   return output;
 }
 
+void VARGEN_write_json(Vargen* gen, JSON_Writer* writer) {
+  /** Writes variable generator as json object. */
+
+  // No gen
+  if (!gen)
+    return;
+
+  // Write
+  JSON_start(writer);
+  JSON_int(writer,"index",gen->index,FALSE);
+  JSON_obj(writer,"bus",gen->bus,BUS_get_index,FALSE);
+  JSON_int(writer,"num_periods",gen->num_periods,FALSE);
+  JSON_str(writer,"name",gen->name,FALSE);
+  JSON_array_float(writer,"P",gen->P,gen->num_periods,FALSE);
+  JSON_array_float(writer,"P_ava",gen->P_ava,gen->num_periods,FALSE)
+  JSON_float(writer,"P_max",gen->P_max,FALSE);
+  JSON_float(writer,"P_min",gen->P_min,FALSE);
+  JSON_array_float(writer,"P_std",gen->P_std,gen->num_periods,FALSE);
+  JSON_array_float(writer,"Q",gen->Q,gen->num_periods,FALSE);
+  JSON_float(writer,"Q_max",gen->Q_max,FALSE);
+  JSON_float(writer,"Q_min",gen->Q_min,TRUE);
+  JSON_end(writer);
+}
+
 
 BOOL VARGEN_has_flags(void* vgen, char flag_type, unsigned char mask) {
   Vargen* gen = (Vargen*)vgen;
@@ -744,3 +770,20 @@ void VARGEN_propagate_data_in_time(Vargen* gen, int start, int end) {
   }
 }
 
+void VARGEN_shift_periods(Vargen* gen, int k) {
+  /** Moves time series k periods back (period t takes the data of period t+k).
+   *  Trailing periods keep the data of the last period.
+   */
+  int t;
+  int s;
+  if (gen && k > 0 && gen->num_periods > 0) {
+    for (t = 0; t < gen->num_periods; t++) {
+      s = t+k < gen->num_periods ? t+k : gen->num_periods-1;
+      gen->P[t] = gen->P[s];
+      gen->P_ava[t] = gen->P_ava[s];
+      gen->P_std[t] = gen->P_std[s];
+      gen->Q[t] = gen->Q[s];
+    }
+  }
+}
+
@@ -12,6 +12,7 @@
 #include <pfnet/parser_MAT.h>
 #include <pfnet/parser_ART.h>
 #include <pfnet/parser_RAW.h>
+#include <pfnet/parser_BIN.h>
 
 struct Parser {
 
@@ -62,6 +63,8 @@ Parser* PARSER_new_for_file(char* f) {
     return MAT_PARSER_new();
   if (strcmp(ext+1,"art") == 0)
     return ART_PARSER_new();
+  if (strcmp(ext+1,"pfb") == 0)
+    return BIN_PARSER_new();
   return NULL;
 }
 
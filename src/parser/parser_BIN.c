@@ -0,0 +1,946 @@
+/** @file parser_BIN.c
+ *  @brief This file defines the BIN_Parser data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ *
+ * Snapshot layout (version 1, native byte order): magic, header integers,
+ * base power, and then, for buses, branches, generators, loads, shunts,
+ * variable generators and batteries, one block per field holding the
+ * field of all components (names as offsets plus characters, time series
+ * as component-major arrays, connections as component indices or -1,
+ * bus lists in compressed row form). Flags and the first variable index
+ * of each variable type of each component come last. Every block starts
+ * at a multiple of BIN_PARSER_ALIGN bytes so that it can be used in place
+ * from a memory-mapped file.
+ */
+
+#include <pfnet/parser_BIN.h>
+#include <pfnet/pfnet_config.h>
+#include <pfnet/array.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Writes column of n values (loop variable i)
+#define BIN_write_col(file,type,n,expr) {				\
+    type* _col_ = (type*)malloc(sizeof(type)*((n)+1));			\
+    for (i = 0; i < (n); i++)						\
+      _col_[i] = (expr);						\
+    BIN_PARSER_write_block(file,_col_,sizeof(type)*(n));		\
+    free(_col_);							\
+  }
+
+// Writes column of n time series (loop variables i and t)
+#define BIN_write_col_T(file,n,expr) {					\
+    REAL* _col_ = (REAL*)malloc(sizeof(REAL)*((n)*T+1));		\
+    for (i = 0; i < (n); i++) {						\
+      for (t = 0; t < T; t++)						\
+	_col_[i*T+t] = (expr);						\
+    }									\
+    BIN_PARSER_write_block(file,_col_,sizeof(REAL)*(n)*T);		\
+    free(_col_);							\
+  }
+
+// Writes names of n components (loop variable i)
+#define BIN_write_names(file,n,expr) {					\
+    int* _off_ = (int*)malloc(sizeof(int)*((n)+1));			\
+    char* _str_;							\
+    _off_[0] = 0;							\
+    for (i = 0; i < (n); i++)						\
+      _off_[i+1] = _off_[i]+strlen(expr);				\
+    _str_ = (char*)malloc(sizeof(char)*(_off_[n]+1));			\
+    for (i = 0; i < (n); i++)						\
+      memcpy(_str_+_off_[i],(expr),_off_[i+1]-_off_[i]);		\
+    BIN_PARSER_write_block(file,_off_,sizeof(int)*((n)+1));		\
+    BIN_PARSER_write_block(file,_str_,_off_[n]);			\
+    free(_off_);							\
+    free(_str_);							\
+  }
+
+// Writes list of components of each of n buses (loop variable i)
+#define BIN_write_list(file,n,type,first,next,index) {			\
+    int* _ptr_ = (int*)malloc(sizeof(int)*((n)+1));			\
+    int* _idx_;								\
+    type* _c_;								\
+    _ptr_[0] = 0;							\
+    for (i = 0; i < (n); i++) {						\
+      _ptr_[i+1] = _ptr_[i];						\
+      for (_c_ = first(NET_get_bus(net,i)); _c_; _c_ = next(_c_))	\
+	_ptr_[i+1]++;							\
+    }									\
+    _idx_ = (int*)malloc(sizeof(int)*(_ptr_[n]+1));			\
+    for (i = 0; i < (n); i++) {						\
+      k = _ptr_[i];							\
+      for (_c_ = first(NET_get_bus(net,i)); _c_; _c_ = next(_c_))	\
+	_idx_[k++] = index(_c_);					\
+    }									\
+    BIN_PARSER_write_block(file,_ptr_,sizeof(int)*((n)+1));		\
+    BIN_PARSER_write_block(file,_idx_,sizeof(int)*_ptr_[n]);		\
+    free(_ptr_);							\
+    free(_idx_);							\
+  }
+
+// Reads column of n values (loop variable i)
+#define BIN_read_col(p,type,n,val,stmt) {				\
+    type* _col_ = (type*)BIN_PARSER_read_block(p,sizeof(type)*(n));	\
+    type val;								\
+    for (i = 0; _col_ && i < (n); i++) {				\
+      val = _col_[i];							\
+      stmt;								\
+    }									\
+  }
+
+// Reads column of n time series into the series with the given name of the components (loop variable i)
+#define BIN_read_series(p,obj_type,n,name) {				\
+    REAL* _col_ = (REAL*)BIN_PARSER_read_block(p,sizeof(REAL)*(n)*T_data); \
+    REAL* _series_;							\
+    for (i = 0; _col_ && i < (n); i++) {				\
+      _series_ = NET_get_series_of_component(net,obj_type,i,name);	\
+      if (_series_)							\
+	memcpy(_series_,_col_+(size_t)i*T_data,sizeof(REAL)*T_min);	\
+    }									\
+  }
+
+// Reads names of n components (loop variable i)
+#define BIN_read_names(p,n,name,stmt) {				\
+    int* _off_ = BIN_PARSER_read_ptr(p,n);				\
+    char* _str_ = _off_ ? (char*)BIN_PARSER_read_block(p,_off_[n]) : NULL; \
+    char name[BIN_PARSER_BUFFER_SIZE];					\
+    size_t _len_;							\
+    for (i = 0; _str_ && i < (n); i++) {				\
+      if (_off_[i] < 0 || _off_[i+1] < _off_[i] || _off_[i+1] > _off_[n]) \
+	break;								\
+      _len_ = _off_[i+1]-_off_[i];					\
+      if (_len_ > BIN_PARSER_BUFFER_SIZE-1)				\
+	_len_ = BIN_PARSER_BUFFER_SIZE-1;				\
+      memcpy(name,_str_+_off_[i],_len_);				\
+      name[_len_] = 0;							\
+      stmt;								\
+    }									\
+  }
+
+// Reads list of components of each of n buses (loop variable i)
+#define BIN_read_list(p,n,num,index,stmt) {				\
+    int* _ptr_ = BIN_PARSER_read_ptr(p,n);				\
+    int* _idx_ = _ptr_ ? (int*)BIN_PARSER_read_block(p,sizeof(int)*_ptr_[n]) : NULL; \
+    int index;								\
+    for (i = 0; _idx_ && i < (n); i++) {				\
+      for (k = _ptr_[i]; k >= 0 && k < _ptr_[i+1] && k < _ptr_[n]; k++) { \
+	index = _idx_[k];						\
+	if (index >= 0 && index < (num))				\
+	  stmt;								\
+      }									\
+    }									\
+  }
+
+struct BIN_Parser {
+
+  // Data
+  char* data;  /**< @brief Snapshot contents */
+  size_t size; /**< @brief Size of snapshot in bytes */
+  size_t pos;  /**< @brief Current position */
+};
+
+Parser* BIN_PARSER_new(void) {
+  Parser* p = PARSER_new();
+  PARSER_set_func_init(p,&BIN_PARSER_init);
+  PARSER_set_func_parse(p,&BIN_PARSER_parse);
+  PARSER_set_func_set(p,&BIN_PARSER_set);
+  PARSER_set_func_show(p,&BIN_PARSER_show);
+  PARSER_set_func_write(p,&BIN_PARSER_write);
+  PARSER_set_func_free(p,&BIN_PARSER_free);
+  PARSER_init(p);
+  return p;
+}
+
+void BIN_PARSER_init(Parser* p) {
+
+  // Local variables
+  BIN_Parser* parser;
+
+  // No parser
+  if (!p)
+    return;
+
+  // Allocate
+  parser = (BIN_Parser*)malloc(sizeof(BIN_Parser));
+  parser->data = NULL;
+  parser->size = 0;
+  parser->pos = 0;
+
+  // Set parser
+  PARSER_set_data(p,(void*)parser);
+}
+
+Net* BIN_PARSER_parse(Parser* p, char* filename, int num_periods) {
+  /** Loads network from binary snapshot. The file is memory-mapped (or
+   *  read with a single call) and the blocks of each field are copied
+   *  into the network components. Component counts that are negative or
+   *  do not fit in the snapshot are rejected before allocating.
+   */
+
+  // Local variables
+  Net* net;
+  char* ext;
+  char* magic;
+  int* header;
+  REAL* base_power;
+  BIN_Parser* parser;
+  Bus* bus;
+  FILE* file;
+  BOOL mapped;
+  int* b_ptr;
+  REAL* b_val;
+  char obj_types[7] = {OBJ_BUS,OBJ_BRANCH,OBJ_GEN,OBJ_LOAD,OBJ_SHUNT,OBJ_VARGEN,OBJ_BAT};
+  int nums[7];
+  int* var_type;
+  int* var_comp;
+  char* var_mask;
+  int nb;
+  int nbr;
+  int ng;
+  int nl;
+  int ns;
+  int nv;
+  int nbat;
+  int num_vars;
+  int T_data;
+  int T_min;
+  size_t remaining;
+  BOOL valid;
+  int i;
+  int k;
+#ifdef HAVE_SYS_MMAN_H
+  int fd;
+  struct stat st;
+#endif
+
+  // Parser
+  parser = (BIN_Parser*)PARSER_get_data(p);
+  if (!parser)
+    return NULL;
+
+  // Check extension
+  ext = strrchr(filename,'.');
+  ext = strtolower(ext);
+  if (!ext || strcmp(ext+1,"pfb") != 0) {
+    PARSER_set_error(p,"invalid file extension");
+    return NULL;
+  }
+
+  // Map file
+  mapped = FALSE;
+#ifdef HAVE_SYS_MMAN_H
+  fd = open(filename,O_RDONLY);
+  if (fd < 0) {
+    PARSER_set_error(p,"unable to open file");
+    return NULL;
+  }
+  if (fstat(fd,&st) == 0 && st.st_size > 0) {
+    parser->data = (char*)mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if (parser->data != MAP_FAILED) {
+      parser->size = (size_t)st.st_size;
+      mapped = TRUE;
+    }
+    else
+      parser->data = NULL;
+  }
+  close(fd);
+#endif
+
+  // Read file
+  if (!mapped) {
+    file = fopen(filename,"rb");
+    if (!file) {
+      PARSER_set_error(p,"unable to open file");
+      return NULL;
+    }
+    fseek(file,0L,SEEK_END);
+    parser->size = ftell(file);
+    rewind(file);
+    parser->data = (char*)malloc(parser->size+1);
+    if (parser->size > 0 && fread(parser->data,parser->size,1,file) != 1)
+      parser->size = 0;
+    fclose(file);
+  }
+  parser->pos = 0;
+
+  // Header
+  magic = (char*)BIN_PARSER_read_block(p,strlen(BIN_PARSER_MAGIC));
+  header = (int*)BIN_PARSER_read_block(p,sizeof(int)*BIN_PARSER_HEADER_SIZE);
+  base_power = (REAL*)BIN_PARSER_read_block(p,sizeof(REAL));
+  if (!magic || !header || !base_power ||
+      strncmp(magic,BIN_PARSER_MAGIC,strlen(BIN_PARSER_MAGIC)) != 0 ||
+      header[1] != BIN_PARSER_ENDIAN) {
+    PARSER_clear_error(p);
+    PARSER_set_error(p,"bad binary network data");
+    BIN_PARSER_free(p);
+    BIN_PARSER_init(p);
+    return NULL;
+  }
+  if (header[0] != BIN_PARSER_VERSION) {
+    PARSER_set_error(p,"unsupported binary network version");
+    BIN_PARSER_free(p);
+    BIN_PARSER_init(p);
+    return NULL;
+  }
+
+  // Sizes
+  T_data = header[2];
+  nb = header[3];
+  nbr = header[4];
+  ng = header[5];
+  nl = header[6];
+  ns = header[7];
+  nv = header[8];
+  nbat = header[9];
+  num_vars = header[10];
+
+  // Check sizes
+  remaining = parser->size-parser->pos;
+  valid = (T_data > 0);
+  for (k = 2; k <= 10; k++)
+    valid = valid && header[k] >= 0 && (size_t)header[k] <= remaining;
+  for (k = 3; k <= 9; k++)
+    valid = valid && (size_t)header[k]*(size_t)T_data <= remaining/sizeof(REAL);
+  if (!valid) {
+    PARSER_set_error(p,"bad binary network sizes");
+    BIN_PARSER_free(p);
+    BIN_PARSER_init(p);
+    return NULL;
+  }
+
+  // Periods
+  if (num_periods <= 0)
+    num_periods = T_data;
+  T_min = imin(T_data,num_periods);
+
+  // Network
+  net = NET_new(num_periods);
+  NET_set_base_power(net,*base_power);
+  NET_set_bus_array(net,BUS_array_new(nb,num_periods),nb);
+  NET_set_branch_array(net,BRANCH_array_new(nbr,num_periods),nbr);
+  NET_set_gen_array(net,GEN_array_new(ng,num_periods),ng);
+  NET_set_load_array(net,LOAD_array_new(nl,num_periods),nl);
+  NET_set_shunt_array(net,SHUNT_array_new(ns,num_periods),ns);
+  NET_set_vargen_array(net,VARGEN_array_new(nv,num_periods),nv);
+  NET_set_bat_array(net,BAT_array_new(nbat,num_periods),nbat);
+
+  // Buses
+  BIN_read_col(p,int,nb,v,{bus = NET_get_bus(net,i); BUS_set_number(bus,v); NET_bus_hash_number_add(net,bus);});
+  BIN_read_names(p,nb,name,{bus = NET_get_bus(net,i); BUS_set_name(bus,name); NET_bus_hash_name_add(net,bus);});
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_base(NET_get_bus(net,i),v));
+  BIN_read_series(p,OBJ_BUS,nb,"v_mag");
+  BIN_read_series(p,OBJ_BUS,nb,"v_ang");
+  BIN_read_series(p,OBJ_BUS,nb,"v_set");
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_max_reg(NET_get_bus(net,i),v));
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_min_reg(NET_get_bus(net,i),v));
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_max_norm(NET_get_bus(net,i),v));
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_min_norm(NET_get_bus(net,i),v));
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_max_emer(NET_get_bus(net,i),v));
+  BIN_read_col(p,REAL,nb,v,BUS_set_v_min_emer(NET_get_bus(net,i),v));
+  BIN_read_col(p,char,nb,v,BUS_set_slack_flag(NET_get_bus(net,i),v));
+  BIN_read_series(p,OBJ_BUS,nb,"price");
+  BIN_read_list(p,nb,ng,j,BUS_add_gen(NET_get_bus(net,i),NET_get_gen(net,j)));
+  BIN_read_list(p,nb,ng,j,BUS_add_reg_gen(NET_get_bus(net,i),NET_get_gen(net,j)));
+  BIN_read_list(p,nb,nl,j,BUS_add_load(NET_get_bus(net,i),NET_get_load(net,j)));
+  BIN_read_list(p,nb,ns,j,BUS_add_shunt(NET_get_bus(net,i),NET_get_shunt(net,j)));
+  BIN_read_list(p,nb,ns,j,BUS_add_reg_shunt(NET_get_bus(net,i),NET_get_shunt(net,j)));
+  BIN_read_list(p,nb,nbr,j,BUS_add_branch_k(NET_get_bus(net,i),NET_get_branch(net,j)));
+  BIN_read_list(p,nb,nbr,j,BUS_add_branch_m(NET_get_bus(net,i),NET_get_branch(net,j)));
+  BIN_read_list(p,nb,nbr,j,BUS_add_reg_tran(NET_get_bus(net,i),NET_get_branch(net,j)));
+  BIN_read_list(p,nb,nv,j,BUS_add_vargen(NET_get_bus(net,i),NET_get_vargen(net,j)));
+  BIN_read_list(p,nb,nbat,j,BUS_add_bat(NET_get_bus(net,i),NET_get_bat(net,j)));
+
+  // Branches
+  BIN_read_col(p,char,nbr,v,BRANCH_set_type(NET_get_branch(net,i),v));
+  BIN_read_names(p,nbr,name,BRANCH_set_name(NET_get_branch(net,i),name));
+  BIN_read_col(p,int,nbr,v,BRANCH_set_bus_k(NET_get_branch(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,int,nbr,v,BRANCH_set_bus_m(NET_get_branch(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,int,nbr,v,BRANCH_set_reg_bus(NET_get_branch(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_g(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_g_k(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_g_m(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_b(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_b_k(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_b_m(NET_get_branch(net,i),v));
+  BIN_read_series(p,OBJ_BRANCH,nbr,"ratio");
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_ratio_max(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_ratio_min(NET_get_branch(net,i),v));
+  BIN_read_series(p,OBJ_BRANCH,nbr,"phase");
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_phase_max(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_phase_min(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_ratingA(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_ratingB(NET_get_branch(net,i),v));
+  BIN_read_col(p,REAL,nbr,v,BRANCH_set_ratingC(NET_get_branch(net,i),v));
+  BIN_read_col(p,char,nbr,v,BRANCH_set_outage(NET_get_branch(net,i),v));
+  BIN_read_col(p,char,nbr,v,BRANCH_set_pos_ratio_v_sens(NET_get_branch(net,i),v));
+
+  // Generators
+  BIN_read_names(p,ng,name,GEN_set_name(NET_get_gen(net,i),name));
+  BIN_read_col(p,int,ng,v,GEN_set_bus(NET_get_gen(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,int,ng,v,GEN_set_reg_bus(NET_get_gen(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,char,ng,v,GEN_set_outage(NET_get_gen(net,i),v));
+  BIN_read_series(p,OBJ_GEN,ng,"P");
+  BIN_read_col(p,REAL,ng,v,GEN_set_P_max(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_P_min(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_dP_max(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_P_prev(NET_get_gen(net,i),v));
+  BIN_read_series(p,OBJ_GEN,ng,"Q");
+  BIN_read_col(p,REAL,ng,v,GEN_set_Q_max(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_Q_min(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_cost_coeff_Q0(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_cost_coeff_Q1(NET_get_gen(net,i),v));
+  BIN_read_col(p,REAL,ng,v,GEN_set_cost_coeff_Q2(NET_get_gen(net,i),v));
+
+  // Loads
+  BIN_read_names(p,nl,name,LOAD_set_name(NET_get_load(net,i),name));
+  BIN_read_col(p,int,nl,v,LOAD_set_bus(NET_get_load(net,i),NET_get_bus(net,v)));
+  BIN_read_series(p,OBJ_LOAD,nl,"P");
+  BIN_read_series(p,OBJ_LOAD,nl,"P_max");
+  BIN_read_series(p,OBJ_LOAD,nl,"P_min");
+  BIN_read_series(p,OBJ_LOAD,nl,"Q");
+  BIN_read_col(p,REAL,nl,v,LOAD_set_target_power_factor(NET_get_load(net,i),v));
+  BIN_read_col(p,REAL,nl,v,LOAD_set_util_coeff_Q0(NET_get_load(net,i),v));
+  BIN_read_col(p,REAL,nl,v,LOAD_set_util_coeff_Q1(NET_get_load(net,i),v));
+  BIN_read_col(p,REAL,nl,v,LOAD_set_util_coeff_Q2(NET_get_load(net,i),v));
+
+  // Shunts
+  BIN_read_names(p,ns,name,SHUNT_set_name(NET_get_shunt(net,i),name));
+  BIN_read_col(p,int,ns,v,SHUNT_set_bus(NET_get_shunt(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,int,ns,v,SHUNT_set_reg_bus(NET_get_shunt(net,i),NET_get_bus(net,v)));
+  BIN_read_col(p,REAL,ns,v,SHUNT_set_g(NET_get_shunt(net,i),v));
+  BIN_read_series(p,OBJ_SHUNT,ns,"b");
+  BIN_read_col(p,REAL,ns,v,SHUNT_set_b_max(NET_get_shunt(net,i),v));
+  BIN_read_col(p,REAL,ns,v,SHUNT_set_b_min(NET_get_shunt(net,i),v));
+  b_ptr = BIN_PARSER_read_ptr(p,ns);
+  b_val = b_ptr ? (REAL*)BIN_PARSER_read_block(p,sizeof(REAL)*b_ptr[ns]) : NULL;
+  for (i = 0; b_val && i < ns; i++) {
+    if (b_ptr[i] >= 0 && b_ptr[i+1] >= b_ptr[i] && b_ptr[i+1] <= b_ptr[ns] && b_ptr[i+1] > b_ptr[i])
+      SHUNT_set_b_values(NET_get_shunt(net,i),b_val+b_ptr[i],b_ptr[i+1]-b_ptr[i]);
+  }
+
+  // Variable generators
+  BIN_read_names(p,nv,name,VARGEN_set_name(NET_get_vargen(net,i),name));
+  BIN_read_col(p,int,nv,v,VARGEN_set_bus(NET_get_vargen(net,i),NET_get_bus(net,v)));
+  BIN_read_series(p,OBJ_VARGEN,nv,"P");
+  BIN_read_series(p,OBJ_VARGEN,nv,"P_ava");
+  BIN_read_col(p,REAL,nv,v,VARGEN_set_P_max(NET_get_vargen(net,i),v));
+  BIN_read_col(p,REAL,nv,v,VARGEN_set_P_min(NET_get_vargen(net,i),v));
+  BIN_read_series(p,OBJ_VARGEN,nv,"P_std");
+  BIN_read_series(p,OBJ_VARGEN,nv,"Q");
+  BIN_read_col(p,REAL,nv,v,VARGEN_set_Q_max(NET_get_vargen(net,i),v));
+  BIN_read_col(p,REAL,nv,v,VARGEN_set_Q_min(NET_get_vargen(net,i),v));
+
+  // Batteries
+  BIN_read_names(p,nbat,name,BAT_set_name(NET_get_bat(net,i),name));
+  BIN_read_col(p,int,nbat,v,BAT_set_bus(NET_get_bat(net,i),NET_get_bus(net,v)));
+  BIN_read_series(p,OBJ_BAT,nbat,"P");
+  BIN_read_col(p,REAL,nbat,v,BAT_set_P_max(NET_get_bat(net,i),v));
+  BIN_read_col(p,REAL,nbat,v,BAT_set_P_min(NET_get_bat(net,i),v));
+  BIN_read_col(p,REAL,nbat,v,BAT_set_eta_c(NET_get_bat(net,i),v));
+  BIN_read_col(p,REAL,nbat,v,BAT_set_eta_d(NET_get_bat(net,i),v));
+  BIN_read_series(p,OBJ_BAT,nbat,"E");
+  BIN_read_col(p,REAL,nbat,v,BAT_set_E_init(NET_get_bat(net,i),v));
+  BIN_read_col(p,REAL,nbat,v,BAT_set_E_final(NET_get_bat(net,i),v));
+  BIN_read_col(p,REAL,nbat,v,BAT_set_E_max(NET_get_bat(net,i),v));
+
+  // Propagate in time
+  NET_propagate_data_in_time(net,T_data-1,num_periods);
+
+  // Flags (variables are replayed in order of their first index)
+  nums[0] = nb; nums[1] = nbr; nums[2] = ng; nums[3] = nl;
+  nums[4] = ns; nums[5] = nv; nums[6] = nbat;
+  if (num_vars < 0)
+    num_vars = 0;
+  ARRAY_alloc(var_type,int,num_vars+1);
+  ARRAY_alloc(var_comp,int,num_vars+1);
+  ARRAY_zalloc(var_mask,char,num_vars+1);
+  for (k = 0; k < 7; k++)
+    BIN_PARSER_read_flags(p,net,obj_types[k],nums[k],T_data,
+			  var_type,var_comp,var_mask,num_vars);
+  for (i = 0; i < num_vars; i++) {
+    if (var_mask[i])
+      NET_set_flags_of_component(net,
+				 BIN_PARSER_get_component(net,(char)var_type[i],var_comp[i]),
+				 (char)var_type[i],
+				 FLAG_VARS,
+				 (unsigned char)var_mask[i]);
+  }
+  free(var_type);
+  free(var_comp);
+  free(var_mask);
+
+  // Check
+  if (PARSER_has_error(p)) {
+    NET_del(net);
+    net = NULL;
+  }
+  else if (T_min == num_periods && T_data == num_periods && NET_get_num_vars(net) != num_vars) {
+    PARSER_set_error(p,"bad binary network variables");
+    NET_del(net);
+    net = NULL;
+  }
+
+  // Unmap
+  BIN_PARSER_free(p);
+  BIN_PARSER_init(p);
+
+  // Return
+  return net;
+}
+
+void BIN_PARSER_set(Parser* p, char* key, REAL value) {
+  // pass
+}
+
+void BIN_PARSER_show(Parser* p) {
+  // pass
+}
+
+void BIN_PARSER_write(Parser* p, Net* net, char* filename) {
+  /** Writes binary snapshot of network (see parser_BIN.c for layout).
+   */
+
+  // Local variables
+  FILE* file;
+  int header[BIN_PARSER_HEADER_SIZE];
+  char obj_types[7] = {OBJ_BUS,OBJ_BRANCH,OBJ_GEN,OBJ_LOAD,OBJ_SHUNT,OBJ_VARGEN,OBJ_BAT};
+  int nums[7];
+  REAL base_power;
+  int* b_ptr;
+  REAL* b_val;
+  int nb;
+  int nbr;
+  int ng;
+  int nl;
+  int ns;
+  int nv;
+  int nbat;
+  int T;
+  int i;
+  int k;
+  int t;
+
+  // Check
+  if (!net)
+    return;
+
+  // Open file
+  file = fopen(filename,"wb");
+  if (file == NULL) {
+    PARSER_set_error(p,"unable to open file");
+    return;
+  }
+
+  // Sizes
+  T = NET_get_num_periods(net);
+  nb = NET_get_num_buses(net);
+  nbr = NET_get_num_branches(net);
+  ng = NET_get_num_gens(net);
+  nl = NET_get_num_loads(net);
+  ns = NET_get_num_shunts(net);
+  nv = NET_get_num_vargens(net);
+  nbat = NET_get_num_bats(net);
+
+  // Header
+  for (i = 0; i < BIN_PARSER_HEADER_SIZE; i++)
+    header[i] = 0;
+  header[0] = BIN_PARSER_VERSION;
+  header[1] = BIN_PARSER_ENDIAN;
+  header[2] = T;
+  header[3] = nb;
+  header[4] = nbr;
+  header[5] = ng;
+  header[6] = nl;
+  header[7] = ns;
+  header[8] = nv;
+  header[9] = nbat;
+  header[10] = NET_get_num_vars(net);
+  header[11] = NET_get_num_fixed(net);
+  header[12] = NET_get_num_bounded(net);
+  header[13] = NET_get_num_sparse(net);
+  base_power = NET_get_base_power(net);
+  BIN_PARSER_write_block(file,BIN_PARSER_MAGIC,strlen(BIN_PARSER_MAGIC));
+  BIN_PARSER_write_block(file,header,sizeof(int)*BIN_PARSER_HEADER_SIZE);
+  BIN_PARSER_write_block(file,&base_power,sizeof(REAL));
+
+  // Buses
+  BIN_write_col(file,int,nb,BUS_get_number(NET_get_bus(net,i)));
+  BIN_write_names(file,nb,BUS_get_name(NET_get_bus(net,i)));
+  BIN_write_col(file,REAL,nb,BUS_get_v_base(NET_get_bus(net,i)));
+  BIN_write_col_T(file,nb,BUS_get_v_mag(NET_get_bus(net,i),t));
+  BIN_write_col_T(file,nb,BUS_get_v_ang(NET_get_bus(net,i),t));
+  BIN_write_col_T(file,nb,BUS_get_v_set(NET_get_bus(net,i),t));
+  BIN_write_col(file,REAL,nb,BUS_get_v_max_reg(NET_get_bus(net,i)));
+  BIN_write_col(file,REAL,nb,BUS_get_v_min_reg(NET_get_bus(net,i)));
+  BIN_write_col(file,REAL,nb,BUS_get_v_max_norm(NET_get_bus(net,i)));
+  BIN_write_col(file,REAL,nb,BUS_get_v_min_norm(NET_get_bus(net,i)));
+  BIN_write_col(file,REAL,nb,BUS_get_v_max_emer(NET_get_bus(net,i)));
+  BIN_write_col(file,REAL,nb,BUS_get_v_min_emer(NET_get_bus(net,i)));
+  BIN_write_col(file,char,nb,BUS_is_slack(NET_get_bus(net,i)));
+  BIN_write_col_T(file,nb,BUS_get_price(NET_get_bus(net,i),t));
+  BIN_write_list(file,nb,Gen,BUS_get_gen,GEN_get_next,GEN_get_index);
+  BIN_write_list(file,nb,Gen,BUS_get_reg_gen,GEN_get_reg_next,GEN_get_index);
+  BIN_write_list(file,nb,Load,BUS_get_load,LOAD_get_next,LOAD_get_index);
+  BIN_write_list(file,nb,Shunt,BUS_get_shunt,SHUNT_get_next,SHUNT_get_index);
+  BIN_write_list(file,nb,Shunt,BUS_get_reg_shunt,SHUNT_get_reg_next,SHUNT_get_index);
+  BIN_write_list(file,nb,Branch,BUS_get_branch_k,BRANCH_get_next_k,BRANCH_get_index);
+  BIN_write_list(file,nb,Branch,BUS_get_branch_m,BRANCH_get_next_m,BRANCH_get_index);
+  BIN_write_list(file,nb,Branch,BUS_get_reg_tran,BRANCH_get_reg_next,BRANCH_get_index);
+  BIN_write_list(file,nb,Vargen,BUS_get_vargen,VARGEN_get_next,VARGEN_get_index);
+  BIN_write_list(file,nb,Bat,BUS_get_bat,BAT_get_next,BAT_get_index);
+
+  // Branches
+  BIN_write_col(file,char,nbr,BRANCH_get_type(NET_get_branch(net,i)));
+  BIN_write_names(file,nbr,BRANCH_get_name(NET_get_branch(net,i)));
+  BIN_write_col(file,int,nbr,BUS_get_index(BRANCH_get_bus_k(NET_get_branch(net,i))));
+  BIN_write_col(file,int,nbr,BUS_get_index(BRANCH_get_bus_m(NET_get_branch(net,i))));
+  BIN_write_col(file,int,nbr,BUS_get_index(BRANCH_get_reg_bus(NET_get_branch(net,i))));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_g(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_g_k(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_g_m(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_b(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_b_k(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_b_m(NET_get_branch(net,i)));
+  BIN_write_col_T(file,nbr,BRANCH_get_ratio(NET_get_branch(net,i),t));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_ratio_max(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_ratio_min(NET_get_branch(net,i)));
+  BIN_write_col_T(file,nbr,BRANCH_get_phase(NET_get_branch(net,i),t));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_phase_max(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_phase_min(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_ratingA(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_ratingB(NET_get_branch(net,i)));
+  BIN_write_col(file,REAL,nbr,BRANCH_get_ratingC(NET_get_branch(net,i)));
+  BIN_write_col(file,char,nbr,BRANCH_is_on_outage(NET_get_branch(net,i)));
+  BIN_write_col(file,char,nbr,BRANCH_has_pos_ratio_v_sens(NET_get_branch(net,i)));
+
+  // Generators
+  BIN_write_names(file,ng,GEN_get_name(NET_get_gen(net,i)));
+  BIN_write_col(file,int,ng,BUS_get_index(GEN_get_bus(NET_get_gen(net,i))));
+  BIN_write_col(file,int,ng,BUS_get_index(GEN_get_reg_bus(NET_get_gen(net,i))));
+  BIN_write_col(file,char,ng,GEN_is_on_outage(NET_get_gen(net,i)));
+  BIN_write_col_T(file,ng,GEN_get_P(NET_get_gen(net,i),t));
+  BIN_write_col(file,REAL,ng,GEN_get_P_max(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_P_min(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_dP_max(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_P_prev(NET_get_gen(net,i)));
+  BIN_write_col_T(file,ng,GEN_get_Q(NET_get_gen(net,i),t));
+  BIN_write_col(file,REAL,ng,GEN_get_Q_max(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_Q_min(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_cost_coeff_Q0(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_cost_coeff_Q1(NET_get_gen(net,i)));
+  BIN_write_col(file,REAL,ng,GEN_get_cost_coeff_Q2(NET_get_gen(net,i)));
+
+  // Loads
+  BIN_write_names(file,nl,LOAD_get_name(NET_get_load(net,i)));
+  BIN_write_col(file,int,nl,BUS_get_index(LOAD_get_bus(NET_get_load(net,i))));
+  BIN_write_col_T(file,nl,LOAD_get_P(NET_get_load(net,i),t));
+  BIN_write_col_T(file,nl,LOAD_get_P_max(NET_get_load(net,i),t));
+  BIN_write_col_T(file,nl,LOAD_get_P_min(NET_get_load(net,i),t));
+  BIN_write_col_T(file,nl,LOAD_get_Q(NET_get_load(net,i),t));
+  BIN_write_col(file,REAL,nl,LOAD_get_target_power_factor(NET_get_load(net,i)));
+  BIN_write_col(file,REAL,nl,LOAD_get_util_coeff_Q0(NET_get_load(net,i)));
+  BIN_write_col(file,REAL,nl,LOAD_get_util_coeff_Q1(NET_get_load(net,i)));
+  BIN_write_col(file,REAL,nl,LOAD_get_util_coeff_Q2(NET_get_load(net,i)));
+
+  // Shunts
+  BIN_write_names(file,ns,SHUNT_get_name(NET_get_shunt(net,i)));
+  BIN_write_col(file,int,ns,BUS_get_index(SHUNT_get_bus(NET_get_shunt(net,i))));
+  BIN_write_col(file,int,ns,BUS_get_index(SHUNT_get_reg_bus(NET_get_shunt(net,i))));
+  BIN_write_col(file,REAL,ns,SHUNT_get_g(NET_get_shunt(net,i)));
+  BIN_write_col_T(file,ns,SHUNT_get_b(NET_get_shunt(net,i),t));
+  BIN_write_col(file,REAL,ns,SHUNT_get_b_max(NET_get_shunt(net,i)));
+  BIN_write_col(file,REAL,ns,SHUNT_get_b_min(NET_get_shunt(net,i)));
+  ARRAY_alloc(b_ptr,int,ns+1);
+  b_ptr[0] = 0;
+  for (i = 0; i < ns; i++)
+    b_ptr[i+1] = b_ptr[i]+SHUNT_get_num_b_values(NET_get_shunt(net,i));
+  ARRAY_alloc(b_val,REAL,b_ptr[ns]+1);
+  for (i = 0; i < ns; i++) {
+    for (k = b_ptr[i]; k < b_ptr[i+1]; k++)
+      b_val[k] = SHUNT_get_b_values(NET_get_shunt(net,i))[k-b_ptr[i]];
+  }
+  BIN_PARSER_write_block(file,b_ptr,sizeof(int)*(ns+1));
+  BIN_PARSER_write_block(file,b_val,sizeof(REAL)*b_ptr[ns]);
+  free(b_ptr);
+  free(b_val);
+
+  // Variable generators
+  BIN_write_names(file,nv,VARGEN_get_name(NET_get_vargen(net,i)));
+  BIN_write_col(file,int,nv,BUS_get_index(VARGEN_get_bus(NET_get_vargen(net,i))));
+  BIN_write_col_T(file,nv,VARGEN_get_P(NET_get_vargen(net,i),t));
+  BIN_write_col_T(file,nv,VARGEN_get_P_ava(NET_get_vargen(net,i),t));
+  BIN_write_col(file,REAL,nv,VARGEN_get_P_max(NET_get_vargen(net,i)));
+  BIN_write_col(file,REAL,nv,VARGEN_get_P_min(NET_get_vargen(net,i)));
+  BIN_write_col_T(file,nv,VARGEN_get_P_std(NET_get_vargen(net,i),t));
+  BIN_write_col_T(file,nv,VARGEN_get_Q(NET_get_vargen(net,i),t));
+  BIN_write_col(file,REAL,nv,VARGEN_get_Q_max(NET_get_vargen(net,i)));
+  BIN_write_col(file,REAL,nv,VARGEN_get_Q_min(NET_get_vargen(net,i)));
+
+  // Batteries
+  BIN_write_names(file,nbat,BAT_get_name(NET_get_bat(net,i)));
+  BIN_write_col(file,int,nbat,BUS_get_index(BAT_get_bus(NET_get_bat(net,i))));
+  BIN_write_col_T(file,nbat,BAT_get_P(NET_get_bat(net,i),t));
+  BIN_write_col(file,REAL,nbat,BAT_get_P_max(NET_get_bat(net,i)));
+  BIN_write_col(file,REAL,nbat,BAT_get_P_min(NET_get_bat(net,i)));
+  BIN_write_col(file,REAL,nbat,BAT_get_eta_c(NET_get_bat(net,i)));
+  BIN_write_col(file,REAL,nbat,BAT_get_eta_d(NET_get_bat(net,i)));
+  BIN_write_col_T(file,nbat,BAT_get_E(NET_get_bat(net,i),t));
+  BIN_write_col(file,REAL,nbat,BAT_get_E_init(NET_get_bat(net,i)));
+  BIN_write_col(file,REAL,nbat,BAT_get_E_final(NET_get_bat(net,i)));
+  BIN_write_col(file,REAL,nbat,BAT_get_E_max(NET_get_bat(net,i)));
+
+  // Flags
+  nums[0] = nb; nums[1] = nbr; nums[2] = ng; nums[3] = nl;
+  nums[4] = ns; nums[5] = nv; nums[6] = nbat;
+  for (k = 0; k < 7; k++)
+    BIN_PARSER_write_flags(file,net,obj_types[k],nums[k]);
+
+  // Close
+  fclose(file);
+}
+
+void BIN_PARSER_free(Parser* p) {
+
+  // Local variables
+  BIN_Parser* parser = (BIN_Parser*)PARSER_get_data(p);
+
+  // No parser
+  if (!parser)
+    return;
+
+  // Data
+  if (parser->data) {
+#ifdef HAVE_SYS_MMAN_H
+    if (munmap(parser->data,parser->size) != 0)
+      free(parser->data);
+#else
+    free(parser->data);
+#endif
+  }
+
+  // Free parser
+  free(parser);
+  PARSER_set_data(p,NULL);
+}
+
+void* BIN_PARSER_get_component(Net* net, char obj_type, int index) {
+  switch (obj_type) {
+  case OBJ_BUS:
+    return NET_get_bus(net,index);
+  case OBJ_BRANCH:
+    return NET_get_branch(net,index);
+  case OBJ_GEN:
+    return NET_get_gen(net,index);
+  case OBJ_LOAD:
+    return NET_get_load(net,index);
+  case OBJ_SHUNT:
+    return NET_get_shunt(net,index);
+  case OBJ_VARGEN:
+    return NET_get_vargen(net,index);
+  case OBJ_BAT:
+    return NET_get_bat(net,index);
+  default:
+    return NULL;
+  }
+}
+
+void* BIN_PARSER_read_block(Parser* p, size_t size) {
+  /** Returns pointer to next block of snapshot and moves to the
+   *  following aligned position, or NULL and sets error if the
+   *  snapshot is too short.
+   */
+
+  // Local variables
+  BIN_Parser* parser = (BIN_Parser*)PARSER_get_data(p);
+  void* block;
+
+  // Check
+  if (!parser || !parser->data || PARSER_has_error(p))
+    return NULL;
+  if (parser->pos > parser->size || size > parser->size-parser->pos) {
+    PARSER_set_error(p,"truncated binary network data");
+    return NULL;
+  }
+
+  // Block
+  block = (void*)(parser->data+parser->pos);
+  parser->pos += size;
+  if (parser->pos % BIN_PARSER_ALIGN)
+    parser->pos += BIN_PARSER_ALIGN-parser->pos%BIN_PARSER_ALIGN;
+  return block;
+}
+
+int* BIN_PARSER_read_ptr(Parser* p, int n) {
+  /** Returns pointer to next block of n+1 offsets into a following
+   *  block, or NULL and sets error if the snapshot is too short or if
+   *  the first offset is not zero or the last one is negative.
+   */
+
+  // Local variables
+  int* ptr;
+
+  // Block
+  ptr = (int*)BIN_PARSER_read_block(p,sizeof(int)*((size_t)n+1));
+  if (!ptr)
+    return NULL;
+
+  // Check
+  if (ptr[0] != 0 || ptr[n] < 0) {
+    PARSER_set_error(p,"bad binary network data");
+    return NULL;
+  }
+  return ptr;
+}
+
+void BIN_PARSER_read_flags(Parser* p, Net* net, char obj_type, int num, int T_data,
+			   int* var_type, int* var_comp, char* var_mask, int num_vars) {
+  /** Reads flags of components of the given type. Fixed, bounded and
+   *  sparse flags are set right away. Variables are recorded by first
+   *  index so that they can be set in their original order.
+   */
+
+  // Local variables
+  char* masks[4];
+  int* start[2];
+  char flag_types[4] = {FLAG_VARS,FLAG_FIXED,FLAG_BOUNDED,FLAG_SPARSE};
+  int i;
+  int j;
+  int k;
+
+  // Masks
+  for (j = 0; j < 4; j++)
+    masks[j] = (char*)BIN_PARSER_read_block(p,sizeof(char)*num);
+  for (k = 0; k < 2; k++)
+    start[k] = (int*)BIN_PARSER_read_block(p,sizeof(int)*num);
+  if (PARSER_has_error(p))
+    return;
+
+  // Fixed, bounded, sparse
+  for (i = 0; i < num; i++) {
+    for (j = 1; j < 4; j++) {
+      if (masks[j][i])
+	NET_set_flags_of_component(net,BIN_PARSER_get_component(net,obj_type,i),obj_type,
+				   flag_types[j],(unsigned char)masks[j][i]);
+    }
+  }
+
+  // Variables
+  for (i = 0; i < num; i++) {
+    for (k = 0; k < 2; k++) {
+      if ((masks[0][i] & (1 << k)) && start[k][i] >= 0 && start[k][i] < num_vars) {
+	var_type[start[k][i]] = obj_type;
+	var_comp[start[k][i]] = i;
+	var_mask[start[k][i]] = (char)(1 << k);
+      }
+    }
+  }
+}
+
+void BIN_PARSER_write_block(FILE* file, void* data, size_t size) {
+  /** Writes block of data followed by padding up to the
+   *  next multiple of BIN_PARSER_ALIGN bytes.
+   */
+
+  // Local variables
+  char pad[BIN_PARSER_ALIGN] = {0};
+
+  if (size > 0)
+    fwrite(data,1,size,file);
+  if (size % BIN_PARSER_ALIGN)
+    fwrite(pad,1,BIN_PARSER_ALIGN-size%BIN_PARSER_ALIGN,file);
+}
+
+void BIN_PARSER_write_flags(FILE* file, Net* net, char obj_type, int num) {
+  /** Writes flags of components of the given type, and the first
+   *  variable index of each of the (at most two) variable types.
+   */
+
+  // Local variables
+  BOOL (*has_flags)(void*,char,unsigned char);
+  Vec* (*get_var_indices)(void*,unsigned char,int,int);
+  char flag_types[4] = {FLAG_VARS,FLAG_FIXED,FLAG_BOUNDED,FLAG_SPARSE};
+  char* masks;
+  int* start;
+  void* obj;
+  Vec* indices;
+  int i;
+  int j;
+  int k;
+
+  // Pointers
+  switch (obj_type) {
+  case OBJ_BUS:
+    has_flags = &BUS_has_flags;
+    get_var_indices = &BUS_get_var_indices;
+    break;
+  case OBJ_BRANCH:
+    has_flags = &BRANCH_has_flags;
+    get_var_indices = &BRANCH_get_var_indices;
+    break;
+  case OBJ_GEN:
+    has_flags = &GEN_has_flags;
+    get_var_indices = &GEN_get_var_indices;
+    break;
+  case OBJ_LOAD:
+    has_flags = &LOAD_has_flags;
+    get_var_indices = &LOAD_get_var_indices;
+    break;
+  case OBJ_SHUNT:
+    has_flags = &SHUNT_has_flags;
+    get_var_indices = &SHUNT_get_var_indices;
+    break;
+  case OBJ_VARGEN:
+    has_flags = &VARGEN_has_flags;
+    get_var_indices = &VARGEN_get_var_indices;
+    break;
+  default:
+    has_flags = &BAT_has_flags;
+    get_var_indices = &BAT_get_var_indices;
+  }
+
+  // Allocate
+  ARRAY_zalloc(masks,char,num+1);
+  ARRAY_alloc(start,int,num+1);
+
+  // Masks
+  for (j = 0; j < 4; j++) {
+    for (i = 0; i < num; i++) {
+      obj = BIN_PARSER_get_component(net,obj_type,i);
+      masks[i] = 0;
+      for (k = 0; k < 2; k++) {
+	if (has_flags(obj,flag_types[j],(unsigned char)(1 << k)))
+	  masks[i] |= (char)(1 << k);
+      }
+    }
+    BIN_PARSER_write_block(file,masks,sizeof(char)*num);
+  }
+
+  // First variable indices
+  for (k = 0; k < 2; k++) {
+    for (i = 0; i < num; i++) {
+      obj = BIN_PARSER_get_component(net,obj_type,i);
+      start[i] = -1;
+      if (has_flags(obj,FLAG_VARS,(unsigned char)(1 << k))) {
+	indices = get_var_indices(obj,(unsigned char)(1 << k),0,0);
+	if (VEC_get_size(indices) > 0)
+	  start[i] = (int)VEC_get(indices,0);
+	VEC_del(indices);
+      }
+    }
+    BIN_PARSER_write_block(file,start,sizeof(int)*num);
+  }
+
+  // Clean up
+  free(masks);
+  free(start);
+}
@@ -10,6 +10,10 @@
 
 #include <pfnet/parser_CSV.h>
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#endif
+
 struct CSV_Parser {
   char field[CSV_PARSER_BUFFER_SIZE];
   int field_index;
@@ -36,6 +40,47 @@ CSV_Parser* CSV_PARSER_new(void) {
   return csv;
 }
 
+size_t CSV_PARSER_scan(char* buffer, size_t len, char* chars, int num_chars) {
+  /** Returns the number of leading characters of the buffer
+   *  that are not in chars. Uses 16-byte SSE2 comparisons when available.
+   */
+
+  // Local variables
+  size_t i;
+  int k;
+#if defined(__SSE2__) && defined(__GNUC__)
+  __m128i c[CSV_PARSER_MAX_SPECIAL];
+  __m128i block;
+  __m128i match;
+  int mask;
+#endif
+
+  i = 0;
+
+#if defined(__SSE2__) && defined(__GNUC__)
+  for (k = 0; k < num_chars; k++)
+    c[k] = _mm_set1_epi8(chars[k]);
+  while (i+16 <= len) {
+    block = _mm_loadu_si128((__m128i*)(buffer+i));
+    match = _mm_cmpeq_epi8(block,c[0]);
+    for (k = 1; k < num_chars; k++)
+      match = _mm_or_si128(match,_mm_cmpeq_epi8(block,c[k]));
+    mask = _mm_movemask_epi8(match);
+    if (mask)
+      return i+__builtin_ctz(mask);
+    i += 16;
+  }
+#endif
+
+  for (; i < len; i++) {
+    for (k = 0; k < num_chars; k++) {
+      if (buffer[i] == chars[k])
+	return i;
+    }
+  }
+  return len;
+}
+
 size_t CSV_PARSER_parse(CSV_Parser* p,
 			char* buffer,
 			size_t len,
@@ -50,11 +95,30 @@ size_t CSV_PARSER_parse(CSV_Parser* p,
   // Local variables
   size_t buffer_index;
   size_t lookahead_index;
+  size_t run;
+  size_t n;
+  char field_chars[CSV_PARSER_MAX_SPECIAL] = {'\'','"',comment,delimeter,end_of_record,'\n','\r'};
+  char comment_chars[3] = {end_of_record,'\n','\r'};
 
   // Parse
   buffer_index = 0;
   while (buffer_index < len) {
 
+    // Ordinary characters (skipped in comments, appended to field otherwise)
+    if (p->in_comment)
+      buffer_index += CSV_PARSER_scan(buffer+buffer_index,len-buffer_index,comment_chars,3);
+    else {
+      run = CSV_PARSER_scan(buffer+buffer_index,len-buffer_index,field_chars,CSV_PARSER_MAX_SPECIAL);
+      n = run;
+      if (p->field_index+n > CSV_PARSER_BUFFER_SIZE-1)
+	n = (p->field_index < CSV_PARSER_BUFFER_SIZE-1) ? CSV_PARSER_BUFFER_SIZE-1-p->field_index : 0;
+      memcpy(p->field+p->field_index,buffer+buffer_index,n);
+      p->field_index += n;
+      buffer_index += run;
+    }
+    if (buffer_index >= len)
+      break;
+
     // Single quote
     if (buffer[buffer_index] == '\'' && !p->in_string_double && !p->in_comment) {
       if (!p->in_string_single)
@@ -144,7 +208,7 @@ size_t CSV_PARSER_parse(CSV_Parser* p,
     }
 
     // In field
-    else if (!p->in_comment) {
+    else if (!p->in_comment && p->field_index < CSV_PARSER_BUFFER_SIZE-1) {
       p->field[p->field_index] = buffer[buffer_index];
       p->field_index++;
     }
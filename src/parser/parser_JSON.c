@@ -6,9 +6,52 @@
  * Copyright (c) 2015, Tomas Tinoco De Rubira.
  *
  * PFNET is released under the BSD 2-clause license.
+ *
+ * The parser reads the file through a cursor without building a
+ * document tree. A first pass over the top-level object reads the scalar
+ * values and counts the components of each array, skipping their
+ * contents. Component arrays are then allocated and a second pass fills
+ * each component directly from its json object.
  */
 
 #include <pfnet/parser_JSON.h>
+#include <pfnet/pfnet_config.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Reads time series (uses val and k)
+#define JSON_PARSER_read_series(p,obj,set,get_num_periods) do {	\
+    JSON_PARSER_expect(p,'[');					\
+    for (k = 0; JSON_PARSER_next_item(p,k,']'); k++) {		\
+      val = JSON_PARSER_read_real(p);				\
+      if (k < get_num_periods(obj))				\
+	set(obj,val,k);						\
+    }								\
+  } while (0)
+
+// Reads list of component indices (uses k)
+#define JSON_PARSER_read_list(p,obj,add,get) do {		\
+    JSON_PARSER_expect(p,'[');				\
+    for (k = 0; JSON_PARSER_next_item(p,k,']'); k++)	\
+      add(obj,get(net,JSON_PARSER_read_int(p)));	\
+  } while (0)
+
+struct JSON_Parser {
+
+  // Data
+  char* data;   /**< @brief File contents */
+  size_t size;  /**< @brief Size of file contents */
+  size_t pos;   /**< @brief Current position */
+  BOOL mapped;  /**< @brief Flag for memory-mapped contents */
+
+  // Buffer
+  char string[JSON_PARSER_BUFFER_SIZE]; /**< @brief Last string read */
+};
 
 Parser* JSON_PARSER_new(void) {
   Parser* p = PARSER_new();
@@ -23,40 +66,54 @@ Parser* JSON_PARSER_new(void) {
 }
 
 void JSON_PARSER_init(Parser* p) {
-  // pass
+
+  // Local variables
+  JSON_Parser* parser;
+
+  // No parser
+  if (!p)
+    return;
+
+  // Allocate
+  parser = (JSON_Parser*)malloc(sizeof(JSON_Parser));
+  parser->data = NULL;
+  parser->size = 0;
+  parser->pos = 0;
+  parser->mapped = FALSE;
+  parser->string[0] = '\0';
+
+  // Set parser
+  PARSER_set_data(p,(void*)parser);
 }
 
 Net* JSON_PARSER_parse(Parser* p, char* filename, int num_periods) {
 
   // Local variables
+  JSON_Parser* parser;
   Net* net;
   char* ext;
-  FILE* file;
-  size_t file_size;
-  char* file_contents;
-  json_char* json_string;
-  json_value* value;
-  json_value* json_base_power = NULL;
-  json_value* json_num_periods = NULL;
-  json_value* json_bus_array = NULL;
-  json_value* json_branch_array = NULL;
-  json_value* json_gen_array = NULL;
-  json_value* json_vargen_array = NULL;
-  json_value* json_shunt_array = NULL;
-  json_value* json_load_array = NULL;
-  json_value* json_bat_array = NULL;
-  json_value* val;
   char* key;
-  REAL data_num_periods;
-  int num_buses;
-  int num_branches;
-  int num_gens;
-  int num_vargens;
-  int num_shunts;
-  int num_loads;
-  int num_bats;
+  FILE* file;
+  char* array_names[JSON_PARSER_NUM_ARRAYS] = {"buses","branches","generators","var_generators",
+					       "shunts","loads","batteries"};
+  size_t array_start[JSON_PARSER_NUM_ARRAYS];
+  int array_size[JSON_PARSER_NUM_ARRAYS];
+  BOOL has_base_power = FALSE;
+  BOOL has_num_periods = FALSE;
+  REAL base_power = 0;
+  int data_num_periods = 0;
   int i;
-	
+  int j;
+#ifdef HAVE_SYS_MMAN_H
+  int fd;
+  struct stat st;
+#endif
+
+  // Parser
+  parser = (JSON_Parser*)PARSER_get_data(p);
+  if (!parser)
+    return NULL;
+
   // Check extension
   ext = strrchr(filename,'.');
   ext = strtolower(ext);
@@ -65,88 +122,92 @@ Net* JSON_PARSER_parse(Parser* p, char* filename, int num_periods) {
     return NULL;
   }
 
-  // Open file
-  file = fopen(filename,"rb");
-  if (!file) {
+  // Map file
+#ifdef HAVE_SYS_MMAN_H
+  fd = open(filename,O_RDONLY);
+  if (fd < 0) {
     PARSER_set_error(p,"unable to open file");
     return NULL;
   }
-
-  // File size
-  fseek(file,0L,SEEK_END);
-  file_size = ftell(file);
-  rewind(file);
-
-  // Allocate
-  file_contents = (char*)malloc(file_size);
-
-  // Read file contents
-  if (fread(file_contents,file_size,1,file) != 1 ) {
-    PARSER_set_error(p,"Unable to read file contents");
-    free(file_contents);
+  if (fstat(fd,&st) == 0 && st.st_size > 0) {
+    parser->data = (char*)mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if (parser->data != MAP_FAILED) {
+      parser->size = (size_t)st.st_size;
+      parser->mapped = TRUE;
+#ifdef MADV_SEQUENTIAL
+      madvise(parser->data,parser->size,MADV_SEQUENTIAL);
+#endif
+    }
+    else
+      parser->data = NULL;
+  }
+  close(fd);
+#endif
+
+  // Read file
+  if (!parser->mapped) {
+    file = fopen(filename,"rb");
+    if (!file) {
+      PARSER_set_error(p,"unable to open file");
+      return NULL;
+    }
+    fseek(file,0L,SEEK_END);
+    parser->size = ftell(file);
+    rewind(file);
+    parser->data = (char*)malloc(parser->size+1);
+    if (parser->size > 0 && fread(parser->data,parser->size,1,file) != 1) {
+      PARSER_set_error(p,"Unable to read file contents");
+      fclose(file);
+      return NULL;
+    }
     fclose(file);
-    return NULL;
   }
-  fclose(file);
-
-  // Parse json string
-  json_string = (json_char*)file_contents;
-  value = json_parse(json_string,file_size);
+  parser->pos = 0;
 
-  // Checks
-  if (value == NULL) {
-    PARSER_set_error(p,"Unable to parse json data");
-    free(file_contents);
-    return NULL;
+  // Scan top-level object (values and array sizes)
+  for (i = 0; i < JSON_PARSER_NUM_ARRAYS; i++) {
+    array_start[i] = 0;
+    array_size[i] = -1;
   }
-  if (value->type != json_object) {
-    PARSER_set_error(p,"Bad json data");
-    json_value_free(value);
-    free(file_contents);
-    return NULL;
-  }
-
-  // Get data
-  for (i = 0; i < value->u.object.length; i++) {
-    key = value->u.object.values[i].name;
-    val = value->u.object.values[i].value;
-    if (strcmp(key,"base_power") == 0)
-      json_base_power = val;
-    else if (strcmp(key,"num_periods") == 0)
-      json_num_periods = val;
-    else if (strcmp(key,"buses") == 0)
-      json_bus_array = val;
-    else if (strcmp(key,"branches") == 0)
-      json_branch_array = val;
-    else if (strcmp(key,"generators") == 0)
-      json_gen_array = val;
-    else if (strcmp(key,"var_generators") == 0)
-      json_vargen_array = val;
-    else if (strcmp(key,"shunts") == 0)
-      json_shunt_array = val;
-    else if (strcmp(key,"loads") == 0)
-      json_load_array = val;
-    else if (strcmp(key,"batteries") == 0)
-      json_bat_array = val;   
+  JSON_PARSER_expect(p,'{');
+  for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+    if (strcmp(key,"base_power") == 0) {
+      base_power = JSON_PARSER_read_real(p);
+      has_base_power = TRUE;
+    }
+    else if (strcmp(key,"num_periods") == 0) {
+      data_num_periods = JSON_PARSER_read_int(p);
+      has_num_periods = TRUE;
+    }
+    else {
+      for (i = 0; i < JSON_PARSER_NUM_ARRAYS; i++) {
+	if (strcmp(key,array_names[i]) == 0)
+	  break;
+      }
+      if (i < JSON_PARSER_NUM_ARRAYS && JSON_PARSER_peek(p) == '[') {
+	array_start[i] = parser->pos;
+	array_size[i] = JSON_PARSER_count_items(p);
+      }
+      else
+	JSON_PARSER_skip_value(p);
+    }
   }
 
   // Check data
-  if ((!json_base_power || json_base_power->type != json_double) ||
-      (!json_num_periods || json_num_periods->type != json_integer) ||
-      (!json_bus_array || json_bus_array->type != json_array) ||
-      (!json_branch_array || json_branch_array->type != json_array) ||
-      (!json_gen_array || json_gen_array->type != json_array) ||
-      (!json_vargen_array || json_vargen_array->type != json_array) ||
-      (!json_shunt_array || json_shunt_array->type != json_array) ||
-      (!json_load_array || json_load_array->type != json_array) ||
-      (!json_bat_array || json_bat_array->type != json_array)) {
+  for (i = 0; i < JSON_PARSER_NUM_ARRAYS; i++) {
+    if (array_size[i] < 0)
+      break;
+  }
+  if (PARSER_has_error(p) || !has_base_power || !has_num_periods ||
+      data_num_periods < 1 || i < JSON_PARSER_NUM_ARRAYS) {
+    PARSER_clear_error(p);
     PARSER_set_error(p,"Bad json data");
-    json_value_free(value);
-    free(file_contents);
+    JSON_PARSER_free(p);
+    JSON_PARSER_init(p);
+    return NULL;
   }
 
   // Num periods
-  data_num_periods = json_num_periods->u.integer;
   if (num_periods <= 0)
     num_periods = data_num_periods;
 
@@ -154,40 +215,46 @@ Net* JSON_PARSER_parse(Parser* p, char* filename, int num_periods) {
   net = NET_new(num_periods);
 
   // Base power
-  NET_set_base_power(net,json_base_power->u.dbl);
+  NET_set_base_power(net,base_power);
 
   // Set arrays
-  num_buses = json_bus_array->u.array.length;
-  num_branches = json_branch_array->u.array.length;
-  num_gens = json_gen_array->u.array.length;
-  num_vargens = json_vargen_array->u.array.length;
-  num_shunts = json_shunt_array->u.array.length;
-  num_loads = json_load_array->u.array.length;
-  num_bats = json_bat_array->u.array.length;  
-  NET_set_bus_array(net,BUS_array_new(num_buses,num_periods),num_buses);
-  NET_set_branch_array(net,BRANCH_array_new(num_branches,num_periods),num_branches);
-  NET_set_gen_array(net,GEN_array_new(num_gens,num_periods),num_gens);
-  NET_set_vargen_array(net,VARGEN_array_new(num_vargens,num_periods),num_vargens);
-  NET_set_shunt_array(net,SHUNT_array_new(num_shunts,num_periods),num_shunts);
-  NET_set_load_array(net,LOAD_array_new(num_loads,num_periods),num_loads);
-  NET_set_bat_array(net,BAT_array_new(num_bats,num_periods),num_bats);
+  NET_set_bus_array(net,BUS_array_new(array_size[0],num_periods),array_size[0]);
+  NET_set_branch_array(net,BRANCH_array_new(array_size[1],num_periods),array_size[1]);
+  NET_set_gen_array(net,GEN_array_new(array_size[2],num_periods),array_size[2]);
+  NET_set_vargen_array(net,VARGEN_array_new(array_size[3],num_periods),array_size[3]);
+  NET_set_shunt_array(net,SHUNT_array_new(array_size[4],num_periods),array_size[4]);
+  NET_set_load_array(net,LOAD_array_new(array_size[5],num_periods),array_size[5]);
+  NET_set_bat_array(net,BAT_array_new(array_size[6],num_periods),array_size[6]);
 
   // Process arrays
-  JSON_PARSER_process_json_bus_array(p,net,json_bus_array);
-  JSON_PARSER_process_json_branch_array(p,net,json_branch_array);
-  JSON_PARSER_process_json_gen_array(p,net,json_gen_array);
-  JSON_PARSER_process_json_vargen_array(p,net,json_vargen_array);
-  JSON_PARSER_process_json_shunt_array(p,net,json_shunt_array);
-  JSON_PARSER_process_json_load_array(p,net,json_load_array);
-  JSON_PARSER_process_json_bat_array(p,net,json_bat_array);
+  parser->pos = array_start[0];
+  JSON_PARSER_read_bus_array(p,net);
+  parser->pos = array_start[1];
+  JSON_PARSER_read_branch_array(p,net);
+  parser->pos = array_start[2];
+  JSON_PARSER_read_gen_array(p,net);
+  parser->pos = array_start[3];
+  JSON_PARSER_read_vargen_array(p,net);
+  parser->pos = array_start[4];
+  JSON_PARSER_read_shunt_array(p,net);
+  parser->pos = array_start[5];
+  JSON_PARSER_read_load_array(p,net);
+  parser->pos = array_start[6];
+  JSON_PARSER_read_bat_array(p,net);
 
   // Propagate in time
   NET_propagate_data_in_time(net,data_num_periods-1,num_periods);
-  
+
+  // Check
+  if (PARSER_has_error(p)) {
+    NET_del(net);
+    net = NULL;
+  }
+
   // Free
-  json_value_free(value);
-  free(file_contents);
-  
+  JSON_PARSER_free(p);
+  JSON_PARSER_init(p);
+
   // Return
   return net;
 }
@@ -204,7 +271,7 @@ void JSON_PARSER_write(Parser* p, Net* net, char* filename) {
 
   // Local variables
   FILE* file;
-  char* json_string;
+  JSON_Writer* writer;
 
   // Open file
   file = fopen(filename,"w");
@@ -213,848 +280,1074 @@ void JSON_PARSER_write(Parser* p, Net* net, char* filename) {
     return;
   }
 
-  // Write
-  json_string = NET_get_json_string(net);
-  fprintf(file,"%s",json_string);
+  // Write (streamed in chunks)
+  writer = JSON_WRITER_new_for_file(file);
+  NET_write_json(net,writer);
+  JSON_WRITER_flush(writer);
+  if (JSON_WRITER_has_error(writer))
+    PARSER_set_error(p,"unable to write file");
 
   // Clean up
-  free(json_string);
+  JSON_WRITER_del(writer);
   fclose(file);
 }
 
 void JSON_PARSER_free(Parser* p) {
-  // pass
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+
+  // No parser
+  if (!parser)
+    return;
+
+  // Data
+  if (parser->data) {
+#ifdef HAVE_SYS_MMAN_H
+    if (parser->mapped)
+      munmap(parser->data,parser->size);
+    else
+      free(parser->data);
+#else
+    free(parser->data);
+#endif
+  }
+
+  // Free parser
+  free(parser);
+  PARSER_set_data(p,NULL);
 }
 
-void JSON_PARSER_process_json_bus_array(Parser* p, Net* net, json_value* json_bus_array) {
+BOOL JSON_PARSER_next_item(Parser* p, int k, char close) {
+  /** Moves to item k of an array or object ended by close. Returns
+   *  FALSE (after consuming close) if there are no more items.
+   */
 
   // Local variables
-  Bus* bus;
-  json_value* json_bus;
-  json_value* val;
-  char* key;  
-  int i;
-  int j;
-  int k;
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char c = JSON_PARSER_peek(p);
+
+  // Check
+  if (!c) {
+    if (!PARSER_has_error(p))
+      PARSER_set_error(p,"Unable to parse json data");
+    return FALSE;
+  }
 
-  // Processs bus array
-  for (i = 0; i < json_bus_array->u.array.length; i++) {
+  // End
+  if (c == close) {
+    parser->pos++;
+    return FALSE;
+  }
 
-    // Json bus
-    json_bus = json_bus_array->u.array.values[i];
+  // Separator
+  if (k > 0)
+    JSON_PARSER_expect(p,',');
+  return !PARSER_has_error(p);
+}
+
+char* JSON_PARSER_next_key(Parser* p, int k) {
+  /** Reads key k of an object and the following colon. Returns NULL
+   *  if there are no more keys.
+   */
+
+  // Local variables
+  char* key;
+
+  if (!JSON_PARSER_next_item(p,k,'}'))
+    return NULL;
+  key = JSON_PARSER_read_string(p);
+  JSON_PARSER_expect(p,':');
+  if (PARSER_has_error(p))
+    return NULL;
+  return key;
+}
+
+char JSON_PARSER_peek(Parser* p) {
+  /** Skips white space and returns next character without consuming
+   *  it, or zero at the end of the data or after an error.
+   */
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char c;
+
+  if (!parser || PARSER_has_error(p))
+    return 0;
+  while (parser->pos < parser->size) {
+    c = parser->data[parser->pos];
+    if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+      return c;
+    parser->pos++;
+  }
+  return 0;
+}
+
+void JSON_PARSER_expect(Parser* p, char c) {
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+
+  if (JSON_PARSER_peek(p) == c && c)
+    parser->pos++;
+  else if (!PARSER_has_error(p))
+    PARSER_set_error(p,"Unable to parse json data");
+}
+
+BOOL JSON_PARSER_read_bool(Parser* p) {
 
-    // Check
-    if (!json_bus || json_bus->type != json_object) {
-      PARSER_set_error(p,"Bad json bus array");
-      continue;
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char c = JSON_PARSER_peek(p);
+
+  if (c == 't' && parser->pos+4 <= parser->size &&
+      strncmp(parser->data+parser->pos,"true",4) == 0) {
+    parser->pos += 4;
+    return TRUE;
+  }
+  if (c == 'f' && parser->pos+5 <= parser->size &&
+      strncmp(parser->data+parser->pos,"false",5) == 0) {
+    parser->pos += 5;
+    return FALSE;
+  }
+  if (!PARSER_has_error(p))
+    PARSER_set_error(p,"Unable to parse json data");
+  return FALSE;
+}
+
+int JSON_PARSER_read_int(Parser* p) {
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char number[JSON_PARSER_NUMBER_SIZE];
+  char c;
+  int len = 0;
+
+  // Copy
+  JSON_PARSER_peek(p);
+  while (parser && parser->pos < parser->size && len < JSON_PARSER_NUMBER_SIZE-1) {
+    c = parser->data[parser->pos];
+    if ((c < '0' || c > '9') && c != '-' && c != '+')
+      break;
+    number[len++] = c;
+    parser->pos++;
+  }
+  number[len] = '\0';
+
+  // Convert
+  if (len == 0) {
+    if (!PARSER_has_error(p))
+      PARSER_set_error(p,"Unable to parse json data");
+    return 0;
+  }
+  return fast_atoi(number);
+}
+
+BOOL JSON_PARSER_read_null(Parser* p) {
+  /** Reads null if it is the next value. */
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+
+  if (JSON_PARSER_peek(p) == 'n' && parser->pos+4 <= parser->size &&
+      strncmp(parser->data+parser->pos,"null",4) == 0) {
+    parser->pos += 4;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+REAL JSON_PARSER_read_real(Parser* p) {
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char number[JSON_PARSER_NUMBER_SIZE];
+  char c;
+  int len = 0;
+
+  // Copy
+  JSON_PARSER_peek(p);
+  while (parser && parser->pos < parser->size && len < JSON_PARSER_NUMBER_SIZE-1) {
+    c = parser->data[parser->pos];
+    if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+      break;
+    number[len++] = c;
+    parser->pos++;
+  }
+  number[len] = '\0';
+
+  // Convert
+  if (len == 0) {
+    if (!PARSER_has_error(p))
+      PARSER_set_error(p,"Unable to parse json data");
+    return 0;
+  }
+  return fast_atof(number);
+}
+
+char* JSON_PARSER_read_string(Parser* p) {
+  /** Reads string with escapes decoded (\\u as UTF-8). The result
+   *  is valid until the next string is read.
+   */
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char* s;
+  char c;
+  unsigned int code;
+  unsigned int low;
+  int len = 0;
+  int i;
+
+  // Start
+  JSON_PARSER_expect(p,'"');
+  if (PARSER_has_error(p))
+    return parser ? parser->string : NULL;
+  s = parser->string;
+
+  // Characters
+  while (parser->pos < parser->size) {
+    c = parser->data[parser->pos++];
+    if (c == '"') {
+      s[len] = '\0';
+      return s;
     }
-    
-    // Get bus
-    bus = NULL;
-    for (j = 0; j < json_bus->u.object.length; j++) {
-      key = json_bus->u.object.values[j].name;
-      val = json_bus->u.object.values[j].value;
-      if (strcmp(key,"index") == 0) {
-	bus = NET_get_bus(net,val->u.integer);
+    if (c == '\\' && parser->pos < parser->size) {
+      c = parser->data[parser->pos++];
+      switch (c) {
+      case 'b':
+	c = '\b';
+	break;
+      case 'f':
+	c = '\f';
+	break;
+      case 'n':
+	c = '\n';
+	break;
+      case 'r':
+	c = '\r';
+	break;
+      case 't':
+	c = '\t';
+	break;
+      case 'u':
+	code = 0;
+	for (i = 0; i < 4 && parser->pos < parser->size; i++) {
+	  c = parser->data[parser->pos++];
+	  code = 16*code+(unsigned int)(isdigit((unsigned char)c) ? c-'0' : (tolower((unsigned char)c)-'a'+10));
+	}
+	if (code >= 0xD800 && code < 0xDC00 && parser->pos+6 <= parser->size &&
+	    parser->data[parser->pos] == '\\' && parser->data[parser->pos+1] == 'u') {
+	  low = 0;
+	  for (i = 2; i < 6; i++) {
+	    c = parser->data[parser->pos+i];
+	    low = 16*low+(unsigned int)(isdigit((unsigned char)c) ? c-'0' : (tolower((unsigned char)c)-'a'+10));
+	  }
+	  if (low >= 0xDC00 && low < 0xE000) {
+	    code = 0x10000+((code-0xD800) << 10)+(low-0xDC00);
+	    parser->pos += 6;
+	  }
+	}
+	if (len+4 >= JSON_PARSER_BUFFER_SIZE-8)
+	  continue;
+	if (code < 0x80)
+	  s[len++] = (char)code;
+	else if (code < 0x800) {
+	  s[len++] = (char)(0xC0 | (code >> 6));
+	  s[len++] = (char)(0x80 | (code & 0x3F));
+	}
+	else if (code < 0x10000) {
+	  s[len++] = (char)(0xE0 | (code >> 12));
+	  s[len++] = (char)(0x80 | ((code >> 6) & 0x3F));
+	  s[len++] = (char)(0x80 | (code & 0x3F));
+	}
+	else {
+	  s[len++] = (char)(0xF0 | (code >> 18));
+	  s[len++] = (char)(0x80 | ((code >> 12) & 0x3F));
+	  s[len++] = (char)(0x80 | ((code >> 6) & 0x3F));
+	  s[len++] = (char)(0x80 | (code & 0x3F));
+	}
+	continue;
+      default:
+	break;
+      }
+    }
+    if (len < JSON_PARSER_BUFFER_SIZE-8)
+      s[len++] = c;
+  }
+
+  // Unterminated
+  s[len] = '\0';
+  PARSER_set_error(p,"Unable to parse json data");
+  return s;
+}
+
+void JSON_PARSER_skip_value(Parser* p) {
+  /** Skips next value, including nested arrays and objects. */
+
+  // Local variables
+  JSON_Parser* parser = (JSON_Parser*)PARSER_get_data(p);
+  char* data;
+  size_t size;
+  size_t pos;
+  char c = JSON_PARSER_peek(p);
+  int depth = 0;
+
+  // Scalar
+  if (!c)
+    return;
+  if (c == '"') {
+    JSON_PARSER_read_string(p);
+    return;
+  }
+  if (c != '[' && c != '{') {
+    while (parser->pos < parser->size) {
+      c = parser->data[parser->pos];
+      if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t')
 	break;
+      parser->pos++;
+    }
+    return;
+  }
+
+  // Array or object
+  data = parser->data;
+  size = parser->size;
+  for (pos = parser->pos; pos < size; pos++) {
+    c = data[pos];
+    if (c == '"') {
+      for (pos++; pos < size && data[pos] != '"'; pos++) {
+	if (data[pos] == '\\')
+	  pos++;
       }
     }
-    
-    // Check
-    if (!bus) {
-      PARSER_set_error(p,"Bad json bus data");
-      continue;
+    else if (c == '[' || c == '{')
+      depth++;
+    else if (c == ']' || c == '}') {
+      depth--;
+      if (depth == 0) {
+	parser->pos = pos+1;
+	return;
+      }
     }
+  }
+
+  // Unterminated
+  parser->pos = size;
+  PARSER_set_error(p,"Unable to parse json data");
+}
+
+int JSON_PARSER_count_items(Parser* p) {
+  /** Skips array and returns its number of items. */
+
+  // Local variables
+  int k;
+
+  JSON_PARSER_expect(p,'[');
+  for (k = 0; JSON_PARSER_next_item(p,k,']'); k++)
+    JSON_PARSER_skip_value(p);
+  return PARSER_has_error(p) ? -1 : k;
+}
+
+void JSON_PARSER_read_bus_array(Parser* p, Net* net) {
+  /** Reads array of bus objects. Each object fills the bus with its
+   *  "index" (or, before it, the one at the same position).
+   */
+
+  // Local variables
+  Bus* bus;
+  char* key;
+  REAL val;
+  int i;
+  int j;
+  int k;
+
+  // Process bus array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
+
+    // Json bus
+    bus = NET_get_bus(net,i);
+    JSON_PARSER_expect(p,'{');
 
     // Fill
-    for (j = 0; j < json_bus->u.object.length; j++) {
-      
-      key = json_bus->u.object.values[j].name;
-      val = json_bus->u.object.values[j].value;
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
+      if (strcmp(key,"index") == 0) {
+	bus = NET_get_bus(net,JSON_PARSER_read_int(p));
+	if (!bus)
+	  PARSER_set_error(p,"Bad json bus data");
+      }
 
       // number
-      if (strcmp(key,"number") == 0) {
-	BUS_set_number(bus,val->u.integer);
+      else if (strcmp(key,"number") == 0) {
+	BUS_set_number(bus,JSON_PARSER_read_int(p));
 	NET_bus_hash_number_add(net,bus);
       }
 
       // name
       else if (strcmp(key,"name") == 0) {
-	BUS_set_name(bus,val->u.string.ptr);
+	BUS_set_name(bus,JSON_PARSER_read_string(p));
 	NET_bus_hash_name_add(net,bus);
       }
 
       // v_base
       else if (strcmp(key,"v_base") == 0)
-	BUS_set_v_base(bus,val->u.dbl);
-	
+	BUS_set_v_base(bus,JSON_PARSER_read_real(p));
+
       // v_mag
-      else if (strcmp(key,"v_mag") == 0) {
-	for (k = 0; k < imin(BUS_get_num_periods(bus),val->u.array.length); k++)
-	  BUS_set_v_mag(bus,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"v_mag") == 0)
+	JSON_PARSER_read_series(p,bus,BUS_set_v_mag,BUS_get_num_periods);
 
       // v_ang
-      else if (strcmp(key,"v_ang") == 0) {
-	for (k = 0; k < imin(BUS_get_num_periods(bus),val->u.array.length); k++)
-	  BUS_set_v_ang(bus,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"v_ang") == 0)
+	JSON_PARSER_read_series(p,bus,BUS_set_v_ang,BUS_get_num_periods);
 
       // v_set
-      else if (strcmp(key,"v_set") == 0) {
-	for (k = 0; k < imin(BUS_get_num_periods(bus),val->u.array.length); k++)
-	  BUS_set_v_set(bus,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"v_set") == 0)
+	JSON_PARSER_read_series(p,bus,BUS_set_v_set,BUS_get_num_periods);
 
       // v_max_reg
       else if (strcmp(key,"v_max_reg") == 0)
-	BUS_set_v_max_reg(bus,val->u.dbl);
+	BUS_set_v_max_reg(bus,JSON_PARSER_read_real(p));
 
       // v_min_reg
       else if (strcmp(key,"v_min_reg") == 0)
-	BUS_set_v_min_reg(bus,val->u.dbl);
+	BUS_set_v_min_reg(bus,JSON_PARSER_read_real(p));
 
       // v_max_norm
       else if (strcmp(key,"v_max_norm") == 0)
-	BUS_set_v_max_norm(bus,val->u.dbl);
+	BUS_set_v_max_norm(bus,JSON_PARSER_read_real(p));
 
       // v_min_norm
       else if (strcmp(key,"v_min_norm") == 0)
-	BUS_set_v_min_norm(bus,val->u.dbl);
+	BUS_set_v_min_norm(bus,JSON_PARSER_read_real(p));
 
       // v_max_emer
       else if (strcmp(key,"v_max_emer") == 0)
-	BUS_set_v_max_emer(bus,val->u.dbl);
+	BUS_set_v_max_emer(bus,JSON_PARSER_read_real(p));
 
       // v_min_emer
       else if (strcmp(key,"v_min_emer") == 0)
-	BUS_set_v_min_emer(bus,val->u.dbl);
-      
+	BUS_set_v_min_emer(bus,JSON_PARSER_read_real(p));
+
       // slack
       else if (strcmp(key,"slack") == 0)
-	BUS_set_slack_flag(bus,val->u.boolean);
-	
+	BUS_set_slack_flag(bus,JSON_PARSER_read_bool(p));
+
       // price
-      else if (strcmp(key,"price") == 0) {
-	for (k = 0; k < imin(BUS_get_num_periods(bus),val->u.array.length); k++)
-	  BUS_set_price(bus,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"price") == 0)
+	JSON_PARSER_read_series(p,bus,BUS_set_price,BUS_get_num_periods);
 
-      // gen
-      else if (strcmp(key,"generators") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_gen(bus,NET_get_gen(net,val->u.array.values[k]->u.integer));
-      }
+      // generators
+      else if (strcmp(key,"generators") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_gen,NET_get_gen);
 
-      // reg_gen
-      else if (strcmp(key,"reg_generators") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_reg_gen(bus,NET_get_gen(net,val->u.array.values[k]->u.integer));
-      }
+      // reg_generators
+      else if (strcmp(key,"reg_generators") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_reg_gen,NET_get_gen);
 
-      // load
-      else if (strcmp(key,"loads") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_load(bus,NET_get_load(net,val->u.array.values[k]->u.integer));
-      }
+      // loads
+      else if (strcmp(key,"loads") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_load,NET_get_load);
 
-      // shunt
-      else if (strcmp(key,"shunts") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_shunt(bus,NET_get_shunt(net,val->u.array.values[k]->u.integer));
-      }
+      // shunts
+      else if (strcmp(key,"shunts") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_shunt,NET_get_shunt);
 
-      // reg_shunt
-      else if (strcmp(key,"reg_shunts") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_reg_shunt(bus,NET_get_shunt(net,val->u.array.values[k]->u.integer));
-      }
+      // reg_shunts
+      else if (strcmp(key,"reg_shunts") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_reg_shunt,NET_get_shunt);
 
-      // branch_k
-      else if (strcmp(key,"branches_k") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_branch_k(bus,NET_get_branch(net,val->u.array.values[k]->u.integer));
-      }
+      // branches_k
+      else if (strcmp(key,"branches_k") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_branch_k,NET_get_branch);
 
-      // branch_m
-      else if (strcmp(key,"branches_m") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_branch_m(bus,NET_get_branch(net,val->u.array.values[k]->u.integer));
-      }
+      // branches_m
+      else if (strcmp(key,"branches_m") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_branch_m,NET_get_branch);
 
-      // reg_tran
-      else if (strcmp(key,"reg_transformers") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_reg_tran(bus,NET_get_branch(net,val->u.array.values[k]->u.integer));
-      }
+      // reg_transformers
+      else if (strcmp(key,"reg_transformers") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_reg_tran,NET_get_branch);
 
-      // vargen
-      else if (strcmp(key,"var_generators") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_vargen(bus,NET_get_vargen(net,val->u.array.values[k]->u.integer));
-      }
+      // var_generators
+      else if (strcmp(key,"var_generators") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_vargen,NET_get_vargen);
 
-      // bat
-      else if (strcmp(key,"batteries") == 0) {
-	for (k = 0; k < val->u.array.length; k++)
-	  BUS_add_bat(bus,NET_get_bat(net,val->u.array.values[k]->u.integer));
-      }
+      // batteries
+      else if (strcmp(key,"batteries") == 0)
+	JSON_PARSER_read_list(p,bus,BUS_add_bat,NET_get_bat);
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
   }
 }
-											
-void JSON_PARSER_process_json_branch_array(Parser* p, Net* net, json_value* json_branch_array) {
+
+void JSON_PARSER_read_branch_array(Parser* p, Net* net) {
+  /** Reads array of branch objects. Each object fills the branch with its
+   *  "index" (or, before it, the one at the same position).
+   */
 
   // Local variables
   Branch* branch;
-  json_value* json_branch;
-  json_value* val;
-  char* key;  
+  char* key;
+  REAL val;
   int i;
   int j;
   int k;
 
-  // Processs branch array
-  for (i = 0; i < json_branch_array->u.array.length; i++) {
+  // Process branch array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
 
     // Json branch
-    json_branch = json_branch_array->u.array.values[i];
-    
-    // Check
-    if (!json_branch || json_branch->type != json_object) {
-      PARSER_set_error(p,"Bad json branch array");
-      continue;
-    }
-    
-    // Get branch
-    branch = NULL;
-    for (j = 0; j < json_branch->u.object.length; j++) {
-      key = json_branch->u.object.values[j].name;
-      val = json_branch->u.object.values[j].value;
-      if (strcmp(key,"index") == 0) {
-	branch = NET_get_branch(net,val->u.integer);
-	break;
-      }
-    }
-    
-    // Check
-    if (!branch) {
-      PARSER_set_error(p,"Bad json branch data");
-      continue;
-    }
+    branch = NET_get_branch(net,i);
+    JSON_PARSER_expect(p,'{');
 
     // Fill
-    for (j = 0; j < json_branch->u.object.length; j++) {
-      
-      key = json_branch->u.object.values[j].name;
-      val = json_branch->u.object.values[j].value;
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
+      if (strcmp(key,"index") == 0) {
+	branch = NET_get_branch(net,JSON_PARSER_read_int(p));
+	if (!branch)
+	  PARSER_set_error(p,"Bad json branch data");
+      }
 
       // type
-      if (strcmp(key,"type") == 0)
-	BRANCH_set_type(branch,val->u.integer);
+      else if (strcmp(key,"type") == 0)
+	BRANCH_set_type(branch,JSON_PARSER_read_int(p));
 
       // name
       else if (strcmp(key,"name") == 0)
-	BRANCH_set_name(branch,val->u.string.ptr);
-      
+	BRANCH_set_name(branch,JSON_PARSER_read_string(p));
+
       // bus_k
       else if (strcmp(key,"bus_k") == 0) {
-	if (val->type == json_integer)
-	  BRANCH_set_bus_k(branch,NET_get_bus(net,val->u.integer));
+	if (!JSON_PARSER_read_null(p))
+	  BRANCH_set_bus_k(branch,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
-	    
+
       // bus_m
       else if (strcmp(key,"bus_m") == 0) {
-	if (val->type == json_integer)
-	  BRANCH_set_bus_m(branch,NET_get_bus(net,val->u.integer));
-      }      
-	    
+	if (!JSON_PARSER_read_null(p))
+	  BRANCH_set_bus_m(branch,NET_get_bus(net,JSON_PARSER_read_int(p)));
+      }
+
       // reg_bus
       else if (strcmp(key,"reg_bus") == 0) {
-	if (val->type == json_integer)
-	  BRANCH_set_reg_bus(branch,NET_get_bus(net,val->u.integer));
+	if (!JSON_PARSER_read_null(p))
+	  BRANCH_set_reg_bus(branch,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
-      
+
       // g
       else if (strcmp(key,"g") == 0)
-	BRANCH_set_g(branch,val->u.dbl);
+	BRANCH_set_g(branch,JSON_PARSER_read_real(p));
 
       // g_k
       else if (strcmp(key,"g_k") == 0)
-	BRANCH_set_g_k(branch,val->u.dbl);
+	BRANCH_set_g_k(branch,JSON_PARSER_read_real(p));
 
       // g_m
       else if (strcmp(key,"g_m") == 0)
-	BRANCH_set_g_m(branch,val->u.dbl);
-      
+	BRANCH_set_g_m(branch,JSON_PARSER_read_real(p));
+
       // b
       else if (strcmp(key,"b") == 0)
-	BRANCH_set_b(branch,val->u.dbl);
+	BRANCH_set_b(branch,JSON_PARSER_read_real(p));
 
       // b_k
       else if (strcmp(key,"b_k") == 0)
-	BRANCH_set_b_k(branch,val->u.dbl);
+	BRANCH_set_b_k(branch,JSON_PARSER_read_real(p));
 
       // b_m
       else if (strcmp(key,"b_m") == 0)
-	BRANCH_set_b_m(branch,val->u.dbl);
+	BRANCH_set_b_m(branch,JSON_PARSER_read_real(p));
 
       // ratio
-      else if (strcmp(key,"ratio") == 0) {
-	for (k = 0; k < imin(BRANCH_get_num_periods(branch),val->u.array.length); k++)
-	  BRANCH_set_ratio(branch,val->u.array.values[k]->u.dbl,k);
-      }
-      
+      else if (strcmp(key,"ratio") == 0)
+	JSON_PARSER_read_series(p,branch,BRANCH_set_ratio,BRANCH_get_num_periods);
+
       // ratio_max
       else if (strcmp(key,"ratio_max") == 0)
-	BRANCH_set_ratio_max(branch,val->u.dbl);
+	BRANCH_set_ratio_max(branch,JSON_PARSER_read_real(p));
 
       // ratio_min
       else if (strcmp(key,"ratio_min") == 0)
-	BRANCH_set_ratio_min(branch,val->u.dbl);
+	BRANCH_set_ratio_min(branch,JSON_PARSER_read_real(p));
 
       // phase
-      else if (strcmp(key,"phase") == 0) {
-	for (k = 0; k < imin(BRANCH_get_num_periods(branch),val->u.array.length); k++)
-	  BRANCH_set_phase(branch,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"phase") == 0)
+	JSON_PARSER_read_series(p,branch,BRANCH_set_phase,BRANCH_get_num_periods);
 
       // phase_max
       else if (strcmp(key,"phase_max") == 0)
-	BRANCH_set_phase_max(branch,val->u.dbl);
+	BRANCH_set_phase_max(branch,JSON_PARSER_read_real(p));
 
       // phase_min
       else if (strcmp(key,"phase_min") == 0)
-	BRANCH_set_phase_min(branch,val->u.dbl);
+	BRANCH_set_phase_min(branch,JSON_PARSER_read_real(p));
 
       // ratingA
       else if (strcmp(key,"ratingA") == 0)
-	BRANCH_set_ratingA(branch,val->u.dbl);
+	BRANCH_set_ratingA(branch,JSON_PARSER_read_real(p));
 
       // ratingB
       else if (strcmp(key,"ratingB") == 0)
-	BRANCH_set_ratingB(branch,val->u.dbl);
+	BRANCH_set_ratingB(branch,JSON_PARSER_read_real(p));
 
       // ratingC
       else if (strcmp(key,"ratingC") == 0)
-	BRANCH_set_ratingC(branch,val->u.dbl);
-      
+	BRANCH_set_ratingC(branch,JSON_PARSER_read_real(p));
+
       // outage
       else if (strcmp(key,"outage") == 0)
-	BRANCH_set_outage(branch,val->u.boolean);
+	BRANCH_set_outage(branch,JSON_PARSER_read_bool(p));
 
       // pos_ratio_v_sens
       else if (strcmp(key,"pos_ratio_v_sens") == 0)
-	BRANCH_set_pos_ratio_v_sens(branch,val->u.boolean);
+	BRANCH_set_pos_ratio_v_sens(branch,JSON_PARSER_read_bool(p));
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
   }
 }
 
-void JSON_PARSER_process_json_gen_array(Parser* p, Net* net, json_value* json_gen_array) {
+void JSON_PARSER_read_gen_array(Parser* p, Net* net) {
+  /** Reads array of generator objects. Each object fills the generator with its
+   *  "index" (or, before it, the one at the same position).
+   */
 
   // Local variables
   Gen* gen;
-  json_value* json_gen;
-  json_value* val;
-  char* key;  
+  char* key;
+  REAL val;
   int i;
   int j;
   int k;
 
-  // Processs gen array
-  for (i = 0; i < json_gen_array->u.array.length; i++) {
+  // Process gen array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
 
     // Json gen
-    json_gen = json_gen_array->u.array.values[i];
-    
-    // Check
-    if (!json_gen || json_gen->type != json_object) {
-      PARSER_set_error(p,"Bad json gen array");
-      continue;
-    }
-    
-    // Get gen
-    gen = NULL;
-    for (j = 0; j < json_gen->u.object.length; j++) {
-      key = json_gen->u.object.values[j].name;
-      val = json_gen->u.object.values[j].value;
-      if (strcmp(key,"index") == 0) {
-	gen = NET_get_gen(net,val->u.integer);
-	break;
-      }
-    }
-    
-    // Check
-    if (!gen) {
-      PARSER_set_error(p,"Bad json gen data");
-      continue;
-    }
+    gen = NET_get_gen(net,i);
+    JSON_PARSER_expect(p,'{');
 
     // Fill
-    for (j = 0; j < json_gen->u.object.length; j++) {
-      
-      key = json_gen->u.object.values[j].name;
-      val = json_gen->u.object.values[j].value;
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
+      if (strcmp(key,"index") == 0) {
+	gen = NET_get_gen(net,JSON_PARSER_read_int(p));
+	if (!gen)
+	  PARSER_set_error(p,"Bad json gen data");
+      }
 
       // bus
-      if (strcmp(key,"bus") == 0) {
-	if (val->type == json_integer)
-	  GEN_set_bus(gen,NET_get_bus(net,val->u.integer));
+      else if (strcmp(key,"bus") == 0) {
+	if (!JSON_PARSER_read_null(p))
+	  GEN_set_bus(gen,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // reg_bus
       else if (strcmp(key,"reg_bus") == 0) {
-	if (val->type == json_integer)
-	  GEN_set_reg_bus(gen,NET_get_bus(net,val->u.integer));
+	if (!JSON_PARSER_read_null(p))
+	  GEN_set_reg_bus(gen,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // name
       else if (strcmp(key,"name") == 0)
-	GEN_set_name(gen,val->u.string.ptr);
+	GEN_set_name(gen,JSON_PARSER_read_string(p));
 
       // outage
       else if (strcmp(key,"outage") == 0)
-	GEN_set_outage(gen,val->u.boolean);
+	GEN_set_outage(gen,JSON_PARSER_read_bool(p));
 
       // P
-      else if (strcmp(key,"P") == 0) {
-	for (k = 0; k < imin(GEN_get_num_periods(gen),val->u.array.length); k++)
-	  GEN_set_P(gen,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P") == 0)
+	JSON_PARSER_read_series(p,gen,GEN_set_P,GEN_get_num_periods);
 
       // P_max
       else if (strcmp(key,"P_max") == 0)
-	GEN_set_P_max(gen,val->u.dbl);
+	GEN_set_P_max(gen,JSON_PARSER_read_real(p));
 
       // P_min
       else if (strcmp(key,"P_min") == 0)
-	GEN_set_P_min(gen,val->u.dbl);
+	GEN_set_P_min(gen,JSON_PARSER_read_real(p));
 
       // dP_max
       else if (strcmp(key,"dP_max") == 0)
-	GEN_set_dP_max(gen,val->u.dbl);
+	GEN_set_dP_max(gen,JSON_PARSER_read_real(p));
 
       // P_prev
       else if (strcmp(key,"P_prev") == 0)
-	GEN_set_P_prev(gen,val->u.dbl);
+	GEN_set_P_prev(gen,JSON_PARSER_read_real(p));
 
       // Q
-      else if (strcmp(key,"Q") == 0) {
-	for (k = 0; k < imin(GEN_get_num_periods(gen),val->u.array.length); k++)
-	  GEN_set_Q(gen,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"Q") == 0)
+	JSON_PARSER_read_series(p,gen,GEN_set_Q,GEN_get_num_periods);
 
       // Q_max
       else if (strcmp(key,"Q_max") == 0)
-	GEN_set_Q_max(gen,val->u.dbl);
+	GEN_set_Q_max(gen,JSON_PARSER_read_real(p));
 
       // Q_min
       else if (strcmp(key,"Q_min") == 0)
-	GEN_set_Q_min(gen,val->u.dbl);
+	GEN_set_Q_min(gen,JSON_PARSER_read_real(p));
 
       // cost_coeff_Q0
       else if (strcmp(key,"cost_coeff_Q0") == 0)
-	GEN_set_cost_coeff_Q0(gen,val->u.dbl);
+	GEN_set_cost_coeff_Q0(gen,JSON_PARSER_read_real(p));
 
       // cost_coeff_Q1
       else if (strcmp(key,"cost_coeff_Q1") == 0)
-	GEN_set_cost_coeff_Q1(gen,val->u.dbl);
-      
+	GEN_set_cost_coeff_Q1(gen,JSON_PARSER_read_real(p));
+
       // cost_coeff_Q2
       else if (strcmp(key,"cost_coeff_Q2") == 0)
-	GEN_set_cost_coeff_Q2(gen,val->u.dbl);
+	GEN_set_cost_coeff_Q2(gen,JSON_PARSER_read_real(p));
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
   }
 }
 
-void JSON_PARSER_process_json_vargen_array(Parser* p, Net* net, json_value* json_vargen_array) {
+void JSON_PARSER_read_vargen_array(Parser* p, Net* net) {
+  /** Reads array of variable generator objects. Each object fills the variable generator with its
+   *  "index" (or, before it, the one at the same position).
+   */
 
   // Local variables
   Vargen* vargen;
-  json_value* json_vargen;
-  json_value* val;
-  char* key;  
+  char* key;
+  REAL val;
   int i;
   int j;
   int k;
 
-  // Processs vargen array
-  for (i = 0; i < json_vargen_array->u.array.length; i++) {
+  // Process vargen array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
 
     // Json vargen
-    json_vargen = json_vargen_array->u.array.values[i];
-    
-    // Check
-    if (!json_vargen || json_vargen->type != json_object) {
-      PARSER_set_error(p,"Bad json vargen array");
-      continue;
-    }
-    
-    // Get vargen
-    vargen = NULL;
-    for (j = 0; j < json_vargen->u.object.length; j++) {
-      key = json_vargen->u.object.values[j].name;
-      val = json_vargen->u.object.values[j].value;
-      if (strcmp(key,"index") == 0) {
-	vargen = NET_get_vargen(net,val->u.integer);
-	break;
-      }
-    }
-    
-    // Check
-    if (!vargen) {
-      PARSER_set_error(p,"Bad json vargen data");
-      continue;
-    }
+    vargen = NET_get_vargen(net,i);
+    JSON_PARSER_expect(p,'{');
 
     // Fill
-    for (j = 0; j < json_vargen->u.object.length; j++) {
-      
-      key = json_vargen->u.object.values[j].name;
-      val = json_vargen->u.object.values[j].value;
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
+      if (strcmp(key,"index") == 0) {
+	vargen = NET_get_vargen(net,JSON_PARSER_read_int(p));
+	if (!vargen)
+	  PARSER_set_error(p,"Bad json vargen data");
+      }
 
       // bus
-      if (strcmp(key,"bus") == 0) {
-	if (val->type == json_integer)
-	  VARGEN_set_bus(vargen,NET_get_bus(net,val->u.integer));
+      else if (strcmp(key,"bus") == 0) {
+	if (!JSON_PARSER_read_null(p))
+	  VARGEN_set_bus(vargen,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // name
       else if (strcmp(key,"name") == 0)
-	VARGEN_set_name(vargen,val->u.string.ptr);
+	VARGEN_set_name(vargen,JSON_PARSER_read_string(p));
 
       // P
-      else if (strcmp(key,"P") == 0) {
-	for (k = 0; k < imin(VARGEN_get_num_periods(vargen),val->u.array.length); k++)
-	  VARGEN_set_P(vargen,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P") == 0)
+	JSON_PARSER_read_series(p,vargen,VARGEN_set_P,VARGEN_get_num_periods);
 
       // P_ava
-      else if (strcmp(key,"P_ava") == 0) {
-	for (k = 0; k < imin(VARGEN_get_num_periods(vargen),val->u.array.length); k++)
-	  VARGEN_set_P_ava(vargen,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P_ava") == 0)
+	JSON_PARSER_read_series(p,vargen,VARGEN_set_P_ava,VARGEN_get_num_periods);
 
       // P_max
       else if (strcmp(key,"P_max") == 0)
-	VARGEN_set_P_max(vargen,val->u.dbl);
+	VARGEN_set_P_max(vargen,JSON_PARSER_read_real(p));
 
       // P_min
       else if (strcmp(key,"P_min") == 0)
-	VARGEN_set_P_min(vargen,val->u.dbl);
+	VARGEN_set_P_min(vargen,JSON_PARSER_read_real(p));
 
       // P_std
-      else if (strcmp(key,"P_std") == 0) {
-	for (k = 0; k < imin(VARGEN_get_num_periods(vargen),val->u.array.length); k++)
-	  VARGEN_set_P_std(vargen,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P_std") == 0)
+	JSON_PARSER_read_series(p,vargen,VARGEN_set_P_std,VARGEN_get_num_periods);
 
       // Q
-      else if (strcmp(key,"Q") == 0) {
-	for (k = 0; k < imin(VARGEN_get_num_periods(vargen),val->u.array.length); k++)
-	  VARGEN_set_Q(vargen,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"Q") == 0)
+	JSON_PARSER_read_series(p,vargen,VARGEN_set_Q,VARGEN_get_num_periods);
 
       // Q_max
       else if (strcmp(key,"Q_max") == 0)
-	VARGEN_set_Q_max(vargen,val->u.dbl);
+	VARGEN_set_Q_max(vargen,JSON_PARSER_read_real(p));
 
       // Q_min
       else if (strcmp(key,"Q_min") == 0)
-	VARGEN_set_Q_min(vargen,val->u.dbl);
+	VARGEN_set_Q_min(vargen,JSON_PARSER_read_real(p));
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
   }
 }
 
-void JSON_PARSER_process_json_shunt_array(Parser* p, Net* net, json_value* json_shunt_array) {
+void JSON_PARSER_read_shunt_array(Parser* p, Net* net) {
+  /** Reads array of shunt objects. Each object fills the shunt with its
+   *  "index" (or, before it, the one at the same position).
+   */
 
   // Local variables
   Shunt* shunt;
-  json_value* json_shunt;
-  json_value* val;
-  char* key;  
+  char* key;
+  REAL* b_values;
+  int num_b;
+  REAL val;
   int i;
   int j;
   int k;
-  REAL* b_values;
-  int num_b;
 
-  // Processs shunt array
-  for (i = 0; i < json_shunt_array->u.array.length; i++) {
+  // Process shunt array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
 
     // Json shunt
-    json_shunt = json_shunt_array->u.array.values[i];
-    
-    // Check
-    if (!json_shunt || json_shunt->type != json_object) {
-      PARSER_set_error(p,"Bad json shunt array");
-      continue;
-    }
-    
-    // Get shunt
-    shunt = NULL;
-    for (j = 0; j < json_shunt->u.object.length; j++) {
-      key = json_shunt->u.object.values[j].name;
-      val = json_shunt->u.object.values[j].value;
+    shunt = NET_get_shunt(net,i);
+    JSON_PARSER_expect(p,'{');
+
+    // Fill
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
       if (strcmp(key,"index") == 0) {
-	shunt = NET_get_shunt(net,val->u.integer);
-	break;
+	shunt = NET_get_shunt(net,JSON_PARSER_read_int(p));
+	if (!shunt)
+	  PARSER_set_error(p,"Bad json shunt data");
       }
-    }
-    
-    // Check
-    if (!shunt) {
-      PARSER_set_error(p,"Bad json shunt data");
-      continue;
-    }
 
-    // Fill
-    for (j = 0; j < json_shunt->u.object.length; j++) {
-      
-      key = json_shunt->u.object.values[j].name;
-      val = json_shunt->u.object.values[j].value;
-      
       // bus
-      if (strcmp(key,"bus") == 0) {
-	if (val->type == json_integer)
-	  SHUNT_set_bus(shunt,NET_get_bus(net,val->u.integer));
+      else if (strcmp(key,"bus") == 0) {
+	if (!JSON_PARSER_read_null(p))
+	  SHUNT_set_bus(shunt,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // reg_bus
-      if (strcmp(key,"reg_bus") == 0) {
-	if (val->type == json_integer)
-	  SHUNT_set_reg_bus(shunt,NET_get_bus(net,val->u.integer));
+      else if (strcmp(key,"reg_bus") == 0) {
+	if (!JSON_PARSER_read_null(p))
+	  SHUNT_set_reg_bus(shunt,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // name
       else if (strcmp(key,"name") == 0)
-	SHUNT_set_name(shunt,val->u.string.ptr);
-      
+	SHUNT_set_name(shunt,JSON_PARSER_read_string(p));
+
       // g
       else if (strcmp(key,"g") == 0)
-	SHUNT_set_g(shunt,val->u.dbl); 
+	SHUNT_set_g(shunt,JSON_PARSER_read_real(p));
 
       // b
-      else if (strcmp(key,"b") == 0) {
-	for (k = 0; k < imin(SHUNT_get_num_periods(shunt),val->u.array.length); k++)
-	  SHUNT_set_b(shunt,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"b") == 0)
+	JSON_PARSER_read_series(p,shunt,SHUNT_set_b,SHUNT_get_num_periods);
 
       // b_max
       else if (strcmp(key,"b_max") == 0)
-	SHUNT_set_b_max(shunt,val->u.dbl);
+	SHUNT_set_b_max(shunt,JSON_PARSER_read_real(p));
 
       // b_min
       else if (strcmp(key,"b_min") == 0)
-	SHUNT_set_b_min(shunt,val->u.dbl);      
+	SHUNT_set_b_min(shunt,JSON_PARSER_read_real(p));
 
       // b_values
       else if (strcmp(key,"b_values") == 0) {
-	num_b = val->u.array.length;
-	b_values = (REAL*)malloc(sizeof(REAL)*num_b);
-	for (k = 0; k < num_b; k++)
-	  b_values[k] = val->u.array.values[k]->u.dbl;
-	SHUNT_set_b_values(shunt,b_values,num_b); // sets num_b as well
-      }      
+	num_b = 0;
+	b_values = NULL;
+	JSON_PARSER_expect(p,'[');
+	for (k = 0; JSON_PARSER_next_item(p,k,']'); k++) {
+	  val = JSON_PARSER_read_real(p);
+	  if (num_b%8 == 0)
+	    b_values = (REAL*)realloc(b_values,sizeof(REAL)*(num_b+8));
+	  b_values[num_b++] = val;
+	}
+	if (b_values)
+	  SHUNT_set_b_values(shunt,b_values,num_b); // sets num_b as well
+      }
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
   }
 }
 
-void JSON_PARSER_process_json_load_array(Parser* p, Net* net, json_value* json_load_array) {
+void JSON_PARSER_read_load_array(Parser* p, Net* net) {
+  /** Reads array of load objects. Each object fills the load with its
+   *  "index" (or, before it, the one at the same position).
+   */
 
   // Local variables
   Load* load;
-  json_value* json_load;
-  json_value* val;
-  char* key;  
+  char* key;
+  REAL val;
   int i;
   int j;
   int k;
 
-  // Processs load array
-  for (i = 0; i < json_load_array->u.array.length; i++) {
+  // Process load array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
 
     // Json load
-    json_load = json_load_array->u.array.values[i];
-    
-    // Check
-    if (!json_load || json_load->type != json_object) {
-      PARSER_set_error(p,"Bad json load array");
-      continue;
-    }
-    
-    // Get load
-    load = NULL;
-    for (j = 0; j < json_load->u.object.length; j++) {
-      key = json_load->u.object.values[j].name;
-      val = json_load->u.object.values[j].value;
-      if (strcmp(key,"index") == 0) {
-	load = NET_get_load(net,val->u.integer);
-	break;
-      }
-    }
-    
-    // Check
-    if (!load) {
-      PARSER_set_error(p,"Bad json load data");
-      continue;
-    }
+    load = NET_get_load(net,i);
+    JSON_PARSER_expect(p,'{');
 
     // Fill
-    for (j = 0; j < json_load->u.object.length; j++) {
-      
-      key = json_load->u.object.values[j].name;
-      val = json_load->u.object.values[j].value;
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
+      if (strcmp(key,"index") == 0) {
+	load = NET_get_load(net,JSON_PARSER_read_int(p));
+	if (!load)
+	  PARSER_set_error(p,"Bad json load data");
+      }
 
       // bus
-      if (strcmp(key,"bus") == 0) {
-	if (val->type == json_integer)
-	  LOAD_set_bus(load,NET_get_bus(net,val->u.integer));
+      else if (strcmp(key,"bus") == 0) {
+	if (!JSON_PARSER_read_null(p))
+	  LOAD_set_bus(load,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // name
       else if (strcmp(key,"name") == 0)
-	LOAD_set_name(load,val->u.string.ptr);
+	LOAD_set_name(load,JSON_PARSER_read_string(p));
 
       // P
-      else if (strcmp(key,"P") == 0) {
-	for (k = 0; k < imin(LOAD_get_num_periods(load),val->u.array.length); k++)
-	  LOAD_set_P(load,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P") == 0)
+	JSON_PARSER_read_series(p,load,LOAD_set_P,LOAD_get_num_periods);
 
       // P_max
-      else if (strcmp(key,"P_max") == 0) {
-	for (k = 0; k < imin(LOAD_get_num_periods(load),val->u.array.length); k++)
-	  LOAD_set_P_max(load,val->u.array.values[k]->u.dbl,k);
-      }
-
+      else if (strcmp(key,"P_max") == 0)
+	JSON_PARSER_read_series(p,load,LOAD_set_P_max,LOAD_get_num_periods);
 
       // P_min
-      else if (strcmp(key,"P_min") == 0) {
-	for (k = 0; k < imin(LOAD_get_num_periods(load),val->u.array.length); k++)
-	  LOAD_set_P_min(load,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P_min") == 0)
+	JSON_PARSER_read_series(p,load,LOAD_set_P_min,LOAD_get_num_periods);
 
       // Q
-      else if (strcmp(key,"Q") == 0) {
-	for (k = 0; k < imin(LOAD_get_num_periods(load),val->u.array.length); k++)
-	  LOAD_set_Q(load,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"Q") == 0)
+	JSON_PARSER_read_series(p,load,LOAD_set_Q,LOAD_get_num_periods);
 
-      // target power factor
+      // target_power_factor
       else if (strcmp(key,"target_power_factor") == 0)
-	LOAD_set_target_power_factor(load,val->u.dbl);
+	LOAD_set_target_power_factor(load,JSON_PARSER_read_real(p));
 
       // util_coeff_Q0
       else if (strcmp(key,"util_coeff_Q0") == 0)
-	LOAD_set_util_coeff_Q0(load,val->u.dbl);
+	LOAD_set_util_coeff_Q0(load,JSON_PARSER_read_real(p));
 
       // util_coeff_Q1
       else if (strcmp(key,"util_coeff_Q1") == 0)
-	LOAD_set_util_coeff_Q1(load,val->u.dbl);
-      
+	LOAD_set_util_coeff_Q1(load,JSON_PARSER_read_real(p));
+
       // util_coeff_Q2
       else if (strcmp(key,"util_coeff_Q2") == 0)
-	LOAD_set_util_coeff_Q2(load,val->u.dbl);
+	LOAD_set_util_coeff_Q2(load,JSON_PARSER_read_real(p));
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
-  }  
+  }
 }
 
-void JSON_PARSER_process_json_bat_array(Parser* p, Net* net, json_value* json_bat_array) {
+void JSON_PARSER_read_bat_array(Parser* p, Net* net) {
+  /** Reads array of battery objects. Each object fills the battery with its
+   *  "index" (or, before it, the one at the same position).
+   */
 
   // Local variables
   Bat* bat;
-  json_value* json_bat;
-  json_value* val;
-  char* key;  
+  char* key;
+  REAL val;
   int i;
   int j;
   int k;
 
-  // Processs bat array
-  for (i = 0; i < json_bat_array->u.array.length; i++) {
+  // Process bat array
+  JSON_PARSER_expect(p,'[');
+  for (i = 0; JSON_PARSER_next_item(p,i,']'); i++) {
 
     // Json bat
-    json_bat = json_bat_array->u.array.values[i];
-    
-    // Check
-    if (!json_bat || json_bat->type != json_object) {
-      PARSER_set_error(p,"Bad json battery array");
-      continue;
-    }
-    
-    // Get bat
-    bat = NULL;
-    for (j = 0; j < json_bat->u.object.length; j++) {
-      key = json_bat->u.object.values[j].name;
-      val = json_bat->u.object.values[j].value;
-      if (strcmp(key,"index") == 0) {
-	bat = NET_get_bat(net,val->u.integer);
-	break;
-      }
-    }
-    
-    // Check
-    if (!bat) {
-      PARSER_set_error(p,"Bad json battery data");
-      continue;
-    }
+    bat = NET_get_bat(net,i);
+    JSON_PARSER_expect(p,'{');
 
     // Fill
-    for (j = 0; j < json_bat->u.object.length; j++) {
-      
-      key = json_bat->u.object.values[j].name;
-      val = json_bat->u.object.values[j].value;
+    for (j = 0; (key = JSON_PARSER_next_key(p,j)) != NULL; j++) {
+
+      // index
+      if (strcmp(key,"index") == 0) {
+	bat = NET_get_bat(net,JSON_PARSER_read_int(p));
+	if (!bat)
+	  PARSER_set_error(p,"Bad json battery data");
+      }
 
       // bus
-      if (strcmp(key,"bus") == 0) {
-	if (val->type == json_integer)
-	  BAT_set_bus(bat,NET_get_bus(net,val->u.integer));
+      else if (strcmp(key,"bus") == 0) {
+	if (!JSON_PARSER_read_null(p))
+	  BAT_set_bus(bat,NET_get_bus(net,JSON_PARSER_read_int(p)));
       }
 
       // name
       else if (strcmp(key,"name") == 0)
-	BAT_set_name(bat,val->u.string.ptr);
+	BAT_set_name(bat,JSON_PARSER_read_string(p));
 
       // P
-      else if (strcmp(key,"P") == 0) {
-	for (k = 0; k < imin(BAT_get_num_periods(bat),val->u.array.length); k++)
-	  BAT_set_P(bat,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"P") == 0)
+	JSON_PARSER_read_series(p,bat,BAT_set_P,BAT_get_num_periods);
 
       // P_max
       else if (strcmp(key,"P_max") == 0)
-	BAT_set_P_max(bat,val->u.dbl);
+	BAT_set_P_max(bat,JSON_PARSER_read_real(p));
 
       // P_min
       else if (strcmp(key,"P_min") == 0)
-	BAT_set_P_min(bat,val->u.dbl);
+	BAT_set_P_min(bat,JSON_PARSER_read_real(p));
 
       // eta_c
       else if (strcmp(key,"eta_c") == 0)
-	BAT_set_eta_c(bat,val->u.dbl);
+	BAT_set_eta_c(bat,JSON_PARSER_read_real(p));
 
       // eta_d
       else if (strcmp(key,"eta_d") == 0)
-	BAT_set_eta_d(bat,val->u.dbl);
+	BAT_set_eta_d(bat,JSON_PARSER_read_real(p));
 
       // E
-      else if (strcmp(key,"E") == 0) {
-	for (k = 0; k < imin(BAT_get_num_periods(bat),val->u.array.length); k++)
-	  BAT_set_E(bat,val->u.array.values[k]->u.dbl,k);
-      }
+      else if (strcmp(key,"E") == 0)
+	JSON_PARSER_read_series(p,bat,BAT_set_E,BAT_get_num_periods);
 
       // E_init
       else if (strcmp(key,"E_init") == 0)
-	BAT_set_E_init(bat,val->u.dbl);
+	BAT_set_E_init(bat,JSON_PARSER_read_real(p));
 
       // E_final
       else if (strcmp(key,"E_final") == 0)
-	BAT_set_E_final(bat,val->u.dbl);
+	BAT_set_E_final(bat,JSON_PARSER_read_real(p));
 
       // E_max
       else if (strcmp(key,"E_max") == 0)
-	BAT_set_E_max(bat,val->u.dbl);
+	BAT_set_E_max(bat,JSON_PARSER_read_real(p));
+
+      // other
+      else
+	JSON_PARSER_skip_value(p);
     }
   }
 }
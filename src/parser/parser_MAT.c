@@ -9,6 +9,14 @@
  */
 
 #include <pfnet/parser_MAT.h>
+#include <pfnet/pfnet_config.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 struct MAT_Bus {
   int number;
@@ -87,6 +95,7 @@ struct MAT_Parser {
 
   // Options
   int output_level;
+  BOOL fast;
 
   // Base
   REAL base_power;
@@ -146,6 +155,7 @@ void MAT_PARSER_init(Parser* p) {
   
   // Options
   parser->output_level = 0;
+  parser->fast = TRUE;
 
   // Base
   parser->base_power = MAT_PARSER_BASE_POWER;
@@ -176,6 +186,12 @@ void MAT_PARSER_init(Parser* p) {
 }
 
 Net* MAT_PARSER_parse(Parser* p, char* filename, int num_periods) {
+  /** Parses MATPOWER-derived CSV file. By default ("fast" option set),
+   *  the file is memory-mapped and scanned in one pass, and numbers
+   *  are converted with fast_atof/fast_atoi. Otherwise, the file is read
+   *  in chunks and numbers are converted with atof/atoi. Both paths
+   *  produce the same network.
+   */
 
   // Local variables
   Net* net;
@@ -184,7 +200,13 @@ Net* MAT_PARSER_parse(Parser* p, char* filename, int num_periods) {
   CSV_Parser* csv;
   size_t bytes_read;
   MAT_Parser* parser;
+  BOOL mapped;
   char buffer[MAT_PARSER_BUFFER_SIZE];
+#ifdef HAVE_SYS_MMAN_H
+  int fd;
+  struct stat st;
+  char* data;
+#endif
   
   // Parser
   parser = (MAT_Parser*)PARSER_get_data(p);
@@ -202,34 +224,72 @@ Net* MAT_PARSER_parse(Parser* p, char* filename, int num_periods) {
   // CSV parser
   csv = CSV_PARSER_new();
 
-  // Open file
-  file = fopen(filename,"rb");
-  if (!file) {
-    PARSER_set_error(p,"unable to open file");
-    CSV_PARSER_del(csv);
-    return NULL;
+  // Memory-mapped file
+  mapped = FALSE;
+#ifdef HAVE_SYS_MMAN_H
+  if (parser->fast) {
+    fd = open(filename,O_RDONLY);
+    if (fd < 0) {
+      PARSER_set_error(p,"unable to open file");
+      CSV_PARSER_del(csv);
+      return NULL;
+    }
+    if (fstat(fd,&st) == 0 && st.st_size > 0) {
+      data = (char*)mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+      if (data != MAP_FAILED) {
+	mapped = TRUE;
+	if (CSV_PARSER_parse(csv,
+			     data,
+			     (size_t)st.st_size,
+			     TRUE,
+			     ',',
+			     '\n',
+			     0,
+			     MAT_PARSER_callback_field,
+			     MAT_PARSER_callback_row,
+			     parser) != (size_t)st.st_size)
+	  PARSER_set_error(p,"error parsing buffer");
+	munmap(data,(size_t)st.st_size);
+      }
+    }
+    close(fd);
   }
+#endif
 
-  // Parse
-  while ((bytes_read=fread(buffer,1,MAT_PARSER_BUFFER_SIZE,file)) > 0) {
-    if (CSV_PARSER_parse(csv,
-			 buffer,
-			 bytes_read,
-			 feof(file),
-			 ',',
-			 '\n',
-			 0,
-			 MAT_PARSER_callback_field,
-			 MAT_PARSER_callback_row,
-			 parser) != bytes_read) {
-      PARSER_set_error(p,"error parsing buffer");
-      break;
+  // Read file in chunks
+  if (!mapped) {
+
+    // Open file
+    file = fopen(filename,"rb");
+    if (!file) {
+      PARSER_set_error(p,"unable to open file");
+      CSV_PARSER_del(csv);
+      return NULL;
+    }
+
+    // Parse
+    while ((bytes_read=fread(buffer,1,MAT_PARSER_BUFFER_SIZE,file)) > 0) {
+      if (CSV_PARSER_parse(csv,
+			   buffer,
+			   bytes_read,
+			   feof(file),
+			   ',',
+			   '\n',
+			   0,
+			   MAT_PARSER_callback_field,
+			   MAT_PARSER_callback_row,
+			   parser) != bytes_read) {
+	PARSER_set_error(p,"error parsing buffer");
+	break;
+      }
     }
+
+    // Close
+    fclose(file);
   }
 
-  // Free and close
+  // Free
   CSV_PARSER_del(csv);
-  fclose(file);
 
   // Check error
   if (PARSER_has_error(p))
@@ -266,6 +326,10 @@ void MAT_PARSER_set(Parser* p, char* key, REAL value) {
   // Output level
   if (strcmp(key,"output_level") == 0)
     parser->output_level = (int)value;
+
+  // Fast path
+  else if (strcmp(key,"fast") == 0)
+    parser->fast = value != 0 ? TRUE : FALSE;
 }
 
 void MAT_PARSER_show(Parser* p) {
@@ -578,6 +642,20 @@ void MAT_PARSER_clear_token(MAT_Parser* parser) {
     parser->token[i] = 0;
 }
 
+REAL MAT_PARSER_atof(MAT_Parser* parser, char* s) {
+  if (parser && parser->fast)
+    return fast_atof(s);
+  else
+    return atof(s);
+}
+
+int MAT_PARSER_atoi(MAT_Parser* parser, char* s) {
+  if (parser && parser->fast)
+    return fast_atoi(s);
+  else
+    return atoi(s);
+}
+
 BOOL MAT_PARSER_has_error(MAT_Parser* parser) {
   if (!parser)
     return TRUE;
@@ -709,7 +787,7 @@ void MAT_PARSER_parse_title_field(char* s, MAT_Parser* parser) {
 
   // Base power
   if (parser->field == 0 && parser->record == 1) {
-    parser->base_power = atof(s);
+    parser->base_power = MAT_PARSER_atof(parser,s);
   }
 }
 
@@ -748,45 +826,45 @@ void MAT_PARSER_parse_bus_field(char* s, MAT_Parser* parser) {
   if (parser->bus) {
     switch (parser->field) {
     case 0:
-      parser->bus->number = atoi(s);
+      parser->bus->number = MAT_PARSER_atoi(parser,s);
       snprintf(parser->bus->name,(size_t)(MAT_BUS_NAME_BUFFER_SIZE-1),
 	       "BUS %d",parser->bus->number);
       break;
     case 1:
-      parser->bus->type = atoi(s);
+      parser->bus->type = MAT_PARSER_atoi(parser,s);
       break;
     case 2:
-      parser->bus->Pd = atof(s);
+      parser->bus->Pd = MAT_PARSER_atof(parser,s);
       break;
     case 3:
-      parser->bus->Qd = atof(s);
+      parser->bus->Qd = MAT_PARSER_atof(parser,s);
       break;
     case 4:
-      parser->bus->Gs = atof(s);
+      parser->bus->Gs = MAT_PARSER_atof(parser,s);
       break;
     case 5:
-      parser->bus->Bs = atof(s);
+      parser->bus->Bs = MAT_PARSER_atof(parser,s);
       break;
     case 6:
-      parser->bus->area = atoi(s);
+      parser->bus->area = MAT_PARSER_atoi(parser,s);
       break;
     case 7:
-      parser->bus->Vm = atof(s);
+      parser->bus->Vm = MAT_PARSER_atof(parser,s);
       break;
     case 8:
-      parser->bus->Va = atof(s);
+      parser->bus->Va = MAT_PARSER_atof(parser,s);
       break;
     case 9:
-      parser->bus->basekv = atof(s);
+      parser->bus->basekv = MAT_PARSER_atof(parser,s);
       break;
     case 10:
-      parser->bus->zone = atoi(s);
+      parser->bus->zone = MAT_PARSER_atoi(parser,s);
       break;
     case 11:
-      parser->bus->maxVm = atof(s);
+      parser->bus->maxVm = MAT_PARSER_atof(parser,s);
       break;
     case 12:
-      parser->bus->minVm = atof(s);
+      parser->bus->minVm = MAT_PARSER_atof(parser,s);
       break;
     }
   }
@@ -832,34 +910,34 @@ void MAT_PARSER_parse_gen_field(char* s, MAT_Parser* parser) {
   if (parser->gen) {
     switch (parser->field) {
     case 0:
-      parser->gen->bus_number = atoi(s);
+      parser->gen->bus_number = MAT_PARSER_atoi(parser,s);
       break;
     case 1:
-      parser->gen->Pg = atof(s);
+      parser->gen->Pg = MAT_PARSER_atof(parser,s);
       break;
     case 2:
-      parser->gen->Qg = atof(s);
+      parser->gen->Qg = MAT_PARSER_atof(parser,s);
       break;
     case 3:
-      parser->gen->Qmax = atof(s);
+      parser->gen->Qmax = MAT_PARSER_atof(parser,s);
       break;
     case 4:
-      parser->gen->Qmin = atof(s);
+      parser->gen->Qmin = MAT_PARSER_atof(parser,s);
       break;
     case 5:
-      parser->gen->Vg = atof(s);
+      parser->gen->Vg = MAT_PARSER_atof(parser,s);
       break;
     case 6:
-      parser->gen->mBase = atof(s);
+      parser->gen->mBase = MAT_PARSER_atof(parser,s);
       break;
     case 7:
-      parser->gen->status = atoi(s);
+      parser->gen->status = MAT_PARSER_atoi(parser,s);
       break;
     case 8:
-      parser->gen->Pmax = atof(s);
+      parser->gen->Pmax = MAT_PARSER_atof(parser,s);
       break;
     case 9:
-      parser->gen->Pmin = atof(s);
+      parser->gen->Pmin = MAT_PARSER_atof(parser,s);
       break;
     }
   }
@@ -903,37 +981,37 @@ void MAT_PARSER_parse_branch_field(char* s, MAT_Parser* parser) {
   if (parser->branch) {
     switch (parser->field) {
     case 0:
-      parser->branch->bus_k_number = atoi(s);
+      parser->branch->bus_k_number = MAT_PARSER_atoi(parser,s);
       break;
     case 1:
-      parser->branch->bus_m_number = atoi(s);
+      parser->branch->bus_m_number = MAT_PARSER_atoi(parser,s);
       break;
     case 2:
-      parser->branch->r = atof(s);
+      parser->branch->r = MAT_PARSER_atof(parser,s);
       break;
     case 3:
-      parser->branch->x = atof(s);
+      parser->branch->x = MAT_PARSER_atof(parser,s);
       break;
     case 4:
-      parser->branch->b = atof(s);
+      parser->branch->b = MAT_PARSER_atof(parser,s);
       break;
     case 5:
-      parser->branch->rateA = atof(s);
+      parser->branch->rateA = MAT_PARSER_atof(parser,s);
       break;
     case 6:
-      parser->branch->rateB = atof(s);
+      parser->branch->rateB = MAT_PARSER_atof(parser,s);
       break;
     case 7:
-      parser->branch->rateC = atof(s);
+      parser->branch->rateC = MAT_PARSER_atof(parser,s);
       break;
     case 8:
-      parser->branch->ratio = atof(s);
+      parser->branch->ratio = MAT_PARSER_atof(parser,s);
       break;
     case 9:
-      parser->branch->angle = atof(s);
+      parser->branch->angle = MAT_PARSER_atof(parser,s);
       break;
     case 10:
-      parser->branch->status = atoi(s);
+      parser->branch->status = MAT_PARSER_atoi(parser,s);
       break;
     }
   }
@@ -977,13 +1055,13 @@ void MAT_PARSER_parse_cost_field(char* s, MAT_Parser* parser) {
   if (parser->cost) {
     switch (parser->field) {
     case 0:
-      parser->cost->Q2 = atof(s);
+      parser->cost->Q2 = MAT_PARSER_atof(parser,s);
       break;
     case 1:
-      parser->cost->Q1 = atof(s);
+      parser->cost->Q1 = MAT_PARSER_atof(parser,s);
       break;
     case 2:
-      parser->cost->Q0 = atof(s);
+      parser->cost->Q0 = MAT_PARSER_atof(parser,s);
       break;
     }
   }
@@ -1027,13 +1105,13 @@ void MAT_PARSER_parse_util_field(char* s, MAT_Parser* parser) {
   if (parser->util) {
     switch (parser->field) {
     case 0:
-      parser->util->Q2 = atof(s);
+      parser->util->Q2 = MAT_PARSER_atof(parser,s);
       break;
     case 1:
-      parser->util->Q1 = atof(s);
+      parser->util->Q1 = MAT_PARSER_atof(parser,s);
       break;
     case 2:
-      parser->util->Q0 = atof(s);
+      parser->util->Q0 = MAT_PARSER_atof(parser,s);
       break;
     }
   }
@@ -56,6 +56,11 @@ struct Constr {
   int G_row;             /**< @brief Counter for linear inequality constraints */
   char* bus_counted;     /**< @brief Flag for processing buses */
   int bus_counted_size;  /**< @brief Size of array of flags for processing buses */
+  BOOL periodic;         /**< @brief Flag for structure that is the same in every time period */
+  BOOL island_safe;      /**< @brief Flag for steps that only write data of the island of the branch besides the counters */
+  BOOL view;             /**< @brief Flag for views that share the data of another constraint */
+  char* branch_active;   /**< @brief Flags of branches and periods with rows (active set, NULL if all) */
+  int branch_active_size; /**< @brief Size of array of active flags of branches */
 
   // Row info
   char* A_row_info; /**< @brief Array for info strings of rows of A (x,y) = b */
@@ -69,9 +74,21 @@ struct Constr {
   void (*func_clear)(Constr* c);                                         /**< @brief Function for clearing flags, counters, and function values */
   void (*func_analyze_step)(Constr* c, Branch* br, int t);               /**< @brief Function for analyzing sparsity pattern */
   void (*func_eval_step)(Constr* c, Branch* br, int t, Vec* v, Vec* ve); /**< @brief Function for evaluating constraint */
+  void (*func_eval_period)(Constr* c, int t, Vec* v, Vec* ve);           /**< @brief Function for evaluating constraint over components of a time period */
   void (*func_store_sens_step)(Constr* c, Branch* br, int t,
 			       Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);    /**< @brief Func. for storing sensitivities */
   void (*func_free)(Constr* c);                                          /**< @brief Function for de-allocating any data used */
+  void (*func_analyze_data_step)(Constr* c, Branch* br, int t);          /**< @brief Function for storing data of periods after the first (periodic structure) */
+  REAL (*func_get_branch_loading)(Constr* c, Branch* br, int t, Vec* v); /**< @brief Function for computing flow over rating of branch (active set) */
+  void (*func_eval_Jv)(Constr* c, Vec* v, Vec* ve, Vec* d, Vec* Jd);     /**< @brief Function for adding Jacobian-vector product without forming J */
+  void (*func_eval_JTy)(Constr* c, Vec* v, Vec* ve, Vec* y, Vec* JTy);   /**< @brief Function for adding transpose Jacobian-vector product without forming J */
+  void (*func_eval_Hv)(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd); /**< @brief Function for adding combined Hessian-vector product without forming H */
+
+  // Type batch functions (called once per pass after the steps)
+  void (*func_count)(Constr* c);                                         /**< @brief Function for counting nonzero entries */
+  void (*func_analyze)(Constr* c);                                       /**< @brief Function for analyzing sparsity pattern */
+  void (*func_eval)(Constr* c, Vec* v, Vec* ve);                         /**< @brief Function for evaluating constraint */
+  void (*func_store_sens)(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl); /**< @brief Function for storing sensitivities */
 
   // Type data
   void* data; /**< @brief Type-dependent constraint data structure */
@@ -143,6 +160,25 @@ void CONSTR_finalize_structure_of_Hessians(Constr* c) {
   }
 }
 
+int CONSTR_get_num_active_branches(Constr* c) {
+  /** Gets the number of (branch, time period) pairs of the active set,
+   *  or -1 if the constraint has no active set.
+   */
+
+  // Local variables
+  int num = 0;
+  int i;
+
+  // Check
+  if (!c || !c->branch_active)
+    return -1;
+
+  // Count
+  for (i = 0; i < c->branch_active_size; i++)
+    num += c->branch_active[i];
+  return num;
+}
+
 int CONSTR_get_num_extra_vars(Constr* c) {
   if (c)
     return c->num_extra_vars;
@@ -239,12 +275,20 @@ void CONSTR_del_matvec(Constr* c) {
 void CONSTR_del(Constr* c) {
   if (c) {
 
+    // View
+    if (c->view) {
+      free(c);
+      return;
+    }
+
     // Mat and vec
     CONSTR_del_matvec(c);
 
     // Utils
     if (c->bus_counted)
       free(c->bus_counted);
+    if (c->branch_active)
+      free(c->branch_active);
     if (c->H_nnz)
       free(c->H_nnz);
 
@@ -418,6 +462,20 @@ int CONSTR_get_H_nnz_size(Constr* c) {
     return 0;
 }
 
+void CONSTR_get_counters(Constr* c, int* counters) {
+  /** Copies the counters of nonzeros and rows of A, J and G
+   *  to an array of CONSTR_NUM_COUNTERS values.
+   */
+  if (c && counters) {
+    counters[0] = c->A_nnz;
+    counters[1] = c->J_nnz;
+    counters[2] = c->G_nnz;
+    counters[3] = c->A_row;
+    counters[4] = c->J_row;
+    counters[5] = c->G_row;
+  }
+}
+
 int CONSTR_get_A_row(Constr* c) {
   if (c)
     return c->A_row;
@@ -624,6 +682,12 @@ void CONSTR_list_combine_H(Constr* clist, Vec* coeff, BOOL ensure_psd) {
   }
 }
 
+void CONSTR_list_count_batch(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
+    CONSTR_count_batch(cc);
+}
+
 void CONSTR_list_count_step(Constr* clist, Branch* br, int t) {
   Constr* cc;
   for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
@@ -642,18 +706,70 @@ void CONSTR_list_clear(Constr* clist) {
     CONSTR_clear(cc);
 }
 
+void CONSTR_list_analyze_batch(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
+    CONSTR_analyze_batch(cc);
+}
+
 void CONSTR_list_analyze_step(Constr* clist, Branch* br, int t) {
   Constr* cc;
   for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
     CONSTR_analyze_step(cc,br,t);
 }
 
+void CONSTR_list_eval_batch(Constr* clist, Vec* v, Vec* ve) {
+  Constr* cc;
+  Vec* ve_c;
+  int offset = 0;
+  REAL* ve_data = VEC_get_data(ve);
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (!cc->func_eval) {
+      offset += CONSTR_get_num_extra_vars(cc);
+      continue;
+    }
+    if (offset + CONSTR_get_num_extra_vars(cc) <= VEC_get_size(ve))
+      ve_c = VEC_new_from_array(&(ve_data[offset]),CONSTR_get_num_extra_vars(cc));
+    else
+      ve_c = NULL;
+    CONSTR_eval_batch(cc,v,ve_c);
+    offset += CONSTR_get_num_extra_vars(cc);
+    if (ve_c)
+      free(ve_c);
+  }
+}
+
+void CONSTR_list_eval_period(Constr* clist, int t, Vec* v, Vec* ve) {
+  Constr* cc;
+  Vec* ve_c;
+  int offset = 0;
+  REAL* ve_data = VEC_get_data(ve);
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (!cc->func_eval_period) {
+      offset += CONSTR_get_num_extra_vars(cc);
+      continue;
+    }
+    if (offset + CONSTR_get_num_extra_vars(cc) <= VEC_get_size(ve))
+      ve_c = VEC_new_from_array(&(ve_data[offset]),CONSTR_get_num_extra_vars(cc));
+    else
+      ve_c = NULL;
+    CONSTR_eval_period(cc,t,v,ve_c);
+    offset += CONSTR_get_num_extra_vars(cc);
+    if (ve_c)
+      free(ve_c);
+  }
+}
+
 void CONSTR_list_eval_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve) {
   Constr* cc;
   Vec* ve_c;
   int offset = 0;
   REAL* ve_data = VEC_get_data(ve);
   for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (!cc->func_eval_step) {
+      offset += CONSTR_get_num_extra_vars(cc);
+      continue;
+    }
     if (offset + CONSTR_get_num_extra_vars(cc) <= VEC_get_size(ve))
       ve_c = VEC_new_from_array(&(ve_data[offset]),CONSTR_get_num_extra_vars(cc));
     else
@@ -665,7 +781,19 @@ void CONSTR_list_eval_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve) {
   }
 }
 
+void CONSTR_list_store_sens_batch(Constr* clist, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
+  CONSTR_list_store_sens_map(clist,NULL,0,sA,sf,sGu,sGl);
+}
+
 void CONSTR_list_store_sens_step(Constr* clist, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
+  CONSTR_list_store_sens_map(clist,br,t,sA,sf,sGu,sGl);
+}
+
+void CONSTR_list_store_sens_map(Constr* clist, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
+  /** Maps sensitivity vectors to the constraints of the list and
+   *  stores them with the step functions or, if br is NULL, with the
+   *  batch functions.
+   */
   Constr* cc;
   Vec* vA;
   Vec* vf;
@@ -716,7 +844,10 @@ void CONSTR_list_store_sens_step(Constr* clist, Branch* br, int t, Vec* sA, Vec*
     else
       vGl = NULL;
 
-    CONSTR_store_sens_step(cc,br,t,vA,vf,vGu,vGl);
+    if (br)
+      CONSTR_store_sens_step(cc,br,t,vA,vf,vGu,vGl);
+    else
+      CONSTR_store_sens_batch(cc,vA,vf,vGu,vGl);
 
     offset_sA += MAT_get_size1(CONSTR_get_A(cc));
     offset_sf += VEC_get_size(CONSTR_get_f(cc));
@@ -783,6 +914,15 @@ Constr* CONSTR_new(Net* net) {
   c->bus_counted_size = 0;
   c->bus_counted = NULL;
 
+  // Periodic structure
+  c->periodic = FALSE;
+  c->island_safe = FALSE;
+  c->view = FALSE;
+
+  // Active set
+  c->branch_active = NULL;
+  c->branch_active_size = 0;
+
   // Methods
   c->func_init = NULL;
   c->func_count_step = NULL;
@@ -790,8 +930,18 @@ Constr* CONSTR_new(Net* net) {
   c->func_clear = NULL;
   c->func_analyze_step = NULL;
   c->func_eval_step = NULL;
+  c->func_eval_period = NULL;
   c->func_store_sens_step = NULL;
   c->func_free = NULL;
+  c->func_analyze_data_step = NULL;
+  c->func_get_branch_loading = NULL;
+  c->func_eval_Jv = NULL;
+  c->func_eval_JTy = NULL;
+  c->func_eval_Hv = NULL;
+  c->func_count = NULL;
+  c->func_analyze = NULL;
+  c->func_eval = NULL;
+  c->func_store_sens = NULL;
   
   // Data
   c->data = NULL;
@@ -802,6 +952,30 @@ Constr* CONSTR_new(Net* net) {
   return c;
 }
 
+Constr* CONSTR_new_view(Constr* c) {
+  /** Creates a view of the constraint. The view has its own counters
+   *  and error but shares every other field, including the matrices,
+   *  vectors and flags of buses, with the constraint. It must be
+   *  created after the constraint is cleared, and deleting it does
+   *  not free any shared data.
+   */
+
+  // Local variables
+  Constr* view;
+
+  // Check
+  if (!c)
+    return NULL;
+
+  // View
+  view = (Constr*)malloc(sizeof(Constr));
+  memcpy(view,c,sizeof(Constr));
+  view->view = TRUE;
+  view->next = NULL;
+  CONSTR_clear_error(view);
+  return view;
+}
+
 void CONSTR_set_name(Constr* c, char* name) {
   if (c)
     strcpy(c->name,name);
@@ -915,6 +1089,20 @@ void CONSTR_set_H_nnz(Constr* c, int* nnz, int size) {
   }
 }
 
+void CONSTR_set_counters(Constr* c, int* counters) {
+  /** Sets the counters of the constraint from an array of
+   *  CONSTR_NUM_COUNTERS values (see CONSTR_get_counters).
+   */
+  if (c && counters) {
+    c->A_nnz = counters[0];
+    c->J_nnz = counters[1];
+    c->G_nnz = counters[2];
+    c->A_row = counters[3];
+    c->J_row = counters[4];
+    c->G_row = counters[5];
+  }
+}
+
 void CONSTR_set_A_row(Constr* c, int index) {
   if (c)
     c->A_row = index;
@@ -1014,9 +1202,20 @@ void CONSTR_count(Constr* c) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       CONSTR_count_step(c,NET_get_branch(net,i),t);
   }
+  CONSTR_count_batch(c);
+}
+
+void CONSTR_count_batch(Constr* c) {
+  CONSTR_replicate_counts(c);
+  if (c && c->func_count && CONSTR_is_safe_to_count(c))
+    (*(c->func_count))(c);
 }
 
 void CONSTR_count_step(Constr* c, Branch* br, int t) {
+  if (CONSTR_has_periodic_structure(c) && t > 0)
+    return;
+  if (!CONSTR_is_branch_active(c,br,t))
+    return;
   if (c && c->func_count_step && CONSTR_is_safe_to_count(c))
     (*(c->func_count_step))(c,br,t);
 }
@@ -1046,26 +1245,204 @@ void CONSTR_analyze(Constr* c) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       CONSTR_analyze_step(c,NET_get_branch(net,i),t);
   }
+  CONSTR_analyze_batch(c);
   CONSTR_finalize_structure_of_Hessians(c);
 }
 
+void CONSTR_analyze_batch(Constr* c) {
+  CONSTR_replicate_structure(c);
+  if (c && c->func_analyze && CONSTR_is_safe_to_analyze(c))
+    (*(c->func_analyze))(c);
+}
+
 void CONSTR_analyze_step(Constr* c, Branch* br, int t) {
-  if (c && c->func_analyze_step && CONSTR_is_safe_to_analyze(c))
+  if (!CONSTR_is_branch_active(c,br,t))
+    return;
+  if (CONSTR_has_periodic_structure(c) && t > 0) {
+    if (c->func_analyze_data_step && CONSTR_is_safe_to_analyze(c))
+      (*(c->func_analyze_data_step))(c,br,t);
+  }
+  else if (c && c->func_analyze_step && CONSTR_is_safe_to_analyze(c))
     (*(c->func_analyze_step))(c,br,t);
 }
 
 void CONSTR_eval(Constr* c, Vec* v, Vec* ve) {
+  /** Evaluates the constraint with the branch traversal, the period
+   *  sweeps and the batch function. Eval safety is checked once here,
+   *  so the hooks are called directly.
+   */
+
+  // Local variables
+  Branch* br;
   int i;
   int t;
   Net* net = CONSTR_get_network(c);
+
+  // Check
   CONSTR_clear(c);
+  if (!c || !CONSTR_is_safe_to_eval(c,v,ve))
+    return;
+
+  // Steps and sweeps
   for (t = 0; t < NET_get_num_periods(net); t++) {
-    for (i = 0; i < NET_get_num_branches(net); i++)
-      CONSTR_eval_step(c,NET_get_branch(net,i),t,v,ve);
+    if (c->func_eval_step) {
+      for (i = 0; i < NET_get_num_branches(net); i++) {
+	br = NET_get_branch(net,i);
+	if (CONSTR_is_branch_active(c,br,t))
+	  (*(c->func_eval_step))(c,br,t,v,ve);
+      }
+    }
+    if (c->func_eval_period)
+      (*(c->func_eval_period))(c,t,v,ve);
   }
+
+  // Batch
+  if (c->func_eval)
+    (*(c->func_eval))(c,v,ve);
+}
+
+void CONSTR_eval_Jv(Constr* c, Vec* v, Vec* ve, Vec* d, Vec* Jd) {
+  /** Adds to Jd the product of the Jacobian of f at (v,ve) and the
+   *  direction d, which has one entry per network and extra variable
+   *  of the constraint. Constraints without a native product are
+   *  evaluated at (v,ve) and use J.
+   */
+
+  // Local variables
+  Mat* J;
+  REAL* dd;
+  REAL* Jdd;
+  int k;
+
+  // Check
+  if (!c)
+    return;
+  if (VEC_get_size(d) != NET_get_num_vars(c->net)+CONSTR_get_num_extra_vars(c) ||
+      VEC_get_size(Jd) != MAT_get_size1(c->J)) {
+    sprintf(c->error_string,"invalid vector size");
+    c->error_flag = TRUE;
+    return;
+  }
+
+  // Native
+  if (c->func_eval_Jv) {
+    if (CONSTR_is_safe_to_eval(c,v,ve))
+      (*(c->func_eval_Jv))(c,v,ve,d,Jd);
+    return;
+  }
+
+  // Fallback
+  CONSTR_eval(c,v,ve);
+  J = c->J;
+  dd = VEC_get_data(d);
+  Jdd = VEC_get_data(Jd);
+  for (k = 0; k < MAT_get_nnz(J); k++)
+    Jdd[MAT_get_i(J,k)] += MAT_get_d(J,k)*dd[MAT_get_j(J,k)];
+}
+
+void CONSTR_eval_JTy(Constr* c, Vec* v, Vec* ve, Vec* y, Vec* JTy) {
+  /** Adds to JTy the product of the transpose of the Jacobian of f
+   *  at (v,ve) and y. JTy has one entry per network and extra
+   *  variable of the constraint. Constraints without a native product
+   *  are evaluated at (v,ve) and use J.
+   */
+
+  // Local variables
+  Mat* J;
+  REAL* yd;
+  REAL* JTyd;
+  int k;
+
+  // Check
+  if (!c)
+    return;
+  if (VEC_get_size(JTy) != NET_get_num_vars(c->net)+CONSTR_get_num_extra_vars(c) ||
+      VEC_get_size(y) != MAT_get_size1(c->J)) {
+    sprintf(c->error_string,"invalid vector size");
+    c->error_flag = TRUE;
+    return;
+  }
+
+  // Native
+  if (c->func_eval_JTy) {
+    if (CONSTR_is_safe_to_eval(c,v,ve))
+      (*(c->func_eval_JTy))(c,v,ve,y,JTy);
+    return;
+  }
+
+  // Fallback
+  CONSTR_eval(c,v,ve);
+  J = c->J;
+  yd = VEC_get_data(y);
+  JTyd = VEC_get_data(JTy);
+  for (k = 0; k < MAT_get_nnz(J); k++)
+    JTyd[MAT_get_j(J,k)] += MAT_get_d(J,k)*yd[MAT_get_i(J,k)];
+}
+
+void CONSTR_eval_Hv(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the linear combination of the Hessians
+   *  of f at (v,ve) with coefficients lam and the direction d, which has
+   *  one entry per network and extra variable of the constraint.
+   *  Constraints without a native product are evaluated at (v,ve) and
+   *  use their Hessian array.
+   */
+
+  // Local variables
+  REAL* lamd;
+  int k;
+
+  // Check
+  if (!c)
+    return;
+  if (VEC_get_size(d) != NET_get_num_vars(c->net)+CONSTR_get_num_extra_vars(c) ||
+      VEC_get_size(Hd) != VEC_get_size(d) ||
+      VEC_get_size(lam) != MAT_get_size1(c->J)) {
+    sprintf(c->error_string,"invalid vector size");
+    c->error_flag = TRUE;
+    return;
+  }
+
+  // Native
+  if (c->func_eval_Hv) {
+    if (CONSTR_is_safe_to_eval(c,v,ve))
+      (*(c->func_eval_Hv))(c,v,ve,lam,d,Hd);
+    return;
+  }
+
+  // Fallback
+  CONSTR_eval(c,v,ve);
+  lamd = VEC_get_data(lam);
+  for (k = 0; k < c->H_array_size; k++)
+    MAT_add_sym_mul_vec(MAT_array_get(c->H_array,k),lamd[k],VEC_get_data(d),VEC_get_data(Hd));
+}
+
+void CONSTR_add_H_product(int i, int j, REAL val, REAL* d, REAL* Hd) {
+  /** Adds to Hd the product of the symmetric matrix with the single
+   *  entry val at (i,j) and (j,i) and the vector d.
+   */
+  Hd[i] += val*d[j];
+  if (i != j)
+    Hd[j] += val*d[i];
+}
+
+void CONSTR_eval_batch(Constr* c, Vec* v, Vec* ve) {
+  if (c && c->func_eval && CONSTR_is_safe_to_eval(c,v,ve))
+    (*(c->func_eval))(c,v,ve);
+}
+
+void CONSTR_eval_period(Constr* c, int t, Vec* v, Vec* ve) {
+  /** Evaluates the parts of the constraint that are computed with a
+   *  sweep over the network components of time period t instead of
+   *  with the branch traversal of CONSTR_eval_step. It is called once
+   *  per period, after the steps of the period.
+   */
+  if (c && c->func_eval_period && CONSTR_is_safe_to_eval(c,v,ve))
+    (*(c->func_eval_period))(c,t,v,ve);
 }
 
 void CONSTR_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve) {
+  if (!CONSTR_is_branch_active(c,br,t))
+    return;
   if (c && c->func_eval_step && CONSTR_is_safe_to_eval(c,v,ve))
     (*(c->func_eval_step))(c,br,t,v,ve);
 }
@@ -1099,13 +1476,41 @@ void CONSTR_store_sens(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       CONSTR_store_sens_step(c,NET_get_branch(net,i),t,sA,sf,sGu,sGl);
   }
+  CONSTR_store_sens_batch(c,sA,sf,sGu,sGl);
+}
+
+void CONSTR_store_sens_batch(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
+  if (c && c->func_store_sens && CONSTR_is_safe_to_count(c))
+    (*(c->func_store_sens))(c,sA,sf,sGu,sGl);
 }
 
 void CONSTR_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
+  if (!CONSTR_is_branch_active(c,br,t))
+    return;
   if (c && c->func_store_sens_step && CONSTR_is_safe_to_count(c))
     (*(c->func_store_sens_step))(c,br,t,sA,sf,sGu,sGl);
 }
 
+BOOL CONSTR_is_branch_active(Constr* c, Branch* br, int t) {
+  /** Determines whether the rows of the given branch and time
+   *  period are included in the constraint. All are if the
+   *  constraint has no active set.
+   */
+
+  // Local variables
+  int index;
+
+  // Check
+  if (!c || !c->branch_active || !br)
+    return TRUE;
+
+  // Flag
+  index = t*NET_get_num_branches(c->net)+BRANCH_get_index(br);
+  if (index < 0 || index >= c->branch_active_size)
+    return TRUE;
+  return c->branch_active[index];
+}
+
 BOOL CONSTR_is_safe_to_count(Constr* c) {
   Net* net = CONSTR_get_network(c);
   if (CONSTR_get_bus_counted_size(c) == NET_get_num_buses(net)*NET_get_num_periods(net))
@@ -1153,6 +1558,34 @@ BOOL CONSTR_is_safe_to_eval(Constr* c, Vec* v, Vec* ve) {
   }
 }
 
+BOOL CONSTR_has_active_set(Constr* c) {
+  if (c)
+    return c->branch_active != NULL;
+  else
+    return FALSE;
+}
+
+BOOL CONSTR_is_island_safe(Constr* c) {
+  /** Periodic structure needs the counters of the first period
+   *  in the data steps of the other periods, so those constraints
+   *  are not split into islands.
+   */
+  if (c)
+    return c->island_safe && !CONSTR_has_periodic_structure(c);
+  else
+    return FALSE;
+}
+
+BOOL CONSTR_has_periodic_structure(Constr* c) {
+  /** Periodic structure is not used with an active set,
+   *  since the active branches may differ among periods.
+   */
+  if (c)
+    return c->periodic && !c->branch_active;
+  else
+    return FALSE;
+}
+
 BOOL CONSTR_has_error(Constr* c) {
   if (c)
     return c->error_flag;
@@ -1241,6 +1674,11 @@ void CONSTR_set_func_eval_step(Constr* c, void (*func)(Constr* c, Branch* br, in
     c->func_eval_step = func;
 }
 
+void CONSTR_set_func_eval_period(Constr* c, void (*func)(Constr* c, int t, Vec* v, Vec* ve)) {
+  if (c)
+    c->func_eval_period = func;
+}
+
 void CONSTR_set_func_store_sens_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl)) {
   if (c)
     c->func_store_sens_step = func;
@@ -1250,3 +1688,228 @@ void CONSTR_set_func_free(Constr* c, void (*func)(Constr* c)) {
   if (c)
     c->func_free = func;
 }
+
+void CONSTR_set_func_count(Constr* c, void (*func)(Constr* c)) {
+  if (c)
+    c->func_count = func;
+}
+
+void CONSTR_set_func_analyze(Constr* c, void (*func)(Constr* c)) {
+  if (c)
+    c->func_analyze = func;
+}
+
+void CONSTR_set_func_eval(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve)) {
+  if (c)
+    c->func_eval = func;
+}
+
+void CONSTR_set_func_store_sens(Constr* c, void (*func)(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl)) {
+  if (c)
+    c->func_store_sens = func;
+}
+
+void CONSTR_set_func_analyze_data_step(Constr* c, void (*func)(Constr* c, Branch* br, int t)) {
+  if (c)
+    c->func_analyze_data_step = func;
+}
+
+void CONSTR_set_active_set(Constr* c, BOOL flag) {
+  /** Enables or disables the active-set mode of a constraint with
+   *  rows per branch (e.g. branch flow limits). In this mode, rows are
+   *  created only for the branches and time periods added to the active
+   *  set with CONSTR_screen_branches, which starts empty. The problem
+   *  must be analyzed again after changing the active set.
+   */
+
+  // No c
+  if (!c)
+    return;
+
+  // Disable
+  if (!flag) {
+    free(c->branch_active);
+    c->branch_active = NULL;
+    c->branch_active_size = 0;
+    return;
+  }
+
+  // Check
+  if (!c->func_get_branch_loading) {
+    sprintf(c->error_string,"constraint does not support active set");
+    c->error_flag = TRUE;
+    return;
+  }
+
+  // Enable
+  if (!c->branch_active) {
+    c->branch_active_size = NET_get_num_branches(c->net)*NET_get_num_periods(c->net);
+    ARRAY_zalloc(c->branch_active,char,c->branch_active_size);
+  }
+}
+
+void CONSTR_set_func_get_branch_loading(Constr* c, REAL (*func)(Constr* c, Branch* br, int t, Vec* v)) {
+  if (c)
+    c->func_get_branch_loading = func;
+}
+
+void CONSTR_set_func_eval_Jv(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve, Vec* d, Vec* Jd)) {
+  if (c)
+    c->func_eval_Jv = func;
+}
+
+void CONSTR_set_func_eval_JTy(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve, Vec* y, Vec* JTy)) {
+  if (c)
+    c->func_eval_JTy = func;
+}
+
+void CONSTR_set_func_eval_Hv(Constr* c, void (*func)(Constr* c, Vec* v, Vec* ve, Vec* lam, Vec* d, Vec* Hd)) {
+  if (c)
+    c->func_eval_Hv = func;
+}
+
+void CONSTR_set_island_safe(Constr* c, BOOL flag) {
+  /** Sets whether the count, analyze and eval steps of a branch only
+   *  write counters of the constraint and data of the rows, buses,
+   *  branches and components of the island of the branch, and return
+   *  immediately for branches on outage. Steps of different islands can
+   *  then run on separate threads with views of the constraint (see
+   *  CONSTR_new_view).
+   */
+  if (c)
+    c->island_safe = flag;
+}
+
+void CONSTR_set_periodic_structure(Constr* c, BOOL flag) {
+  /** Sets whether the constraint has the same structure in every time
+   *  period. If so, the count and analyze steps run only for the first
+   *  period, and the data step stores the vectors and row counters of the
+   *  other periods. Rows of A, J and G of period t must be those of the
+   *  first period shifted by t times the number of rows per period, and
+   *  the constraint must not have Hessians or extra variables.
+   */
+  if (c)
+    c->periodic = flag;
+}
+
+int CONSTR_screen_branches(Constr* c, Vec* values, REAL fraction) {
+  /** Adds to the active set the branches and time periods whose flow
+   *  at the given variable values (or at the current network values if
+   *  values is NULL) exceeds the given fraction of their rating. Branches
+   *  are never removed from the active set. Returns the number of added
+   *  pairs of branch and time period.
+   */
+
+  // Local variables
+  Branch* br;
+  int num_branches;
+  int num_added;
+  int i;
+  int t;
+
+  // Check
+  if (!c || !c->branch_active || !c->func_get_branch_loading)
+    return 0;
+  num_branches = NET_get_num_branches(c->net);
+  if (c->branch_active_size != num_branches*NET_get_num_periods(c->net)) {
+    sprintf(c->error_string,"active set does not match network");
+    c->error_flag = TRUE;
+    return 0;
+  }
+
+  // Screen
+  num_added = 0;
+  for (t = 0; t < NET_get_num_periods(c->net); t++) {
+    for (i = 0; i < num_branches; i++) {
+      if (c->branch_active[t*num_branches+i])
+	continue;
+      br = NET_get_branch(c->net,i);
+      if ((*(c->func_get_branch_loading))(c,br,t,values) > fraction) {
+	c->branch_active[t*num_branches+i] = TRUE;
+	num_added++;
+      }
+    }
+  }
+  return num_added;
+}
+
+void CONSTR_replicate_counts(Constr* c) {
+  /** Scales the counters found for the first time period
+   *  by the number of periods (periodic structure).
+   */
+
+  // Local variables
+  int T;
+
+  // Check
+  if (!CONSTR_has_periodic_structure(c) || !CONSTR_is_safe_to_count(c))
+    return;
+
+  // Counters
+  T = NET_get_num_periods(c->net);
+  c->A_nnz *= T;
+  c->J_nnz *= T;
+  c->G_nnz *= T;
+  c->A_row *= T;
+  c->J_row *= T;
+  c->G_row *= T;
+}
+
+void CONSTR_replicate_structure(Constr* c) {
+  /** Copies the entries of A, J and G found for the first time period
+   *  to the other periods (periodic structure). Rows are shifted by the
+   *  number of rows per period and columns by the period times the
+   *  stride of the variable (see NET_create_var_strides).
+   */
+
+  // Local variables
+  Mat* M[3];
+  int* nnz[3];
+  int* stride;
+  int nnz0;
+  int row0;
+  int num_vars;
+  int j;
+  int k;
+  int r;
+  int t;
+  int T;
+
+  // Check
+  if (!CONSTR_has_periodic_structure(c) || !CONSTR_is_safe_to_analyze(c))
+    return;
+
+  // Matrices
+  M[0] = c->A;
+  M[1] = c->J;
+  M[2] = c->G;
+  nnz[0] = &(c->A_nnz);
+  nnz[1] = &(c->J_nnz);
+  nnz[2] = &(c->G_nnz);
+  T = NET_get_num_periods(c->net);
+  num_vars = NET_get_num_vars(c->net);
+  stride = NET_create_var_strides(c->net);
+
+  // Replicate
+  for (r = 0; r < 3; r++) {
+    nnz0 = *(nnz[r]);
+    if (MAT_get_nnz(M[r]) != nnz0*T || MAT_get_size1(M[r])%T != 0) {
+      sprintf(c->error_string,"structure is not periodic");
+      c->error_flag = TRUE;
+      break;
+    }
+    row0 = MAT_get_size1(M[r])/T;
+    for (t = 1; t < T; t++) {
+      for (k = 0; k < nnz0; k++) {
+	j = MAT_get_j(M[r],k);
+	MAT_set_i(M[r],t*nnz0+k,MAT_get_i(M[r],k)+t*row0);
+	MAT_set_j(M[r],t*nnz0+k,(j < num_vars) ? j+t*stride[j] : j);
+	MAT_set_d(M[r],t*nnz0+k,MAT_get_d(M[r],k));
+      }
+    }
+    *(nnz[r]) = nnz0*T;
+  }
+
+  // Clean up
+  free(stride);
+}
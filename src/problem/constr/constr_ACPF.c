@@ -25,6 +25,9 @@ struct Constr_ACPF_Data {
   int* dwdw_indices;
   int* dwdv_indices;
   int* dvdv_indices;
+
+  // Constant mismatches of fixed branches
+  REAL* f_fixed;
 };
 
 Constr* CONSTR_ACPF_new(Net* net) {
@@ -35,8 +38,14 @@ Constr* CONSTR_ACPF_new(Net* net) {
   CONSTR_set_func_clear(c, &CONSTR_ACPF_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_ACPF_analyze_step);
   CONSTR_set_func_eval_step(c, &CONSTR_ACPF_eval_step);
+  CONSTR_set_func_analyze(c, &CONSTR_ACPF_analyze);
+  CONSTR_set_func_eval(c, &CONSTR_ACPF_eval);
+  CONSTR_set_func_eval_Jv(c, &CONSTR_ACPF_eval_Jv);
+  CONSTR_set_func_eval_JTy(c, &CONSTR_ACPF_eval_JTy);
+  CONSTR_set_func_eval_Hv(c, &CONSTR_ACPF_eval_Hv);
   CONSTR_set_func_store_sens_step(c, &CONSTR_ACPF_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_ACPF_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -63,6 +72,7 @@ void CONSTR_ACPF_init(Constr* c) {
   ARRAY_zalloc(data->dwdw_indices,int,num_buses*num_periods);
   ARRAY_zalloc(data->dwdv_indices,int,num_buses*num_periods);
   ARRAY_zalloc(data->dvdv_indices,int,num_buses*num_periods);
+  ARRAY_zalloc(data->f_fixed,REAL,2*num_buses*num_periods);
   CONSTR_set_name(c,"AC power balance");
   CONSTR_set_data(c,(void*)data);
 }
@@ -914,19 +924,11 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   REAL v[2];
 
   REAL a;
-  REAL a_temp;
   REAL phi;
-  REAL phi_temp;
 
   BOOL var_a;
   BOOL var_phi;
 
-  REAL b;
-  REAL b_sh[2];
-
-  REAL g;
-  REAL g_sh[2];
-
   REAL P_km[2];
   REAL P_kk[2];
   REAL Q_km[2];
@@ -992,12 +994,6 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   // Branch data
   var_a = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO);
   var_phi = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE);
-  b = BRANCH_get_b(br);
-  b_sh[0] = BRANCH_get_b_k(br);
-  b_sh[1] = BRANCH_get_b_m(br);
-  g = BRANCH_get_g(br);
-  g_sh[0] = BRANCH_get_g_k(br);
-  g_sh[1] = BRANCH_get_g_m(br);
   if (var_a)
     a = VEC_get(values,BRANCH_get_index_ratio(br,t));
   else
@@ -1007,35 +1003,17 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   else
     phi = BRANCH_get_phase(br,t);
 
-  // Branch flows
-  for (k = 0; k < 2; k++) {
-
-    if (k == 0) {
-      m = 1;
-      a_temp = a;
-      phi_temp = phi;
-    }
-    else {
-      m = 0;
-      a_temp = 1;
-      phi_temp = -phi;
+  // Branch flows (fixed ones are added by CONSTR_ACPF_eval)
+  if (CONSTR_ACPF_has_fixed_flows(br)) {
+    for (k = 0; k < 2; k++) {
+      P_km[k] = 0.;
+      Q_km[k] = 0.;
+      P_kk[k] = 0.;
+      Q_kk[k] = 0.;
     }
-
-    /** Branch flow equations for refernce:
-     *  theta = w_k-w_m-theta_km+theta_mk
-     *  P_km =  a_km^2*v_k^2*(g_km + gsh_km) - a_km*a_mk*v_k*v_m*( g_km*cos(theta) + b_km*sin(theta) )
-     *  Q_km = -a_km^2*v_k^2*(b_km + bsh_km) - a_km*a_mk*v_k*v_m*( g_km*sin(theta) - b_km*cos(theta) )
-     */
-
-    // Parts of the branch flow dependent on both vk, vm and the angles
-    // (note that a == a_mk*a_km regardless of the direction since the other direction will always will always be 1)
-    P_km[k] = -a*v[k]*v[m]*(g*cos(w[k]-w[m]-phi_temp)+b*sin(w[k]-w[m]-phi_temp));
-    Q_km[k] = -a*v[k]*v[m]*(g*sin(w[k]-w[m]-phi_temp)-b*cos(w[k]-w[m]-phi_temp));
-
-    // Parts of the branch flow dependent on only vk^2
-    P_kk[k] =  a_temp*a_temp*(g_sh[k]+g)*v[k]*v[k];
-    Q_kk[k] = -a_temp*a_temp*(b_sh[k]+b)*v[k]*v[k];
   }
+  else
+    CONSTR_ACPF_get_branch_flows(br,v,w,a,phi,P_km,Q_km,P_kk,Q_kk);
 
   // Branch
   //*******
@@ -1500,9 +1478,617 @@ void CONSTR_ACPF_free(Constr* c) {
     free(data->dwdw_indices);
     free(data->dwdv_indices);
     free(data->dvdv_indices);
+    free(data->f_fixed);
     free(data);
   }
 
   // Set data
   CONSTR_set_data(c,NULL);
 }
+
+void CONSTR_ACPF_analyze(Constr* c) {
+  /** Stores the constant contributions to the mismatches of the
+   *  branches without variables (see CONSTR_ACPF_has_fixed_flows).
+   *  These are skipped by CONSTR_ACPF_eval_step and added by
+   *  CONSTR_ACPF_eval with a single pass over f.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* bus[2];
+  Constr_ACPF_Data* data;
+  REAL w[2];
+  REAL v[2];
+  REAL P_km[2];
+  REAL Q_km[2];
+  REAL P_kk[2];
+  REAL Q_kk[2];
+  int P_index;
+  int Q_index;
+  int num_buses;
+  int i;
+  int k;
+  int t;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  data = (Constr_ACPF_Data*)CONSTR_get_data(c);
+  num_buses = NET_get_num_buses(net);
+
+  // Check pointer
+  if (!data)
+    return;
+
+  // Clear
+  for (i = 0; i < 2*data->size; i++)
+    data->f_fixed[i] = 0;
+
+  // Fixed branches
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+      if (BRANCH_is_on_outage(br) || !CONSTR_ACPF_has_fixed_flows(br))
+	continue;
+
+      // Flows
+      bus[0] = BRANCH_get_bus_k(br);
+      bus[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++) {
+	w[k] = BUS_get_v_ang(bus[k],t);
+	v[k] = BUS_get_v_mag(bus[k],t);
+      }
+      CONSTR_ACPF_get_branch_flows(br,v,w,BRANCH_get_ratio(br,t),BRANCH_get_phase(br,t),P_km,Q_km,P_kk,Q_kk);
+
+      // Mismatches
+      for (k = 0; k < 2; k++) {
+	P_index = BUS_get_index_P(bus[k])+t*2*num_buses;
+	Q_index = BUS_get_index_Q(bus[k])+t*2*num_buses;
+	data->f_fixed[P_index] -= P_kk[k] + P_km[k];
+	data->f_fixed[Q_index] -= Q_kk[k] + Q_km[k];
+      }
+    }
+  }
+}
+
+void CONSTR_ACPF_eval(Constr* c, Vec* values, Vec* values_extra) {
+
+  // Local variables
+  Constr_ACPF_Data* data;
+  REAL* f;
+  int i;
+
+  // Constr data
+  f = VEC_get_data(CONSTR_get_f(c));
+  data = (Constr_ACPF_Data*)CONSTR_get_data(c);
+
+  // Check pointers
+  if (!f || !data || VEC_get_size(CONSTR_get_f(c)) != 2*data->size)
+    return;
+
+  // Fixed branches
+  for (i = 0; i < 2*data->size; i++)
+    f[i] += data->f_fixed[i];
+}
+
+void CONSTR_ACPF_get_branch_flows(Branch* br, REAL* v, REAL* w, REAL a, REAL phi,
+				  REAL* P_km, REAL* Q_km, REAL* P_kk, REAL* Q_kk) {
+  /** Computes the parts of the branch flows in both directions given
+   *  voltage magnitudes v and angles w of buses k and m, tap ratio a
+   *  and phase shift phi.
+   */
+
+  // Local variables
+  REAL a_temp;
+  REAL phi_temp;
+  REAL b;
+  REAL b_sh[2];
+  REAL g;
+  REAL g_sh[2];
+  int k;
+  int m;
+
+  // Branch data
+  b = BRANCH_get_b(br);
+  b_sh[0] = BRANCH_get_b_k(br);
+  b_sh[1] = BRANCH_get_b_m(br);
+  g = BRANCH_get_g(br);
+  g_sh[0] = BRANCH_get_g_k(br);
+  g_sh[1] = BRANCH_get_g_m(br);
+
+  // Branch flows
+  for (k = 0; k < 2; k++) {
+
+    if (k == 0) {
+      m = 1;
+      a_temp = a;
+      phi_temp = phi;
+    }
+    else {
+      m = 0;
+      a_temp = 1;
+      phi_temp = -phi;
+    }
+
+    /** Branch flow equations for refernce:
+     *  theta = w_k-w_m-theta_km+theta_mk
+     *  P_km =  a_km^2*v_k^2*(g_km + gsh_km) - a_km*a_mk*v_k*v_m*( g_km*cos(theta) + b_km*sin(theta) )
+     *  Q_km = -a_km^2*v_k^2*(b_km + bsh_km) - a_km*a_mk*v_k*v_m*( g_km*sin(theta) - b_km*cos(theta) )
+     */
+
+    // Parts of the branch flow dependent on both vk, vm and the angles
+    // (note that a == a_mk*a_km regardless of the direction since the other direction will always will always be 1)
+    P_km[k] = -a*v[k]*v[m]*(g*cos(w[k]-w[m]-phi_temp)+b*sin(w[k]-w[m]-phi_temp));
+    Q_km[k] = -a*v[k]*v[m]*(g*sin(w[k]-w[m]-phi_temp)-b*cos(w[k]-w[m]-phi_temp));
+
+    // Parts of the branch flow dependent on only vk^2
+    P_kk[k] =  a_temp*a_temp*(g_sh[k]+g)*v[k]*v[k];
+    Q_kk[k] = -a_temp*a_temp*(b_sh[k]+b)*v[k]*v[k];
+  }
+}
+
+BOOL CONSTR_ACPF_has_fixed_flows(Branch* br) {
+  /** Checks whether the flows of the branch depend only on data,
+   *  i.e., no voltage magnitude, angle, tap ratio or phase shift of
+   *  the branch is a variable.
+   */
+  Bus* bus_k = BRANCH_get_bus_k(br);
+  Bus* bus_m = BRANCH_get_bus_m(br);
+  return (!BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO) &&
+	  !BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE) &&
+	  !BUS_has_flags(bus_k,FLAG_VARS,BUS_VAR_VMAG) &&
+	  !BUS_has_flags(bus_k,FLAG_VARS,BUS_VAR_VANG) &&
+	  !BUS_has_flags(bus_m,FLAG_VARS,BUS_VAR_VMAG) &&
+	  !BUS_has_flags(bus_m,FLAG_VARS,BUS_VAR_VANG));
+}
+
+void CONSTR_ACPF_add_J_product(int row, int col, REAL val, REAL* d, REAL* Jd, REAL* y, REAL* JTy) {
+  if (Jd)
+    Jd[row] += val*d[col];
+  if (JTy)
+    JTy[col] += val*y[row];
+}
+
+void CONSTR_ACPF_eval_J_products(Constr* c, Vec* values, Vec* d, Vec* Jd, Vec* y, Vec* JTy) {
+  /** Adds J*d to Jd and/or J^T*y to JTy (whichever is not NULL), with J the
+   *  Jacobian of the mismatches at values. Entries of J are computed from the
+   *  branch flow formulas and used right away instead of being stored.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* bus[2];
+  Gen* gen;
+  Vargen* vargen;
+  Load* load;
+  Bat* bat;
+  Shunt* shunt;
+  char* bus_counted;
+  REAL* dd;
+  REAL* Jdd;
+  REAL* yd;
+  REAL* JTyd;
+  int bus_index_t[2];
+  int P_index[2];
+  int Q_index[2];
+  int v_index[2];
+  int w_index[2];
+  BOOL var_v[2];
+  BOOL var_w[2];
+  BOOL var_a;
+  BOOL var_phi;
+  REAL w[2];
+  REAL v[2];
+  REAL a;
+  REAL phi;
+  REAL P_km[2];
+  REAL Q_km[2];
+  REAL P_kk[2];
+  REAL Q_kk[2];
+  REAL indicator_a;
+  REAL indicator_phi;
+  REAL shunt_b;
+  REAL shunt_g;
+  int num_buses;
+  int i;
+  int k;
+  int m;
+  int t;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  num_buses = NET_get_num_buses(net);
+  bus_counted = CONSTR_get_bus_counted(c);
+  dd = VEC_get_data(d);
+  Jdd = VEC_get_data(Jd);
+  yd = VEC_get_data(y);
+  JTyd = VEC_get_data(JTy);
+
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  CONSTR_clear_bus_counted(c);
+
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
+
+      // Bus data
+      bus[0] = BRANCH_get_bus_k(br);
+      bus[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++) {
+	bus_index_t[k] = BUS_get_index(bus[k])+t*num_buses;
+	P_index[k] = BUS_get_index_P(bus[k])+t*2*num_buses;
+	Q_index[k] = BUS_get_index_Q(bus[k])+t*2*num_buses;
+	var_w[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG);
+	var_v[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VMAG);
+	w_index[k] = BUS_get_index_v_ang(bus[k],t);
+	v_index[k] = BUS_get_index_v_mag(bus[k],t);
+	if (var_w[k])
+	  w[k] = VEC_get(values,w_index[k]);
+	else
+	  w[k] = BUS_get_v_ang(bus[k],t);
+	if (var_v[k])
+	  v[k] = VEC_get(values,v_index[k]);
+	else
+	  v[k] = BUS_get_v_mag(bus[k],t);
+      }
+
+      // Branch
+      //*******
+
+      if (!CONSTR_ACPF_has_fixed_flows(br)) {
+
+	// Branch data
+	var_a = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO);
+	var_phi = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE);
+	if (var_a)
+	  a = VEC_get(values,BRANCH_get_index_ratio(br,t));
+	else
+	  a = BRANCH_get_ratio(br,t);
+	if (var_phi)
+	  phi = VEC_get(values,BRANCH_get_index_phase(br,t));
+	else
+	  phi = BRANCH_get_phase(br,t);
+
+	// Branch flows
+	CONSTR_ACPF_get_branch_flows(br,v,w,a,phi,P_km,Q_km,P_kk,Q_kk);
+
+	for (k = 0; k < 2; k++) {
+
+	  if (k == 0) {
+	    m = 1;
+	    indicator_a = 1.;
+	    indicator_phi = 1.;
+	  }
+	  else {
+	    m = 0;
+	    indicator_a = 0.;
+	    indicator_phi = -1.;
+	  }
+
+	  if (var_w[k]) { // wk var
+	    CONSTR_ACPF_add_J_product(P_index[m],w_index[k],-Q_km[m],dd,Jdd,yd,JTyd); // dPm/dwk
+	    CONSTR_ACPF_add_J_product(Q_index[m],w_index[k],P_km[m],dd,Jdd,yd,JTyd);  // dQm/dwk
+	    CONSTR_ACPF_add_J_product(P_index[k],w_index[k],Q_km[k],dd,Jdd,yd,JTyd);  // dPk/dwk
+	    CONSTR_ACPF_add_J_product(Q_index[k],w_index[k],-P_km[k],dd,Jdd,yd,JTyd); // dQk/dwk
+	  }
+
+	  if (var_v[k]) { // vk var
+	    CONSTR_ACPF_add_J_product(P_index[m],v_index[k],-P_km[m]/v[k],dd,Jdd,yd,JTyd); // dPm/dvk
+	    CONSTR_ACPF_add_J_product(Q_index[m],v_index[k],-Q_km[m]/v[k],dd,Jdd,yd,JTyd); // dQm/dvk
+	    CONSTR_ACPF_add_J_product(P_index[k],v_index[k],-2*P_kk[k]/v[k]-P_km[k]/v[k],dd,Jdd,yd,JTyd); // dPk/dvk
+	    CONSTR_ACPF_add_J_product(Q_index[k],v_index[k],-2*Q_kk[k]/v[k]-Q_km[k]/v[k],dd,Jdd,yd,JTyd); // dQk/dvk
+	  }
+
+	  if (var_a) { // a var
+	    CONSTR_ACPF_add_J_product(P_index[k],BRANCH_get_index_ratio(br,t),
+				      indicator_a*(-2.*P_kk[k]/a)-P_km[k]/a,dd,Jdd,yd,JTyd); // dPk/da
+	    CONSTR_ACPF_add_J_product(Q_index[k],BRANCH_get_index_ratio(br,t),
+				      indicator_a*(-2.*Q_kk[k]/a)-Q_km[k]/a,dd,Jdd,yd,JTyd); // dQk/da
+	  }
+
+	  if (var_phi) { // phi var
+	    CONSTR_ACPF_add_J_product(P_index[k],BRANCH_get_index_phase(br,t),
+				      -indicator_phi*Q_km[k],dd,Jdd,yd,JTyd); // dPk/dphi
+	    CONSTR_ACPF_add_J_product(Q_index[k],BRANCH_get_index_phase(br,t),
+				      indicator_phi*P_km[k],dd,Jdd,yd,JTyd);  // dQk/dphi
+	  }
+	}
+      }
+
+      // Buses
+      //******
+
+      for (k = 0; k < 2; k++) {
+
+	if (bus_counted[bus_index_t[k]])
+	  continue;
+	bus_counted[bus_index_t[k]] = TRUE;
+
+	// Generators
+	for (gen = BUS_get_gen(bus[k]); gen != NULL; gen = GEN_get_next(gen)) {
+	  if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+	    CONSTR_ACPF_add_J_product(P_index[k],GEN_get_index_P(gen,t),1.,dd,Jdd,yd,JTyd); // dPk/dPg
+	  if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q))
+	    CONSTR_ACPF_add_J_product(Q_index[k],GEN_get_index_Q(gen,t),1.,dd,Jdd,yd,JTyd); // dQk/dQg
+	}
+
+	// Variable generators
+	for (vargen = BUS_get_vargen(bus[k]); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
+	  if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
+	    CONSTR_ACPF_add_J_product(P_index[k],VARGEN_get_index_P(vargen,t),1.,dd,Jdd,yd,JTyd); // dPk/dPg
+	  if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q))
+	    CONSTR_ACPF_add_J_product(Q_index[k],VARGEN_get_index_Q(vargen,t),1.,dd,Jdd,yd,JTyd); // dQk/dQg
+	}
+
+	// Shunts
+	for (shunt = BUS_get_shunt(bus[k]); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+	  shunt_g = SHUNT_get_g(shunt);
+	  if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
+	    shunt_b = VEC_get(values,SHUNT_get_index_b(shunt,t));
+	    CONSTR_ACPF_add_J_product(Q_index[k],SHUNT_get_index_b(shunt,t),v[k]*v[k],dd,Jdd,yd,JTyd); // dQk/db
+	  }
+	  else
+	    shunt_b = SHUNT_get_b(shunt,t);
+	  if (var_v[k]) {
+	    CONSTR_ACPF_add_J_product(P_index[k],v_index[k],-2*shunt_g*v[k],dd,Jdd,yd,JTyd); // dPk/dvk
+	    CONSTR_ACPF_add_J_product(Q_index[k],v_index[k],2*shunt_b*v[k],dd,Jdd,yd,JTyd);  // dQk/dvk
+	  }
+	}
+
+	// Loads
+	for (load = BUS_get_load(bus[k]); load != NULL; load = LOAD_get_next(load)) {
+	  if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
+	    CONSTR_ACPF_add_J_product(P_index[k],LOAD_get_index_P(load,t),-1.,dd,Jdd,yd,JTyd); // dPk/dPl
+	  if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q))
+	    CONSTR_ACPF_add_J_product(Q_index[k],LOAD_get_index_Q(load,t),-1.,dd,Jdd,yd,JTyd); // dQk/dQl
+	}
+
+	// Batteries
+	for (bat = BUS_get_bat(bus[k]); bat != NULL; bat = BAT_get_next(bat)) {
+	  if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {
+	    CONSTR_ACPF_add_J_product(P_index[k],BAT_get_index_Pc(bat,t),-1.,dd,Jdd,yd,JTyd); // dPk/dPc
+	    CONSTR_ACPF_add_J_product(P_index[k],BAT_get_index_Pd(bat,t),1.,dd,Jdd,yd,JTyd);  // dPk/dPd
+	  }
+	}
+      }
+    }
+  }
+}
+
+void CONSTR_ACPF_eval_Jv(Constr* c, Vec* values, Vec* values_extra, Vec* d, Vec* Jd) {
+  CONSTR_ACPF_eval_J_products(c,values,d,Jd,NULL,NULL);
+}
+
+void CONSTR_ACPF_eval_JTy(Constr* c, Vec* values, Vec* values_extra, Vec* y, Vec* JTy) {
+  CONSTR_ACPF_eval_J_products(c,values,NULL,NULL,y,JTy);
+}
+
+void CONSTR_ACPF_eval_Hv(Constr* c, Vec* values, Vec* values_extra, Vec* lam, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the linear combination of the Hessians
+   *  of the mismatches at values with coefficients lam and d. Entries
+   *  are computed from the branch flow formulas and combined right away
+   *  instead of being stored per row.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* bus[2];
+  Shunt* shunt;
+  char* bus_counted;
+  REAL* lamd;
+  REAL* dd;
+  REAL* Hdd;
+  int bus_index_t[2];
+  int P_index[2];
+  int Q_index[2];
+  int v_index[2];
+  int w_index[2];
+  int a_index;
+  int phi_index;
+  BOOL var_v[2];
+  BOOL var_w[2];
+  BOOL var_a;
+  BOOL var_phi;
+  REAL w[2];
+  REAL v[2];
+  REAL a;
+  REAL phi;
+  REAL P_km[2];
+  REAL Q_km[2];
+  REAL P_kk[2];
+  REAL Q_kk[2];
+  REAL lP;
+  REAL lQ;
+  REAL indicator_a;
+  REAL indicator_phi;
+  REAL shunt_b;
+  REAL shunt_g;
+  int num_buses;
+  int i;
+  int k;
+  int m;
+  int t;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  num_buses = NET_get_num_buses(net);
+  bus_counted = CONSTR_get_bus_counted(c);
+  lamd = VEC_get_data(lam);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
+
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  CONSTR_clear_bus_counted(c);
+
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
+
+      // Bus data
+      bus[0] = BRANCH_get_bus_k(br);
+      bus[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++) {
+	bus_index_t[k] = BUS_get_index(bus[k])+t*num_buses;
+	P_index[k] = BUS_get_index_P(bus[k])+t*2*num_buses;
+	Q_index[k] = BUS_get_index_Q(bus[k])+t*2*num_buses;
+	var_w[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG);
+	var_v[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VMAG);
+	w_index[k] = BUS_get_index_v_ang(bus[k],t);
+	v_index[k] = BUS_get_index_v_mag(bus[k],t);
+	if (var_w[k])
+	  w[k] = VEC_get(values,w_index[k]);
+	else
+	  w[k] = BUS_get_v_ang(bus[k],t);
+	if (var_v[k])
+	  v[k] = VEC_get(values,v_index[k]);
+	else
+	  v[k] = BUS_get_v_mag(bus[k],t);
+      }
+
+      // Branch
+      //*******
+
+      if (!CONSTR_ACPF_has_fixed_flows(br)) {
+
+	// Branch data
+	var_a = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO);
+	var_phi = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE);
+	a_index = BRANCH_get_index_ratio(br,t);
+	phi_index = BRANCH_get_index_phase(br,t);
+	if (var_a)
+	  a = VEC_get(values,a_index);
+	else
+	  a = BRANCH_get_ratio(br,t);
+	if (var_phi)
+	  phi = VEC_get(values,phi_index);
+	else
+	  phi = BRANCH_get_phase(br,t);
+
+	// Branch flows
+	CONSTR_ACPF_get_branch_flows(br,v,w,a,phi,P_km,Q_km,P_kk,Q_kk);
+
+	for (k = 0; k < 2; k++) {
+
+	  if (k == 0) {
+	    m = 1;
+	    indicator_a = 1.;
+	    indicator_phi = 1.;
+	  }
+	  else {
+	    m = 0;
+	    indicator_a = 0.;
+	    indicator_phi = -1.;
+	  }
+
+	  // Multipliers
+	  lP = lamd[P_index[k]];
+	  lQ = lamd[Q_index[k]];
+
+	  if (var_w[k]) { // wk var
+	    CONSTR_add_H_product(w_index[k],w_index[k],lP*P_km[k]+lQ*Q_km[k],dd,Hdd);                   // wk and wk
+	    if (var_v[k])
+	      CONSTR_add_H_product(w_index[k],v_index[k],(lP*Q_km[k]-lQ*P_km[k])/v[k],dd,Hdd);           // wk and vk
+	    if (var_w[m])
+	      CONSTR_add_H_product(w_index[k],w_index[m],-lP*P_km[k]-lQ*Q_km[k],dd,Hdd);                 // wk and wm
+	    if (var_v[m])
+	      CONSTR_add_H_product(w_index[k],v_index[m],(lP*Q_km[k]-lQ*P_km[k])/v[m],dd,Hdd);           // wk and vm
+	    if (var_a)
+	      CONSTR_add_H_product(w_index[k],a_index,(lP*Q_km[k]-lQ*P_km[k])/a,dd,Hdd);                 // wk and a
+	    if (var_phi)
+	      CONSTR_add_H_product(w_index[k],phi_index,-indicator_phi*(lP*P_km[k]+lQ*Q_km[k]),dd,Hdd);  // wk and phi
+	  }
+
+	  if (var_v[k]) { // vk var
+	    CONSTR_add_H_product(v_index[k],v_index[k],-2.*(lP*P_kk[k]+lQ*Q_kk[k])/(v[k]*v[k]),dd,Hdd); // vk and vk
+	    if (var_w[m])
+	      CONSTR_add_H_product(v_index[k],w_index[m],(-lP*Q_km[k]+lQ*P_km[k])/v[k],dd,Hdd);          // vk and wm
+	    if (var_v[m])
+	      CONSTR_add_H_product(v_index[k],v_index[m],-(lP*P_km[k]+lQ*Q_km[k])/(v[k]*v[m]),dd,Hdd);   // vk and vm
+	    if (var_a)
+	      CONSTR_add_H_product(v_index[k],a_index,
+				   -(indicator_a*4.*(lP*P_kk[k]+lQ*Q_kk[k])+lP*P_km[k]+lQ*Q_km[k])/(a*v[k]),
+				   dd,Hdd);                                                                  // vk and a
+	    if (var_phi)
+	      CONSTR_add_H_product(v_index[k],phi_index,indicator_phi*(-lP*Q_km[k]+lQ*P_km[k])/v[k],dd,Hdd); // vk and phi
+	  }
+
+	  if (var_w[m]) { // wm var
+	    CONSTR_add_H_product(w_index[m],w_index[m],lP*P_km[k]+lQ*Q_km[k],dd,Hdd);                   // wm and wm
+	    if (var_v[m])
+	      CONSTR_add_H_product(w_index[m],v_index[m],(-lP*Q_km[k]+lQ*P_km[k])/v[m],dd,Hdd);          // wm and vm
+	    if (var_a)
+	      CONSTR_add_H_product(w_index[m],a_index,(-lP*Q_km[k]+lQ*P_km[k])/a,dd,Hdd);                // wm and a
+	    if (var_phi)
+	      CONSTR_add_H_product(w_index[m],phi_index,indicator_phi*(lP*P_km[k]+lQ*Q_km[k]),dd,Hdd);   // wm and phi
+	  }
+
+	  if (var_v[m]) { // vm var
+	    if (var_a)
+	      CONSTR_add_H_product(v_index[m],a_index,-(lP*P_km[k]+lQ*Q_km[k])/(a*v[m]),dd,Hdd);         // vm and a
+	    if (var_phi)
+	      CONSTR_add_H_product(v_index[m],phi_index,indicator_phi*(-lP*Q_km[k]+lQ*P_km[k])/v[m],dd,Hdd); // vm and phi
+	  }
+
+	  if (var_a) { // a var
+	    if (k == 0)
+	      CONSTR_add_H_product(a_index,a_index,-2.*(lP*P_kk[k]+lQ*Q_kk[k])/(a*a),dd,Hdd);           // a and a
+	    if (var_phi)
+	      CONSTR_add_H_product(a_index,phi_index,indicator_phi*(-lP*Q_km[k]+lQ*P_km[k])/a,dd,Hdd);   // a and phi
+	  }
+
+	  if (var_phi) // phi var
+	    CONSTR_add_H_product(phi_index,phi_index,lP*P_km[k]+lQ*Q_km[k],dd,Hdd);                     // phi and phi
+	}
+      }
+
+      // Buses
+      //******
+
+      for (k = 0; k < 2; k++) {
+
+	if (bus_counted[bus_index_t[k]])
+	  continue;
+	bus_counted[bus_index_t[k]] = TRUE;
+
+	// Multipliers
+	lP = lamd[P_index[k]];
+	lQ = lamd[Q_index[k]];
+
+	// Shunts
+	for (shunt = BUS_get_shunt(bus[k]); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+	  shunt_g = SHUNT_get_g(shunt);
+	  if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC))
+	    shunt_b = VEC_get(values,SHUNT_get_index_b(shunt,t));
+	  else
+	    shunt_b = SHUNT_get_b(shunt,t);
+	  if (var_v[k]) {
+	    CONSTR_add_H_product(v_index[k],v_index[k],-2.*lP*shunt_g+2.*lQ*shunt_b,dd,Hdd); // vk and vk
+	    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC))
+	      CONSTR_add_H_product(SHUNT_get_index_b(shunt,t),v_index[k],2.*lQ*v[k],dd,Hdd);  // b and vk
+	  }
+	}
+      }
+    }
+  }
+}
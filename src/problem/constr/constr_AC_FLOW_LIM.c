@@ -17,12 +17,16 @@ Constr* CONSTR_AC_FLOW_LIM_new(Net* net) {
   Constr* c = CONSTR_new(net);
   CONSTR_set_func_init(c, &CONSTR_AC_FLOW_LIM_init);
   CONSTR_set_func_count_step(c, &CONSTR_AC_FLOW_LIM_count_step);
+  CONSTR_set_func_count(c, &CONSTR_AC_FLOW_LIM_count);
   CONSTR_set_func_allocate(c, &CONSTR_AC_FLOW_LIM_allocate);
   CONSTR_set_func_clear(c, &CONSTR_AC_FLOW_LIM_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_AC_FLOW_LIM_analyze_step);
   CONSTR_set_func_eval_step(c, &CONSTR_AC_FLOW_LIM_eval_step);
+  CONSTR_set_func_eval_Hv(c, &CONSTR_AC_FLOW_LIM_eval_Hv);
   CONSTR_set_func_store_sens_step(c, &CONSTR_AC_FLOW_LIM_store_sens_step);
+  CONSTR_set_func_get_branch_loading(c, &CONSTR_AC_FLOW_LIM_get_branch_loading);
   CONSTR_set_func_free(c, &CONSTR_AC_FLOW_LIM_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -229,6 +233,13 @@ void CONSTR_AC_FLOW_LIM_count_step(Constr* c, Branch* br, int t) {
   }
 }
 
+void CONSTR_AC_FLOW_LIM_count(Constr* c) {
+  /** Sets the number of extra variables also when no
+   *  row is counted (e.g. empty active set).
+   */
+  CONSTR_set_num_extra_vars(c,CONSTR_get_J_row(c));
+}
+
 void CONSTR_AC_FLOW_LIM_allocate(Constr* c) {
   
   // Local variables
@@ -1001,6 +1012,196 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
   }  
 }
 
+void CONSTR_AC_FLOW_LIM_eval_Hv(Constr* c, Vec* values, Vec* values_extra, Vec* lam, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the linear combination of the Hessians
+   *  of the current magnitudes at values with coefficients lam and d.
+   *  With x the variables (wk,vk,wm,vm,a,phi) of a row, the product is
+   *  formed from the gradients of R and I and their Hessian-vector
+   *  products instead of from the entries of the Hessian of the row.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* bus[2];
+  REAL* lamd;
+  REAL* dd;
+  REAL* Hdd;
+  int index[6];
+  BOOL var[6];
+  REAL dx[6];
+  REAL dR[6];
+  REAL dI[6];
+  REAL HRd[6];
+  REAL HId[6];
+  REAL w[2];
+  REAL v[2];
+  REAL a;
+  REAL a_temp;
+  REAL phi;
+  REAL phi_temp;
+  REAL b;
+  REAL b_sh[2];
+  REAL g;
+  REAL g_sh[2];
+  REAL R;
+  REAL I;
+  REAL C;
+  REAL S;
+  REAL dtheta;
+  REAL dRd;
+  REAL dId;
+  REAL sqrterm;
+  REAL sqrterm3;
+  REAL indicator_a;
+  REAL indicator_phi;
+  int row;
+  int i;
+  int j;
+  int k;
+  int m;
+  int t;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  lamd = VEC_get_data(lam);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
+
+  row = 0;
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check active, outage and zero rating
+      if (!CONSTR_is_branch_active(c,br,t) ||
+	  BRANCH_is_on_outage(br) ||
+	  BRANCH_get_ratingA(br) == 0.)
+	continue;
+
+      // Bus data
+      bus[0] = BRANCH_get_bus_k(br);
+      bus[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++) {
+	if (BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG))
+	  w[k] = VEC_get(values,BUS_get_index_v_ang(bus[k],t));
+	else
+	  w[k] = BUS_get_v_ang(bus[k],t);
+	if (BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VMAG))
+	  v[k] = VEC_get(values,BUS_get_index_v_mag(bus[k],t));
+	else
+	  v[k] = BUS_get_v_mag(bus[k],t);
+      }
+
+      // Branch data
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO))
+	a = VEC_get(values,BRANCH_get_index_ratio(br,t));
+      else
+	a = BRANCH_get_ratio(br,t);
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE))
+	phi = VEC_get(values,BRANCH_get_index_phase(br,t));
+      else
+	phi = BRANCH_get_phase(br,t);
+      b = BRANCH_get_b(br);
+      b_sh[0] = BRANCH_get_b_k(br);
+      b_sh[1] = BRANCH_get_b_m(br);
+      g = BRANCH_get_g(br);
+      g_sh[0] = BRANCH_get_g_k(br);
+      g_sh[1] = BRANCH_get_g_m(br);
+
+      for (k = 0; k < 2; k++) {
+
+	if (k == 0) {
+	  m = 1;
+	  a_temp = a;
+	  phi_temp = phi;
+	  indicator_a = 1.;
+	  indicator_phi = 1.;
+	}
+	else {
+	  m = 0;
+	  a_temp = 1;
+	  phi_temp = -phi;
+	  indicator_a = 0.;
+	  indicator_phi = -1.;
+	}
+
+	// Variables (wk,vk,wm,vm,a,phi)
+	var[0] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG);
+	var[1] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VMAG);
+	var[2] = BUS_has_flags(bus[m],FLAG_VARS,BUS_VAR_VANG);
+	var[3] = BUS_has_flags(bus[m],FLAG_VARS,BUS_VAR_VMAG);
+	var[4] = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO);
+	var[5] = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE);
+	index[0] = BUS_get_index_v_ang(bus[k],t);
+	index[1] = BUS_get_index_v_mag(bus[k],t);
+	index[2] = BUS_get_index_v_ang(bus[m],t);
+	index[3] = BUS_get_index_v_mag(bus[m],t);
+	index[4] = BRANCH_get_index_ratio(br,t);
+	index[5] = BRANCH_get_index_phase(br,t);
+	for (j = 0; j < 6; j++)
+	  dx[j] = var[j] ? dd[index[j]] : 0.;
+
+	// |ikm| = |R + j I| with theta = -wk+wm+phi
+	C = g*cos(-w[k]+w[m]+phi_temp)-b*sin(-w[k]+w[m]+phi_temp);
+	S = g*sin(-w[k]+w[m]+phi_temp)+b*cos(-w[k]+w[m]+phi_temp);
+	R = a_temp*a_temp*(g_sh[k]+g)*v[k]-a*v[m]*C;
+	I = a_temp*a_temp*(b_sh[k]+b)*v[k]-a*v[m]*S;
+	sqrterm = sqrt(R*R+I*I+CONSTR_AC_FLOW_LIM_PARAM);
+	sqrterm3 = sqrterm*sqrterm*sqrterm;
+
+	// Gradients of R and I
+	dR[0] = -a*v[m]*S;
+	dR[1] = a_temp*a_temp*(g_sh[k]+g);
+	dR[2] = a*v[m]*S;
+	dR[3] = -a*C;
+	dR[4] = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*C;
+	dR[5] = indicator_phi*a*v[m]*S;
+	dI[0] = a*v[m]*C;
+	dI[1] = a_temp*a_temp*(b_sh[k]+b);
+	dI[2] = -a*v[m]*C;
+	dI[3] = -a*S;
+	dI[4] = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*S;
+	dI[5] = -indicator_phi*a*v[m]*C;
+
+	// Hessians of R and I times dx
+	dtheta = -dx[0]+dx[2]+indicator_phi*dx[5];
+	HRd[2] = a*v[m]*C*dtheta+a*S*dx[3]+v[m]*S*dx[4];
+	HRd[0] = -HRd[2];
+	HRd[5] = indicator_phi*HRd[2];
+	HRd[1] = indicator_a*2.*a_temp*(g_sh[k]+g)*dx[4];
+	HRd[3] = a*S*dtheta-C*dx[4];
+	HRd[4] = (v[m]*S*dtheta+indicator_a*2.*a_temp*(g_sh[k]+g)*dx[1]-C*dx[3]+
+		  indicator_a*2.*(g_sh[k]+g)*v[k]*dx[4]);
+	HId[2] = a*v[m]*S*dtheta-a*C*dx[3]-v[m]*C*dx[4];
+	HId[0] = -HId[2];
+	HId[5] = indicator_phi*HId[2];
+	HId[1] = indicator_a*2.*a_temp*(b_sh[k]+b)*dx[4];
+	HId[3] = -a*C*dtheta-S*dx[4];
+	HId[4] = (-v[m]*C*dtheta+indicator_a*2.*a_temp*(b_sh[k]+b)*dx[1]-S*dx[3]+
+		  indicator_a*2.*(b_sh[k]+b)*v[k]*dx[4]);
+
+	// Product
+	dRd = 0;
+	dId = 0;
+	for (j = 0; j < 6; j++) {
+	  dRd += dR[j]*dx[j];
+	  dId += dI[j]*dx[j];
+	}
+	for (j = 0; j < 6; j++) {
+	  if (var[j])
+	    Hdd[index[j]] += lamd[row]*(-(R*dR[j]+I*dI[j])*(R*dRd+I*dId)/sqrterm3+
+					(dR[j]*dRd+dI[j]*dId+R*HRd[j]+I*HId[j])/sqrterm);
+	}
+
+	// Constraint counter
+	row++;
+      }
+    }
+  }
+}
+
 void CONSTR_AC_FLOW_LIM_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 
   // Local variables
@@ -1039,6 +1240,25 @@ void CONSTR_AC_FLOW_LIM_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, V
   }
 }
 
+REAL CONSTR_AC_FLOW_LIM_get_branch_loading(Constr* c, Branch* br, int t, Vec* values) {
+  /** Largest current magnitude at the ends of the branch over
+   *  its rating (zero for branches without limits).
+   */
+
+  // Local variables
+  REAL i_km;
+  REAL i_mk;
+
+  // Check
+  if (BRANCH_is_on_outage(br) || BRANCH_get_ratingA(br) == 0.)
+    return 0.;
+
+  // Loading
+  i_km = BRANCH_get_i_km_mag(br,values,t,0.);
+  i_mk = BRANCH_get_i_mk_mag(br,values,t,0.);
+  return (i_km > i_mk ? i_km : i_mk)/BRANCH_get_ratingA(br);
+}
+
 void CONSTR_AC_FLOW_LIM_free(Constr* c) {
   // Nothing
 }
@@ -20,6 +20,7 @@ Constr* CONSTR_BAT_DYN_new(Net* net) {
   CONSTR_set_func_eval_step(c, &CONSTR_BAT_DYN_eval_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_BAT_DYN_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_BAT_DYN_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -17,9 +17,12 @@ Constr* CONSTR_DCPF_new(Net* net) {
   CONSTR_set_func_allocate(c, &CONSTR_DCPF_allocate);
   CONSTR_set_func_clear(c, &CONSTR_DCPF_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_DCPF_analyze_step);
+  CONSTR_set_func_analyze_data_step(c, &CONSTR_DCPF_analyze_data_step);
   CONSTR_set_func_eval_step(c, &CONSTR_DCPF_eval_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_DCPF_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_DCPF_free);
+  CONSTR_set_periodic_structure(c, TRUE);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -398,6 +401,112 @@ void CONSTR_DCPF_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
+void CONSTR_DCPF_analyze_data_step(Constr* c, Branch* br, int t) {
+  /** Stores the right-hand side of periods after the first,
+   *  whose structure is copied from the first period.
+   */
+
+  // Local variables
+  Bus* bus[2];
+  Gen* gen;
+  Vargen* vargen;
+  Load* load;
+  Bat* bat;
+  Vec* rhs;
+  char* bus_counted;
+  int bus_index_t[2];
+  REAL b;
+  REAL sign_phi;
+  int k;
+  int m;
+  int num_buses;
+
+  // Number of buses
+  num_buses = NET_get_num_buses(CONSTR_get_network(c));
+
+  // Constr data
+  rhs = CONSTR_get_b(c);
+  bus_counted = CONSTR_get_bus_counted(c);
+
+  // Check pointers
+  if (!rhs || !bus_counted)
+    return;
+
+  // Check outage
+  if (BRANCH_is_on_outage(br))
+    return;
+
+  // Bus data
+  bus[0] = BRANCH_get_bus_k(br);
+  bus[1] = BRANCH_get_bus_m(br);
+  for (k = 0; k < 2; k++) {
+    bus_index_t[k] = BUS_get_index(bus[k])+t*num_buses;
+  }
+
+  // Branch data
+  b = BRANCH_get_b(br);
+
+  // Branch
+  //*******
+
+  for (k = 0; k < 2; k++) {
+
+    if (k == 0) {
+      m = 1;
+      sign_phi = 1;
+    }
+    else {
+      m = 0;
+      sign_phi = -1;
+    }
+
+    if (!BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG))
+      VEC_add_to_entry(rhs,bus_index_t[k],-b*BUS_get_v_ang(bus[k],t));
+
+    if (!BUS_has_flags(bus[m],FLAG_VARS,BUS_VAR_VANG))
+      VEC_add_to_entry(rhs,bus_index_t[k],b*BUS_get_v_ang(bus[m],t));
+
+    if (!BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE))
+      VEC_add_to_entry(rhs,bus_index_t[k],b*BRANCH_get_phase(br,t)*sign_phi);
+  }
+
+  // Buses
+  //******
+
+  for (k = 0; k < 2; k++) {
+
+    if (!bus_counted[bus_index_t[k]]) {
+
+      // Generators
+      for (gen = BUS_get_gen(bus[k]); gen != NULL; gen = GEN_get_next(gen)) {
+	if (!GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+	  VEC_add_to_entry(rhs,bus_index_t[k],-GEN_get_P(gen,t));
+      }
+
+      // Loads
+      for (load = BUS_get_load(bus[k]); load != NULL; load = LOAD_get_next(load)) {
+	if (!LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
+	  VEC_add_to_entry(rhs,bus_index_t[k],LOAD_get_P(load,t));
+      }
+
+      // Variable generators
+      for (vargen = BUS_get_vargen(bus[k]); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
+	if (!VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
+	  VEC_add_to_entry(rhs,bus_index_t[k],-VARGEN_get_P(vargen,t));
+      }
+
+      // Batteries
+      for (bat = BUS_get_bat(bus[k]); bat != NULL; bat = BAT_get_next(bat)) {
+	if (!BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P))
+	  VEC_add_to_entry(rhs,bus_index_t[k],BAT_get_P(bat,t));
+      }
+    }
+
+    // Update counted flag
+    bus_counted[bus_index_t[k]] = TRUE;
+  }
+}
+
 void CONSTR_DCPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
   // Nothing
 }
@@ -17,9 +17,13 @@ Constr* CONSTR_DC_FLOW_LIM_new(Net* net) {
   CONSTR_set_func_allocate(c, &CONSTR_DC_FLOW_LIM_allocate);
   CONSTR_set_func_clear(c, &CONSTR_DC_FLOW_LIM_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_DC_FLOW_LIM_analyze_step);
+  CONSTR_set_func_analyze_data_step(c, &CONSTR_DC_FLOW_LIM_analyze_data_step);
   CONSTR_set_func_eval_step(c, &CONSTR_DC_FLOW_LIM_eval_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_DC_FLOW_LIM_store_sens_step);
+  CONSTR_set_func_get_branch_loading(c, &CONSTR_DC_FLOW_LIM_get_branch_loading);
   CONSTR_set_func_free(c, &CONSTR_DC_FLOW_LIM_free);
+  CONSTR_set_periodic_structure(c, TRUE);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -205,6 +209,65 @@ void CONSTR_DC_FLOW_LIM_analyze_step(Constr* c, Branch* br, int t) {
   (*G_row)++;
 }
 
+void CONSTR_DC_FLOW_LIM_analyze_data_step(Constr* c, Branch* br, int t) {
+  /** Stores the limits of periods after the first,
+   *  whose structure is copied from the first period.
+   */
+
+  // Local variables
+  Bus* bus[2];
+  Vec* l;
+  Vec* u;
+  int* G_row;
+  REAL b;
+  double rating;
+
+  // Constr data
+  l = CONSTR_get_l(c);
+  u = CONSTR_get_u(c);
+  G_row = CONSTR_get_G_row_ptr(c);
+
+  // Check pointer
+  if (!G_row)
+    return;
+
+  // Check outage
+  if (BRANCH_is_on_outage(br))
+    return;
+
+  // Zero limits
+  if (BRANCH_get_ratingA(br) == 0.)
+    return;
+
+  bus[0] = BRANCH_get_bus_k(br);
+  bus[1] = BRANCH_get_bus_m(br);
+
+  b = BRANCH_get_b(br);
+
+  rating = BRANCH_get_ratingA(br); // p.u.
+
+  VEC_set(l,*G_row,-rating); // p.u.
+  VEC_set(u,*G_row,rating);  // p.u.
+
+  if (!BUS_has_flags(bus[0],FLAG_VARS,BUS_VAR_VANG)) {
+    VEC_add_to_entry(l,*G_row,b*BUS_get_v_ang(bus[0],t));
+    VEC_add_to_entry(u,*G_row,b*BUS_get_v_ang(bus[0],t));
+  }
+
+  if (!BUS_has_flags(bus[1],FLAG_VARS,BUS_VAR_VANG)) {
+    VEC_add_to_entry(l,*G_row,-b*BUS_get_v_ang(bus[1],t));
+    VEC_add_to_entry(u,*G_row,-b*BUS_get_v_ang(bus[1],t));
+  }
+
+  if (!BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE)) {
+    VEC_add_to_entry(l,*G_row,-b*BRANCH_get_phase(br,t));
+    VEC_add_to_entry(u,*G_row,-b*BRANCH_get_phase(br,t));
+  }
+
+  // Constraint index
+  (*G_row)++;
+}
+
 void CONSTR_DC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
   // Nothing
 }
@@ -237,6 +300,39 @@ void CONSTR_DC_FLOW_LIM_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, V
   (*G_row)++;
 }
 
+REAL CONSTR_DC_FLOW_LIM_get_branch_loading(Constr* c, Branch* br, int t, Vec* values) {
+  /** Magnitude of the DC power flow of the branch over
+   *  its rating (zero for branches without limits).
+   */
+
+  // Local variables
+  Bus* bus[2];
+  REAL w[2];
+  REAL phi;
+  int k;
+
+  // Check
+  if (BRANCH_is_on_outage(br) || BRANCH_get_ratingA(br) == 0.)
+    return 0.;
+
+  // Angles
+  bus[0] = BRANCH_get_bus_k(br);
+  bus[1] = BRANCH_get_bus_m(br);
+  for (k = 0; k < 2; k++) {
+    if (values && BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG))
+      w[k] = VEC_get(values,BUS_get_index_v_ang(bus[k],t));
+    else
+      w[k] = BUS_get_v_ang(bus[k],t);
+  }
+  if (values && BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE))
+    phi = VEC_get(values,BRANCH_get_index_phase(br,t));
+  else
+    phi = BRANCH_get_phase(br,t);
+
+  // Loading
+  return fabs(BRANCH_get_b(br)*(w[0]-w[1]-phi))/BRANCH_get_ratingA(br);
+}
+
 void CONSTR_DC_FLOW_LIM_free(Constr* c) {
   // Nothing
 }
@@ -20,6 +20,7 @@ Constr* CONSTR_GEN_RAMP_new(Net* net) {
   CONSTR_set_func_eval_step(c, &CONSTR_GEN_RAMP_eval_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_GEN_RAMP_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_GEN_RAMP_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -10,6 +10,12 @@
 
 #include <pfnet/constr_LBOUND.h>
 
+struct Constr_LBOUND_Data {
+
+  // Mode
+  BOOL simple; /**< @brief Flag for emitting bounds as vectors instead of rows of G */
+};
+
 Constr* CONSTR_LBOUND_new(Net* net) {
   Constr* c = CONSTR_new(net);
   CONSTR_set_func_init(c,&CONSTR_LBOUND_init);
@@ -17,18 +23,23 @@ Constr* CONSTR_LBOUND_new(Net* net) {
   CONSTR_set_func_allocate(c,&CONSTR_LBOUND_allocate);
   CONSTR_set_func_clear(c,&CONSTR_LBOUND_clear);
   CONSTR_set_func_analyze_step(c,&CONSTR_LBOUND_analyze_step);
-  CONSTR_set_func_eval_step(c,&CONSTR_LBOUND_eval_step);
   CONSTR_set_func_store_sens_step(c,&CONSTR_LBOUND_store_sens_step);
   CONSTR_set_func_free(c,&CONSTR_LBOUND_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
 
 void CONSTR_LBOUND_init(Constr* c) {
 
+  // Local variables
+  Constr_LBOUND_Data* data;
+
   // Init
+  data = (Constr_LBOUND_Data*)malloc(sizeof(Constr_LBOUND_Data));
+  data->simple = FALSE;
   CONSTR_set_name(c,"variable bounds");
-  CONSTR_set_data(c,NULL);
+  CONSTR_set_data(c,(void*)data);
 }
 
 void CONSTR_LBOUND_clear(Constr* c) {
@@ -49,8 +60,10 @@ void CONSTR_LBOUND_allocate(Constr *c) {
 
   // Local variables
   int num_vars;
+  int num_rows;
 
   num_vars = NET_get_num_vars(CONSTR_get_network(c));
+  num_rows = CONSTR_LBOUND_has_simple_bounds(c) ? 0 : num_vars;
   
   // J f
   CONSTR_set_J(c,MAT_new(0,num_vars,0));
@@ -61,11 +74,11 @@ void CONSTR_LBOUND_allocate(Constr *c) {
   CONSTR_set_b(c,VEC_new(0));
 
   // l u G
-  CONSTR_set_l(c,VEC_new(num_vars));
-  CONSTR_set_u(c,VEC_new(num_vars));
-  CONSTR_set_G(c,MAT_new(num_vars,   // size1 (rows)
+  CONSTR_set_l(c,VEC_new(num_rows));
+  CONSTR_set_u(c,VEC_new(num_rows));
+  CONSTR_set_G(c,MAT_new(num_rows,   // size1 (rows)
 			 num_vars,   // size2 (cols)
-			 num_vars)); // nnz
+			 num_rows)); // nnz
 }
 
 void CONSTR_LBOUND_analyze_step(Constr* c, Branch* br, int t) {
@@ -101,6 +114,10 @@ void CONSTR_LBOUND_analyze_step(Constr* c, Branch* br, int t) {
   if (!bus_counted)
     return;
 
+  // Check mode
+  if (CONSTR_LBOUND_has_simple_bounds(c))
+    return;
+
   // Check outage
   if (BRANCH_is_on_outage(br))
     return;
@@ -464,10 +481,6 @@ void CONSTR_LBOUND_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_LBOUND_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
-  // Nothing to do
-}
-
 void CONSTR_LBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 
   // Local variables
@@ -490,6 +503,10 @@ void CONSTR_LBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* s
   if (!bus_counted)
     return;
 
+  // Check mode
+  if (CONSTR_LBOUND_has_simple_bounds(c))
+    return;
+
   // Check outage
   if (BRANCH_is_on_outage(br))
     return;
@@ -576,5 +593,271 @@ void CONSTR_LBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* s
 }
 
 void CONSTR_LBOUND_free(Constr* c) {
-  // Nothing to do
+
+  // Local variables
+  Constr_LBOUND_Data* data;
+
+  // Get data
+  data = (Constr_LBOUND_Data*)CONSTR_get_data(c);
+
+  // Free
+  if (data)
+    free(data);
+
+  // Set data
+  CONSTR_set_data(c,NULL);
+}
+
+BOOL CONSTR_LBOUND_has_simple_bounds(Constr* c) {
+  Constr_LBOUND_Data* data = (Constr_LBOUND_Data*)CONSTR_get_data(c);
+  if (data)
+    return data->simple;
+  else
+    return FALSE;
+}
+
+void CONSTR_LBOUND_set_simple_bounds(Constr* c, BOOL flag) {
+  /** Sets flag for emitting bounds as dense vectors (see CONSTR_LBOUND_get_bounds)
+   *  instead of as rows of G. Takes effect the next time the constraint is analyzed.
+   */
+  Constr_LBOUND_Data* data = (Constr_LBOUND_Data*)CONSTR_get_data(c);
+  if (data)
+    data->simple = flag;
+}
+
+void CONSTR_LBOUND_get_bounds(Constr* c, Vec* l, Vec* u) {
+  /** Fills the first num_vars entries of l and u with the bounds
+   *  of the network variables in one pass over the component arrays.
+   *  Values are the same as the ones of the rows of G in the default mode.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* bus;
+  Gen* gen;
+  Load* load;
+  Vargen* vargen;
+  Shunt* shunt;
+  Bat* bat;
+  REAL* ld;
+  REAL* ud;
+  int index;
+  int i;
+  int t;
+  int T;
+
+  // Check
+  net = CONSTR_get_network(c);
+  if (!net || VEC_get_size(l) < NET_get_num_vars(net) || VEC_get_size(u) < NET_get_num_vars(net))
+    return;
+
+  // Data
+  ld = VEC_get_data(l);
+  ud = VEC_get_data(u);
+  T = NET_get_num_periods(net);
+
+  // Branches
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    br = NET_get_branch(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Tap ratio
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO)) {
+	index = BRANCH_get_index_ratio(br,t);
+	if (BRANCH_has_flags(br,FLAG_BOUNDED,BRANCH_VAR_RATIO)) {
+	  ud[index] = BRANCH_get_ratio_max(br);
+	  ld[index] = BRANCH_get_ratio_min(br);
+	}
+	else {
+	  ud[index] = BRANCH_INF_RATIO;
+	  ld[index] = 0.;
+	}
+      }
+
+      // Phase shift
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE)) {
+	index = BRANCH_get_index_phase(br,t);
+	if (BRANCH_has_flags(br,FLAG_BOUNDED,BRANCH_VAR_PHASE)) {
+	  ud[index] = BRANCH_get_phase_max(br);
+	  ld[index] = BRANCH_get_phase_min(br);
+	}
+	else {
+	  ud[index] = 2*PI;
+	  ld[index] = -2*PI;
+	}
+      }
+    }
+  }
+
+  // Buses
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Voltage magnitude (V_MAG)
+      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
+	index = BUS_get_index_v_mag(bus,t);
+	if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VMAG)) {
+	  ud[index] = BUS_get_v_max_norm(bus);
+	  ld[index] = BUS_get_v_min_norm(bus);
+	}
+	else {
+	  ud[index] = BUS_INF_V_MAG;
+	  ld[index] = 0.;
+	}
+      }
+
+      // Voltage angle (V_ANG)
+      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) {
+	index = BUS_get_index_v_ang(bus,t);
+	ud[index] = BUS_INF_V_ANG;
+	ld[index] = -BUS_INF_V_ANG;
+      }
+    }
+  }
+
+  // Generators
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Active power (P)
+      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
+	index = GEN_get_index_P(gen,t);
+	if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_P)) {
+	  ud[index] = GEN_get_P_max(gen);
+	  ld[index] = GEN_get_P_min(gen);
+	}
+	else {
+	  ud[index] = GEN_INF_P;
+	  ld[index] = -GEN_INF_P;
+	}
+      }
+
+      // Reactive power (Q)
+      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) {
+	index = GEN_get_index_Q(gen,t);
+	if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_Q)) {
+	  ud[index] = GEN_get_Q_max(gen);
+	  ld[index] = GEN_get_Q_min(gen);
+	}
+	else {
+	  ud[index] = GEN_INF_Q;
+	  ld[index] = -GEN_INF_Q;
+	}
+      }
+    }
+  }
+
+  // Loads
+  for (i = 0; i < NET_get_num_loads(net); i++) {
+    load = NET_get_load(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Active power (P)
+      if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P)) {
+	index = LOAD_get_index_P(load,t);
+	if (LOAD_has_flags(load,FLAG_BOUNDED,LOAD_VAR_P)) {
+	  ud[index] = LOAD_get_P_max(load,t);
+	  ld[index] = LOAD_get_P_min(load,t);
+	}
+	else {
+	  ud[index] = LOAD_INF_P;
+	  ld[index] = -LOAD_INF_P;
+	}
+      }
+
+      // Reactive power (Q)
+      if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q)) {
+	index = LOAD_get_index_Q(load,t);
+	ud[index] = LOAD_INF_Q;
+	ld[index] = -LOAD_INF_Q;
+      }
+    }
+  }
+
+  // Variable generators
+  for (i = 0; i < NET_get_num_vargens(net); i++) {
+    vargen = NET_get_vargen(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Active power (P)
+      if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P)) {
+	index = VARGEN_get_index_P(vargen,t);
+	if (VARGEN_has_flags(vargen,FLAG_BOUNDED,VARGEN_VAR_P)) {
+	  ud[index] = VARGEN_get_P_ava(vargen,t);
+	  ld[index] = VARGEN_get_P_min(vargen);
+	}
+	else {
+	  ud[index] = VARGEN_INF_P;
+	  ld[index] = -VARGEN_INF_P;
+	}
+      }
+
+      // Reactive power (Q)
+      if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q)) {
+	index = VARGEN_get_index_Q(vargen,t);
+	if (VARGEN_has_flags(vargen,FLAG_BOUNDED,VARGEN_VAR_Q)) {
+	  ud[index] = VARGEN_get_Q_max(vargen);
+	  ld[index] = VARGEN_get_Q_min(vargen);
+	}
+	else {
+	  ud[index] = VARGEN_INF_Q;
+	  ld[index] = -VARGEN_INF_Q;
+	}
+      }
+    }
+  }
+
+  // Shunts
+  for (i = 0; i < NET_get_num_shunts(net); i++) {
+    shunt = NET_get_shunt(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Susceptance (b)
+      if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
+	index = SHUNT_get_index_b(shunt,t);
+	if (SHUNT_has_flags(shunt,FLAG_BOUNDED,SHUNT_VAR_SUSC)) {
+	  ud[index] = SHUNT_get_b_max(shunt);
+	  ld[index] = SHUNT_get_b_min(shunt);
+	}
+	else {
+	  ud[index] = SHUNT_INF_SUSC;
+	  ld[index] = -SHUNT_INF_SUSC;
+	}
+      }
+    }
+  }
+
+  // Batteries
+  for (i = 0; i < NET_get_num_bats(net); i++) {
+    bat = NET_get_bat(net,i);
+    for (t = 0; t < T; t++) {
+
+      // Charging/discharging power (P)
+      if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {
+	if (BAT_has_flags(bat,FLAG_BOUNDED,BAT_VAR_P)) {
+	  ud[BAT_get_index_Pc(bat,t)] = BAT_get_P_max(bat);
+	  ud[BAT_get_index_Pd(bat,t)] = -BAT_get_P_min(bat);
+	}
+	else {
+	  ud[BAT_get_index_Pc(bat,t)] = BAT_INF_P;
+	  ud[BAT_get_index_Pd(bat,t)] = BAT_INF_P;
+	}
+	ld[BAT_get_index_Pc(bat,t)] = 0.;
+	ld[BAT_get_index_Pd(bat,t)] = 0.;
+      }
+
+      // Energy level (E)
+      if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_E)) {
+	index = BAT_get_index_E(bat,t);
+	if (BAT_has_flags(bat,FLAG_BOUNDED,BAT_VAR_E))
+	  ud[index] = BAT_get_E_max(bat);
+	else
+	  ud[index] = BAT_INF_E;
+	ld[index] = 0.;
+      }
+    }
+  }
 }
@@ -17,9 +17,9 @@ Constr* CONSTR_LOAD_PF_new(Net* net) {
   CONSTR_set_func_allocate(c,&CONSTR_LOAD_PF_allocate);
   CONSTR_set_func_clear(c,&CONSTR_LOAD_PF_clear);
   CONSTR_set_func_analyze_step(c,&CONSTR_LOAD_PF_analyze_step);
-  CONSTR_set_func_eval_step(c,&CONSTR_LOAD_PF_eval_step);
   CONSTR_set_func_store_sens_step(c,&CONSTR_LOAD_PF_store_sens_step);
   CONSTR_set_func_free(c,&CONSTR_LOAD_PF_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -208,10 +208,6 @@ void CONSTR_LOAD_PF_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_LOAD_PF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
-  // Nothing to do
-}
-
 void CONSTR_LOAD_PF_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
   // Nothing for now
 }
@@ -18,8 +18,10 @@ Constr* CONSTR_NBOUND_new(Net* net) {
   CONSTR_set_func_clear(c, &CONSTR_NBOUND_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_NBOUND_analyze_step);
   CONSTR_set_func_eval_step(c, &CONSTR_NBOUND_eval_step);
+  CONSTR_set_func_eval_Hv(c, &CONSTR_NBOUND_eval_Hv);
   CONSTR_set_func_store_sens_step(c, &CONSTR_NBOUND_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_NBOUND_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -757,6 +759,161 @@ void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* val
   }
 }
 
+void CONSTR_NBOUND_add_Hv_rows(int index, REAL umax, REAL umin, int* row, REAL* values, REAL* lam, REAL* d, REAL* Hd) {
+  /** Adds to Hd the products of the Hessians of the upper and lower
+   *  bound rows of the variable with the given index and d, weighted
+   *  by lam, and moves the row counter past both rows.
+   */
+
+  // Local variables
+  REAL eps = CONSTR_NBOUND_PARAM;
+  REAL du;
+  REAL a1;
+  REAL a2;
+  REAL b;
+  REAL sqrterm1;
+  REAL sqrterm2;
+
+  // Terms
+  du = (umax-umin > eps) ? umax-umin : eps;
+  a1 = umax-values[index];
+  a2 = values[index]-umin;
+  b = eps*eps/du;
+  sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
+  sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
+
+  // Product
+  Hd[index] -= lam[*row]*(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1)*d[index];   // upper
+  Hd[index] -= lam[*row+1]*(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2)*d[index]; // lower
+  (*row) += 2;
+}
+
+void CONSTR_NBOUND_eval_Hv(Constr* c, Vec* values, Vec* values_extra, Vec* lam, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the linear combination of the (diagonal)
+   *  Hessians of the rows at values with coefficients lam and d.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* buses[2];
+  Bus* bus;
+  Gen* gen;
+  Shunt* shunt;
+  char* bus_counted;
+  REAL* x;
+  REAL* lamd;
+  REAL* dd;
+  REAL* Hdd;
+  int bus_index_t[2];
+  int row;
+  int T;
+  int i;
+  int k;
+  int t;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  T = NET_get_num_periods(net);
+  bus_counted = CONSTR_get_bus_counted(c);
+  x = VEC_get_data(values);
+  lamd = VEC_get_data(lam);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
+
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  CONSTR_clear_bus_counted(c);
+
+  row = 0;
+  for (t = 0; t < T; t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
+
+      // Bus data
+      buses[0] = BRANCH_get_bus_k(br);
+      buses[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++)
+	bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+
+      // Branch
+      //*******
+
+      // Tap ratio
+      if (BRANCH_has_flags(br,FLAG_BOUNDED,BRANCH_VAR_RATIO) &&
+	  BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO))
+	CONSTR_NBOUND_add_Hv_rows(BRANCH_get_index_ratio(br,t),BRANCH_get_ratio_max(br),BRANCH_get_ratio_min(br),
+				  &row,x,lamd,dd,Hdd);
+
+      // Phase shift
+      if (BRANCH_has_flags(br,FLAG_BOUNDED,BRANCH_VAR_PHASE) &&
+	  BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE))
+	CONSTR_NBOUND_add_Hv_rows(BRANCH_get_index_phase(br,t),BRANCH_get_phase_max(br),BRANCH_get_phase_min(br),
+				  &row,x,lamd,dd,Hdd);
+
+      // Buses
+      //******
+
+      for (k = 0; k < 2; k++) {
+
+	bus = buses[k];
+
+	if (!bus_counted[bus_index_t[k]]) { // not counted yet
+
+	  // Voltage magnitude (V_MAG)
+	  if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VMAG) &&
+	      BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG))
+	    CONSTR_NBOUND_add_Hv_rows(BUS_get_index_v_mag(bus,t),BUS_get_v_max_norm(bus),BUS_get_v_min_norm(bus),
+				      &row,x,lamd,dd,Hdd);
+
+	  // Volage angle (V_ANG)
+	  if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VANG) &&
+	      BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG))
+	    CONSTR_NBOUND_add_Hv_rows(BUS_get_index_v_ang(bus,t),2*PI,-2*PI,
+				      &row,x,lamd,dd,Hdd);
+
+	  // Generators
+	  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+
+	    // Active power (P)
+	    if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_P) &&
+		GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+	      CONSTR_NBOUND_add_Hv_rows(GEN_get_index_P(gen,t),GEN_get_P_max(gen),GEN_get_P_min(gen),
+					&row,x,lamd,dd,Hdd);
+
+	    // Reactive power (Q)
+	    if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_Q) &&
+		GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q))
+	      CONSTR_NBOUND_add_Hv_rows(GEN_get_index_Q(gen,t),GEN_get_Q_max(gen),GEN_get_Q_min(gen),
+					&row,x,lamd,dd,Hdd);
+	  }
+
+	  // Shunts
+	  for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+
+	    // Susceptance
+	    if (SHUNT_has_flags(shunt,FLAG_BOUNDED,SHUNT_VAR_SUSC) &&
+		SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC))
+	      CONSTR_NBOUND_add_Hv_rows(SHUNT_get_index_b(shunt,t),SHUNT_get_b_max(shunt),SHUNT_get_b_min(shunt),
+					&row,x,lamd,dd,Hdd);
+	  }
+	}
+
+	// Update counted flag
+	bus_counted[bus_index_t[k]] = TRUE;
+      }
+    }
+  }
+}
+
 void CONSTR_NBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 
   // Local variables
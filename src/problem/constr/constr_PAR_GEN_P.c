@@ -17,9 +17,9 @@ Constr* CONSTR_PAR_GEN_P_new(Net* net) {
   CONSTR_set_func_allocate(c, &CONSTR_PAR_GEN_P_allocate);
   CONSTR_set_func_clear(c, &CONSTR_PAR_GEN_P_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_PAR_GEN_P_analyze_step);
-  CONSTR_set_func_eval_step(c, &CONSTR_PAR_GEN_P_eval_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_PAR_GEN_P_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_PAR_GEN_P_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -203,10 +203,6 @@ void CONSTR_PAR_GEN_P_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_PAR_GEN_P_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
-  // Nothing to do
-}
-
 void CONSTR_PAR_GEN_P_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
   // Nothing
 }
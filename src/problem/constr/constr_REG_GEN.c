@@ -18,8 +18,10 @@ Constr* CONSTR_REG_GEN_new(Net* net) {
   CONSTR_set_func_clear(c,&CONSTR_REG_GEN_clear);
   CONSTR_set_func_analyze_step(c,&CONSTR_REG_GEN_analyze_step);
   CONSTR_set_func_eval_step(c,&CONSTR_REG_GEN_eval_step);
+  CONSTR_set_func_eval_Hv(c,&CONSTR_REG_GEN_eval_Hv);
   CONSTR_set_func_store_sens_step(c,&CONSTR_REG_GEN_store_sens_step);
   CONSTR_set_func_free(c,&CONSTR_REG_GEN_free);
+  CONSTR_set_island_safe(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -595,6 +597,144 @@ void CONSTR_REG_GEN_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* va
   }
 }
 
+void CONSTR_REG_GEN_eval_Hv(Constr* c, Vec* values, Vec* values_extra, Vec* lam, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the linear combination of the Hessians
+   *  of the complementarity rows at values with coefficients lam and d.
+   *  The reactive powers of a bus enter only through their sum, so each
+   *  row needs the sum of their directions and not all pairs.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* buses[2];
+  Bus* bus;
+  Gen* rg;
+  char* bus_counted;
+  REAL* lamd;
+  REAL* dd;
+  REAL* Hdd;
+  int bus_index_t[2];
+  int num_vars;
+  int row;
+  int T;
+  int i;
+  int k;
+  REAL y;
+  REAL z;
+  REAL dy;
+  REAL dz;
+  REAL dQ;
+  REAL Qsum;
+  REAL Qmin;
+  REAL Qmax;
+  REAL Qy;
+  REAL Qz;
+  REAL sqrt_termY;
+  REAL sqrt_termZ;
+  REAL HQy;
+  REAL HQz;
+  int t;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  T = NET_get_num_periods(net);
+  num_vars = NET_get_num_vars(net);
+  bus_counted = CONSTR_get_bus_counted(c);
+  lamd = VEC_get_data(lam);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
+
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  CONSTR_clear_bus_counted(c);
+
+  row = 0;
+  for (t = 0; t < T; t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
+
+      // Bus data
+      buses[0] = BRANCH_get_bus_k(br);
+      buses[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++)
+	bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+
+      for (k = 0; k < 2; k++) {
+
+	bus = buses[k];
+
+	if (!bus_counted[bus_index_t[k]] && BUS_is_regulated_by_gen(bus) && !BUS_is_slack(bus)) {
+
+	  // Extra vars
+	  if (VEC_get_size(values_extra) > 0) {
+	    y = VEC_get(values_extra,row);
+	    z = VEC_get(values_extra,row+1);
+	    dy = dd[num_vars+row];
+	    dz = dd[num_vars+row+1];
+	  }
+	  else {
+	    y = 0.;
+	    z = 0.;
+	    dy = 0.;
+	    dz = 0.;
+	  }
+
+	  // Q value and direction
+	  Qsum = 0;
+	  Qmax = 0;
+	  Qmin = 0;
+	  dQ = 0;
+	  for (rg = BUS_get_reg_gen(bus); rg != NULL; rg = GEN_get_reg_next(rg)) {
+	    if (GEN_has_flags(rg,FLAG_VARS,GEN_VAR_Q)) {
+	      Qsum += VEC_get(values,GEN_get_index_Q(rg,t)); // p.u.
+	      dQ += dd[GEN_get_index_Q(rg,t)];
+	    }
+	    else
+	      Qsum += GEN_get_Q(rg,t); // p.u.
+	    Qmax += GEN_get_Q_max(rg); // p.u.
+	    Qmin += GEN_get_Q_min(rg); // p.u.
+	  }
+	  Qy = (Qsum-Qmin);
+	  Qz = (Qmax-Qsum);
+
+	  // Terms
+	  sqrt_termY = sqrt( Qy*Qy + y*y + 2*CONSTR_REG_GEN_PARAM );
+	  sqrt_termZ = sqrt( Qz*Qz + z*z + 2*CONSTR_REG_GEN_PARAM );
+
+	  // y and z
+	  if (VEC_get_size(values_extra) > 0) {
+	    Hdd[num_vars+row] += lamd[row]*(-(Qy*Qy+2*CONSTR_REG_GEN_PARAM)*dy+Qy*y*dQ)/pow(sqrt_termY,3.);     // CompY
+	    Hdd[num_vars+row+1] += lamd[row+1]*(-(Qz*Qz+2*CONSTR_REG_GEN_PARAM)*dz-Qz*z*dQ)/pow(sqrt_termZ,3.); // CompZ
+	  }
+
+	  // Q
+	  HQy = lamd[row]*(-(y*y+2*CONSTR_REG_GEN_PARAM)*dQ+Qy*y*dy)/pow(sqrt_termY,3.);      // CompY
+	  HQz = lamd[row+1]*(-(z*z+2*CONSTR_REG_GEN_PARAM)*dQ-Qz*z*dz)/pow(sqrt_termZ,3.);   // CompZ
+	  for (rg = BUS_get_reg_gen(bus); rg != NULL; rg = GEN_get_reg_next(rg)) {
+	    if (GEN_has_flags(rg,FLAG_VARS,GEN_VAR_Q))
+	      Hdd[GEN_get_index_Q(rg,t)] += HQy+HQz;
+	  }
+
+	  // Count
+	  row += 2;
+	}
+
+	// Update counted flag
+	bus_counted[bus_index_t[k]] = TRUE;
+      }
+    }
+  }
+}
+
 void CONSTR_REG_GEN_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 
   // Local variables
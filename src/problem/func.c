@@ -39,6 +39,8 @@ struct Func {
   int Hphi_nnz;         /**< @brief Counter of number of nonzero elements of the Hessian matrix */
   char* bus_counted;    /**< @brief Flags for processing buses */
   int bus_counted_size; /**< @brief Size of array of flags for processing buses */
+  BOOL island_safe;     /**< @brief Flag for steps that only write data of the island of the branch besides the counter */
+  BOOL view;            /**< @brief Flag for views that share the data of another function */
   
   // Functions
   void (*func_init)(Func* f);                                    /**< @brief Initialization function */
@@ -47,8 +49,15 @@ struct Func {
   void (*func_clear)(Func* f);                                   /**< @brief Function for clearing flags, counters, and function values */
   void (*func_analyze_step)(Func* f, Branch* br, int t);         /**< @brief Function for analyzing sparsity pattern */
   void (*func_eval_step)(Func* f, Branch* br, int t, Vec* v);    /**< @brief Function for evaluating function */
+  void (*func_eval_period)(Func* f, int t, Vec* v);              /**< @brief Function for evaluating function over components of a time period */
   void (*func_free)(Func* f);                                    /**< @brief Function for de-allocating any data used */
 
+  // Batch functions (called once per pass after the steps)
+  void (*func_count)(Func* f);                                   /**< @brief Function for counting nonzero entries */
+  void (*func_analyze)(Func* f);                                 /**< @brief Function for analyzing sparsity pattern */
+  void (*func_eval)(Func* f, Vec* v);                            /**< @brief Function for evaluating function */
+  void (*func_eval_Hv)(Func* f, Vec* v, Vec* d, Vec* Hd);        /**< @brief Function for adding Hessian-vector product without forming Hphi */
+
   // Custom data
   void* data;  /**< @brief Type-dependent function data */
 
@@ -74,6 +83,12 @@ void FUNC_del_matvec(Func* f) {
 
 void FUNC_del(Func* f) {
   if (f) {
+
+    // View
+    if (f->view) {
+      free(f);
+      return;
+    }
     
     // Mat and vec
     FUNC_del_matvec(f);
@@ -223,6 +238,12 @@ void FUNC_list_del(Func* flist) {
   LIST_map(Func,flist,f,next,{FUNC_del(f);});
 }
 
+void FUNC_list_count_batch(Func* flist) {
+  Func* ff;
+  for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
+    FUNC_count_batch(ff);
+}
+
 void FUNC_list_count_step(Func* flist, Branch* br, int t) {
   Func* ff;
   for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
@@ -241,12 +262,30 @@ void FUNC_list_clear(Func* flist) {
     FUNC_clear(ff);
 }
 
+void FUNC_list_analyze_batch(Func* flist) {
+  Func* ff;
+  for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
+    FUNC_analyze_batch(ff);
+}
+
 void FUNC_list_analyze_step(Func* flist, Branch* br, int t) {
   Func* ff;
   for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
     FUNC_analyze_step(ff,br,t);
 }
 
+void FUNC_list_eval_batch(Func* flist, Vec* values) {
+  Func* ff;
+  for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
+    FUNC_eval_batch(ff,values);
+}
+
+void FUNC_list_eval_period(Func* flist, int t, Vec* values) {
+  Func* ff;
+  for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
+    FUNC_eval_period(ff,t,values);
+}
+
 void FUNC_list_eval_step(Func* flist, Branch* br, int t, Vec* values) {
   Func* ff;
   for (ff = flist; ff != NULL; ff = FUNC_get_next(ff))
@@ -284,6 +323,10 @@ Func* FUNC_new(REAL weight, Net* net) {
   // Bus counted
   f->bus_counted_size = 0;
   f->bus_counted = NULL;
+
+  // Flags
+  f->island_safe = FALSE;
+  f->view = FALSE;
   
   // Methods
   f->func_init = NULL;
@@ -292,7 +335,12 @@ Func* FUNC_new(REAL weight, Net* net) {
   f->func_clear = NULL;
   f->func_analyze_step = NULL;
   f->func_eval_step = NULL;
+  f->func_eval_period = NULL;
   f->func_free = NULL;
+  f->func_count = NULL;
+  f->func_analyze = NULL;
+  f->func_eval = NULL;
+  f->func_eval_Hv = NULL;
 
   // Data
   f->data = NULL;
@@ -303,6 +351,31 @@ Func* FUNC_new(REAL weight, Net* net) {
   return f;
 }
 
+Func* FUNC_new_view(Func* f) {
+  /** Creates a view of the function. The view has its own value,
+   *  counter and error but shares every other field, including the
+   *  gradient, Hessian and flags of buses, with the function. Its value
+   *  starts at zero. It must be created after the function is cleared,
+   *  and deleting it does not free any shared data.
+   */
+
+  // Local variables
+  Func* view;
+
+  // Check
+  if (!f)
+    return NULL;
+
+  // View
+  view = (Func*)malloc(sizeof(Func));
+  memcpy(view,f,sizeof(Func));
+  view->view = TRUE;
+  view->phi = 0;
+  view->next = NULL;
+  FUNC_clear_error(view);
+  return view;
+}
+
 void FUNC_set_name(Func* f, char* name) {
   if (f)
     strcpy(f->name,name);
@@ -346,6 +419,12 @@ void FUNC_count(Func* f) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       FUNC_count_step(f,NET_get_branch(net,i),t);
   }
+  FUNC_count_batch(f);
+}
+
+void FUNC_count_batch(Func* f) {
+  if (f && f->func_count && FUNC_is_safe_to_count(f))
+    (*(f->func_count))(f);
 }
 
 void FUNC_count_step(Func* f, Branch* br, int t) {
@@ -381,23 +460,92 @@ void FUNC_analyze(Func* f) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       FUNC_analyze_step(f,NET_get_branch(net,i),t);
   }
+  FUNC_analyze_batch(f);
   FUNC_finalize_structure_of_Hessian(f);
 }
 
+void FUNC_analyze_batch(Func* f) {
+  if (f && f->func_analyze && FUNC_is_safe_to_analyze(f))
+    (*(f->func_analyze))(f);
+}
+
 void FUNC_analyze_step(Func* f, Branch* br, int t) {
   if (f && f->func_analyze_step && FUNC_is_safe_to_analyze(f))
     (*(f->func_analyze_step))(f,br,t);
 }
 
 void FUNC_eval(Func* f, Vec* values) {
+  /** Evaluates the function with the branch traversal, the period
+   *  sweeps and the batch function. Eval safety is checked once here,
+   *  so the hooks are called directly.
+   */
+
+  // Local variables
   int i;
   int t;
   Net* net = FUNC_get_network(f);
+
+  // Check
   FUNC_clear(f);
+  if (!f || !FUNC_is_safe_to_eval(f,values))
+    return;
+
+  // Steps and sweeps
   for (t = 0; t < NET_get_num_periods(net); t++) {
-    for (i = 0; i < NET_get_num_branches(net); i++)
-      FUNC_eval_step(f,NET_get_branch(net,i),t,values);
+    if (f->func_eval_step) {
+      for (i = 0; i < NET_get_num_branches(net); i++)
+	(*(f->func_eval_step))(f,NET_get_branch(net,i),t,values);
+    }
+    if (f->func_eval_period)
+      (*(f->func_eval_period))(f,t,values);
   }
+
+  // Batch
+  if (f->func_eval)
+    (*(f->func_eval))(f,values);
+}
+
+void FUNC_eval_batch(Func* f, Vec* values) {
+  if (f && f->func_eval && FUNC_is_safe_to_eval(f,values))
+    (*(f->func_eval))(f,values);
+}
+
+void FUNC_eval_Hv(Func* f, Vec* values, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the Hessian of the function at values
+   *  and the direction d. Functions without a native product are
+   *  evaluated at values and use Hphi.
+   */
+
+  // Check
+  if (!f)
+    return;
+  if (VEC_get_size(d) != NET_get_num_vars(f->net) ||
+      VEC_get_size(Hd) != VEC_get_size(d)) {
+    sprintf(f->error_string,"invalid vector size");
+    f->error_flag = TRUE;
+    return;
+  }
+
+  // Native
+  if (f->func_eval_Hv) {
+    if (FUNC_is_safe_to_eval(f,values))
+      (*(f->func_eval_Hv))(f,values,d,Hd);
+    return;
+  }
+
+  // Fallback
+  FUNC_eval(f,values);
+  MAT_add_sym_mul_vec(f->Hphi,1.,VEC_get_data(d),VEC_get_data(Hd));
+}
+
+void FUNC_eval_period(Func* f, int t, Vec* values) {
+  /** Evaluates the parts of the function that are computed with a
+   *  sweep over the network components of time period t instead of
+   *  with the branch traversal of FUNC_eval_step. It is called once
+   *  per period, after the steps of the period.
+   */
+  if (f && f->func_eval_period && FUNC_is_safe_to_eval(f,values))
+    (*(f->func_eval_period))(f,t,values);
 }
 
 void FUNC_eval_step(Func* f, Branch* br, int t, Vec* values) {
@@ -405,6 +553,13 @@ void FUNC_eval_step(Func* f, Branch* br, int t, Vec* values) {
     (*(f->func_eval_step))(f,br,t,values);
 }
 
+BOOL FUNC_is_island_safe(Func* f) {
+  if (f)
+    return f->island_safe;
+  else
+    return FALSE;
+}
+
 BOOL FUNC_is_safe_to_count(Func* f) {
   Net* net = FUNC_get_network(f);
   if (FUNC_get_bus_counted_size(f) == NET_get_num_buses(net)*NET_get_num_periods(net))
@@ -496,6 +651,16 @@ Net* FUNC_get_network(Func* f) {
     return NULL;
 }
 
+void FUNC_set_island_safe(Func* f, BOOL flag) {
+  /** Sets whether the count, analyze and eval steps of a branch only
+   *  write the value and counter of the function and data of the
+   *  variables and buses of the island of the branch, and return
+   *  immediately for branches on outage (see FUNC_new_view).
+   */
+  if (f)
+    f->island_safe = flag;
+}
+
 void FUNC_set_func_init(Func* f, void (*func)(Func* f)) {
   if (f)
     f->func_init = func;
@@ -526,11 +691,36 @@ void FUNC_set_func_eval_step(Func* f, void (*func)(Func* f, Branch* br, int t, V
     f->func_eval_step = func;
 }
 
+void FUNC_set_func_eval_period(Func* f, void (*func)(Func* f, int t, Vec* v)) {
+  if (f)
+    f->func_eval_period = func;
+}
+
 void FUNC_set_func_free(Func* f, void (*func)(Func* f)) {
   if (f)
     f->func_free = func;
 }
 
+void FUNC_set_func_count(Func* f, void (*func)(Func* f)) {
+  if (f)
+    f->func_count = func;
+}
+
+void FUNC_set_func_analyze(Func* f, void (*func)(Func* f)) {
+  if (f)
+    f->func_analyze = func;
+}
+
+void FUNC_set_func_eval(Func* f, void (*func)(Func* f, Vec* v)) {
+  if (f)
+    f->func_eval = func;
+}
+
+void FUNC_set_func_eval_Hv(Func* f, void (*func)(Func* f, Vec* v, Vec* d, Vec* Hd)) {
+  if (f)
+    f->func_eval_Hv = func;
+}
+
 void* FUNC_get_data(Func* f) {
   if (f)
     return f->data;
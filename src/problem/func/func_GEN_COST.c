@@ -17,8 +17,10 @@ Func* FUNC_GEN_COST_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f, &FUNC_GEN_COST_allocate);
   FUNC_set_func_clear(f, &FUNC_GEN_COST_clear);
   FUNC_set_func_analyze_step(f, &FUNC_GEN_COST_analyze_step);
-  FUNC_set_func_eval_step(f, &FUNC_GEN_COST_eval_step);
+  FUNC_set_func_eval_period(f, &FUNC_GEN_COST_eval_period);
+  FUNC_set_func_eval_Hv(f, &FUNC_GEN_COST_eval_Hv);
   FUNC_set_func_free(f, &FUNC_GEN_COST_free);
+  FUNC_set_island_safe(f, TRUE);
   FUNC_init(f);
   return f;
 }
@@ -170,14 +172,15 @@ void FUNC_GEN_COST_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_GEN_COST_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_GEN_COST_eval_period(Func* f, int t, Vec* var_values) {
+  /** Sweeps the generators of the network. Generators at buses
+   *  without branches in service are skipped, as in the branch
+   *  traversal of the analysis.
+   */
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
+  Net* net;
   Gen* gen;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   int index_P;
@@ -185,74 +188,126 @@ void FUNC_GEN_COST_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
   REAL Q0;
   REAL Q1;
   REAL Q2;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
+  int i;
 
-  // Constr data
+  // Func data
+  net = FUNC_get_network(f);
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
+  if (!phi || !gphi)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
+  // Generators
+  for (i = 0; i < NET_get_num_gens(net); i++) {
 
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+    gen = NET_get_gen(net,i);
 
-  // Buses
-  for (k = 0; k < 2; k++) {
+    // Check bus
+    if (NET_get_bus_degree(net,BUS_get_index(GEN_get_bus(gen))) == 0)
+      continue;
 
-    bus = buses[k];
+    Q0 = GEN_get_cost_coeff_Q0(gen);
+    Q1 = GEN_get_cost_coeff_Q1(gen);
+    Q2 = GEN_get_cost_coeff_Q2(gen);
 
-    if (!bus_counted[bus_index_t[k]]) {
+    // Variable
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
 
-      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+      // Index
+      index_P = GEN_get_index_P(gen,t);
 
-	Q0 = GEN_get_cost_coeff_Q0(gen);
-	Q1 = GEN_get_cost_coeff_Q1(gen);
-	Q2 = GEN_get_cost_coeff_Q2(gen);
+      // P
+      P = VEC_get(var_values,index_P);
 
-	// Variable
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
+      // phi
+      (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
 
-	  // Index
-	  index_P = GEN_get_index_P(gen,t);
+      // gphi
+      gphi[index_P] = Q1 + 2.*Q2*P;
+    }
 
-	  // P
-	  P = VEC_get(var_values,index_P);
+    // Constant
+    else {
 
-	  // phi
-	  (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
+      // P
+      P = GEN_get_P(gen,t);
 
-	  // gphi
-	  gphi[index_P] = Q1 + 2.*Q2*P;
-	}
+      // phi
+      (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
+    }
+  }
+}
+
+void FUNC_GEN_COST_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the generation cost Hessian and d. The Hessian
+   *  is constant so var_values is not used and nothing is evaluated.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* buses[2];
+  Bus* bus;
+  Gen* gen;
+  int index_P;
+  char* bus_counted;
+  REAL* dd;
+  REAL* Hdd;
+  int bus_index_t[2];
+  int T;
+  int i;
+  int k;
+  int t;
+
+  // Data
+  net = FUNC_get_network(f);
+  T = NET_get_num_periods(net);
+  bus_counted = FUNC_get_bus_counted(f);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
+
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  FUNC_clear_bus_counted(f);
+
+  for (t = 0; t < T; t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
 
-	// Constant
-	else {
+      br = NET_get_branch(net,i);
 
-	  // P
-	  P = GEN_get_P(gen,t);
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
 
-	  // phi
-	  (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
+      // Bus data
+      buses[0] = BRANCH_get_bus_k(br);
+      buses[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++)
+	bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+
+      // Buses
+      for (k = 0; k < 2; k++) {
+
+	bus = buses[k];
+
+	if (!bus_counted[bus_index_t[k]]) {
+	  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+	    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
+	      index_P = GEN_get_index_P(gen,t);
+	      Hdd[index_P] += 2.*GEN_get_cost_coeff_Q2(gen)*dd[index_P];
+	    }
+	  }
 	}
+
+	// Update counted flag
+	bus_counted[bus_index_t[k]] = TRUE;
       }
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
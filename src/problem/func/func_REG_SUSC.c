@@ -19,6 +19,7 @@ Func* FUNC_REG_SUSC_new(REAL weight, Net* net) {
   FUNC_set_func_analyze_step(f,&FUNC_REG_SUSC_analyze_step);
   FUNC_set_func_eval_step(f,&FUNC_REG_SUSC_eval_step);
   FUNC_set_func_free(f,&FUNC_REG_SUSC_free);
+  FUNC_set_island_safe(f, TRUE);
   FUNC_init(f);
   return f;
 }
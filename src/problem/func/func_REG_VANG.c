@@ -18,7 +18,9 @@ Func* FUNC_REG_VANG_new(REAL weight, Net* net) {
   FUNC_set_func_clear(f, &FUNC_REG_VANG_clear);
   FUNC_set_func_analyze_step(f, &FUNC_REG_VANG_analyze_step);
   FUNC_set_func_eval_step(f, &FUNC_REG_VANG_eval_step);
+  FUNC_set_func_eval_Hv(f, &FUNC_REG_VANG_eval_Hv);
   FUNC_set_func_free(f, &FUNC_REG_VANG_free);
+  FUNC_set_island_safe(f, TRUE);
   FUNC_init(f);
   return f;
 }
@@ -285,6 +287,83 @@ void FUNC_REG_VANG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
   }
 }
 
+void FUNC_REG_VANG_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the voltage angle regularization Hessian and d. The Hessian
+   *  is constant so var_values is not used and nothing is evaluated.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* buses[2];
+  int index_v_ang[2];
+  BOOL var_w[2];
+  REAL dw = FUNC_REG_VANG_PARAM;
+  char* bus_counted;
+  REAL* dd;
+  REAL* Hdd;
+  int bus_index_t[2];
+  int T;
+  int i;
+  int k;
+  int t;
+
+  // Data
+  net = FUNC_get_network(f);
+  T = NET_get_num_periods(net);
+  bus_counted = FUNC_get_bus_counted(f);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
+
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  FUNC_clear_bus_counted(f);
+
+  for (t = 0; t < T; t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
+
+      // Bus data
+      buses[0] = BRANCH_get_bus_k(br);
+      buses[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++) {
+	bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+	index_v_ang[k] = BUS_get_index_v_ang(buses[k],t);
+	var_w[k] = BUS_has_flags(buses[k],FLAG_VARS,BUS_VAR_VANG);
+      }
+
+      // Branch
+      if (var_w[0]) // wk and wk
+	Hdd[index_v_ang[0]] += dd[index_v_ang[0]]/(dw*dw);
+      if (var_w[1]) // wm and wm
+	Hdd[index_v_ang[1]] += dd[index_v_ang[1]]/(dw*dw);
+      if (var_w[0] && var_w[1]) { // wk and wm
+	Hdd[index_v_ang[0]] -= dd[index_v_ang[1]]/(dw*dw);
+	Hdd[index_v_ang[1]] -= dd[index_v_ang[0]]/(dw*dw);
+      }
+
+      // Buses
+      for (k = 0; k < 2; k++) {
+	if (!bus_counted[bus_index_t[k]]) {
+	  if (var_w[k]) // w var
+	    Hdd[index_v_ang[k]] += dd[index_v_ang[k]]/(dw*dw);
+	}
+
+	// Update counted flag
+	bus_counted[bus_index_t[k]] = TRUE;
+      }
+    }
+  }
+}
+
 void FUNC_REG_VANG_free(Func* f) {
   // Nothing
 }
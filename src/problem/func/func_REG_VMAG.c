@@ -17,8 +17,10 @@ Func* FUNC_REG_VMAG_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f,&FUNC_REG_VMAG_allocate);
   FUNC_set_func_clear(f,&FUNC_REG_VMAG_clear);
   FUNC_set_func_analyze_step(f,&FUNC_REG_VMAG_analyze_step);
-  FUNC_set_func_eval_step(f,&FUNC_REG_VMAG_eval_step);
+  FUNC_set_func_eval_period(f,&FUNC_REG_VMAG_eval_period);
+  FUNC_set_func_eval_Hv(f,&FUNC_REG_VMAG_eval_Hv);
   FUNC_set_func_free(f,&FUNC_REG_VMAG_free);
+  FUNC_set_island_safe(f, TRUE);
   FUNC_init(f);
   return f;
 }
@@ -167,80 +169,134 @@ void FUNC_REG_VMAG_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_REG_VMAG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_REG_VMAG_eval_period(Func* f, int t, Vec* var_values) {
+  /** Sweeps the buses of the network. Buses without branches in
+   *  service are skipped, as in the branch traversal of the analysis.
+   */
 
   // Local variables
-  Bus* buses[2];
+  Net* net;
   Bus* bus;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   int index_v_mag;
   REAL v;
   REAL vt;
   REAL dv = FUNC_REG_VMAG_PARAM;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
+  int i;
 
-  // Constr data
+  // Func data
+  net = FUNC_get_network(f);
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
+  if (!phi || !gphi)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
+  // Buses
+  for (i = 0; i < NET_get_num_buses(net); i++) {
 
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+    bus = NET_get_bus(net,i);
 
-  // Buses
-  for (k = 0; k < 2; k++) {
+    // Check bus
+    if (NET_get_bus_degree(net,i) == 0)
+      continue;
 
-    bus = buses[k];
+    // Set point
+    vt = BUS_get_v_set(bus,t);
 
-    if (!bus_counted[bus_index_t[k]]) {
+    if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
 
-      // Set point
-      vt = BUS_get_v_set(bus,t);
+      // Index
+      index_v_mag = BUS_get_index_v_mag(bus,t);
 
-      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
+      // v
+      v = VEC_get(var_values,index_v_mag);
 
-	// Index
-	index_v_mag = BUS_get_index_v_mag(bus,t);
+      // phi
+      (*phi) += 0.5*pow((v-vt)/dv,2.);
 
-	// v
-	v = VEC_get(var_values,index_v_mag);
+      // gphi
+      gphi[index_v_mag] = (v-vt)/(dv*dv);
+    }
+    else {
 
-	// phi
-	(*phi) += 0.5*pow((v-vt)/dv,2.);
+      // v
+      v = BUS_get_v_mag(bus,t);
 
-	// gphi
-	gphi[index_v_mag] = (v-vt)/(dv*dv);
-      }
-      else {
+      // phi
+      (*phi) += 0.5*pow((v-vt)/dv,2.);
+    }
+  }
+}
+
+void FUNC_REG_VMAG_eval_Hv(Func* f, Vec* var_values, Vec* d, Vec* Hd) {
+  /** Adds to Hd the product of the voltage magnitude regularization Hessian and d. The Hessian
+   *  is constant so var_values is not used and nothing is evaluated.
+   */
+
+  // Local variables
+  Net* net;
+  Branch* br;
+  Bus* buses[2];
+  Bus* bus;
+  int index_v_mag;
+  REAL dv = FUNC_REG_VMAG_PARAM;
+  char* bus_counted;
+  REAL* dd;
+  REAL* Hdd;
+  int bus_index_t[2];
+  int T;
+  int i;
+  int k;
+  int t;
+
+  // Data
+  net = FUNC_get_network(f);
+  T = NET_get_num_periods(net);
+  bus_counted = FUNC_get_bus_counted(f);
+  dd = VEC_get_data(d);
+  Hdd = VEC_get_data(Hd);
 
-	// v
-	v = BUS_get_v_mag(bus,t);
+  // Check pointers
+  if (!bus_counted)
+    return;
+
+  // Clear
+  FUNC_clear_bus_counted(f);
+
+  for (t = 0; t < T; t++) {
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+
+      br = NET_get_branch(net,i);
+
+      // Check outage
+      if (BRANCH_is_on_outage(br))
+	continue;
 
-	// phi
-	(*phi) += 0.5*pow((v-vt)/dv,2.);
+      // Bus data
+      buses[0] = BRANCH_get_bus_k(br);
+      buses[1] = BRANCH_get_bus_m(br);
+      for (k = 0; k < 2; k++)
+	bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+
+      // Buses
+      for (k = 0; k < 2; k++) {
+
+	bus = buses[k];
+
+	if (!bus_counted[bus_index_t[k]]) {
+	  if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
+	    index_v_mag = BUS_get_index_v_mag(bus,t);
+	    Hdd[index_v_mag] += dd[index_v_mag]/(dv*dv);
+	  }
+	}
+
+	// Update counted flag
+	bus_counted[bus_index_t[k]] = TRUE;
       }
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
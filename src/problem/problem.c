@@ -10,6 +10,7 @@
 
 #include <pfnet/array.h>
 #include <pfnet/problem.h>
+#include <pfnet/constr_LBOUND.h>
 
 struct Prob {
 
@@ -51,8 +52,52 @@ struct Prob {
   Vec* l;           /** @brief Lower bound for linear inequality contraints */
   Vec* u;           /** @brief Upper bound for linear inequality contraints */
 
+  // Simple bounds (x_l <= x <= x_u)
+  BOOL simple_bounds; /**< @brief Flag for emitting variable bounds as vectors instead of rows of G */
+  Vec* x_l;           /**< @brief Lower bounds of primal variables */
+  Vec* x_u;           /**< @brief Upper bounds of primal variables */
+
   // Extra variables
   int num_extra_vars;          /** @brief Number of extra variables */
+
+  // Block decomposition
+  BOOL decompose;              /**< @brief Flag for computing independent blocks (islands) */
+  int num_blocks;              /**< @brief Number of independent blocks */
+  int* var_block;              /**< @brief Block index of each primal variable */
+  int* A_row_block;            /**< @brief Block index of each row of A */
+  int* J_row_block;            /**< @brief Block index of each row of J */
+  int* G_row_block;            /**< @brief Block index of each row of G */
+
+  // Islands
+  int num_islands;             /**< @brief Number of islands of the runs */
+  int num_runs;                /**< @brief Number of runs of consecutive branches of the same island */
+  int* run_start;              /**< @brief First branch of each run, followed by the number of branches */
+  int* island_run_ptr;         /**< @brief Start in island_runs of the runs of each island, followed by the number of runs */
+  int* island_runs;            /**< @brief Runs grouped by island */
+  int num_island_constrs;      /**< @brief Number of constraints with steps that run per island */
+  int num_island_funcs;        /**< @brief Number of functions with steps that run per island */
+  int* constr_counters;        /**< @brief Counters of island constraints at the start of each run of each period, and after the steps */
+  int* func_counters;          /**< @brief Hessian counters of island functions at the start of each run of each period, and after the steps */
+
+  // Period decomposition
+  BOOL period_decompose;       /**< @brief Flag for computing time periods of variables and rows */
+  int* var_period;             /**< @brief Time period of each primal variable */
+  int* A_row_period;           /**< @brief Time period of each row of A */
+  int* J_row_period;           /**< @brief Time period of each row of J */
+  int* G_row_period;           /**< @brief Time period of each row of G */
+
+  // Duplicate compaction
+  BOOL compact;                /**< @brief Flag for summing duplicate entries of J, Hphi and H_combined */
+  int* J_map;                  /**< @brief Index in J of each entry of the Jacobians of the constraints */
+  int* Hphi_map;               /**< @brief Index in Hphi of each entry of the Hessians of the functions */
+  int* H_combined_map;         /**< @brief Index in H_combined of each entry of the combined Hessians of the constraints */
+
+  // Coloring
+  BOOL color;                  /**< @brief Flag for coloring the columns of J and of the Hessian of the Lagrangian */
+  int num_J_colors;            /**< @brief Number of colors of the columns of J */
+  int* J_color;                /**< @brief Color of each column of J */
+  int num_H_colors;            /**< @brief Number of colors of the columns of the Hessian of the Lagrangian */
+  int* H_color;                /**< @brief Color of each column of the Hessian of the Lagrangian */
 };
 
 void PROB_add_constr(Prob* p, Constr* c) {
@@ -88,6 +133,7 @@ void PROB_analyze(Prob* p) {
   // Local variables
   Branch* br;
   Constr* c;
+  Constr* bounds;
   Func* f;
   int Arow;
   int Annz;
@@ -99,22 +145,37 @@ void PROB_analyze(Prob* p) {
   int Hcombnnz;
   int num_vars;
   int num_extra_vars;
+  BOOL islands;
   int k;
+  int r;
   int t;
   
   // No p
   if (!p)
     return;
 
+  // Simple bounds
+  bounds = PROB_find_constr(p,"variable bounds");
+  CONSTR_LBOUND_set_simple_bounds(bounds,p->simple_bounds);
+
   // Clear
   CONSTR_list_clear(p->constr);
   FUNC_list_clear(p->func);
+
+  // Islands
+  PROB_update_islands(p);
+  islands = PROB_has_island_steps(p);
   
   // Count
   for (t = 0; t < NET_get_num_periods(p->net); t++) {
+    r = 0;
     for (k = 0; k < NET_get_num_branches(p->net); k++) {
       
       br = NET_get_branch(p->net,k);
+
+      // Island counters
+      if (islands && k == p->run_start[r])
+	PROB_store_island_counters(p,t*p->num_runs+r++);
       
       // Constraints
       CONSTR_list_count_step(p->constr,br,t);
@@ -133,6 +194,12 @@ void PROB_analyze(Prob* p) {
       }
     }
   }
+  if (islands)
+    PROB_store_island_counters(p,NET_get_num_periods(p->net)*p->num_runs);
+  CONSTR_list_count_batch(p->constr);
+  FUNC_list_count_batch(p->func);
+  if (PROB_copy_list_errors(p))
+    return;
 
   // Extra vars
   num_extra_vars = 0;
@@ -154,6 +221,14 @@ void PROB_analyze(Prob* p) {
       
       br = NET_get_branch(p->net,k);
       
+      // Constraints and functions not split into islands
+      if (islands) {
+	PROB_run_serial_steps(p,br,t,NULL,NULL);
+	if (PROB_copy_list_errors(p))
+	  return;
+	continue;
+      }
+      
       // Constraints
       CONSTR_list_analyze_step(p->constr,br,t);
       if (CONSTR_list_has_error(p->constr)) {
@@ -171,6 +246,12 @@ void PROB_analyze(Prob* p) {
       }
     }
   }
+  if (islands && PROB_run_island_steps(p,NULL,NULL))
+    return;
+  CONSTR_list_analyze_batch(p->constr);
+  FUNC_list_analyze_batch(p->func);
+  if (PROB_copy_list_errors(p))
+    return;
   CONSTR_list_finalize_structure_of_Hessians(p->constr);
   FUNC_list_finalize_structure_of_Hessian(p->func);
 
@@ -217,9 +298,31 @@ void PROB_analyze(Prob* p) {
   p->J = MAT_new(Jrow,num_vars+num_extra_vars,Jnnz);
   p->H_combined = MAT_new(num_vars+num_extra_vars,num_vars+num_extra_vars,Hcombnnz);
 
+  if (p->simple_bounds && bounds) {
+    p->x_l = VEC_new(num_vars+num_extra_vars);
+    p->x_u = VEC_new(num_vars+num_extra_vars);
+  }
+
   // Update
   PROB_update_lin(p);
+  PROB_update_bounds(p);
   PROB_update_nonlin_struc(p);
+
+  // Duplicates
+  if (p->compact)
+    PROB_compact_nonlin(p);
+
+  // Blocks
+  if (p->decompose)
+    PROB_update_blocks(p);
+
+  // Periods
+  if (p->period_decompose)
+    PROB_update_periods(p);
+
+  // Colors
+  if (p->color)
+    PROB_update_colors(p);
 }
 
 void PROB_apply_heuristics(Prob* p, Vec* point) {
@@ -248,6 +351,25 @@ void PROB_apply_heuristics(Prob* p, Vec* point) {
   PROB_update_lin(p);
 }
 
+BOOL PROB_copy_list_errors(Prob* p) {
+  /** Copies error of constraints or functions to problem.
+   *  Returns TRUE if there was an error.
+   */
+  if (!p)
+    return FALSE;
+  if (CONSTR_list_has_error(p->constr)) {
+    strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
+    p->error_flag = TRUE;
+    return TRUE;
+  }
+  if (FUNC_list_has_error(p->func)) {
+    strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+    p->error_flag = TRUE;
+    return TRUE;
+  }
+  return FALSE;
+}
+
 void PROB_clear_error(Prob* p) {
   if (p) {
 
@@ -271,9 +393,15 @@ void PROB_eval(Prob* p, Vec* point) {
   // Local variables
   REAL* point_data;
   Branch* br;
+  Constr* c;
   int num_vars;
+  int offset;
+  BOOL islands;
+  BOOL error;
+  Vec** ve;
   Vec* x;
   Vec* y;
+  int j;
   int k;
   int t;
   
@@ -299,26 +427,48 @@ void PROB_eval(Prob* p, Vec* point) {
   FUNC_list_clear(p->func);
   NET_clear_properties(p->net);
 
+  // Extra variables of each constraint (islands)
+  islands = PROB_has_island_steps(p);
+  ve = NULL;
+  if (islands) {
+    ARRAY_alloc(ve,Vec*,CONSTR_list_len(p->constr));
+    offset = 0;
+    j = 0;
+    for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+      ve[j++] = VEC_new_from_array(&(VEC_get_data(y)[offset]),CONSTR_get_num_extra_vars(c));
+      offset += CONSTR_get_num_extra_vars(c);
+    }
+  }
+
   // Eval
+  error = islands ? PROB_run_island_steps(p,x,ve) : FALSE;
   for (t = 0; t < NET_get_num_periods(p->net); t++) {
-    for (k = 0; k < NET_get_num_branches(p->net); k++) {
+    for (k = 0; k < NET_get_num_branches(p->net) && !error; k++) {
       
       br = NET_get_branch(p->net,k);
-      
-      // Constraints
-      CONSTR_list_eval_step(p->constr,br,t,x,y);
-      if (CONSTR_list_has_error(p->constr)) {
-      	strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
-	p->error_flag = TRUE;
-	return;
+
+      // Constraints and functions not split into islands
+      if (islands) {
+	PROB_run_serial_steps(p,br,t,x,ve);
+	error = PROB_copy_list_errors(p);
       }
+      else {
       
-      // Functions
-      FUNC_list_eval_step(p->func,br,t,x);
-      if (FUNC_list_has_error(p->func)) {
-      	strcpy(p->error_string,FUNC_list_get_error_string(p->func));
-	p->error_flag = TRUE;
-	return;
+	// Constraints
+	CONSTR_list_eval_step(p->constr,br,t,x,y);
+	if (CONSTR_list_has_error(p->constr)) {
+	  strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
+	  p->error_flag = TRUE;
+	  return;
+	}
+      
+	// Functions
+	FUNC_list_eval_step(p->func,br,t,x);
+	if (FUNC_list_has_error(p->func)) {
+	  strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+	  p->error_flag = TRUE;
+	  return;
+	}
       }
       
       // Network
@@ -326,14 +476,31 @@ void PROB_eval(Prob* p, Vec* point) {
       if (NET_has_error(p->net)) {
 	strcpy(p->error_string,NET_get_error_string(p->net));
 	p->error_flag = TRUE;
-	return;
+	error = TRUE;
       }
     }
+    if (error)
+      break;
+
+    // Component sweeps
+    CONSTR_list_eval_period(p->constr,t,x,y);
+    FUNC_list_eval_period(p->func,t,x);
+  }
+  if (!error) {
+    CONSTR_list_eval_batch(p->constr,x,y);
+    FUNC_list_eval_batch(p->func,x);
   }
 
   // Clear
+  if (ve) {
+    for (j = 0; j < CONSTR_list_len(p->constr); j++)
+      free(ve[j]);
+    free(ve);
+  }
   free(x);
   free(y);
+  if (error || PROB_copy_list_errors(p))
+    return;
 
   // Update
   PROB_update_nonlin_data(p,point);
@@ -378,6 +545,8 @@ void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
       }
     }
   }
+  CONSTR_list_store_sens_batch(p->constr,sA,sf,sGu,sGl);
+  PROB_copy_list_errors(p);
 }
 
 void PROB_del(Prob* p) {
@@ -387,6 +556,25 @@ void PROB_del(Prob* p) {
   }
 }
 
+void PROB_del_islands(Prob* p) {
+  if (p) {
+    free(p->run_start);
+    free(p->island_run_ptr);
+    free(p->island_runs);
+    free(p->constr_counters);
+    free(p->func_counters);
+    p->num_islands = 0;
+    p->num_runs = 0;
+    p->run_start = NULL;
+    p->island_run_ptr = NULL;
+    p->island_runs = NULL;
+    p->num_island_constrs = 0;
+    p->num_island_funcs = 0;
+    p->constr_counters = NULL;
+    p->func_counters = NULL;
+  }
+}
+
 void PROB_del_matvec(Prob* p) {
   if (p) {
 
@@ -401,6 +589,11 @@ void PROB_del_matvec(Prob* p) {
     p->u = NULL;
     p->l = NULL;
     p->G = NULL;
+
+    VEC_del(p->x_l);
+    VEC_del(p->x_u);
+    p->x_l = NULL;
+    p->x_u = NULL;
  
     VEC_del(p->f);
     MAT_del(p->J);
@@ -413,6 +606,39 @@ void PROB_del_matvec(Prob* p) {
     MAT_del(p->Hphi);
     p->gphi = NULL;
     p->Hphi = NULL;
+
+    free(p->var_block);
+    free(p->A_row_block);
+    free(p->J_row_block);
+    free(p->G_row_block);
+    p->var_block = NULL;
+    p->A_row_block = NULL;
+    p->J_row_block = NULL;
+    p->G_row_block = NULL;
+    p->num_blocks = 0;
+
+    free(p->var_period);
+    free(p->A_row_period);
+    free(p->J_row_period);
+    free(p->G_row_period);
+    p->var_period = NULL;
+    p->A_row_period = NULL;
+    p->J_row_period = NULL;
+    p->G_row_period = NULL;
+
+    free(p->J_map);
+    free(p->Hphi_map);
+    free(p->H_combined_map);
+    p->J_map = NULL;
+    p->Hphi_map = NULL;
+    p->H_combined_map = NULL;
+
+    free(p->J_color);
+    free(p->H_color);
+    p->J_color = NULL;
+    p->H_color = NULL;
+    p->num_J_colors = 0;
+    p->num_H_colors = 0;
   }
 }
 
@@ -427,6 +653,9 @@ void PROB_clear(Prob* p) {
     // Free matvec
     PROB_del_matvec(p);
 
+    // Free islands
+    PROB_del_islands(p);
+
     // Re-initialize
     PROB_init(p);
   }
@@ -458,15 +687,58 @@ void PROB_combine_H(Prob* p, Vec* coeff, BOOL ensure_psd) {
   // Combine and update
   Hcombnnz = 0;
   Hcomb = MAT_get_data_array(p->H_combined);
+  if (p->H_combined_map)
+    MAT_set_zero_d(p->H_combined);
   for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
     Hcomb_constr = MAT_get_data_array(CONSTR_get_H_combined(c));
     for (k = 0; k < MAT_get_nnz(CONSTR_get_H_combined(c)); k++) {
-      Hcomb[Hcombnnz] = Hcomb_constr[k];
+      if (p->H_combined_map)
+	Hcomb[p->H_combined_map[Hcombnnz]] += Hcomb_constr[k];
+      else
+	Hcomb[Hcombnnz] = Hcomb_constr[k];
       Hcombnnz++;
     }
   }
 }
 
+void PROB_compact_nonlin(Prob* p) {
+  /** Replaces J, Hphi and H_combined by matrices with one entry per
+   *  distinct (i,j) pair, and stores for every entry of the
+   *  constraint Jacobians, function Hessians and combined constraint
+   *  Hessians the index of the entry of the problem matrix where it
+   *  is accumulated (see MAT_new_compact). Entries keep the order of
+   *  their first appearance.
+   */
+
+  // Local variables
+  Mat* M;
+
+  // No p
+  if (!p || !p->J || !p->Hphi || !p->H_combined)
+    return;
+
+  // J
+  free(p->J_map);
+  ARRAY_alloc(p->J_map,int,MAT_get_nnz(p->J));
+  M = MAT_new_compact(p->J,p->J_map);
+  MAT_del(p->J);
+  p->J = M;
+
+  // Hphi
+  free(p->Hphi_map);
+  ARRAY_alloc(p->Hphi_map,int,MAT_get_nnz(p->Hphi));
+  M = MAT_new_compact(p->Hphi,p->Hphi_map);
+  MAT_del(p->Hphi);
+  p->Hphi = M;
+
+  // H combined
+  free(p->H_combined_map);
+  ARRAY_alloc(p->H_combined_map,int,MAT_get_nnz(p->H_combined));
+  M = MAT_new_compact(p->H_combined,p->H_combined_map);
+  MAT_del(p->H_combined);
+  p->H_combined = M;
+}
+
 Constr* PROB_find_constr(Prob* p, char* name) {
   Constr* cc;
   if (p) {
@@ -646,6 +918,20 @@ Vec* PROB_get_u(Prob* p) {
     return NULL;
 }
 
+Vec* PROB_get_x_l(Prob* p) {
+  if (p)
+    return p->x_l;
+  else
+    return NULL;
+}
+
+Vec* PROB_get_x_u(Prob* p) {
+  if (p)
+    return p->x_u;
+  else
+    return NULL;
+}
+
 Mat* PROB_get_J(Prob* p) {
   if (p)
     return p->J;
@@ -667,150 +953,1729 @@ Mat* PROB_get_H_combined(Prob* p) {
     return NULL;
 }
 
-int PROB_get_num_extra_vars(Prob* p) {
+int PROB_get_num_blocks(Prob* p) {
   if (p)
-    return p->num_extra_vars;
+    return p->num_blocks;
   else
     return 0;
 }
 
-BOOL PROB_has_error(Prob* p) {
-  if (!p)
-    return FALSE;
+int* PROB_get_var_blocks(Prob* p) {
+  if (p)
+    return p->var_block;
   else
-    return p->error_flag;
+    return NULL;
 }
 
-void PROB_init(Prob* p) {
-  if (p) {
+int* PROB_get_A_row_blocks(Prob* p) {
+  if (p)
+    return p->A_row_block;
+  else
+    return NULL;
+}
 
-    // Error
-    p->error_flag = FALSE;
-    strcpy(p->error_string,"");
-   
-    // Output
-    strcpy(p->output_string,"");
- 
-    p->constr = NULL;
-    p->func = NULL;
-    p->heur = NULL;
-    
-    p->phi = 0;
-    p->gphi = NULL;
-    p->Hphi = NULL;
-    
-    p->b = NULL;
-    p->A = NULL;
-    
-    p->l = NULL;
-    p->u = NULL;
-    p->G = NULL;
-    
-    p->f = NULL;
-    p->J = NULL;
-    p->H_combined = NULL;
+int* PROB_get_J_row_blocks(Prob* p) {
+  if (p)
+    return p->J_row_block;
+  else
+    return NULL;
+}
 
-    p->num_extra_vars = 0;
+int* PROB_get_G_row_blocks(Prob* p) {
+  if (p)
+    return p->G_row_block;
+  else
+    return NULL;
+}
+
+Mat* PROB_get_block_of_mat(Prob* p, Mat* M, int* row_block, int block) {
+  /** Extracts the submatrix of M formed by the rows and columns that
+   *  belong to the given block. If row_block is NULL, the rows of M are
+   *  taken to be primal variables (e.g. Hessians). Rows and columns of
+   *  the block keep their relative order and are renumbered from zero.
+   *  Returns a new matrix owned by the caller, or NULL on failure.
+   */
+
+  // Local variables
+  Mat* B;
+  int* col_local;
+  int* row_local;
+  int num_rows;
+  int num_cols;
+  int num_vars;
+  int nnz;
+  int i;
+  int j;
+  int k;
+
+  // Check
+  if (!p || !M || !p->var_block || block < 0 || block >= p->num_blocks)
+    return NULL;
+  num_vars = NET_get_num_vars(p->net)+p->num_extra_vars;
+  if (MAT_get_size2(M) != num_vars || (!row_block && MAT_get_size1(M) != num_vars))
+    return NULL;
+  if (!row_block)
+    row_block = p->var_block;
+
+  // Local indices
+  ARRAY_alloc(col_local,int,num_vars);
+  ARRAY_alloc(row_local,int,MAT_get_size1(M));
+  num_cols = 0;
+  for (j = 0; j < num_vars; j++)
+    col_local[j] = (p->var_block[j] == block) ? num_cols++ : -1;
+  num_rows = 0;
+  for (i = 0; i < MAT_get_size1(M); i++)
+    row_local[i] = (row_block[i] == block) ? num_rows++ : -1;
+
+  // Count
+  nnz = 0;
+  for (k = 0; k < MAT_get_nnz(M); k++) {
+    if (row_local[MAT_get_i(M,k)] >= 0 && col_local[MAT_get_j(M,k)] >= 0)
+      nnz++;
   }
+
+  // Fill
+  B = MAT_new(num_rows,num_cols,nnz);
+  nnz = 0;
+  for (k = 0; k < MAT_get_nnz(M); k++) {
+    i = row_local[MAT_get_i(M,k)];
+    j = col_local[MAT_get_j(M,k)];
+    if (i >= 0 && j >= 0) {
+      MAT_set_i(B,nnz,i);
+      MAT_set_j(B,nnz,j);
+      MAT_set_d(B,nnz,MAT_get_d(M,k));
+      nnz++;
+    }
+  }
+
+  // Clean up
+  free(col_local);
+  free(row_local);
+
+  // Return
+  return B;
 }
 
-Prob* PROB_new(Net* net) {
-  Prob* p = (Prob*)malloc(sizeof(Prob));
-  p->net = net;
-  PROB_init(p);
-  return p;
+int* PROB_get_var_periods(Prob* p) {
+  if (p)
+    return p->var_period;
+  else
+    return NULL;
 }
 
-char* PROB_get_show_str(Prob* p) {
+int* PROB_get_A_row_periods(Prob* p) {
+  if (p)
+    return p->A_row_period;
+  else
+    return NULL;
+}
 
-  Func* f;
-  Constr* c;
-  char* out;
+int* PROB_get_J_row_periods(Prob* p) {
+  if (p)
+    return p->J_row_period;
+  else
+    return NULL;
+}
 
-  if (!p)
+int* PROB_get_G_row_periods(Prob* p) {
+  if (p)
+    return p->G_row_period;
+  else
     return NULL;
+}
 
-  out = p->output_string;
-  strcpy(out,"");
+int PROB_get_num_J_colors(Prob* p) {
+  if (p)
+    return p->num_J_colors;
+  else
+    return 0;
+}
 
-  sprintf(out+strlen(out),"\nProblem\n");
-  sprintf(out+strlen(out),"functions: %d\n",FUNC_list_len(p->func));
-  for (f = p->func; f != NULL; f = FUNC_get_next(f))
-    sprintf(out+strlen(out),"   %s\n",FUNC_get_name(f));
-  sprintf(out+strlen(out),"constraints: %d\n",CONSTR_list_len(p->constr));  
-  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
-    sprintf(out+strlen(out),"   %s\n",CONSTR_get_name(c));
+int* PROB_get_J_colors(Prob* p) {
+  if (p)
+    return p->J_color;
+  else
+    return NULL;
+}
 
-  return out;
+int PROB_get_num_H_colors(Prob* p) {
+  if (p)
+    return p->num_H_colors;
+  else
+    return 0;
 }
 
-void PROB_show(Prob* p) {
-  
-  printf("%s",PROB_get_show_str(p));
+int* PROB_get_H_colors(Prob* p) {
+  if (p)
+    return p->H_color;
+  else
+    return NULL;
 }
 
-void PROB_update_nonlin_struc(Prob* p) {
-  /* This function fills in problem Jacobians and Hessians
-     structure with constraint structure */
+Mat* PROB_get_period_major_mat(Prob* p, Mat* M, int* row_period, int* nnz_ptr) {
+  /** Creates a copy of M with rows and columns renumbered in
+   *  period-major order: those of period 0 first, then those of period 1,
+   *  and so on, followed by the rows and columns without a single period
+   *  (e.g. coupling rows). Relative order is kept within
+   *  each period. If row_period is NULL, the rows of M are taken to be
+   *  primal variables (e.g. Hessians). Entries are sorted so that those
+   *  of the diagonal block of period t are in positions nnz_ptr[t] to
+   *  nnz_ptr[t+1]-1, and the remaining ones (coupling entries) follow
+   *  from nnz_ptr[T] to nnz_ptr[T+1]-1, where T is the number of periods.
+   *  The array nnz_ptr (size T+2) is filled if not NULL. Returns a new
+   *  matrix owned by the caller, or NULL on failure.
+   */
 
   // Local variables
-  Func* f;
-  Constr* c;
-  int* Hphi_i;
-  int* Hphi_j;
-  int* Hphi_i_func;
-  int* Hphi_j_func;
-  int Hphinnz;
-  int* Ji;
-  int* Jj;
-  int* Ji_constr;
-  int* Jj_constr;
-  int Jrow;
-  int Jnnz;
-  int* Hcomb_i;
-  int* Hcomb_j;
-  int* Hcomb_i_constr;
-  int* Hcomb_j_constr;
-  int Hcombnnz;
-
+  Mat* B;
+  int* col_new;
+  int* row_new;
+  int* ptr;
+  int* pos;
+  BOOL rows_are_vars;
+  int num_periods;
+  int num_rows;
   int num_vars;
-  int offset;
+  int key;
+  int i;
+  int j;
   int k;
+  int t;
 
-  // Hphi
-  Hphinnz = 0;
-  Hphi_i = MAT_get_row_array(p->Hphi);
-  Hphi_j = MAT_get_col_array(p->Hphi);
-  for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
-    Hphi_i_func = MAT_get_row_array(FUNC_get_Hphi(f));
-    Hphi_j_func = MAT_get_col_array(FUNC_get_Hphi(f));
-    for (k = 0; k < MAT_get_nnz(FUNC_get_Hphi(f)); k++) {
-      Hphi_i[Hphinnz] = Hphi_i_func[k];
-      Hphi_j[Hphinnz] = Hphi_j_func[k];
-      Hphinnz++;
-    }     
+  // Check
+  if (!p || !M || !p->var_period)
+    return NULL;
+  num_vars = NET_get_num_vars(p->net)+p->num_extra_vars;
+  if (MAT_get_size2(M) != num_vars || (!row_period && MAT_get_size1(M) != num_vars))
+    return NULL;
+  rows_are_vars = !row_period;
+  if (!row_period)
+    row_period = p->var_period;
+  num_periods = NET_get_num_periods(p->net);
+  num_rows = MAT_get_size1(M);
+
+  // Allocate
+  ARRAY_zalloc(ptr,int,num_periods+2);
+  ARRAY_alloc(pos,int,num_periods+1);
+  ARRAY_alloc(col_new,int,num_vars);
+  ARRAY_alloc(row_new,int,num_rows);
+
+  // New column indices
+  for (j = 0; j < num_vars; j++)
+    ptr[(p->var_period[j] >= 0 ? p->var_period[j] : num_periods)+1]++;
+  pos[0] = 0;
+  for (t = 1; t <= num_periods; t++)
+    pos[t] = pos[t-1]+ptr[t];
+  for (j = 0; j < num_vars; j++)
+    col_new[j] = pos[p->var_period[j] >= 0 ? p->var_period[j] : num_periods]++;
+
+  // New row indices
+  for (t = 0; t < num_periods+2; t++)
+    ptr[t] = 0;
+  for (i = 0; i < num_rows; i++)
+    ptr[(row_period[i] >= 0 ? row_period[i] : num_periods)+1]++;
+  pos[0] = 0;
+  for (t = 1; t <= num_periods; t++)
+    pos[t] = pos[t-1]+ptr[t];
+  for (i = 0; i < num_rows; i++)
+    row_new[i] = pos[row_period[i] >= 0 ? row_period[i] : num_periods]++;
+
+  // Count entries of each block
+  for (t = 0; t < num_periods+2; t++)
+    ptr[t] = 0;
+  for (k = 0; k < MAT_get_nnz(M); k++) {
+    key = row_period[MAT_get_i(M,k)];
+    if (key < 0 || (rows_are_vars && p->var_period[MAT_get_j(M,k)] != key))
+      key = num_periods;
+    ptr[key+1]++;
+  }
+  for (t = 1; t < num_periods+2; t++)
+    ptr[t] += ptr[t-1];
+
+  // Fill
+  B = MAT_new(num_rows,num_vars,MAT_get_nnz(M));
+  for (t = 0; t <= num_periods; t++)
+    pos[t] = ptr[t];
+  for (k = 0; k < MAT_get_nnz(M); k++) {
+    i = MAT_get_i(M,k);
+    j = MAT_get_j(M,k);
+    key = row_period[i];
+    if (key < 0 || (rows_are_vars && p->var_period[j] != key))
+      key = num_periods;
+    MAT_set_i(B,pos[key],row_new[i]);
+    MAT_set_j(B,pos[key],col_new[j]);
+    MAT_set_d(B,pos[key],MAT_get_d(M,k));
+    pos[key]++;
+  }
+  if (nnz_ptr) {
+    for (t = 0; t < num_periods+2; t++)
+      nnz_ptr[t] = ptr[t];
   }
 
-  // J and Hcomb
-  Jnnz = 0;
-  Jrow = 0;
-  Ji = MAT_get_row_array(p->J);
-  Jj = MAT_get_col_array(p->J);
-  Hcombnnz = 0;
-  Hcomb_i = MAT_get_row_array(p->H_combined);
-  Hcomb_j = MAT_get_col_array(p->H_combined);
-  num_vars = NET_get_num_vars(p->net);
-  offset = num_vars;
-  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+  // Clean up
+  free(ptr);
+  free(pos);
+  free(col_new);
+  free(row_new);
 
-    // J
-    Ji_constr = MAT_get_row_array(CONSTR_get_J(c));
-    Jj_constr = MAT_get_col_array(CONSTR_get_J(c));
-    for (k = 0; k < MAT_get_nnz(CONSTR_get_J(c)); k++) {
-      Ji[Jnnz] = Jrow+Ji_constr[k];
-      if (Jj_constr[k] < num_vars)
-	Jj[Jnnz] = Jj_constr[k];                 // x var
-      else
+  // Return
+  return B;
+}
+
+int PROB_get_num_extra_vars(Prob* p) {
+  if (p)
+    return p->num_extra_vars;
+  else
+    return 0;
+}
+
+BOOL PROB_has_error(Prob* p) {
+  if (!p)
+    return FALSE;
+  else
+    return p->error_flag;
+}
+
+Vec* PROB_Jv(Prob* p, Vec* x, Vec* v) {
+  /** Returns the product of the Jacobian of the nonlinear equality
+   *  constraints at x and v without forming the Jacobian of the problem.
+   *  Constraints without a native product are evaluated at x (see
+   *  CONSTR_eval_Jv). The problem must be analyzed.
+   */
+
+  // Local variables
+  Constr* c;
+  Vec* out;
+  Vec* xc;
+  Vec* xc_extra;
+  Vec* vc;
+  Vec* Jvc;
+  REAL* x_data;
+  REAL* v_data;
+  REAL* out_data;
+  int num_vars;
+  int num_extra;
+  int offset;
+  int row;
+
+  // Check
+  if (!p)
+    return NULL;
+  if (!p->J ||
+      VEC_get_size(x) != PROB_get_num_primal_variables(p) ||
+      VEC_get_size(v) != PROB_get_num_primal_variables(p)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return NULL;
+  }
+
+  // Data
+  out = VEC_new(MAT_get_size1(p->J));
+  x_data = VEC_get_data(x);
+  v_data = VEC_get_data(v);
+  out_data = VEC_get_data(out);
+  num_vars = NET_get_num_vars(p->net);
+
+  // Constraints
+  offset = num_vars;
+  row = 0;
+  xc = VEC_new_from_array(x_data,num_vars);
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    num_extra = CONSTR_get_num_extra_vars(c);
+    xc_extra = VEC_new_from_array(&(x_data[offset]),num_extra);
+    Jvc = VEC_new_from_array(&(out_data[row]),MAT_get_size1(CONSTR_get_J(c)));
+    if (num_extra == 0)
+      vc = VEC_new_from_array(v_data,num_vars);
+    else {
+      vc = VEC_new(num_vars+num_extra);
+      memcpy(VEC_get_data(vc),v_data,sizeof(REAL)*num_vars);
+      memcpy(VEC_get_data(vc)+num_vars,&(v_data[offset]),sizeof(REAL)*num_extra);
+    }
+    CONSTR_eval_Jv(c,xc,xc_extra,vc,Jvc);
+    if (num_extra == 0)
+      free(vc);
+    else
+      VEC_del(vc);
+    free(xc_extra);
+    free(Jvc);
+    offset += num_extra;
+    row += MAT_get_size1(CONSTR_get_J(c));
+  }
+  free(xc);
+
+  // Errors
+  if (PROB_copy_list_errors(p)) {
+    VEC_del(out);
+    return NULL;
+  }
+  return out;
+}
+
+Vec* PROB_JTy(Prob* p, Vec* x, Vec* y) {
+  /** Returns the product of the transpose of the Jacobian of the
+   *  nonlinear equality constraints at x and y without forming the
+   *  Jacobian of the problem. Constraints without a native product are
+   *  evaluated at x (see CONSTR_eval_JTy). The problem must be analyzed.
+   */
+
+  // Local variables
+  Constr* c;
+  Vec* out;
+  Vec* xc;
+  Vec* xc_extra;
+  Vec* yc;
+  Vec* JTyc;
+  REAL* x_data;
+  REAL* y_data;
+  REAL* out_data;
+  int num_vars;
+  int num_extra;
+  int offset;
+  int row;
+  int j;
+
+  // Check
+  if (!p)
+    return NULL;
+  if (!p->J ||
+      VEC_get_size(x) != PROB_get_num_primal_variables(p) ||
+      VEC_get_size(y) != MAT_get_size1(p->J)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return NULL;
+  }
+
+  // Data
+  out = VEC_new(PROB_get_num_primal_variables(p));
+  x_data = VEC_get_data(x);
+  y_data = VEC_get_data(y);
+  out_data = VEC_get_data(out);
+  num_vars = NET_get_num_vars(p->net);
+
+  // Constraints
+  offset = num_vars;
+  row = 0;
+  xc = VEC_new_from_array(x_data,num_vars);
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    num_extra = CONSTR_get_num_extra_vars(c);
+    xc_extra = VEC_new_from_array(&(x_data[offset]),num_extra);
+    yc = VEC_new_from_array(&(y_data[row]),MAT_get_size1(CONSTR_get_J(c)));
+    if (num_extra == 0) {
+      JTyc = VEC_new_from_array(out_data,num_vars);
+      CONSTR_eval_JTy(c,xc,xc_extra,yc,JTyc);
+      free(JTyc);
+    }
+    else {
+      JTyc = VEC_new(num_vars+num_extra);
+      CONSTR_eval_JTy(c,xc,xc_extra,yc,JTyc);
+      for (j = 0; j < num_vars; j++)
+	out_data[j] += VEC_get(JTyc,j);
+      for (j = 0; j < num_extra; j++)
+	out_data[offset+j] += VEC_get(JTyc,num_vars+j);
+      VEC_del(JTyc);
+    }
+    free(xc_extra);
+    free(yc);
+    offset += num_extra;
+    row += MAT_get_size1(CONSTR_get_J(c));
+  }
+  free(xc);
+
+  // Errors
+  if (PROB_copy_list_errors(p)) {
+    VEC_del(out);
+    return NULL;
+  }
+  return out;
+}
+
+Vec* PROB_Hv(Prob* p, Vec* x, Vec* lam, Vec* v) {
+  /** Returns the product of the Hessian of the Lagrangian at x, i.e.,
+   *  Hphi plus the linear combination of the Hessians of the nonlinear
+   *  equality constraints with coefficients lam, and v without forming
+   *  H_combined. Off-diagonal entries stored once in the triangular
+   *  Hessians count for both sides. Constraints and functions without
+   *  a native product are evaluated at x (see CONSTR_eval_Hv and
+   *  FUNC_eval_Hv). The problem must be analyzed.
+   */
+
+  // Local variables
+  Constr* c;
+  Func* f;
+  Vec* out;
+  Vec* xc;
+  Vec* xc_extra;
+  Vec* lamc;
+  Vec* vc;
+  Vec* Hvc;
+  REAL* x_data;
+  REAL* lam_data;
+  REAL* v_data;
+  REAL* out_data;
+  int num_vars;
+  int num_extra;
+  int offset;
+  int row;
+  int j;
+
+  // Check
+  if (!p)
+    return NULL;
+  if (!p->J ||
+      VEC_get_size(x) != PROB_get_num_primal_variables(p) ||
+      VEC_get_size(lam) != MAT_get_size1(p->J) ||
+      VEC_get_size(v) != PROB_get_num_primal_variables(p)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return NULL;
+  }
+
+  // Data
+  out = VEC_new(PROB_get_num_primal_variables(p));
+  x_data = VEC_get_data(x);
+  lam_data = VEC_get_data(lam);
+  v_data = VEC_get_data(v);
+  out_data = VEC_get_data(out);
+  num_vars = NET_get_num_vars(p->net);
+  xc = VEC_new_from_array(x_data,num_vars);
+
+  // Functions
+  vc = VEC_new_from_array(v_data,num_vars);
+  Hvc = VEC_new(num_vars);
+  for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+    VEC_set_zero(Hvc);
+    FUNC_eval_Hv(f,xc,vc,Hvc);
+    for (j = 0; j < num_vars; j++)
+      out_data[j] += FUNC_get_weight(f)*VEC_get(Hvc,j);
+  }
+  free(vc);
+  VEC_del(Hvc);
+
+  // Constraints
+  offset = num_vars;
+  row = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    num_extra = CONSTR_get_num_extra_vars(c);
+    xc_extra = VEC_new_from_array(&(x_data[offset]),num_extra);
+    lamc = VEC_new_from_array(&(lam_data[row]),MAT_get_size1(CONSTR_get_J(c)));
+    if (num_extra == 0) {
+      vc = VEC_new_from_array(v_data,num_vars);
+      Hvc = VEC_new_from_array(out_data,num_vars);
+      CONSTR_eval_Hv(c,xc,xc_extra,lamc,vc,Hvc);
+      free(vc);
+      free(Hvc);
+    }
+    else {
+      vc = VEC_new(num_vars+num_extra);
+      Hvc = VEC_new(num_vars+num_extra);
+      memcpy(VEC_get_data(vc),v_data,sizeof(REAL)*num_vars);
+      memcpy(VEC_get_data(vc)+num_vars,&(v_data[offset]),sizeof(REAL)*num_extra);
+      CONSTR_eval_Hv(c,xc,xc_extra,lamc,vc,Hvc);
+      for (j = 0; j < num_vars; j++)
+	out_data[j] += VEC_get(Hvc,j);
+      for (j = 0; j < num_extra; j++)
+	out_data[offset+j] += VEC_get(Hvc,num_vars+j);
+      VEC_del(vc);
+      VEC_del(Hvc);
+    }
+    free(xc_extra);
+    free(lamc);
+    offset += num_extra;
+    row += MAT_get_size1(CONSTR_get_J(c));
+  }
+  free(xc);
+
+  // Errors
+  if (PROB_copy_list_errors(p)) {
+    VEC_del(out);
+    return NULL;
+  }
+  return out;
+}
+
+Mat* PROB_new_H_pattern(Prob* p) {
+  /** Creates matrix with one entry per distinct (i,j) pair, i >= j,
+   *  of the Hessian of the Lagrangian, i.e., of Hphi and of every pair
+   *  of columns of J that share a row. The pattern does not rely on the
+   *  Hessians declared by the constraints, which may be incomplete
+   *  (e.g. custom constraints without H). Its data is zero.
+   */
+
+  // Local variables
+  Mat* Jc;
+  Mat* S;
+  Mat* P;
+  int* map;
+  int* row_ptr;
+  int* cols;
+  int num_rows;
+  int nnz;
+  int i;
+  int j;
+  int k;
+  int r;
+  int s;
+
+  // Check
+  if (!p || !p->J || !p->Hphi)
+    return NULL;
+
+  // Distinct entries of J grouped by row
+  ARRAY_alloc(map,int,MAT_get_nnz(p->J));
+  Jc = MAT_new_compact(p->J,map);
+  free(map);
+  num_rows = MAT_get_size1(Jc);
+  ARRAY_zalloc(row_ptr,int,num_rows+1);
+  ARRAY_alloc(cols,int,MAT_get_nnz(Jc));
+  for (k = 0; k < MAT_get_nnz(Jc); k++)
+    row_ptr[MAT_get_i(Jc,k)+1]++;
+  for (i = 0; i < num_rows; i++)
+    row_ptr[i+1] += row_ptr[i];
+  for (k = 0; k < MAT_get_nnz(Jc); k++)
+    cols[row_ptr[MAT_get_i(Jc,k)]++] = MAT_get_j(Jc,k);
+  for (i = num_rows; i > 0; i--)
+    row_ptr[i] = row_ptr[i-1];
+  row_ptr[0] = 0;
+
+  // Count
+  nnz = MAT_get_nnz(p->Hphi);
+  for (i = 0; i < num_rows; i++)
+    nnz += (row_ptr[i+1]-row_ptr[i])*(row_ptr[i+1]-row_ptr[i]+1)/2;
+
+  // Stack
+  S = MAT_new(MAT_get_size1(p->Hphi),
+	      MAT_get_size2(p->Hphi),
+	      nnz);
+  nnz = 0;
+  for (k = 0; k < MAT_get_nnz(p->Hphi); k++) {
+    i = MAT_get_i(p->Hphi,k);
+    j = MAT_get_j(p->Hphi,k);
+    MAT_set_i(S,nnz,(i >= j) ? i : j);
+    MAT_set_j(S,nnz,(i >= j) ? j : i);
+    nnz++;
+  }
+  for (i = 0; i < num_rows; i++) {
+    for (r = row_ptr[i]; r < row_ptr[i+1]; r++) {
+      for (s = row_ptr[i]; s <= r; s++) {
+	MAT_set_i(S,nnz,(cols[r] >= cols[s]) ? cols[r] : cols[s]);
+	MAT_set_j(S,nnz,(cols[r] >= cols[s]) ? cols[s] : cols[r]);
+	nnz++;
+      }
+    }
+  }
+
+  // Compact
+  ARRAY_alloc(map,int,nnz);
+  P = MAT_new_compact(S,map);
+  free(map);
+  free(row_ptr);
+  free(cols);
+  MAT_del(Jc);
+  MAT_del(S);
+  return P;
+}
+
+void PROB_update_colors(Prob* p) {
+  /** Colors the columns of J and of the Hessian of the Lagrangian
+   *  (pattern of PROB_new_H_pattern) so that columns of the same color have no
+   *  entries in a common row (see MAT_color_columns). For the symmetric
+   *  Hessian, this is a distance-2 coloring of the graph of its pattern.
+   *  Columns without entries have color -1. The colors determine the
+   *  directions used by PROB_estimate_J and PROB_estimate_H.
+   */
+
+  // Local variables
+  Mat* P;
+  Mat* S;
+  char* has_entry;
+  int num_primal;
+  int nnz;
+  int i;
+  int j;
+  int k;
+
+  // Check
+  if (!p || !p->J || !p->Hphi)
+    return;
+
+  // Free
+  free(p->J_color);
+  free(p->H_color);
+
+  // J
+  num_primal = PROB_get_num_primal_variables(p);
+  ARRAY_alloc(p->J_color,int,num_primal);
+  p->num_J_colors = MAT_color_columns(p->J,p->J_color);
+
+  // Full symmetric pattern of H with diagonal
+  P = PROB_new_H_pattern(p);
+  ARRAY_zalloc(has_entry,char,num_primal);
+  S = MAT_new(num_primal,num_primal,2*MAT_get_nnz(P)+num_primal);
+  nnz = 0;
+  for (k = 0; k < MAT_get_nnz(P); k++) {
+    i = MAT_get_i(P,k);
+    j = MAT_get_j(P,k);
+    has_entry[i] = TRUE;
+    has_entry[j] = TRUE;
+    if (i == j)
+      continue;
+    MAT_set_i(S,nnz,i);
+    MAT_set_j(S,nnz,j);
+    nnz++;
+    MAT_set_i(S,nnz,j);
+    MAT_set_j(S,nnz,i);
+    nnz++;
+  }
+  for (j = 0; j < num_primal; j++) {
+    if (!has_entry[j])
+      continue;
+    MAT_set_i(S,nnz,j);
+    MAT_set_j(S,nnz,j);
+    nnz++;
+  }
+  MAT_set_nnz(S,nnz);
+
+  // H
+  ARRAY_alloc(p->H_color,int,num_primal);
+  p->num_H_colors = MAT_color_columns(S,p->H_color);
+
+  // Clean up
+  MAT_del(P);
+  MAT_del(S);
+  free(has_entry);
+}
+
+Mat* PROB_estimate_J(Prob* p, Vec* point, REAL h) {
+  /** Estimates J at point with forward differences of f with step h
+   *  along one direction per color of the columns of J (see
+   *  PROB_update_colors), i.e., with one evaluation per color besides
+   *  the ones at point. The estimate has the pattern of J without
+   *  duplicates. The problem is left evaluated at point.
+   */
+
+  // Local variables
+  Mat* Jest;
+  REAL* f0;
+  REAL* f;
+  REAL* x0;
+  REAL* x;
+  REAL* d;
+  Vec* xv;
+  int* map;
+  int num_primal;
+  int num_rows;
+  int c;
+  int j;
+  int k;
+
+  // Check
+  if (!p || !p->J)
+    return NULL;
+
+  // Check sizes
+  num_primal = PROB_get_num_primal_variables(p);
+  if (VEC_get_size(point) != num_primal) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return NULL;
+  }
+
+  // Colors
+  if (!p->J_color)
+    PROB_update_colors(p);
+
+  // Pattern
+  ARRAY_alloc(map,int,MAT_get_nnz(p->J));
+  Jest = MAT_new_compact(p->J,map);
+  free(map);
+  d = MAT_get_data_array(Jest);
+
+  // Allocate
+  num_rows = MAT_get_size1(p->J);
+  x0 = VEC_get_data(point);
+  ARRAY_alloc(x,REAL,num_primal);
+  ARRAY_alloc(f0,REAL,num_rows);
+  xv = VEC_new_from_array(x,num_primal);
+  for (j = 0; j < num_primal; j++)
+    x[j] = x0[j];
+
+  // Evaluations (c = -1 for point)
+  for (c = -1; c < p->num_J_colors; c++) {
+
+    // Perturb
+    for (j = 0; j < num_primal; j++) {
+      if (p->J_color[j] == c && c >= 0)
+	x[j] = x0[j]+h;
+    }
+
+    // Eval
+    PROB_eval(p,xv);
+    if (PROB_has_error(p))
+      break;
+    f = VEC_get_data(p->f);
+
+    // Differences
+    if (c < 0) {
+      for (k = 0; k < num_rows; k++)
+	f0[k] = f[k];
+    }
+    else {
+      for (k = 0; k < MAT_get_nnz(Jest); k++) {
+	if (p->J_color[MAT_get_j(Jest,k)] == c)
+	  d[k] = (f[MAT_get_i(Jest,k)]-f0[MAT_get_i(Jest,k)])/h;
+      }
+    }
+
+    // Restore
+    for (j = 0; j < num_primal; j++)
+      x[j] = x0[j];
+  }
+
+  // Point
+  if (!PROB_has_error(p))
+    PROB_eval(p,point);
+
+  // Clean up
+  free(x);
+  free(xv);
+  free(f0);
+
+  // Error
+  if (PROB_has_error(p)) {
+    MAT_del(Jest);
+    return NULL;
+  }
+
+  // Return
+  return Jest;
+}
+
+Mat* PROB_estimate_H(Prob* p, Vec* point, Vec* lam, REAL h) {
+  /** Estimates the lower triangle of the Hessian of the Lagrangian,
+   *  Hphi plus H_combined for coefficients lam, at point with forward
+   *  differences of gphi + J^T lam with step h along one direction per
+   *  color of its columns (see PROB_update_colors), i.e., with one
+   *  evaluation per color besides the ones at point. The estimate has
+   *  the pattern of PROB_new_H_pattern, which covers entries missing
+   *  from the Hessians declared by the constraints. The problem is left
+   *  evaluated at point.
+   */
+
+  // Local variables
+  Mat* Hest;
+  REAL* g0;
+  REAL* g;
+  REAL* gphi;
+  REAL* l;
+  REAL* x0;
+  REAL* x;
+  REAL* d;
+  Vec* xv;
+  Mat* J;
+  int num_primal;
+  int c;
+  int j;
+  int k;
+
+  // Check
+  if (!p || !p->J)
+    return NULL;
+
+  // Check sizes
+  num_primal = PROB_get_num_primal_variables(p);
+  if (VEC_get_size(point) != num_primal ||
+      VEC_get_size(lam) != MAT_get_size1(p->J)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return NULL;
+  }
+
+  // Colors
+  if (!p->H_color)
+    PROB_update_colors(p);
+
+  // Pattern
+  Hest = PROB_new_H_pattern(p);
+  d = MAT_get_data_array(Hest);
+
+  // Allocate
+  x0 = VEC_get_data(point);
+  l = VEC_get_data(lam);
+  ARRAY_alloc(x,REAL,num_primal);
+  ARRAY_alloc(g,REAL,num_primal);
+  ARRAY_alloc(g0,REAL,num_primal);
+  xv = VEC_new_from_array(x,num_primal);
+  for (j = 0; j < num_primal; j++)
+    x[j] = x0[j];
+
+  // Evaluations (c = -1 for point)
+  for (c = -1; c < p->num_H_colors; c++) {
+
+    // Perturb
+    for (j = 0; j < num_primal; j++) {
+      if (p->H_color[j] == c && c >= 0)
+	x[j] = x0[j]+h;
+    }
+
+    // Eval
+    PROB_eval(p,xv);
+    if (PROB_has_error(p))
+      break;
+
+    // Gradient of Lagrangian
+    gphi = VEC_get_data(p->gphi);
+    J = p->J;
+    for (j = 0; j < num_primal; j++)
+      g[j] = gphi[j];
+    for (k = 0; k < MAT_get_nnz(J); k++)
+      g[MAT_get_j(J,k)] += MAT_get_d(J,k)*l[MAT_get_i(J,k)];
+
+    // Differences
+    if (c < 0) {
+      for (j = 0; j < num_primal; j++)
+	g0[j] = g[j];
+    }
+    else {
+      for (k = 0; k < MAT_get_nnz(Hest); k++) {
+	if (p->H_color[MAT_get_j(Hest,k)] == c)
+	  d[k] = (g[MAT_get_i(Hest,k)]-g0[MAT_get_i(Hest,k)])/h;
+      }
+    }
+
+    // Restore
+    for (j = 0; j < num_primal; j++)
+      x[j] = x0[j];
+  }
+
+  // Point
+  if (!PROB_has_error(p))
+    PROB_eval(p,point);
+
+  // Clean up
+  free(x);
+  free(xv);
+  free(g);
+  free(g0);
+
+  // Error
+  if (PROB_has_error(p)) {
+    MAT_del(Hest);
+    return NULL;
+  }
+
+  // Return
+  return Hest;
+}
+
+void PROB_init(Prob* p) {
+  if (p) {
+
+    // Error
+    p->error_flag = FALSE;
+    strcpy(p->error_string,"");
+   
+    // Output
+    strcpy(p->output_string,"");
+ 
+    p->constr = NULL;
+    p->func = NULL;
+    p->heur = NULL;
+    
+    p->phi = 0;
+    p->gphi = NULL;
+    p->Hphi = NULL;
+    
+    p->b = NULL;
+    p->A = NULL;
+    
+    p->l = NULL;
+    p->u = NULL;
+    p->G = NULL;
+
+    p->simple_bounds = FALSE;
+    p->x_l = NULL;
+    p->x_u = NULL;
+    
+    p->f = NULL;
+    p->J = NULL;
+    p->H_combined = NULL;
+
+    p->num_extra_vars = 0;
+
+    p->decompose = FALSE;
+    p->num_blocks = 0;
+    p->var_block = NULL;
+    p->A_row_block = NULL;
+    p->J_row_block = NULL;
+    p->G_row_block = NULL;
+
+    p->num_islands = 0;
+    p->num_runs = 0;
+    p->run_start = NULL;
+    p->island_run_ptr = NULL;
+    p->island_runs = NULL;
+    p->num_island_constrs = 0;
+    p->num_island_funcs = 0;
+    p->constr_counters = NULL;
+    p->func_counters = NULL;
+
+    p->period_decompose = FALSE;
+    p->var_period = NULL;
+    p->A_row_period = NULL;
+    p->J_row_period = NULL;
+    p->G_row_period = NULL;
+
+    p->compact = FALSE;
+    p->J_map = NULL;
+    p->Hphi_map = NULL;
+    p->H_combined_map = NULL;
+
+    p->color = FALSE;
+    p->num_J_colors = 0;
+    p->J_color = NULL;
+    p->num_H_colors = 0;
+    p->H_color = NULL;
+  }
+}
+
+Prob* PROB_new(Net* net) {
+  Prob* p = (Prob*)malloc(sizeof(Prob));
+  p->net = net;
+  PROB_init(p);
+  return p;
+}
+
+char* PROB_get_show_str(Prob* p) {
+
+  Func* f;
+  Constr* c;
+  char* out;
+
+  if (!p)
+    return NULL;
+
+  out = p->output_string;
+  strcpy(out,"");
+
+  sprintf(out+strlen(out),"\nProblem\n");
+  sprintf(out+strlen(out),"functions: %d\n",FUNC_list_len(p->func));
+  for (f = p->func; f != NULL; f = FUNC_get_next(f))
+    sprintf(out+strlen(out),"   %s\n",FUNC_get_name(f));
+  sprintf(out+strlen(out),"constraints: %d\n",CONSTR_list_len(p->constr));  
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+    sprintf(out+strlen(out),"   %s\n",CONSTR_get_name(c));
+
+  return out;
+}
+
+void PROB_show(Prob* p) {
+  
+  printf("%s",PROB_get_show_str(p));
+}
+
+int PROB_screen_branches(Prob* p, Vec* values, REAL fraction) {
+  /** Screens the branches of the constraints in active-set mode
+   *  (see CONSTR_screen_branches). Returns the total number of added
+   *  pairs of branch and time period. The problem must be analyzed
+   *  again if this number is positive.
+   */
+
+  // Local variables
+  Constr* c;
+  int num_added = 0;
+
+  // No p
+  if (!p)
+    return 0;
+
+  // Screen
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+    num_added += CONSTR_screen_branches(c,values,fraction);
+  PROB_copy_list_errors(p);
+  return num_added;
+}
+
+void PROB_set_coloring(Prob* p, BOOL flag) {
+  /** Enables or disables the coloring of the columns of J and of the
+   *  Hessian of the Lagrangian during PROB_analyze. See PROB_update_colors.
+   */
+  if (p)
+    p->color = flag;
+}
+
+void PROB_set_duplicate_compaction(Prob* p, BOOL flag) {
+  /** Enables or disables summing duplicate (i,j) entries of J, Hphi
+   *  and H_combined during PROB_analyze. See PROB_compact_nonlin.
+   */
+  if (p)
+    p->compact = flag;
+}
+
+void PROB_set_island_decomposition(Prob* p, BOOL flag) {
+  /** Enables or disables the computation of independent blocks
+   *  during PROB_analyze (see PROB_update_blocks). With several islands,
+   *  it also runs the steps of the island safe constraints and functions
+   *  per island in PROB_analyze and PROB_eval (see PROB_run_island_steps).
+   */
+  if (p)
+    p->decompose = flag;
+}
+
+void PROB_set_period_decomposition(Prob* p, BOOL flag) {
+  /** Enables or disables the computation of the time periods of
+   *  variables and rows during PROB_analyze. See PROB_update_periods.
+   */
+  if (p)
+    p->period_decompose = flag;
+}
+
+void PROB_set_simple_bounds(Prob* p, BOOL flag) {
+  /** Enables or disables emitting the bounds of the "variable bounds"
+   *  constraint as dense vectors x_l and x_u over the primal variables
+   *  instead of as rows of G. Takes effect during PROB_analyze.
+   */
+  if (p)
+    p->simple_bounds = flag;
+}
+
+void PROB_shift_periods(Prob* p, int k, char* profiles) {
+  /** Moves the network data k periods back (see NET_shift_periods)
+   *  and refreshes the problem data, keeping its structure.
+   */
+
+  // No p
+  if (!p)
+    return;
+
+  // Network
+  NET_shift_periods(p->net,k,profiles);
+  if (NET_has_error(p->net)) {
+    strcpy(p->error_string,NET_get_error_string(p->net));
+    p->error_flag = TRUE;
+    return;
+  }
+
+  // Data
+  PROB_update_data(p);
+}
+
+BOOL PROB_has_island_steps(Prob* p) {
+  /** Determines whether the steps of the constraints and functions
+   *  that are island safe run per island (see PROB_update_islands).
+   */
+
+  // Local variables
+  Constr* c;
+  Func* f;
+  int nc;
+  int nf;
+
+  // Check
+  if (!p || !p->run_start)
+    return FALSE;
+
+  // Counts
+  nc = 0;
+  nf = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+    nc += CONSTR_is_island_safe(c) ? 1 : 0;
+  for (f = p->func; f != NULL; f = FUNC_get_next(f))
+    nf += FUNC_is_island_safe(f) ? 1 : 0;
+  return (nc == p->num_island_constrs && nf == p->num_island_funcs);
+}
+
+BOOL PROB_run_island_steps(Prob* p, Vec* x, Vec** ve) {
+  /** Runs the analyze steps (x is NULL) or the eval steps of the
+   *  constraints and functions that are island safe, with the islands
+   *  on separate threads if OpenMP is available. Each island works on
+   *  views of the constraints and functions (see CONSTR_new_view and
+   *  FUNC_new_view) whose counters are set at the start of each run to
+   *  the values recorded during the count, so every entry ends up where
+   *  the serial traversal of the branches puts it. The values of the
+   *  functions are added up in island order afterwards. The array ve has
+   *  the extra variables of each constraint of the list. Returns TRUE if
+   *  there was an error.
+   */
+
+  // Local variables
+  Constr** cviews;
+  Func** fviews;
+  Constr* cview;
+  Func* fview;
+  Vec** cve;
+  Constr* c;
+  Func* f;
+  Branch* br;
+  int num_islands;
+  int num_slots;
+  int slot;
+  int nc;
+  int nf;
+  int T;
+  int i;
+  int j;
+  int k;
+  int n;
+  int r;
+  int t;
+
+  // Check
+  if (!p || !p->run_start)
+    return FALSE;
+
+  // Sizes
+  num_islands = p->num_islands;
+  T = NET_get_num_periods(p->net);
+  num_slots = T*p->num_runs+1;
+  nc = p->num_island_constrs;
+  nf = p->num_island_funcs;
+
+  // Extra variables
+  ARRAY_zalloc(cve,Vec*,nc+1);
+  n = 0;
+  j = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c), j++) {
+    if (CONSTR_is_island_safe(c))
+      cve[n++] = ve ? ve[j] : NULL;
+  }
+
+  // Views
+  ARRAY_zalloc(cviews,Constr*,num_islands*nc+1);
+  ARRAY_zalloc(fviews,Func*,num_islands*nf+1);
+  for (i = 0; i < num_islands; i++) {
+    if (p->island_run_ptr[i] == p->island_run_ptr[i+1])
+      continue;
+    n = 0;
+    for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+      if (CONSTR_is_island_safe(c))
+	cviews[i*nc+n++] = CONSTR_new_view(c);
+    }
+    n = 0;
+    for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+      if (FUNC_is_island_safe(f))
+	fviews[i*nf+n++] = FUNC_new_view(f);
+    }
+  }
+
+  // Steps
+#ifdef _OPENMP
+#pragma omp parallel for private(br,slot,j,k,n,r,t) schedule(dynamic,1)
+#endif
+  for (i = 0; i < num_islands; i++) {
+    for (t = 0; t < T; t++) {
+      for (j = p->island_run_ptr[i]; j < p->island_run_ptr[i+1]; j++) {
+	r = p->island_runs[j];
+	slot = t*p->num_runs+r;
+	for (n = 0; n < nc; n++)
+	  CONSTR_set_counters(cviews[i*nc+n],&(p->constr_counters[(n*num_slots+slot)*CONSTR_NUM_COUNTERS]));
+	for (n = 0; n < nf; n++)
+	  FUNC_set_Hphi_nnz(fviews[i*nf+n],p->func_counters[n*num_slots+slot]);
+	for (k = p->run_start[r]; k < p->run_start[r+1]; k++) {
+	  br = NET_get_branch(p->net,k);
+	  for (n = 0; n < nc; n++) {
+	    if (x)
+	      CONSTR_eval_step(cviews[i*nc+n],br,t,x,cve[n]);
+	    else
+	      CONSTR_analyze_step(cviews[i*nc+n],br,t);
+	  }
+	  for (n = 0; n < nf; n++) {
+	    if (x)
+	      FUNC_eval_step(fviews[i*nf+n],br,t,x);
+	    else
+	      FUNC_analyze_step(fviews[i*nf+n],br,t);
+	  }
+	}
+      }
+    }
+  }
+
+  // Errors, values and views
+  for (i = 0; i < num_islands; i++) {
+    n = 0;
+    for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+      if (!CONSTR_is_island_safe(c))
+	continue;
+      cview = cviews[i*nc+n++];
+      if (!cview)
+	continue;
+      if (CONSTR_has_error(cview) && !p->error_flag) {
+	strcpy(p->error_string,CONSTR_get_error_string(cview));
+	p->error_flag = TRUE;
+      }
+      CONSTR_del(cview);
+    }
+    n = 0;
+    for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+      if (!FUNC_is_island_safe(f))
+	continue;
+      fview = fviews[i*nf+n++];
+      if (!fview)
+	continue;
+      if (FUNC_has_error(fview) && !p->error_flag) {
+	strcpy(p->error_string,FUNC_get_error_string(fview));
+	p->error_flag = TRUE;
+      }
+      FUNC_set_phi(f,FUNC_get_phi(f)+FUNC_get_phi(fview));
+      FUNC_del(fview);
+    }
+  }
+
+  // Counters after the steps
+  n = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    if (CONSTR_is_island_safe(c)) {
+      CONSTR_set_counters(c,&(p->constr_counters[(n*num_slots+num_slots-1)*CONSTR_NUM_COUNTERS]));
+      n++;
+    }
+  }
+  n = 0;
+  for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+    if (FUNC_is_island_safe(f)) {
+      FUNC_set_Hphi_nnz(f,p->func_counters[n*num_slots+num_slots-1]);
+      n++;
+    }
+  }
+
+  // Clean up
+  free(cve);
+  free(cviews);
+  free(fviews);
+  return p->error_flag;
+}
+
+void PROB_run_serial_steps(Prob* p, Branch* br, int t, Vec* x, Vec** ve) {
+  /** Runs the analyze step (x is NULL) or the eval step of the branch
+   *  for the constraints and functions that are not island safe, which
+   *  are left out of PROB_run_island_steps. The array ve has the extra
+   *  variables of each constraint of the list.
+   */
+
+  // Local variables
+  Constr* c;
+  Func* f;
+  int j;
+
+  // Check
+  if (!p)
+    return;
+
+  // Constraints
+  j = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c), j++) {
+    if (CONSTR_is_island_safe(c))
+      continue;
+    if (x)
+      CONSTR_eval_step(c,br,t,x,ve ? ve[j] : NULL);
+    else
+      CONSTR_analyze_step(c,br,t);
+  }
+
+  // Functions
+  for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+    if (FUNC_is_island_safe(f))
+      continue;
+    if (x)
+      FUNC_eval_step(f,br,t,x);
+    else
+      FUNC_analyze_step(f,br,t);
+  }
+}
+
+void PROB_store_island_counters(Prob* p, int slot) {
+  /** Records the counters of the constraints and functions that are
+   *  island safe in the given slot of the tables of counters, which is
+   *  t*num_runs+r at the start of run r of period t, and T*num_runs
+   *  after the steps.
+   */
+
+  // Local variables
+  Constr* c;
+  Func* f;
+  int num_slots;
+  int n;
+
+  // Check
+  if (!p || !p->run_start)
+    return;
+
+  // Slots
+  num_slots = NET_get_num_periods(p->net)*p->num_runs+1;
+
+  // Constraints
+  n = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    if (CONSTR_is_island_safe(c)) {
+      CONSTR_get_counters(c,&(p->constr_counters[(n*num_slots+slot)*CONSTR_NUM_COUNTERS]));
+      n++;
+    }
+  }
+
+  // Functions
+  n = 0;
+  for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+    if (FUNC_is_island_safe(f)) {
+      p->func_counters[n*num_slots+slot] = FUNC_get_Hphi_nnz(f);
+      n++;
+    }
+  }
+}
+
+void PROB_update_islands(Prob* p) {
+  /** Splits the branches into runs of consecutive branches of the same
+   *  island for the island-parallel steps of PROB_analyze and PROB_eval
+   *  (see PROB_run_island_steps). Branches on outage join the run before
+   *  them. Nothing is done unless island decomposition is enabled and
+   *  the network has more than one island.
+   */
+
+  // Local variables
+  Constr* c;
+  Func* f;
+  Branch* br;
+  int* run_island;
+  int* next;
+  int num_branches;
+  int num_islands;
+  int num_slots;
+  int island;
+  int k;
+  int r;
+
+  // Check
+  if (!p)
+    return;
+
+  // Clear
+  PROB_del_islands(p);
+
+  // Islands
+  if (!p->decompose || NET_get_num_islands(p->net) < 2)
+    return;
+  num_islands = NET_get_num_islands(p->net);
+  num_branches = NET_get_num_branches(p->net);
+  p->num_islands = num_islands;
+
+  // Runs
+  ARRAY_alloc(p->run_start,int,num_branches+1);
+  ARRAY_alloc(run_island,int,num_branches+1);
+  for (k = 0; k < num_branches; k++) {
+    br = NET_get_branch(p->net,k);
+    if (BRANCH_is_on_outage(br))
+      continue;
+    island = NET_get_bus_island(p->net,BUS_get_index(BRANCH_get_bus_k(br)));
+    if (p->num_runs == 0 || run_island[p->num_runs-1] != island) {
+      p->run_start[p->num_runs] = (p->num_runs == 0) ? 0 : k;
+      run_island[p->num_runs++] = island;
+    }
+  }
+  p->run_start[p->num_runs] = num_branches;
+  if (p->num_runs == 0) {
+    free(run_island);
+    PROB_del_islands(p);
+    return;
+  }
+
+  // Runs of each island
+  ARRAY_zalloc(p->island_run_ptr,int,num_islands+1);
+  ARRAY_alloc(p->island_runs,int,p->num_runs);
+  ARRAY_alloc(next,int,num_islands);
+  for (r = 0; r < p->num_runs; r++)
+    p->island_run_ptr[run_island[r]+1]++;
+  for (k = 0; k < num_islands; k++) {
+    p->island_run_ptr[k+1] += p->island_run_ptr[k];
+    next[k] = p->island_run_ptr[k];
+  }
+  for (r = 0; r < p->num_runs; r++)
+    p->island_runs[next[run_island[r]]++] = r;
+  free(run_island);
+  free(next);
+
+  // Counters
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+    p->num_island_constrs += CONSTR_is_island_safe(c) ? 1 : 0;
+  for (f = p->func; f != NULL; f = FUNC_get_next(f))
+    p->num_island_funcs += FUNC_is_island_safe(f) ? 1 : 0;
+  num_slots = NET_get_num_periods(p->net)*p->num_runs+1;
+  ARRAY_zalloc(p->constr_counters,int,p->num_island_constrs*num_slots*CONSTR_NUM_COUNTERS+1);
+  ARRAY_zalloc(p->func_counters,int,p->num_island_funcs*num_slots+1);
+}
+
+void PROB_update_blocks(Prob* p) {
+  /** Partitions the primal variables and the rows of A, J and G into
+   *  independent blocks. Two variables are in the same block if they
+   *  appear together in a row of A, J or G, or in an entry of the
+   *  Hessians of the objective or of the nonlinear constraints. When the
+   *  network is split into islands, each island (and period, for
+   *  constraints without time coupling) gives rise to its own block, so
+   *  that the permuted J and H are block-diagonal. Blocks are numbered in
+   *  order of their lowest variable index. Rows with no entries have
+   *  block index -1.
+   */
+
+  // Local variables
+  Mat* M[3];
+  int** row_block[3];
+  int* parent;
+  int* first;
+  int num_vars;
+  int a;
+  int b;
+  int i;
+  int j;
+  int k;
+  int r;
+
+  // Check
+  if (!p || !p->A || !p->J || !p->G || !p->Hphi || !p->H_combined)
+    return;
+
+  // Free
+  free(p->var_block);
+  free(p->A_row_block);
+  free(p->J_row_block);
+  free(p->G_row_block);
+
+  // Union-find forest
+  num_vars = NET_get_num_vars(p->net)+p->num_extra_vars;
+  ARRAY_alloc(parent,int,num_vars);
+  for (i = 0; i < num_vars; i++)
+    parent[i] = i;
+
+  // Linear and Jacobian rows
+  M[0] = p->A;
+  M[1] = p->J;
+  M[2] = p->G;
+  row_block[0] = &(p->A_row_block);
+  row_block[1] = &(p->J_row_block);
+  row_block[2] = &(p->G_row_block);
+  for (r = 0; r < 3; r++) {
+    ARRAY_alloc(first,int,MAT_get_size1(M[r]));
+    for (i = 0; i < MAT_get_size1(M[r]); i++)
+      first[i] = -1;
+    for (k = 0; k < MAT_get_nnz(M[r]); k++) {
+      i = MAT_get_i(M[r],k);
+      j = MAT_get_j(M[r],k);
+      if (first[i] < 0) {
+	first[i] = j;
+	continue;
+      }
+      for (a = first[i]; parent[a] != a; a = parent[a] = parent[parent[a]]);
+      for (b = j; parent[b] != b; b = parent[b] = parent[parent[b]]);
+      if (a < b)
+	parent[b] = a;
+      else if (b < a)
+	parent[a] = b;
+    }
+    *(row_block[r]) = first; // holds a variable of each row for now
+  }
+
+  // Hessians
+  M[0] = p->Hphi;
+  M[1] = p->H_combined;
+  for (r = 0; r < 2; r++) {
+    for (k = 0; k < MAT_get_nnz(M[r]); k++) {
+      for (a = MAT_get_i(M[r],k); parent[a] != a; a = parent[a] = parent[parent[a]]);
+      for (b = MAT_get_j(M[r],k); parent[b] != b; b = parent[b] = parent[parent[b]]);
+      if (a < b)
+	parent[b] = a;
+      else if (b < a)
+	parent[a] = b;
+    }
+  }
+
+  // Label variables (roots are the lowest index of each block)
+  ARRAY_alloc(p->var_block,int,num_vars);
+  p->num_blocks = 0;
+  for (i = 0; i < num_vars; i++) {
+    for (a = i; parent[a] != a; a = parent[a]);
+    if (a == i)
+      p->var_block[i] = p->num_blocks++;
+    else
+      p->var_block[i] = p->var_block[a];
+  }
+
+  // Label rows
+  M[0] = p->A;
+  M[1] = p->J;
+  M[2] = p->G;
+  for (r = 0; r < 3; r++) {
+    first = *(row_block[r]);
+    for (i = 0; i < MAT_get_size1(M[r]); i++) {
+      if (first[i] >= 0)
+	first[i] = p->var_block[first[i]];
+    }
+  }
+
+  // Clean up
+  free(parent);
+}
+
+void PROB_update_periods(Prob* p) {
+  /** Finds the time period of each primal variable and of each row of
+   *  A, J and G. A row belongs to the period of its network variables,
+   *  and rows with network variables of different periods (e.g. rows of
+   *  GEN_RAMP or BAT_DYN) have period PROB_PERIOD_COUPLING. An extra
+   *  variable belongs to the period of the rows with network variables
+   *  that contain it (e.g. those of REG_GEN), and rows with only extra
+   *  variables belong to the period of those variables. Periods that
+   *  differ give PROB_PERIOD_COUPLING. Rows with no entries and extra
+   *  variables not in any of those rows have period PROB_PERIOD_NONE.
+   */
+
+  // Local variables
+  Mat* M[3];
+  int** row_period[3];
+  int* period;
+  int num_vars;
+  int q;
+  int i;
+  int j;
+  int k;
+  int r;
+
+  // Check
+  if (!p || !p->A || !p->J || !p->G)
+    return;
+
+  // Free
+  free(p->var_period);
+  free(p->A_row_period);
+  free(p->J_row_period);
+  free(p->G_row_period);
+
+  // Network variables
+  num_vars = NET_get_num_vars(p->net);
+  period = NET_create_var_periods(p->net);
+  ARRAY_alloc(p->var_period,int,num_vars+p->num_extra_vars);
+  for (j = 0; j < num_vars; j++)
+    p->var_period[j] = period[j];
+  for (j = num_vars; j < num_vars+p->num_extra_vars; j++)
+    p->var_period[j] = PROB_PERIOD_NONE;
+  free(period);
+
+  // Rows (network variables)
+  M[0] = p->A;
+  M[1] = p->J;
+  M[2] = p->G;
+  row_period[0] = &(p->A_row_period);
+  row_period[1] = &(p->J_row_period);
+  row_period[2] = &(p->G_row_period);
+  for (r = 0; r < 3; r++) {
+    ARRAY_alloc(period,int,MAT_get_size1(M[r]));
+    for (i = 0; i < MAT_get_size1(M[r]); i++)
+      period[i] = PROB_PERIOD_NONE;
+    for (k = 0; k < MAT_get_nnz(M[r]); k++) {
+      i = MAT_get_i(M[r],k);
+      j = MAT_get_j(M[r],k);
+      if (j >= num_vars)
+	continue;
+      if (period[i] == PROB_PERIOD_NONE)
+	period[i] = p->var_period[j];
+      else if (period[i] != p->var_period[j])
+	period[i] = PROB_PERIOD_COUPLING;
+    }
+    *(row_period[r]) = period;
+  }
+
+  // Extra variables
+  for (r = 0; r < 3; r++) {
+    for (k = 0; k < MAT_get_nnz(M[r]); k++) {
+      j = MAT_get_j(M[r],k);
+      q = (*(row_period[r]))[MAT_get_i(M[r],k)];
+      if (j < num_vars || q == PROB_PERIOD_NONE)
+	continue;
+      if (p->var_period[j] == PROB_PERIOD_NONE)
+	p->var_period[j] = q;
+      else if (p->var_period[j] != q)
+	p->var_period[j] = PROB_PERIOD_COUPLING;
+    }
+  }
+
+  // Rows (only extra variables)
+  for (r = 0; r < 3; r++) {
+    ARRAY_alloc(period,int,MAT_get_size1(M[r]));
+    for (i = 0; i < MAT_get_size1(M[r]); i++)
+      period[i] = PROB_PERIOD_NONE;
+    for (k = 0; k < MAT_get_nnz(M[r]); k++) {
+      i = MAT_get_i(M[r],k);
+      q = p->var_period[MAT_get_j(M[r],k)];
+      if ((*(row_period[r]))[i] != PROB_PERIOD_NONE || q == PROB_PERIOD_NONE)
+	continue;
+      if (period[i] == PROB_PERIOD_NONE)
+	period[i] = q;
+      else if (period[i] != q)
+	period[i] = PROB_PERIOD_COUPLING;
+    }
+    for (i = 0; i < MAT_get_size1(M[r]); i++) {
+      if ((*(row_period[r]))[i] == PROB_PERIOD_NONE)
+	(*(row_period[r]))[i] = period[i];
+    }
+    free(period);
+  }
+}
+
+void PROB_update_nonlin_struc(Prob* p) {
+  /* This function fills in problem Jacobians and Hessians
+     structure with constraint structure */
+
+  // Local variables
+  Func* f;
+  Constr* c;
+  int* Hphi_i;
+  int* Hphi_j;
+  int* Hphi_i_func;
+  int* Hphi_j_func;
+  int Hphinnz;
+  int* Ji;
+  int* Jj;
+  int* Ji_constr;
+  int* Jj_constr;
+  int Jrow;
+  int Jnnz;
+  int* Hcomb_i;
+  int* Hcomb_j;
+  int* Hcomb_i_constr;
+  int* Hcomb_j_constr;
+  int Hcombnnz;
+
+  int num_vars;
+  int offset;
+  int k;
+
+  // Hphi
+  Hphinnz = 0;
+  Hphi_i = MAT_get_row_array(p->Hphi);
+  Hphi_j = MAT_get_col_array(p->Hphi);
+  for (f = p->func; f != NULL; f = FUNC_get_next(f)) {
+    Hphi_i_func = MAT_get_row_array(FUNC_get_Hphi(f));
+    Hphi_j_func = MAT_get_col_array(FUNC_get_Hphi(f));
+    for (k = 0; k < MAT_get_nnz(FUNC_get_Hphi(f)); k++) {
+      Hphi_i[Hphinnz] = Hphi_i_func[k];
+      Hphi_j[Hphinnz] = Hphi_j_func[k];
+      Hphinnz++;
+    }     
+  }
+
+  // J and Hcomb
+  Jnnz = 0;
+  Jrow = 0;
+  Ji = MAT_get_row_array(p->J);
+  Jj = MAT_get_col_array(p->J);
+  Hcombnnz = 0;
+  Hcomb_i = MAT_get_row_array(p->H_combined);
+  Hcomb_j = MAT_get_col_array(p->H_combined);
+  num_vars = NET_get_num_vars(p->net);
+  offset = num_vars;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+
+    // J
+    Ji_constr = MAT_get_row_array(CONSTR_get_J(c));
+    Jj_constr = MAT_get_col_array(CONSTR_get_J(c));
+    for (k = 0; k < MAT_get_nnz(CONSTR_get_J(c)); k++) {
+      Ji[Jnnz] = Jrow+Ji_constr[k];
+      if (Jj_constr[k] < num_vars)
+	Jj[Jnnz] = Jj_constr[k];                 // x var
+      else
 	Jj[Jnnz] = offset+Jj_constr[k]-num_vars; // y var
       Jnnz++;
     }
@@ -870,6 +2735,8 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
   VEC_set_zero(p->gphi);
   gphi = VEC_get_data(p->gphi);
   Hphi = MAT_get_data_array(p->Hphi);
+  if (p->Hphi_map)
+    MAT_set_zero_d(p->Hphi);
   for (func = p->func; func != NULL; func = FUNC_get_next(func)) {
 
     // Weight
@@ -886,7 +2753,10 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
     // Hphi
     Hphi_func = MAT_get_data_array(FUNC_get_Hphi(func));
     for (k = 0; k < MAT_get_nnz(FUNC_get_Hphi(func)); k++) {
-      Hphi[Hphinnz] = weight*Hphi_func[k];
+      if (p->Hphi_map)
+	Hphi[p->Hphi_map[Hphinnz]] += weight*Hphi_func[k];
+      else
+	Hphi[Hphinnz] = weight*Hphi_func[k];
       Hphinnz++;
     }     
   }
@@ -896,6 +2766,8 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
   Jrow = 0;
   f = VEC_get_data(p->f);
   J = MAT_get_data_array(p->J);
+  if (p->J_map)
+    MAT_set_zero_d(p->J);
   for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
     
     // J, f of constraint
@@ -909,7 +2781,10 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
 
     // Update J 
     for (k = 0; k < MAT_get_nnz(CONSTR_get_J(c)); k++) {
-      J[Jnnz] = J_constr[k];
+      if (p->J_map)
+	J[p->J_map[Jnnz]] += J_constr[k];
+      else
+	J[Jnnz] = J_constr[k];
       Jnnz++;
     }
 
@@ -918,6 +2793,112 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
   }
 }
 
+void PROB_update_data(Prob* p) {
+  /** Refreshes the data of constraints and functions (A, b, G, l, u
+   *  and constant terms) after changes of network data that leave
+   *  flags unchanged. Counts, allocations, offsets and sparsity
+   *  structure of the last analysis are kept.
+   */
+
+  // Local variables
+  Branch* br;
+  Constr* c;
+  Func* f;
+  int k;
+  int t;
+
+  // No p
+  if (!p)
+    return;
+
+  // Check
+  if (!p->gphi || VEC_get_size(p->gphi) != NET_get_num_vars(p->net)+p->num_extra_vars) {
+    strcpy(p->error_string,"problem must be analyzed");
+    p->error_flag = TRUE;
+    return;
+  }
+
+  // Clear (analysis accumulates into freshly allocated data)
+  CONSTR_list_clear(p->constr);
+  FUNC_list_clear(p->func);
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    VEC_set_zero(CONSTR_get_b(c));
+    VEC_set_zero(CONSTR_get_l(c));
+    VEC_set_zero(CONSTR_get_u(c));
+    MAT_set_zero_d(CONSTR_get_A(c));
+    MAT_set_zero_d(CONSTR_get_G(c));
+  }
+  for (f = p->func; f != NULL; f = FUNC_get_next(f))
+    MAT_set_zero_d(FUNC_get_Hphi(f));
+
+  // Analyze
+  for (t = 0; t < NET_get_num_periods(p->net); t++) {
+    for (k = 0; k < NET_get_num_branches(p->net); k++) {
+
+      br = NET_get_branch(p->net,k);
+
+      // Constraints
+      CONSTR_list_analyze_step(p->constr,br,t);
+      if (CONSTR_list_has_error(p->constr)) {
+	strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
+	p->error_flag = TRUE;
+	return;
+      }
+
+      // Functions
+      FUNC_list_analyze_step(p->func,br,t);
+      if (FUNC_list_has_error(p->func)) {
+	strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+	p->error_flag = TRUE;
+	return;
+      }
+    }
+  }
+  CONSTR_list_analyze_batch(p->constr);
+  FUNC_list_analyze_batch(p->func);
+  if (PROB_copy_list_errors(p))
+    return;
+  CONSTR_list_finalize_structure_of_Hessians(p->constr);
+  FUNC_list_finalize_structure_of_Hessian(p->func);
+
+  // Update
+  PROB_update_lin(p);
+  PROB_update_bounds(p);
+}
+
+void PROB_update_bounds(Prob* p) {
+  /** Fills simple bounds x_l and x_u (if allocated) with the bounds of
+   *  the network variables followed by the ones of the extra variables
+   *  of the constraints.
+   */
+
+  // Local variables
+  Constr* c;
+  Vec* l_extra;
+  Vec* u_extra;
+  int offset;
+  int j;
+
+  // Check
+  if (!p || !p->x_l || !p->x_u)
+    return;
+
+  // Network variables
+  CONSTR_LBOUND_get_bounds(PROB_find_constr(p,"variable bounds"),p->x_l,p->x_u);
+
+  // Extra variables
+  offset = NET_get_num_vars(p->net);
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    l_extra = CONSTR_get_l_extra_vars(c);
+    u_extra = CONSTR_get_u_extra_vars(c);
+    for (j = 0; j < CONSTR_get_num_extra_vars(c); j++) {
+      VEC_set(p->x_l,offset+j,VEC_get(l_extra,j));
+      VEC_set(p->x_u,offset+j,VEC_get(u_extra,j));
+    }
+    offset += CONSTR_get_num_extra_vars(c);
+  }
+}
+
 void PROB_update_lin(Prob* p) {
   /* This function updates problem A,b,G,l,u with 
      constraint A,b,G,l,u. */
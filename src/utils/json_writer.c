@@ -0,0 +1,214 @@
+/** @file json_writer.c
+ *  @brief This file defines the JSON_Writer data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <pfnet/json_writer.h>
+#include <pfnet/pfnet_config.h>
+#include <pfnet/utils.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+struct JSON_Writer {
+
+  // Buffer
+  char* buffer;   /**< @brief Output buffer */
+  size_t size;    /**< @brief Allocated size of buffer */
+  size_t len;     /**< @brief Number of characters in buffer */
+  size_t total;   /**< @brief Number of characters written so far */
+
+  // Destination
+  FILE* file;     /**< @brief Output file (NULL if none) */
+  int fd;         /**< @brief Output file descriptor (-1 if none) */
+
+  // Error
+  BOOL error_flag; /**< @brief Write error flag */
+};
+
+void JSON_WRITER_del(JSON_Writer* w) {
+  if (w) {
+    JSON_WRITER_flush(w);
+    free(w->buffer);
+    free(w);
+  }
+}
+
+void JSON_WRITER_flush(JSON_Writer* w) {
+  /** Sends buffered characters to the file or file descriptor
+   *  of the writer. Writers without destination keep growing
+   *  their buffer instead.
+   */
+
+  // Local variables
+  size_t done = 0;
+#ifdef HAVE_UNISTD_H
+  ssize_t n;
+#endif
+
+  // No writer or destination
+  if (!w || w->len == 0 || (!w->file && w->fd < 0))
+    return;
+
+  // File
+  if (w->file) {
+    if (fwrite(w->buffer,1,w->len,w->file) != w->len)
+      w->error_flag = TRUE;
+  }
+
+  // File descriptor
+  else {
+#ifdef HAVE_UNISTD_H
+    while (done < w->len) {
+      n = write(w->fd,w->buffer+done,w->len-done);
+      if (n <= 0) {
+	w->error_flag = TRUE;
+	break;
+      }
+      done += (size_t)n;
+    }
+#else
+    w->error_flag = TRUE;
+#endif
+  }
+  w->len = 0;
+  w->buffer[0] = '\0';
+}
+
+size_t JSON_WRITER_get_length(JSON_Writer* w) {
+  if (w)
+    return w->total;
+  else
+    return 0;
+}
+
+char* JSON_WRITER_get_string(JSON_Writer* w) {
+  if (w)
+    return w->buffer;
+  else
+    return NULL;
+}
+
+BOOL JSON_WRITER_has_error(JSON_Writer* w) {
+  if (w)
+    return w->error_flag;
+  else
+    return FALSE;
+}
+
+JSON_Writer* JSON_WRITER_new(void) {
+  /** Creates writer that accumulates output in a growable buffer. */
+
+  JSON_Writer* w = (JSON_Writer*)malloc(sizeof(JSON_Writer));
+  w->size = JSON_WRITER_BUFFER_SIZE/16;
+  w->buffer = (char*)malloc(sizeof(char)*w->size);
+  w->buffer[0] = '\0';
+  w->len = 0;
+  w->total = 0;
+  w->file = NULL;
+  w->fd = -1;
+  w->error_flag = FALSE;
+  return w;
+}
+
+JSON_Writer* JSON_WRITER_new_for_fd(int fd) {
+  /** Creates writer that sends output to a file descriptor
+   *  in chunks of at most JSON_WRITER_BUFFER_SIZE characters.
+   */
+
+  JSON_Writer* w = JSON_WRITER_new();
+  w->size = JSON_WRITER_BUFFER_SIZE;
+  w->buffer = (char*)realloc(w->buffer,sizeof(char)*w->size);
+  w->fd = fd;
+  return w;
+}
+
+JSON_Writer* JSON_WRITER_new_for_file(FILE* file) {
+  /** Creates writer that sends output to a file
+   *  in chunks of at most JSON_WRITER_BUFFER_SIZE characters.
+   */
+
+  JSON_Writer* w = JSON_WRITER_new();
+  w->size = JSON_WRITER_BUFFER_SIZE;
+  w->buffer = (char*)realloc(w->buffer,sizeof(char)*w->size);
+  w->file = file;
+  return w;
+}
+
+char* JSON_WRITER_release_string(JSON_Writer* w) {
+  /** Returns buffered output trimmed to size and leaves the
+   *  writer empty. The caller is responsible for freeing it.
+   */
+
+  // Local variables
+  char* s;
+
+  // No writer
+  if (!w)
+    return NULL;
+
+  // Release
+  s = (char*)realloc(w->buffer,sizeof(char)*(w->len+1)); // +1 important!
+  w->size = JSON_WRITER_BUFFER_SIZE/16;
+  w->buffer = (char*)malloc(sizeof(char)*w->size);
+  w->buffer[0] = '\0';
+  w->len = 0;
+  return s;
+}
+
+void JSON_WRITER_write(JSON_Writer* w, char* data, size_t len) {
+
+  // No writer
+  if (!w)
+    return;
+
+  // Make room
+  if (w->len+len+1 > w->size) {
+    JSON_WRITER_flush(w);
+    if (w->len+len+1 > w->size) {
+      while (w->len+len+1 > w->size)
+	w->size *= 2;
+      w->buffer = (char*)realloc(w->buffer,sizeof(char)*w->size);
+    }
+  }
+
+  // Copy
+  memcpy(w->buffer+w->len,data,len);
+  w->len += len;
+  w->total += len;
+  w->buffer[w->len] = '\0';
+}
+
+void JSON_WRITER_write_char(JSON_Writer* w, char c) {
+  if (w && w->len+2 <= w->size) {
+    w->buffer[w->len++] = c;
+    w->buffer[w->len] = '\0';
+    w->total++;
+  }
+  else
+    JSON_WRITER_write(w,&c,1);
+}
+
+void JSON_WRITER_write_float(JSON_Writer* w, REAL v) {
+  /** Writes number like "%.10e". */
+  char temp[JSON_WRITER_NUMBER_SIZE];
+  JSON_WRITER_write(w,temp,fast_ftoa(temp,v));
+}
+
+void JSON_WRITER_write_int(JSON_Writer* w, int v) {
+  char temp[JSON_WRITER_NUMBER_SIZE];
+  JSON_WRITER_write(w,temp,fast_itoa(temp,v));
+}
+
+void JSON_WRITER_write_str(JSON_Writer* w, char* s) {
+  if (s)
+    JSON_WRITER_write(w,s,strlen(s));
+  else
+    JSON_WRITER_write(w,"(null)",6);
+}
@@ -51,3 +51,209 @@ char* strtolower(char s[]) {
   }
   return s;
 }
+
+double fast_atof(char* s) {
+  /* Converts string to double like atof. Numbers with at most 15
+   * significant digits and small exponents are converted with a single
+   * correctly rounded operation (exact like strtod). Other strings are
+   * passed to strtod. */
+
+  static const double pow10[] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,
+				 1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,
+				 1e20,1e21,1e22};
+  char* c = s;
+  unsigned long long m = 0;
+  int num_digits = 0;
+  int num_sig = 0;
+  int exp = 0;
+  int exp_val = 0;
+  int exp_sign = 1;
+  int neg = 0;
+  char* e;
+  double v;
+
+  while (isspace((unsigned char)*c))
+    c++;
+  if (*c == '-' || *c == '+') {
+    neg = (*c == '-');
+    c++;
+  }
+  while (*c >= '0' && *c <= '9') {
+    if (m || *c != '0') {
+      m = 10*m+(*c-'0');
+      num_sig++;
+    }
+    num_digits++;
+    c++;
+  }
+  if (num_digits == 1 && m == 0 && (*c == 'x' || *c == 'X'))
+    return atof(s);
+  if (*c == '.') {
+    c++;
+    while (*c >= '0' && *c <= '9') {
+      if (m || *c != '0') {
+	m = 10*m+(*c-'0');
+	num_sig++;
+      }
+      num_digits++;
+      exp--;
+      c++;
+    }
+  }
+  if (num_digits == 0 || num_sig > 15)
+    return atof(s);
+  if (*c == 'e' || *c == 'E') {
+    e = c+1;
+    if (*e == '-' || *e == '+') {
+      exp_sign = (*e == '-') ? -1 : 1;
+      e++;
+    }
+    if (*e >= '0' && *e <= '9') {
+      while (*e >= '0' && *e <= '9') {
+	if (exp_val < 10000)
+	  exp_val = 10*exp_val+(*e-'0');
+	e++;
+      }
+      exp += exp_sign*exp_val;
+    }
+  }
+  if (m == 0)
+    return neg ? -0. : 0.;
+  if (exp < -22 || exp > 22)
+    return atof(s);
+  if (exp < 0)
+    v = (double)m/pow10[-exp];
+  else
+    v = (double)m*pow10[exp];
+  return neg ? -v : v;
+}
+
+int fast_atoi(char* s) {
+  /* Converts string to int like atoi. */
+
+  char* c = s;
+  long v = 0;
+  int neg = 0;
+
+  while (isspace((unsigned char)*c))
+    c++;
+  if (*c == '-' || *c == '+') {
+    neg = (*c == '-');
+    c++;
+  }
+  while (*c >= '0' && *c <= '9' && v < 100000000000L) {
+    v = 10*v+(*c-'0');
+    c++;
+  }
+  if (*c >= '0' && *c <= '9')
+    return atoi(s);
+  return (int)(neg ? -v : v);
+}
+
+int fast_itoa(char* s, int v) {
+  /* Writes integer to string like sprintf(s,"%d",v) and returns
+   * number of characters written. */
+
+  char digits[12];
+  unsigned int u;
+  int n = 0;
+  int len = 0;
+
+  if (v < 0) {
+    s[len++] = '-';
+    u = 0U-(unsigned int)v;
+  }
+  else
+    u = (unsigned int)v;
+  do {
+    digits[n++] = (char)('0'+u%10);
+    u /= 10;
+  } while (u);
+  while (n > 0)
+    s[len++] = digits[--n];
+  s[len] = '\0';
+  return len;
+}
+
+int fast_ftoa(char* s, double x) {
+  /* Writes double to string like sprintf(s,"%.10e",x) and returns
+   * number of characters written. The 11 significant digits come from
+   * a single scaling by an exact power of ten in extended precision,
+   * whose error is far smaller than the distance to the rounding point
+   * except near ties. Ties, very large or small magnitudes, and
+   * non-finite values are passed to sprintf. */
+
+#if LDBL_MANT_DIG >= 64
+  static const long double pow10[] = {1e0L,1e1L,1e2L,1e3L,1e4L,1e5L,1e6L,1e7L,1e8L,
+				      1e9L,1e10L,1e11L,1e12L,1e13L,1e14L,1e15L,1e16L,
+				      1e17L,1e18L,1e19L,1e20L,1e21L,1e22L,1e23L,1e24L,
+				      1e25L,1e26L,1e27L};
+  unsigned long long m;
+  long double y;
+  long double f;
+  double a;
+  int len = 0;
+  int e;
+  int k;
+  int i;
+
+  if (x != x || x-x != 0.)
+    return sprintf(s,"%.10e",x);
+  if (signbit(x))
+    s[len++] = '-';
+  a = fabs(x);
+  if (a == 0.) {
+    strcpy(s+len,"0.0000000000e+00");
+    return len+16;
+  }
+
+  // Exponent
+  frexp(a,&e);
+  e = (int)floor((e-1)*0.30102999566398120);
+  while (1) {
+    k = 10-e;
+    if (k < -27 || k > 27)
+      return sprintf(s,"%.10e",x);
+    y = (k >= 0) ? (long double)a*pow10[k] : (long double)a/pow10[-k];
+    if (y >= 1e11L)
+      e++;
+    else if (y < 1e10L)
+      e--;
+    else
+      break;
+  }
+
+  // Digits
+  m = (unsigned long long)y;
+  f = y-(long double)m;
+  if (f > 0.5L-1e-6L && f < 0.5L+1e-6L)
+    return sprintf(s,"%.10e",x);
+  if (f > 0.5L)
+    m++;
+  if (m == 100000000000ULL) {
+    m = 10000000000ULL;
+    e++;
+  }
+  for (i = 11; i >= 2; i--) {
+    s[len+i] = (char)('0'+m%10);
+    m /= 10;
+  }
+  s[len] = (char)('0'+m);
+  s[len+1] = '.';
+  len += 12;
+
+  // Exponent
+  s[len++] = 'e';
+  s[len++] = (e < 0) ? '-' : '+';
+  if (e < 0)
+    e = -e;
+  if (e >= 100)
+    s[len++] = (char)('0'+e/100);
+  s[len++] = (char)('0'+(e/10)%10);
+  s[len++] = (char)('0'+e%10);
+  s[len] = '\0';
+  return len;
+#else
+  return sprintf(s,"%.10e",x);
+#endif
+}
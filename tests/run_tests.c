@@ -22,11 +22,21 @@ static char * all_tests() {
   // Network
   run_test(test_net_new);
   run_test(test_net_load);
+  run_test(test_net_load_fast);
+  run_test(test_net_binary);
+  run_test(test_net_json_writer);
+  run_test(test_net_json_parser);
+  run_test(test_net_load_profiles);
+  run_test(test_net_series);
   run_test(test_net_check);
   run_test(test_net_variables);
   run_test(test_net_fixed);
   run_test(test_net_properties);
   run_test(test_net_init_point);
+  run_test(test_net_adjacency);
+  run_test(test_net_islands);
+  run_test(test_net_var_ordering);
+  run_test(test_net_reduction);
 
   // Graph
   run_test(test_graph_basic);
@@ -37,15 +47,28 @@ static char * all_tests() {
   run_test(test_constr_PAR_GEN_P);
   run_test(test_constr_PAR_GEN_Q);
   run_test(test_constr_ACPF);
+  run_test(test_constr_ACPF_fixed);
   run_test(test_constr_REG_GEN);
   run_test(test_constr_REG_TRAN);
   run_test(test_constr_REG_SHUNT);
+  run_test(test_constr_periodic);
+  run_test(test_constr_active_set);
 
   // Functions
   run_test(test_func_GEN_COST);
 
   // Problem
   run_test(test_problem_basic);
+  run_test(test_problem_islands);
+  run_test(test_problem_island_steps);
+  run_test(test_problem_shift_periods);
+  run_test(test_problem_batch);
+  run_test(test_problem_periods);
+  run_test(test_problem_simple_bounds);
+  run_test(test_problem_Jv);
+  run_test(test_problem_Hv);
+  run_test(test_problem_duplicate_compaction);
+  run_test(test_problem_estimates);
   
   return 0;
 }
@@ -930,3 +930,285 @@ static char* test_constr_REG_SHUNT() {
   printf("ok\n");
   return 0;
 }
+
+static char* test_constr_periodic() {
+
+  // Local variables
+  Parser* parser;
+  Net* net;
+  Constr* c[2];
+  Mat* M[2];
+  Vec* v[2];
+  int ordering;
+  int type;
+  int i;
+  int k;
+  int T = 3;
+
+  printf("test_constr_periodic ...");
+
+  for (ordering = NET_ORDER_NATURAL; ordering <= NET_ORDER_RCM; ordering++) {
+
+    // Load
+    parser = PARSER_new_for_file(test_case);
+    net = PARSER_parse(parser,test_case,T);
+    PARSER_del(parser);
+    Assert("error - invalid number of periods",NET_get_num_periods(net) == T);
+
+    // Set flags
+    NET_set_flags(net,OBJ_BUS,
+		  FLAG_VARS,
+		  BUS_PROP_NOT_SLACK,
+		  BUS_VAR_VANG);
+    NET_set_flags(net,OBJ_GEN,
+		  FLAG_VARS,
+		  GEN_PROP_ANY,
+		  GEN_VAR_P);
+    NET_set_flags(net,OBJ_BRANCH,
+		  FLAG_VARS,
+		  BRANCH_PROP_PHASE_SHIFTER,
+		  BRANCH_VAR_PHASE);
+    NET_add_batteries(net,NET_get_gen_buses(net),20.,40.,0.8,0.7);
+    NET_set_flags(net,OBJ_BAT,
+		  FLAG_VARS,
+		  BAT_PROP_ANY,
+		  BAT_VAR_P);
+    NET_set_var_ordering(net,ordering);
+    Assert("error - no variables",NET_get_num_vars(net) > 0);
+
+    for (type = 0; type < 2; type++) {
+
+      // Periodic and full analysis
+      for (k = 0; k < 2; k++) {
+	c[k] = (type == 0) ? CONSTR_DCPF_new(net) : CONSTR_DC_FLOW_LIM_new(net);
+	Assert("error - structure should be periodic",CONSTR_has_periodic_structure(c[k]));
+	if (k == 1)
+	  CONSTR_set_periodic_structure(c[k],FALSE);
+	CONSTR_count(c[k]);
+	CONSTR_allocate(c[k]);
+	CONSTR_analyze(c[k]);
+	Assert(CONSTR_get_error_string(c[k]),!CONSTR_has_error(c[k]));
+      }
+      Assert("error - bad A nnz",CONSTR_get_A_nnz(c[0]) == CONSTR_get_A_nnz(c[1]));
+      Assert("error - bad G nnz",CONSTR_get_G_nnz(c[0]) == CONSTR_get_G_nnz(c[1]));
+      Assert("error - bad G row",CONSTR_get_G_row(c[0]) == CONSTR_get_G_row(c[1]));
+
+      // Same matrices
+      for (k = 0; k < 2; k++) {
+	M[k] = (type == 0) ? CONSTR_get_A(c[k]) : CONSTR_get_G(c[k]);
+	v[k] = (type == 0) ? CONSTR_get_b(c[k]) : CONSTR_get_u(c[k]);
+      }
+      Assert("error - bad nnz",MAT_get_nnz(M[0]) == MAT_get_nnz(M[1]));
+      Assert("error - bad size",MAT_get_size1(M[0]) == MAT_get_size1(M[1]));
+      for (i = 0; i < MAT_get_nnz(M[0]); i++) {
+	Assert("error - bad row",MAT_get_i(M[0],i) == MAT_get_i(M[1],i));
+	Assert("error - bad col",MAT_get_j(M[0],i) == MAT_get_j(M[1],i));
+	Assert("error - bad value",MAT_get_d(M[0],i) == MAT_get_d(M[1],i));
+      }
+      Assert("error - bad size",VEC_get_size(v[0]) == VEC_get_size(v[1]));
+      for (i = 0; i < VEC_get_size(v[0]); i++)
+	Assert("error - bad vector",VEC_get(v[0],i) == VEC_get(v[1],i));
+
+      CONSTR_del(c[0]);
+      CONSTR_del(c[1]);
+    }
+
+    NET_del(net);
+  }
+
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_constr_active_set() {
+
+  // Local variables
+  Parser* parser;
+  Net* net;
+  Constr* c[2];
+  Branch* br;
+  Vec* x;
+  int num_rows[2];
+  int num_added;
+  int type;
+  int i;
+  int k;
+  int t;
+  int T = 2;
+
+  printf("test_constr_active_set ...");
+
+  // Load
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,T);
+  PARSER_del(parser);
+
+  // Set flags
+  NET_set_flags(net,OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  x = NET_get_var_values(net,CURRENT);
+
+  for (type = 0; type < 2; type++) {
+
+    // Full and active-set constraints
+    for (k = 0; k < 2; k++) {
+      c[k] = (type == 0) ? CONSTR_AC_FLOW_LIM_new(net) : CONSTR_DC_FLOW_LIM_new(net);
+      Assert("error - active set",!CONSTR_has_active_set(c[k]));
+      Assert("error - bad number of active branches",CONSTR_get_num_active_branches(c[k]) == -1);
+    }
+    CONSTR_set_active_set(c[1],TRUE);
+    Assert(CONSTR_get_error_string(c[1]),!CONSTR_has_error(c[1]));
+    Assert("error - no active set",CONSTR_has_active_set(c[1]));
+    Assert("error - structure should not be periodic",!CONSTR_has_periodic_structure(c[1]));
+
+    // Empty active set
+    CONSTR_count(c[1]);
+    CONSTR_allocate(c[1]);
+    CONSTR_analyze(c[1]);
+    Assert("error - rows with empty active set",MAT_get_size1(CONSTR_get_G(c[1])) == 0);
+    Assert("error - extra vars with empty active set",CONSTR_get_num_extra_vars(c[1]) == 0);
+
+    // Partial screening
+    num_added = CONSTR_screen_branches(c[1],x,0.5);
+    Assert("error - bad number of added branches",num_added == CONSTR_get_num_active_branches(c[1]));
+    for (t = 0; t < T; t++) {
+      for (i = 0; i < NET_get_num_branches(net); i++) {
+	br = NET_get_branch(net,i);
+	if (BRANCH_is_on_outage(br) || BRANCH_get_ratingA(br) == 0.)
+	  continue;
+	if (type == 0)
+	  Assert("error - bad active branch",
+		 CONSTR_is_branch_active(c[1],br,t) ==
+		 (CONSTR_AC_FLOW_LIM_get_branch_loading(c[1],br,t,x) > 0.5));
+	else
+	  Assert("error - bad active branch",
+		 CONSTR_is_branch_active(c[1],br,t) ==
+		 (CONSTR_DC_FLOW_LIM_get_branch_loading(c[1],br,t,x) > 0.5));
+      }
+    }
+    CONSTR_count(c[1]);
+    CONSTR_allocate(c[1]);
+    CONSTR_analyze(c[1]);
+    Assert("error - bad number of rows",
+	   MAT_get_size1(CONSTR_get_G(c[1])) == (type == 0 ? 2 : 1)*num_added);
+
+    // Complete screening
+    CONSTR_screen_branches(c[1],x,-1.);
+    Assert("error - screening adds twice",CONSTR_screen_branches(c[1],x,-1.) == 0);
+    for (k = 0; k < 2; k++) {
+      CONSTR_count(c[k]);
+      CONSTR_allocate(c[k]);
+      CONSTR_analyze(c[k]);
+      CONSTR_eval(c[k],x,NULL);
+      Assert(CONSTR_get_error_string(c[k]),!CONSTR_has_error(c[k]));
+      num_rows[k] = MAT_get_size1(CONSTR_get_G(c[k]));
+    }
+    Assert("error - bad number of rows",num_rows[0] == num_rows[1]);
+    Assert("error - bad G nnz",MAT_get_nnz(CONSTR_get_G(c[0])) == MAT_get_nnz(CONSTR_get_G(c[1])));
+    Assert("error - bad J nnz",MAT_get_nnz(CONSTR_get_J(c[0])) == MAT_get_nnz(CONSTR_get_J(c[1])));
+    for (i = 0; i < VEC_get_size(CONSTR_get_u(c[0])); i++)
+      Assert("error - bad bounds",VEC_get(CONSTR_get_u(c[0]),i) == VEC_get(CONSTR_get_u(c[1]),i));
+    for (i = 0; i < VEC_get_size(CONSTR_get_f(c[0])); i++)
+      Assert("error - bad f",VEC_get(CONSTR_get_f(c[0]),i) == VEC_get(CONSTR_get_f(c[1]),i));
+
+    // Disable
+    CONSTR_set_active_set(c[1],FALSE);
+    Assert("error - active set",!CONSTR_has_active_set(c[1]));
+
+    CONSTR_del(c[0]);
+    CONSTR_del(c[1]);
+  }
+
+  // Unsupported
+  c[0] = CONSTR_DCPF_new(net);
+  CONSTR_set_active_set(c[0],TRUE);
+  Assert("error - active set of DCPF",CONSTR_has_error(c[0]) && !CONSTR_has_active_set(c[0]));
+  CONSTR_del(c[0]);
+
+  VEC_del(x);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_constr_ACPF_fixed() {
+
+  // Local variables
+  Net* net;
+  Parser* parser;
+  Constr* c;
+  Bus* bus;
+  Gen* gen;
+  Vec* x;
+  Vec* f;
+  int num_fixed;
+  int num_buses;
+  int i;
+  int t;
+  int T = 2;
+
+  printf("test_constr_ACPF_fixed ...");
+
+  // Load
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,T);
+  PARSER_del(parser);
+  num_buses = NET_get_num_buses(net);
+
+  // Variables on half of the buses
+  for (i = 0; i < num_buses/2; i++)
+    NET_set_flags_of_component(net,NET_get_bus(net,i),OBJ_BUS,FLAG_VARS,BUS_VAR_VMAG|BUS_VAR_VANG);
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    NET_set_flags_of_component(net,gen,OBJ_GEN,FLAG_VARS,GEN_VAR_P|GEN_VAR_Q);
+  }
+  num_fixed = 0;
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    if (CONSTR_ACPF_has_fixed_flows(NET_get_branch(net,i)))
+      num_fixed++;
+  }
+  Assert("error - no fixed branches",num_fixed > 0);
+  Assert("error - no variable branches",num_fixed < NET_get_num_branches(net));
+
+  // Point away from network values
+  x = NET_get_var_values(net,CURRENT);
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,0.01*(i%3));
+
+  // Constraint
+  c = CONSTR_ACPF_new(net);
+  CONSTR_count(c);
+  CONSTR_allocate(c);
+  CONSTR_analyze(c);
+  CONSTR_eval(c,x,NULL);
+  Assert("error - ACPF eval failed",!CONSTR_has_error(c));
+  f = CONSTR_get_f(c);
+
+  // Compare with mismatches of network
+  NET_update_properties(net,x);
+  for (t = 0; t < T; t++) {
+    for (i = 0; i < num_buses; i++) {
+      bus = NET_get_bus(net,i);
+      Assert("error - bad P mismatch",
+	     fabs(VEC_get(f,BUS_get_index_P(bus)+t*2*num_buses)-BUS_get_P_mis(bus,t)) < 1e-10);
+      Assert("error - bad Q mismatch",
+	     fabs(VEC_get(f,BUS_get_index_Q(bus)+t*2*num_buses)-BUS_get_Q_mis(bus,t)) < 1e-10);
+    }
+  }
+
+  // Evaluating twice gives the same values
+  CONSTR_eval(c,x,NULL);
+  for (t = 0; t < T; t++) {
+    bus = NET_get_bus(net,num_buses-1);
+    Assert("error - bad P mismatch",
+	   fabs(VEC_get(f,BUS_get_index_P(bus)+t*2*num_buses)-BUS_get_P_mis(bus,t)) < 1e-10);
+  }
+
+  VEC_del(x);
+  CONSTR_del(c);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
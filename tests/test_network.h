@@ -9,7 +9,11 @@
 
 #include "unit.h"
 #include <pfnet/parser.h>
+#include <pfnet/parser_JSON.h>
+#include <pfnet/parser_BIN.h>
 #include <pfnet/net.h>
+#include <pfnet/contingency.h>
+#include <pfnet/reduction.h>
 
 static char* test_net_new() {
 
@@ -46,6 +50,440 @@ static char* test_net_load() {
   return 0;
 }
 
+static char* test_net_load_fast() {
+
+  Parser* parser;
+  Net* net;
+  Net* net_slow;
+  char* json;
+  char* json_slow;
+  int i;
+
+  printf("test_net_load_fast ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  PARSER_set(parser,"fast",1);
+  net = PARSER_parse(parser,test_case,2);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+
+  parser = PARSER_new_for_file(test_case);
+  PARSER_set(parser,"fast",0);
+  net_slow = PARSER_parse(parser,test_case,2);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+
+  json = NET_get_json_string(net);
+  json_slow = NET_get_json_string(net_slow);
+  Assert("error - fast and slow parsers differ",strcmp(json,json_slow) == 0);
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    Assert("error - bad v_mag",BUS_get_v_mag(NET_get_bus(net,i),0) == BUS_get_v_mag(NET_get_bus(net_slow,i),0));
+    Assert("error - bad v_ang",BUS_get_v_ang(NET_get_bus(net,i),0) == BUS_get_v_ang(NET_get_bus(net_slow,i),0));
+  }
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    Assert("error - bad g",BRANCH_get_g(NET_get_branch(net,i)) == BRANCH_get_g(NET_get_branch(net_slow,i)));
+    Assert("error - bad b",BRANCH_get_b(NET_get_branch(net,i)) == BRANCH_get_b(NET_get_branch(net_slow,i)));
+  }
+  for (i = 0; i < NET_get_num_gens(net); i++)
+    Assert("error - bad P",GEN_get_P(NET_get_gen(net,i),0) == GEN_get_P(NET_get_gen(net_slow,i),0));
+
+  free(json);
+  free(json_slow);
+  NET_del(net);
+  NET_del(net_slow);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_binary() {
+
+  Parser* parser;
+  Parser* parser_bin;
+  Net* net;
+  Net* net_bin;
+  Vec* x;
+  Vec* x_bin;
+  char* json;
+  char* json_bin;
+  char filename[] = "test_net_binary.pfb";
+  char* data;
+  FILE* file;
+  long size;
+  int num;
+  int i;
+
+  printf("test_net_binary ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,3);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_ANY,GEN_VAR_Q|GEN_VAR_P);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_TAP_CHANGER,BRANCH_VAR_RATIO);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG);
+  NET_set_flags(net,OBJ_BUS,FLAG_FIXED,BUS_PROP_SLACK,BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_BOUNDED,GEN_PROP_ANY,GEN_VAR_P);
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    BUS_set_v_mag(NET_get_bus(net,i),1.+0.01*i,2);
+
+  parser_bin = PARSER_new_for_file(filename);
+  Assert("error - unable to create binary parser",parser_bin != NULL);
+  PARSER_write(parser_bin,net,filename);
+  Assert(PARSER_get_error_string(parser_bin),!PARSER_has_error(parser_bin));
+  net_bin = PARSER_parse(parser_bin,filename,0);
+  Assert(PARSER_get_error_string(parser_bin),!PARSER_has_error(parser_bin));
+  remove(filename);
+
+  Assert("error - bad number of periods",NET_get_num_periods(net_bin) == 3);
+  json = NET_get_json_string(net);
+  json_bin = NET_get_json_string(net_bin);
+  Assert("error - binary snapshot differs",strcmp(json,json_bin) == 0);
+  free(json);
+  free(json_bin);
+
+  Assert("error - bad number of vars",NET_get_num_vars(net_bin) == NET_get_num_vars(net));
+  Assert("error - bad number of fixed",NET_get_num_fixed(net_bin) == NET_get_num_fixed(net));
+  Assert("error - bad number of bounded",NET_get_num_bounded(net_bin) == NET_get_num_bounded(net));
+  x = NET_get_var_values(net,CURRENT);
+  x_bin = NET_get_var_values(net_bin,CURRENT);
+  for (i = 0; i < VEC_get_size(x); i++)
+    Assert("error - bad variable order",VEC_get(x,i) == VEC_get(x_bin,i));
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    Assert("error - bad bus hash",NET_bus_hash_number_find(net_bin,BUS_get_number(NET_get_bus(net,i))) == NET_get_bus(net_bin,i));
+  VEC_del(x);
+  VEC_del(x_bin);
+  NET_del(net_bin);
+
+  PARSER_write(parser_bin,net,filename);
+  net_bin = PARSER_parse(parser_bin,filename,2);
+  Assert(PARSER_get_error_string(parser_bin),!PARSER_has_error(parser_bin));
+  remove(filename);
+  Assert("error - bad number of periods",NET_get_num_periods(net_bin) == 2);
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    Assert("error - bad v_mag",BUS_get_v_mag(NET_get_bus(net_bin,i),1) == BUS_get_v_mag(NET_get_bus(net,i),1));
+  NET_del(net_bin);
+
+  // Bad number of buses
+  for (i = 0; i < 2; i++) {
+    PARSER_write(parser_bin,net,filename);
+    file = fopen(filename,"r+b");
+    Assert("error - unable to open snapshot",file != NULL);
+    num = (i == 0) ? -1 : (1 << 30);
+    fseek(file,strlen(BIN_PARSER_MAGIC)+3*sizeof(int),SEEK_SET);
+    fwrite(&num,sizeof(int),1,file);
+    fclose(file);
+    PARSER_clear_error(parser_bin);
+    net_bin = PARSER_parse(parser_bin,filename,0);
+    remove(filename);
+    Assert("error - bad sizes accepted",net_bin == NULL && PARSER_has_error(parser_bin));
+  }
+
+  // Bad offsets of bus names (negative end, nonzero start), after magic, header, base power and bus numbers
+  size = sizeof(int)*NET_get_num_buses(net);
+  size = (strlen(BIN_PARSER_MAGIC)+sizeof(int)*BIN_PARSER_HEADER_SIZE+sizeof(REAL)+
+	  (size+BIN_PARSER_ALIGN-1)/BIN_PARSER_ALIGN*BIN_PARSER_ALIGN);
+  for (i = 0; i < 2; i++) {
+    PARSER_write(parser_bin,net,filename);
+    file = fopen(filename,"r+b");
+    Assert("error - unable to open snapshot",file != NULL);
+    num = (i == 0) ? -8 : 1;
+    fseek(file,size+((i == 0) ? sizeof(int)*NET_get_num_buses(net) : 0),SEEK_SET);
+    fwrite(&num,sizeof(int),1,file);
+    fclose(file);
+    PARSER_clear_error(parser_bin);
+    net_bin = PARSER_parse(parser_bin,filename,0);
+    remove(filename);
+    Assert("error - bad offsets accepted",net_bin == NULL && PARSER_has_error(parser_bin));
+    Assert("error - bad error",strcmp(PARSER_get_error_string(parser_bin),"bad binary network data") == 0);
+  }
+
+  // Truncated
+  PARSER_write(parser_bin,net,filename);
+  file = fopen(filename,"rb");
+  Assert("error - unable to open snapshot",file != NULL);
+  fseek(file,0,SEEK_END);
+  size = ftell(file);
+  fseek(file,0,SEEK_SET);
+  data = (char*)malloc(size);
+  Assert("error - unable to read snapshot",fread(data,size,1,file) == 1);
+  fclose(file);
+  file = fopen(filename,"wb");
+  fwrite(data,size/2,1,file);
+  fclose(file);
+  free(data);
+  PARSER_clear_error(parser_bin);
+  net_bin = PARSER_parse(parser_bin,filename,0);
+  remove(filename);
+  Assert("error - truncated snapshot accepted",net_bin == NULL && PARSER_has_error(parser_bin));
+
+  PARSER_del(parser_bin);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_json_writer() {
+
+  Parser* parser;
+  Net* net;
+  JSON_Writer* writer;
+  FILE* file;
+  char* json;
+  char* json_file;
+  char temp[JSON_WRITER_NUMBER_SIZE];
+  char temp_ref[JSON_WRITER_NUMBER_SIZE];
+  char filename[] = "test_net_json_writer.json";
+  REAL values[] = {0.,-0.,1.,-1.,0.1,1e-300,1e300,99999999999.5,9.99999999995,-2.5e-5,123456789012.};
+  long size;
+  int len;
+  int i;
+
+  printf("test_net_json_writer ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+
+  // Numbers
+  for (i = 0; i < (int)(sizeof(values)/sizeof(REAL)); i++) {
+    len = fast_ftoa(temp,values[i]);
+    sprintf(temp_ref,"%.10e",values[i]);
+    Assert("error - bad float format",strcmp(temp,temp_ref) == 0 && len == (int)strlen(temp_ref));
+  }
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    fast_ftoa(temp,BUS_get_v_ang(NET_get_bus(net,i),0));
+    sprintf(temp_ref,"%.10e",BUS_get_v_ang(NET_get_bus(net,i),0));
+    Assert("error - bad float format",strcmp(temp,temp_ref) == 0);
+    fast_itoa(temp,-BUS_get_number(NET_get_bus(net,i)));
+    sprintf(temp_ref,"%d",-BUS_get_number(NET_get_bus(net,i)));
+    Assert("error - bad int format",strcmp(temp,temp_ref) == 0);
+  }
+
+  // Buffer
+  json = NET_get_json_string(net);
+  writer = JSON_WRITER_new();
+  NET_write_json(net,writer);
+  Assert("error - bad json length",JSON_WRITER_get_length(writer) == strlen(json));
+  Assert("error - bad json string",strcmp(JSON_WRITER_get_string(writer),json) == 0);
+  JSON_WRITER_del(writer);
+
+  // File
+  file = fopen(filename,"w");
+  writer = JSON_WRITER_new_for_file(file);
+  NET_write_json(net,writer);
+  JSON_WRITER_flush(writer);
+  Assert("error - json writer failed",!JSON_WRITER_has_error(writer));
+  Assert("error - bad json length",JSON_WRITER_get_length(writer) == strlen(json));
+  JSON_WRITER_del(writer);
+  fclose(file);
+  file = fopen(filename,"r");
+  fseek(file,0L,SEEK_END);
+  size = ftell(file);
+  rewind(file);
+  json_file = (char*)calloc(size+1,sizeof(char));
+  Assert("error - unable to read json",fread(json_file,1,size,file) == (size_t)size);
+  fclose(file);
+  remove(filename);
+  Assert("error - bad json file",strcmp(json_file,json) == 0);
+
+  free(json);
+  free(json_file);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_json_parser() {
+
+  Parser* parser;
+  Parser* parser_json;
+  Net* net;
+  Net* net_json;
+  char* json;
+  char* json_new;
+  char filename[] = "test_net_json_parser.json";
+  char filename_bad[] = "test_net_json_parser_bad.json";
+  FILE* file;
+  int i;
+
+  printf("test_net_json_parser ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,3);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    BUS_set_price(NET_get_bus(net,i),(REAL)i,2);
+
+  // Write
+  parser_json = JSON_PARSER_new();
+  PARSER_write(parser_json,net,filename);
+  Assert(PARSER_get_error_string(parser_json),!PARSER_has_error(parser_json));
+
+  // Round trip
+  net_json = PARSER_parse(parser_json,filename,0);
+  Assert(PARSER_get_error_string(parser_json),!PARSER_has_error(parser_json));
+  Assert("error - bad number of periods",NET_get_num_periods(net_json) == 3);
+  json = NET_get_json_string(net);
+  json_new = NET_get_json_string(net_json);
+  Assert("error - bad json round trip",strcmp(json,json_new) == 0);
+  Assert("error - bad bus hash",NET_bus_hash_number_find(net_json,BUS_get_number(NET_get_bus(net,0))) == NET_get_bus(net_json,0));
+  free(json_new);
+  NET_del(net_json);
+
+  // Fewer periods
+  net_json = PARSER_parse(parser_json,filename,2);
+  Assert(PARSER_get_error_string(parser_json),!PARSER_has_error(parser_json));
+  Assert("error - bad number of periods",NET_get_num_periods(net_json) == 2);
+  Assert("error - bad number of buses",NET_get_num_buses(net_json) == NET_get_num_buses(net));
+  Assert("error - bad price",BUS_get_price(NET_get_bus(net_json,5),1) == BUS_get_price(NET_get_bus(net,5),1));
+  NET_del(net_json);
+
+  // Truncated data
+  file = fopen(filename_bad,"w");
+  fwrite(json,1,strlen(json)/2,file);
+  fclose(file);
+  net_json = PARSER_parse(parser_json,filename_bad,0);
+  Assert("error - truncated json accepted",!net_json && PARSER_has_error(parser_json));
+  remove(filename_bad);
+  remove(filename);
+
+  free(json);
+  PARSER_del(parser_json);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_load_profiles() {
+
+  Parser* parser;
+  Net* net;
+  Load* load;
+  Gen* gen;
+  Vargen* vargen;
+  FILE* file;
+  char filename[] = "test_net_load_profiles.csv";
+  REAL P;
+  int t;
+
+  printf("test_net_load_profiles ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,3);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+  NET_add_vargens(net,NET_get_load_buses(net),50.,30.,5.,0,0.);
+  Assert(NET_get_error_string(net),!NET_has_error(net));
+  Assert("error - no loads or vargens",NET_get_num_loads(net) > 1 && NET_get_num_vargens(net) > 0);
+  load = NET_get_load(net,1);
+  gen = NET_get_gen(net,0);
+  vargen = NET_get_vargen(net,0);
+  P = GEN_get_P(gen,0);
+
+  // Profiles (last record beyond network periods)
+  file = fopen(filename,"w");
+  fprintf(file,"# profiles\n");
+  fprintf(file,"t, load:1:P, load:1:Q, load:1:P_max, vargen:%s:P_ava, vargen:0:P_std, gen:0:P\n",
+	  VARGEN_get_name(vargen));
+  for (t = 0; t < 4; t++)
+    fprintf(file,"%d, %.4f, %.4f, %.4f, %.4f, %.4f, %.4f\n",t,1.+t,2.+t,3.+t,0.5+t,0.1*t,P+t);
+  fclose(file);
+  NET_load_profiles(net,filename);
+  Assert(NET_get_error_string(net),!NET_has_error(net));
+  for (t = 0; t < 3; t++) {
+    Assert("error - bad load P",LOAD_get_P(load,t) == 1.+t);
+    Assert("error - bad load Q",LOAD_get_Q(load,t) == 2.+t);
+    Assert("error - bad load P_max",LOAD_get_P_max(load,t) == 3.+t);
+    Assert("error - bad vargen P_ava",VARGEN_get_P_ava(vargen,t) == 0.5+t);
+    Assert("error - bad vargen P_std",fabs(VARGEN_get_P_std(vargen,t)-0.1*t) < 1e-12);
+    Assert("error - bad gen P",fabs(GEN_get_P(gen,t)-(P+t)) < 1e-4);
+  }
+
+  // Bad profiles
+  file = fopen(filename,"w");
+  fprintf(file,"t,load:1:P_ava\n0,1.\n");
+  fclose(file);
+  NET_load_profiles(net,filename);
+  Assert("error - bad quantity accepted",NET_has_error(net));
+  NET_clear_error(net);
+  file = fopen(filename,"w");
+  fprintf(file,"t,load:1:P,load:%d:Q\n0,1.,2.\n",NET_get_num_loads(net));
+  fclose(file);
+  NET_load_profiles(net,filename);
+  Assert("error - bad component accepted",NET_has_error(net));
+  NET_clear_error(net);
+  file = fopen(filename,"w");
+  fprintf(file,"t,load:1:P,load:1:Q\n0,1.\n");
+  fclose(file);
+  NET_load_profiles(net,filename);
+  Assert("error - missing value accepted",NET_has_error(net));
+  remove(filename);
+
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_series() {
+
+  Parser* parser;
+  Net* net;
+  Bus* bus;
+  Gen* gen;
+  REAL* values;
+  int num;
+  int i;
+  int t;
+
+  printf("test_net_series ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,3);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+
+  // Get
+  num = NET_get_num_components(net,OBJ_BUS);
+  Assert("error - bad number of components",num == NET_get_num_buses(net));
+  values = (REAL*)malloc(sizeof(REAL)*num*3);
+  NET_get_series(net,OBJ_BUS,"v_mag",values);
+  Assert(NET_get_error_string(net),!NET_has_error(net));
+  for (i = 0; i < num; i++) {
+    bus = NET_get_bus(net,i);
+    for (t = 0; t < 3; t++)
+      Assert("error - bad bus v_mag",values[i*3+t] == BUS_get_v_mag(bus,t));
+  }
+  free(values);
+
+  // Set
+  num = NET_get_num_components(net,OBJ_GEN);
+  values = (REAL*)malloc(sizeof(REAL)*num*3);
+  for (i = 0; i < num*3; i++)
+    values[i] = 0.5*i;
+  NET_set_series(net,OBJ_GEN,"Q",values);
+  Assert(NET_get_error_string(net),!NET_has_error(net));
+  for (i = 0; i < num; i++) {
+    gen = NET_get_gen(net,i);
+    for (t = 0; t < 3; t++)
+      Assert("error - bad gen Q",GEN_get_Q(gen,t) == 0.5*(i*3+t));
+  }
+
+  // Bad name
+  NET_get_series(net,OBJ_GEN,"v_mag",values);
+  Assert("error - bad series name accepted",NET_has_error(net));
+  NET_clear_error(net);
+  Assert("error - bad series",NET_get_series_of_component(net,OBJ_GEN,num,"P") == NULL);
+  free(values);
+
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
 static char* test_net_check() {
   
   Parser* parser;
@@ -278,3 +716,307 @@ static char* test_net_init_point() {
   return 0;
 }
 
+
+static char* test_net_adjacency() {
+
+  Parser* parser;
+  Net* net;
+  Cont* cont;
+  Branch* br;
+  Bus* bus;
+  int* ptr;
+  int* adj_br;
+  int* adj_bus;
+  int i;
+  int j;
+  int k;
+
+  printf("test_net_adjacency ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+
+  Assert("error - invalid number of buses",NET_get_num_buses(net) > 0);
+
+  ptr = NET_get_adjacency_ptr(net);
+  adj_br = NET_get_adjacency_branches(net);
+  adj_bus = NET_get_adjacency_buses(net);
+
+  Assert("error - NULL adjacency",ptr != NULL && adj_br != NULL && adj_bus != NULL);
+  Assert("error - bad number of incidences",ptr[NET_get_num_buses(net)] == 2*NET_get_num_branches(net));
+
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    Assert("error - bad bus degree",NET_get_bus_degree(net,i) == BUS_get_degree(bus));
+    for (j = ptr[i]; j < ptr[i+1]; j++) {
+      br = NET_get_branch(net,adj_br[j]);
+      Assert("error - bad incident branch",BRANCH_get_bus_k(br) == bus || BRANCH_get_bus_m(br) == bus);
+      if (BRANCH_get_bus_k(br) == bus)
+	Assert("error - bad adjacent bus",adj_bus[j] == BUS_get_index(BRANCH_get_bus_m(br)));
+      else
+	Assert("error - bad adjacent bus",adj_bus[j] == BUS_get_index(BRANCH_get_bus_k(br)));
+    }
+  }
+
+  // Outage
+  br = NET_get_branch(net,0);
+  i = BUS_get_index(BRANCH_get_bus_k(br));
+  k = NET_get_bus_degree(net,i);
+  cont = CONT_new();
+  CONT_add_branch_outage(cont,0);
+  CONT_apply(cont,net);
+  Assert("error - adjacency not updated after outage",NET_get_bus_degree(net,i) == k-1);
+  CONT_clear(cont,net);
+  Assert("error - adjacency not updated after outage",NET_get_bus_degree(net,i) == k);
+
+  // Direct outage
+  BRANCH_set_outage(br,TRUE);
+  Assert("error - adjacency not updated after direct outage",NET_get_bus_degree(net,i) == k-1);
+  BRANCH_set_outage(br,FALSE);
+  Assert("error - adjacency not updated after direct outage",NET_get_bus_degree(net,i) == k);
+
+  CONT_del(cont);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_islands() {
+
+  Parser* parser;
+  Net* net;
+  Cont* cont;
+  Branch* br;
+  int* island;
+  int num_islands;
+  int i;
+  int k;
+
+  printf("test_net_islands ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+
+  Assert("error - invalid number of buses",NET_get_num_buses(net) > 0);
+
+  num_islands = NET_get_num_islands(net);
+  island = NET_get_bus_islands(net);
+
+  Assert("error - bad number of islands",num_islands >= 1);
+  Assert("error - NULL islands",island != NULL);
+  Assert("error - bad island of first bus",NET_get_bus_island(net,0) == 0);
+  Assert("error - bad island of invalid bus",NET_get_bus_island(net,-1) == -1);
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    br = NET_get_branch(net,i);
+    Assert("error - branch joins islands",
+	   island[BUS_get_index(BRANCH_get_bus_k(br))] == island[BUS_get_index(BRANCH_get_bus_m(br))]);
+  }
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    Assert("error - bad island index",island[i] >= 0 && island[i] < num_islands);
+
+  // Outage of branch of bus with degree one
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    if (NET_get_bus_degree(net,i) == 1)
+      break;
+  }
+  if (i < NET_get_num_buses(net)) {
+    k = NET_get_adjacency_branches(net)[NET_get_adjacency_ptr(net)[i]];
+    cont = CONT_new();
+    CONT_add_branch_outage(cont,k);
+    CONT_apply(cont,net);
+    Assert("error - islands not updated after outage",NET_get_num_islands(net) == num_islands+1);
+    Assert("error - bus not isolated",NET_get_bus_island(net,i) != NET_get_bus_island(net,(i == 0) ? 1 : 0));
+    CONT_clear(cont,net);
+    Assert("error - islands not updated after outage",NET_get_num_islands(net) == num_islands);
+    CONT_del(cont);
+    br = NET_get_branch(net,k);
+    BRANCH_set_outage(br,TRUE);
+    Assert("error - islands not updated after direct outage",NET_get_num_islands(net) == num_islands+1);
+    BRANCH_set_outage(br,FALSE);
+    Assert("error - islands not updated after direct outage",NET_get_num_islands(net) == num_islands);
+  }
+
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_var_ordering() {
+
+  Parser* parser;
+  Net* net;
+  Net* net_nat;
+  Bus* bus;
+  Bus* bus_nat;
+  Gen* gen;
+  Gen* gen_nat;
+  Vec* x;
+  Vec* x_nat;
+  int* order;
+  int* perm;
+  char* seen;
+  int ordering;
+  int i;
+  int t;
+
+  printf("test_net_var_ordering ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net_nat = PARSER_parse(parser,test_case,2);
+
+  // Bus orderings
+  for (ordering = NET_ORDER_NATURAL; ordering <= NET_ORDER_AMD; ordering++) {
+    order = NET_create_bus_ordering(net_nat,ordering);
+    Assert("error - NULL bus ordering",order != NULL);
+    seen = (char*)calloc(NET_get_num_buses(net_nat),sizeof(char));
+    for (i = 0; i < NET_get_num_buses(net_nat); i++) {
+      Assert("error - invalid bus ordering",order[i] >= 0 && order[i] < NET_get_num_buses(net_nat));
+      Assert("error - repeated bus in ordering",!seen[order[i]]);
+      seen[order[i]] = TRUE;
+    }
+    free(seen);
+    free(order);
+  }
+
+  for (ordering = NET_ORDER_RCM; ordering <= NET_ORDER_AMD; ordering++) {
+
+    net = NET_get_copy(net_nat);
+    NET_set_var_ordering(net,ordering);
+    Assert("error - bad var ordering",NET_get_var_ordering(net) == ordering);
+    Assert("error - permutation without variables",NET_get_var_permutation(net) == NULL);
+
+    // Flags (in two calls)
+    NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_ANY,GEN_VAR_P);
+    NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VANG|BUS_VAR_VMAG);
+    NET_set_flags(net_nat,OBJ_GEN,FLAG_VARS,GEN_PROP_ANY,GEN_VAR_P);
+    NET_set_flags(net_nat,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VANG|BUS_VAR_VMAG);
+    Assert("error - bad number of vars",NET_get_num_vars(net) == NET_get_num_vars(net_nat));
+
+    // Permutation
+    perm = NET_get_var_permutation(net);
+    Assert("error - NULL permutation",perm != NULL);
+    seen = (char*)calloc(NET_get_num_vars(net),sizeof(char));
+    for (i = 0; i < NET_get_num_vars(net); i++) {
+      Assert("error - invalid permutation",perm[i] >= 0 && perm[i] < NET_get_num_vars(net));
+      Assert("error - repeated index in permutation",!seen[perm[i]]);
+      seen[perm[i]] = TRUE;
+    }
+    free(seen);
+    for (i = 0; i < NET_get_num_buses(net); i++) {
+      bus = NET_get_bus(net,i);
+      bus_nat = NET_get_bus(net_nat,i);
+      for (t = 0; t < NET_get_num_periods(net); t++) {
+	Assert("error - bad permutation",perm[BUS_get_index_v_mag(bus_nat,t)] == BUS_get_index_v_mag(bus,t));
+	Assert("error - bad permutation",perm[BUS_get_index_v_ang(bus_nat,t)] == BUS_get_index_v_ang(bus,t));
+      }
+      Assert("error - not contiguous",BUS_get_index_v_mag(bus,1) == BUS_get_index_v_mag(bus,0)+1);
+    }
+    for (i = 0; i < NET_get_num_gens(net); i++) {
+      gen = NET_get_gen(net,i);
+      gen_nat = NET_get_gen(net_nat,i);
+      for (t = 0; t < NET_get_num_periods(net); t++)
+	Assert("error - bad permutation",perm[GEN_get_index_P(gen_nat,t)] == GEN_get_index_P(gen,t));
+    }
+
+    // Values
+    x = NET_get_var_values(net,CURRENT);
+    x_nat = NET_get_var_values(net_nat,CURRENT);
+    for (i = 0; i < NET_get_num_vars(net); i++)
+      Assert("error - bad permuted values",VEC_get(x,perm[i]) == VEC_get(x_nat,i));
+    VEC_del(x);
+    VEC_del(x_nat);
+
+    NET_clear_flags(net_nat);
+    NET_del(net);
+  }
+
+  NET_del(net_nat);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_reduction() {
+
+  Parser* parser;
+  Net* net;
+  Net* red_net;
+  Red* red;
+  Bus* bus;
+  Bus* red_bus;
+  int* bus_map;
+  int* branch_map;
+  int num_kept;
+  int i;
+  int t;
+
+  printf("test_net_reduction ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  red = RED_new(net,3);
+  Assert("error - reduction failed",!RED_has_error(red));
+  red_net = RED_get_network(red);
+  Assert("error - NULL reduced network",red_net != NULL);
+  Assert("error - bad number of buses",
+	 NET_get_num_buses(red_net)+RED_get_num_eliminated_buses(red) == NET_get_num_buses(net));
+  Assert("error - bad number of gens",NET_get_num_gens(red_net) == NET_get_num_gens(net));
+  Assert("error - bad number of loads",NET_get_num_loads(red_net) == NET_get_num_loads(net));
+
+  // Maps
+  bus_map = RED_get_bus_map(red);
+  branch_map = RED_get_branch_map(red);
+  num_kept = 0;
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    if (bus_map[i] < 0)
+      continue;
+    Assert("error - bad bus map",bus_map[i] == num_kept);
+    Assert("error - bad bus map",BUS_get_number(NET_get_bus(red_net,bus_map[i])) == BUS_get_number(NET_get_bus(net,i)));
+    num_kept++;
+  }
+  for (i = 0; i < RED_get_num_eliminated_buses(red); i++)
+    Assert("error - bad eliminated bus",bus_map[RED_get_eliminated_buses(red)[i]] == -1);
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    if (branch_map[i] < 0)
+      continue;
+    Assert("error - bad branch map",BUS_get_number(BRANCH_get_bus_k(NET_get_branch(red_net,branch_map[i]))) ==
+	   BUS_get_number(BRANCH_get_bus_k(NET_get_branch(net,i))));
+  }
+
+  // Perturbed voltages
+  for (i = 0; i < NET_get_num_buses(red_net); i++) {
+    red_bus = NET_get_bus(red_net,i);
+    for (t = 0; t < NET_get_num_periods(net); t++) {
+      BUS_set_v_mag(red_bus,1.+0.01*((i+t)%7),t);
+      BUS_set_v_ang(red_bus,0.02*((i*3+t)%5),t);
+    }
+  }
+  RED_expand(red);
+  NET_update_properties(net,NULL);
+  NET_update_properties(red_net,NULL);
+
+  // Mismatches
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    for (t = 0; t < NET_get_num_periods(net); t++) {
+      if (bus_map[i] < 0) {
+	Assert("error - nonzero P injection",fabs(BUS_get_P_mis(bus,t)) < 1e-8);
+	Assert("error - nonzero Q injection",fabs(BUS_get_Q_mis(bus,t)) < 1e-8);
+      }
+      else {
+	red_bus = NET_get_bus(red_net,bus_map[i]);
+	Assert("error - bad P mismatch",fabs(BUS_get_P_mis(bus,t)-BUS_get_P_mis(red_bus,t)) < 1e-8);
+	Assert("error - bad Q mismatch",fabs(BUS_get_Q_mis(bus,t)-BUS_get_Q_mis(red_bus,t)) < 1e-8);
+      }
+    }
+  }
+
+  RED_del(red);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
@@ -101,3 +101,1062 @@ static char* test_problem_basic() {
   printf("ok\n");
   return 0;
 }
+
+static char* test_problem_islands() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Cont* cont;
+  Vec* x;
+  Mat* J;
+  Mat* B;
+  int* var_block;
+  int* J_row_block;
+  int nnz;
+  int i;
+  int k;
+
+  printf("test_problem_islands ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+
+  // Split network
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    if (NET_get_bus_degree(net,i) == 1)
+      break;
+  }
+  cont = CONT_new();
+  if (i < NET_get_num_buses(net))
+    CONT_add_branch_outage(cont,NET_get_adjacency_branches(net)[NET_get_adjacency_ptr(net)[i]]);
+  CONT_apply(cont,net);
+
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(1.,net));
+
+  // No decomposition
+  PROB_analyze(p);
+  Assert("error - bad number of blocks",PROB_get_num_blocks(p) == 0);
+  Assert("error - bad var blocks",PROB_get_var_blocks(p) == NULL);
+
+  // Decomposition
+  PROB_set_island_decomposition(p,TRUE);
+  PROB_analyze(p);
+  x = PROB_get_init_point(p);
+  PROB_eval(p,x);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  Assert("error - bad number of blocks",PROB_get_num_blocks(p) >= NET_get_num_islands(net));
+
+  var_block = PROB_get_var_blocks(p);
+  J_row_block = PROB_get_J_row_blocks(p);
+  J = PROB_get_J(p);
+  Assert("error - NULL blocks",var_block != NULL && J_row_block != NULL);
+  for (k = 0; k < MAT_get_nnz(J); k++)
+    Assert("error - J not block diagonal",J_row_block[MAT_get_i(J,k)] == var_block[MAT_get_j(J,k)]);
+  for (k = 0; k < NET_get_num_branches(net); k++) {
+    if (BRANCH_is_on_outage(NET_get_branch(net,k)))
+      continue;
+    Assert("error - branch joins blocks",
+	   var_block[BUS_get_index_v_mag(BRANCH_get_bus_k(NET_get_branch(net,k)),0)] ==
+	   var_block[BUS_get_index_v_mag(BRANCH_get_bus_m(NET_get_branch(net,k)),0)]);
+  }
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    Assert("error - islands share block",
+	   (NET_get_bus_island(net,i) == NET_get_bus_island(net,0)) ==
+	   (var_block[BUS_get_index_v_mag(NET_get_bus(net,i),0)] ==
+	    var_block[BUS_get_index_v_mag(NET_get_bus(net,0),0)]));
+  }
+
+  // Blocks of J
+  nnz = 0;
+  for (k = 0; k < PROB_get_num_blocks(p); k++) {
+    B = PROB_get_block_of_mat(p,J,J_row_block,k);
+    Assert("error - NULL block",B != NULL);
+    nnz += MAT_get_nnz(B);
+    MAT_del(B);
+  }
+  Assert("error - bad nnz of blocks",nnz == MAT_get_nnz(J));
+  Assert("error - bad block",PROB_get_block_of_mat(p,J,J_row_block,-1) == NULL);
+
+  CONT_clear(cont,net);
+  CONT_del(cont);
+  VEC_del(x);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_island_steps() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p[2];
+  Vec* x;
+  Vec* coeff;
+  Mat* M[2];
+  REAL phi[2];
+  char* has_branches;
+  int num_islands;
+  int br_index;
+  int i;
+  int k;
+  int n;
+
+  printf("test_problem_island_steps ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Outage that leaves branches in more than one island
+  br_index = -1;
+  has_branches = (char*)calloc(NET_get_num_buses(net),sizeof(char));
+  for (k = 0; k < NET_get_num_branches(net) && br_index < 0; k++) {
+    BRANCH_set_outage(NET_get_branch(net,k),TRUE);
+    for (i = 0; i < NET_get_num_buses(net); i++)
+      has_branches[i] = FALSE;
+    num_islands = 0;
+    for (i = 0; i < NET_get_num_buses(net); i++) {
+      if (NET_get_bus_degree(net,i) > 0 && !has_branches[NET_get_bus_island(net,i)]) {
+	has_branches[NET_get_bus_island(net,i)] = TRUE;
+	num_islands++;
+      }
+    }
+    if (num_islands > 1)
+      br_index = k;
+    else
+      BRANCH_set_outage(NET_get_branch(net,k),FALSE);
+  }
+  free(has_branches);
+
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+
+  // Serial (0) and island (1) steps
+  for (n = 0; n < 2; n++) {
+    p[n] = PROB_new(net);
+    PROB_add_constr(p[n],CONSTR_ACPF_new(net));
+    PROB_add_constr(p[n],CONSTR_DCPF_new(net));
+    PROB_add_constr(p[n],CONSTR_REG_GEN_new(net));
+    PROB_add_func(p[n],FUNC_REG_VMAG_new(1.,net));
+    PROB_add_func(p[n],FUNC_REG_VANG_new(1.,net));
+    PROB_add_func(p[n],FUNC_GEN_COST_new(1.,net));
+    PROB_set_island_decomposition(p[n],n == 1);
+    PROB_analyze(p[n]);
+    Assert("error - problem failed on analyze",!PROB_has_error(p[n]));
+  }
+  Assert("error - serial steps with islands",!PROB_has_island_steps(p[0]));
+  Assert("error - no island steps",(br_index < 0) || PROB_has_island_steps(p[1]));
+
+  // Structure and values
+  x = PROB_get_init_point(p[0]);
+  coeff = VEC_new(MAT_get_size1(PROB_get_J(p[0])));
+  for (k = 0; k < VEC_get_size(coeff); k++)
+    VEC_set(coeff,k,1.+k%3);
+  for (n = 0; n < 2; n++) {
+    PROB_eval(p[n],x);
+    Assert("error - problem failed on eval",!PROB_has_error(p[n]));
+    PROB_combine_H(p[n],coeff,FALSE);
+    phi[n] = PROB_get_phi(p[n]);
+  }
+  Assert("error - bad phi",fabs(phi[0]-phi[1]) <= 1e-10*(1.+fabs(phi[0])));
+  Assert("error - bad f",VEC_get_size(PROB_get_f(p[0])) == VEC_get_size(PROB_get_f(p[1])));
+  for (k = 0; k < VEC_get_size(PROB_get_f(p[0])); k++)
+    Assert("error - bad f",VEC_get(PROB_get_f(p[0]),k) == VEC_get(PROB_get_f(p[1]),k));
+  for (k = 0; k < VEC_get_size(PROB_get_gphi(p[0])); k++)
+    Assert("error - bad gphi",VEC_get(PROB_get_gphi(p[0]),k) == VEC_get(PROB_get_gphi(p[1]),k));
+  for (i = 0; i < 3; i++) {
+    M[0] = (i == 0) ? PROB_get_J(p[0]) : ((i == 1) ? PROB_get_Hphi(p[0]) : PROB_get_H_combined(p[0]));
+    M[1] = (i == 0) ? PROB_get_J(p[1]) : ((i == 1) ? PROB_get_Hphi(p[1]) : PROB_get_H_combined(p[1]));
+    Assert("error - bad nnz",MAT_get_nnz(M[0]) == MAT_get_nnz(M[1]));
+    for (k = 0; k < MAT_get_nnz(M[0]); k++) {
+      Assert("error - bad row",MAT_get_i(M[0],k) == MAT_get_i(M[1],k));
+      Assert("error - bad column",MAT_get_j(M[0],k) == MAT_get_j(M[1],k));
+      Assert("error - bad value",MAT_get_d(M[0],k) == MAT_get_d(M[1],k));
+    }
+  }
+
+  VEC_del(coeff);
+  VEC_del(x);
+  PROB_del(p[0]);
+  PROB_del(p[1]);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static void test_batch_constr_allocate(Constr* c) {
+  int num_vars = NET_get_num_vars(CONSTR_get_network(c));
+  CONSTR_set_J(c,MAT_new(0,num_vars,0));
+  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new(0,num_vars,0));
+  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_u(c,VEC_new(0));
+  CONSTR_set_b(c,VEC_new(num_vars));
+  CONSTR_set_A(c,MAT_new(num_vars,num_vars,CONSTR_get_A_nnz(c)));
+}
+
+static void test_batch_constr_count(Constr* c) {
+  CONSTR_set_A_nnz(c,NET_get_num_vars(CONSTR_get_network(c)));
+}
+
+static void test_batch_constr_analyze(Constr* c) {
+  int i;
+  Vec* x = NET_get_var_values(CONSTR_get_network(c),CURRENT);
+  for (i = 0; i < VEC_get_size(x); i++) {
+    MAT_set_i(CONSTR_get_A(c),i,i);
+    MAT_set_j(CONSTR_get_A(c),i,i);
+    MAT_set_d(CONSTR_get_A(c),i,1.);
+    VEC_set(CONSTR_get_b(c),i,VEC_get(x,i));
+  }
+  VEC_del(x);
+}
+
+static void test_batch_func_allocate(Func* f) {
+  int num_vars = NET_get_num_vars(FUNC_get_network(f));
+  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_Hphi(f,MAT_new(num_vars,num_vars,FUNC_get_Hphi_nnz(f)));
+}
+
+static void test_batch_func_count(Func* f) {
+  FUNC_set_Hphi_nnz(f,NET_get_num_vars(FUNC_get_network(f)));
+}
+
+static void test_batch_func_analyze(Func* f) {
+  int i;
+  for (i = 0; i < NET_get_num_vars(FUNC_get_network(f)); i++) {
+    MAT_set_i(FUNC_get_Hphi(f),i,i);
+    MAT_set_j(FUNC_get_Hphi(f),i,i);
+    MAT_set_d(FUNC_get_Hphi(f),i,1.);
+  }
+}
+
+static void test_batch_func_eval(Func* f, Vec* x) {
+  int i;
+  REAL phi = 0;
+  for (i = 0; i < VEC_get_size(x); i++) {
+    phi += 0.5*VEC_get(x,i)*VEC_get(x,i);
+    VEC_set(FUNC_get_gphi(f),i,VEC_get(x,i));
+  }
+  FUNC_set_phi(f,phi);
+}
+
+static char* test_problem_batch() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Constr* c;
+  Func* f;
+  Vec* x;
+  REAL phi;
+  int i;
+
+  printf("test_problem_batch ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  Assert(PARSER_get_error_string(parser),!PARSER_has_error(parser));
+  PARSER_del(parser);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG);
+  Assert("error - no variables",NET_get_num_vars(net) > 0);
+
+  // Constraint and function with batch callbacks only
+  c = CONSTR_new(net);
+  CONSTR_set_func_allocate(c,test_batch_constr_allocate);
+  CONSTR_set_func_count(c,test_batch_constr_count);
+  CONSTR_set_func_analyze(c,test_batch_constr_analyze);
+  f = FUNC_new(1.,net);
+  FUNC_set_func_allocate(f,test_batch_func_allocate);
+  FUNC_set_func_count(f,test_batch_func_count);
+  FUNC_set_func_analyze(f,test_batch_func_analyze);
+  FUNC_set_func_eval(f,test_batch_func_eval);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,c);
+  PROB_add_func(p,f);
+  PROB_analyze(p);
+  Assert(PROB_get_error_string(p),!PROB_has_error(p));
+  x = PROB_get_init_point(p);
+  Assert("error - bad A",MAT_get_nnz(PROB_get_A(p)) == VEC_get_size(x));
+  Assert("error - bad Hphi",MAT_get_nnz(PROB_get_Hphi(p)) == VEC_get_size(x));
+  phi = 0;
+  for (i = 0; i < VEC_get_size(x); i++) {
+    Assert("error - bad b",VEC_get(PROB_get_b(p),i) == VEC_get(x,i));
+    Assert("error - bad A",MAT_get_d(PROB_get_A(p),i) == 1.);
+    phi += 0.5*VEC_get(x,i)*VEC_get(x,i);
+  }
+
+  // Eval
+  PROB_eval(p,x);
+  Assert(PROB_get_error_string(p),!PROB_has_error(p));
+  Assert("error - bad phi",fabs(PROB_get_phi(p)-phi) < 1e-10);
+  for (i = 0; i < VEC_get_size(x); i++)
+    Assert("error - bad gphi",VEC_get(PROB_get_gphi(p),i) == VEC_get(x,i));
+
+  VEC_del(x);
+  PROB_del(p);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_shift_periods() {
+
+  Parser* parser;
+  Net* net[2];
+  Prob* p[2];
+  Load* load;
+  Gen* gen;
+  Vec* x;
+  Vec* v[2];
+  Mat* M[2];
+  int T = 4;
+  int i;
+  int j;
+  int k;
+  int t;
+
+  printf("test_problem_shift_periods ...");
+
+  // Networks (second one has shifted data)
+  parser = PARSER_new_for_file(test_case);
+  for (j = 0; j < 2; j++) {
+    net[j] = PARSER_parse(parser,test_case,T);
+    for (i = 0; i < NET_get_num_loads(net[j]); i++) {
+      load = NET_get_load(net[j],i);
+      for (t = 0; t < T; t++)
+	LOAD_set_P(load,LOAD_get_P(load,t)*(1.+0.1*(j == 0 ? t : (t+1 < T ? t+1 : T-1))),t);
+    }
+    for (i = 0; i < NET_get_num_gens(net[j]); i++) {
+      gen = NET_get_gen(net[j],i);
+      GEN_set_P_prev(gen,GEN_get_P(gen,0)+(j == 0 ? 1. : 0.));
+    }
+    NET_set_flags(net[j],OBJ_BUS,FLAG_VARS,BUS_PROP_NOT_SLACK,BUS_VAR_VANG);
+    NET_set_flags(net[j],OBJ_GEN,FLAG_VARS|FLAG_BOUNDED,GEN_PROP_ANY,GEN_VAR_P);
+    p[j] = PROB_new(net[j]);
+    PROB_add_constr(p[j],CONSTR_DCPF_new(net[j]));
+    PROB_add_constr(p[j],CONSTR_LBOUND_new(net[j]));
+    PROB_add_constr(p[j],CONSTR_GEN_RAMP_new(net[j]));
+    PROB_add_func(p[j],FUNC_GEN_COST_new(1.,net[j]));
+    PROB_analyze(p[j]);
+    Assert("error - problem analyze failed",!PROB_has_error(p[j]));
+  }
+
+  // Shift
+  PROB_shift_periods(p[0],1,NULL);
+  Assert("error - problem shift failed",!PROB_has_error(p[0]));
+  for (i = 0; i < NET_get_num_loads(net[0]); i++) {
+    for (t = 0; t < T; t++)
+      Assert("error - bad shifted load",
+	     fabs(LOAD_get_P(NET_get_load(net[0],i),t)-LOAD_get_P(NET_get_load(net[1],i),t)) < 1e-12);
+  }
+  for (i = 0; i < NET_get_num_gens(net[0]); i++)
+    Assert("error - bad previous power",
+	   GEN_get_P_prev(NET_get_gen(net[0],i)) == GEN_get_P_prev(NET_get_gen(net[1],i)));
+
+  // Same as analyzed problem with shifted data
+  for (k = 0; k < 3; k++) {
+    v[0] = k == 0 ? PROB_get_b(p[0]) : (k == 1 ? PROB_get_l(p[0]) : PROB_get_u(p[0]));
+    v[1] = k == 0 ? PROB_get_b(p[1]) : (k == 1 ? PROB_get_l(p[1]) : PROB_get_u(p[1]));
+    Assert("error - bad vector size",VEC_get_size(v[0]) == VEC_get_size(v[1]));
+    for (i = 0; i < VEC_get_size(v[0]); i++)
+      Assert("error - bad shifted vector",fabs(VEC_get(v[0],i)-VEC_get(v[1],i)) < 1e-10);
+  }
+  for (k = 0; k < 2; k++) {
+    M[0] = k == 0 ? PROB_get_A(p[0]) : PROB_get_G(p[0]);
+    M[1] = k == 0 ? PROB_get_A(p[1]) : PROB_get_G(p[1]);
+    Assert("error - bad matrix nnz",MAT_get_nnz(M[0]) == MAT_get_nnz(M[1]));
+    for (i = 0; i < MAT_get_nnz(M[0]); i++) {
+      Assert("error - bad shifted matrix",
+	     MAT_get_i(M[0],i) == MAT_get_i(M[1],i) &&
+	     MAT_get_j(M[0],i) == MAT_get_j(M[1],i) &&
+	     fabs(MAT_get_d(M[0],i)-MAT_get_d(M[1],i)) < 1e-10);
+    }
+  }
+  x = PROB_get_init_point(p[1]);
+  PROB_eval(p[0],x);
+  PROB_eval(p[1],x);
+  Assert("error - bad shifted objective",fabs(PROB_get_phi(p[0])-PROB_get_phi(p[1])) < 1e-8);
+  VEC_del(x);
+
+  // Not analyzed
+  PROB_del(p[1]);
+  p[1] = PROB_new(net[1]);
+  PROB_add_constr(p[1],CONSTR_DCPF_new(net[1]));
+  PROB_shift_periods(p[1],1,NULL);
+  Assert("error - shift of problem not analyzed",PROB_has_error(p[1]));
+
+  for (j = 0; j < 2; j++) {
+    PROB_del(p[j]);
+    NET_del(net[j]);
+  }
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_periods() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Gen* gen;
+  Mat* M[3];
+  Mat* B;
+  int* row_period[3];
+  int* var_period;
+  int* col_ptr;
+  int nnz_ptr[6];
+  int num_coupling;
+  int num_vars;
+  int T = 4;
+  int i;
+  int k;
+  int r;
+  int t;
+
+  printf("test_problem_periods ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,T);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_NOT_SLACK,BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS|FLAG_BOUNDED,GEN_PROP_ANY,GEN_VAR_P);
+  num_vars = NET_get_num_vars(net);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_DCPF_new(net));
+  PROB_add_constr(p,CONSTR_LBOUND_new(net));
+  PROB_add_constr(p,CONSTR_GEN_RAMP_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+
+  // No decomposition
+  PROB_analyze(p);
+  Assert("error - bad var periods",PROB_get_var_periods(p) == NULL);
+
+  // Decomposition
+  PROB_set_period_decomposition(p,TRUE);
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  var_period = PROB_get_var_periods(p);
+  Assert("error - NULL periods",var_period != NULL);
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    for (t = 0; t < T; t++)
+      Assert("error - bad var period",var_period[GEN_get_index_P(gen,t)] == t);
+  }
+
+  // Column ranges
+  col_ptr = (int*)calloc(T+2,sizeof(int));
+  for (i = 0; i < num_vars; i++) {
+    Assert("error - variable without period",var_period[i] >= 0 && var_period[i] < T);
+    col_ptr[var_period[i]+1]++;
+  }
+  for (t = 1; t < T+2; t++)
+    col_ptr[t] += col_ptr[t-1];
+
+  // Rows (GEN_RAMP couples periods, DCPF and LBOUND do not)
+  M[0] = PROB_get_A(p);
+  M[1] = PROB_get_G(p);
+  M[2] = PROB_get_Hphi(p);
+  row_period[0] = PROB_get_A_row_periods(p);
+  row_period[1] = PROB_get_G_row_periods(p);
+  row_period[2] = NULL;
+  num_coupling = 0;
+  for (i = 0; i < MAT_get_size1(M[0]); i++)
+    Assert("error - coupling row of A",row_period[0][i] >= 0);
+  for (i = 0; i < MAT_get_size1(M[1]); i++) {
+    if (row_period[1][i] == PROB_PERIOD_COUPLING)
+      num_coupling++;
+  }
+  Assert("error - bad number of coupling rows",num_coupling == NET_get_num_gens(net)*(T-1));
+
+  // Period-major matrices
+  for (r = 0; r < 3; r++) {
+    B = PROB_get_period_major_mat(p,M[r],row_period[r],nnz_ptr);
+    Assert("error - NULL matrix",B != NULL);
+    Assert("error - bad nnz",nnz_ptr[0] == 0 && nnz_ptr[T+1] == MAT_get_nnz(M[r]));
+    for (t = 0; t < T; t++) {
+      for (k = nnz_ptr[t]; k < nnz_ptr[t+1]; k++)
+	Assert("error - entry outside diagonal block",
+	       col_ptr[t] <= MAT_get_j(B,k) && MAT_get_j(B,k) < col_ptr[t+1]);
+    }
+    Assert("error - bad coupling entries",(r == 1) == (nnz_ptr[T+1] > nnz_ptr[T]));
+    MAT_del(B);
+  }
+  Assert("error - bad period-major matrix",PROB_get_period_major_mat(p,M[0],NULL,NULL) == NULL);
+
+  free(col_ptr);
+  PROB_del(p);
+
+  // Extra variables (REG_GEN rows belong to one period)
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_NOT_SLACK,BUS_VAR_VMAG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_REG,GEN_VAR_Q);
+  num_vars = NET_get_num_vars(net);
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_REG_GEN_new(net));
+  PROB_set_period_decomposition(p,TRUE);
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  Assert("error - no extra variables",
+	 (PROB_get_num_extra_vars(p) > 0) == (NET_get_num_buses_reg_by_gen(net) > NET_get_num_slack_buses(net)));
+  var_period = PROB_get_var_periods(p);
+  for (i = num_vars; i < num_vars+PROB_get_num_extra_vars(p); i++)
+    Assert("error - extra variable without period",var_period[i] >= 0 && var_period[i] < T);
+  M[0] = PROB_get_J(p);
+  row_period[0] = PROB_get_J_row_periods(p);
+  for (i = 0; i < MAT_get_size1(M[0]); i++)
+    Assert("error - coupling row of J",row_period[0][i] >= 0);
+  for (k = 0; k < MAT_get_nnz(M[0]); k++)
+    Assert("error - bad period of entry",row_period[0][MAT_get_i(M[0],k)] == var_period[MAT_get_j(M[0],k)]);
+  PROB_del(p);
+
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_simple_bounds() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Mat* G;
+  Vec* l;
+  Vec* u;
+  Vec* x_l;
+  Vec* x_u;
+  REAL* l_ref;
+  REAL* u_ref;
+  char* bounded;
+  int num_vars;
+  int num_extra_vars;
+  int Grow;
+  int Gnnz;
+  int T = 2;
+  int i;
+  int k;
+
+  printf("test_problem_simple_bounds ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,T);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_BUS,FLAG_BOUNDED,BUS_PROP_ANY,BUS_VAR_VMAG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS|FLAG_BOUNDED,GEN_PROP_ANY,GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_TAP_CHANGER,BRANCH_VAR_RATIO);
+  NET_set_flags(net,OBJ_SHUNT,FLAG_VARS|FLAG_BOUNDED,SHUNT_PROP_SWITCHED_V,SHUNT_VAR_SUSC);
+  NET_set_flags(net,OBJ_LOAD,FLAG_VARS,LOAD_PROP_ANY,LOAD_VAR_P|LOAD_VAR_Q);
+  NET_set_flags(net,OBJ_LOAD,FLAG_BOUNDED,LOAD_PROP_ANY,LOAD_VAR_P);
+  NET_add_batteries(net,NET_get_gen_buses(net),20.,40.,0.8,0.7);
+  NET_set_flags(net,OBJ_BAT,FLAG_VARS|FLAG_BOUNDED,BAT_PROP_ANY,BAT_VAR_P|BAT_VAR_E);
+  num_vars = NET_get_num_vars(net);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_LBOUND_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+
+  // Rows of G
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  Assert("error - bad simple bounds",PROB_get_x_l(p) == NULL && PROB_get_x_u(p) == NULL);
+  G = PROB_get_G(p);
+  l = PROB_get_l(p);
+  u = PROB_get_u(p);
+  Grow = MAT_get_size1(G);
+  Gnnz = MAT_get_nnz(G);
+  num_extra_vars = PROB_get_num_extra_vars(p);
+  l_ref = (REAL*)calloc(num_vars+num_extra_vars,sizeof(REAL));
+  u_ref = (REAL*)calloc(num_vars+num_extra_vars,sizeof(REAL));
+  bounded = (char*)calloc(num_vars+num_extra_vars,sizeof(char));
+  for (k = 0; k < Gnnz; k++) {
+    if (MAT_get_d(G,k) != 1.)
+      continue;
+    i = MAT_get_j(G,k);
+    l_ref[i] = VEC_get(l,MAT_get_i(G,k));
+    u_ref[i] = VEC_get(u,MAT_get_i(G,k));
+    bounded[i] = TRUE;
+  }
+
+  // Vectors
+  PROB_set_simple_bounds(p,TRUE);
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  Assert("error - bad number of rows of G",MAT_get_size1(PROB_get_G(p)) == Grow-num_vars);
+  Assert("error - bad nnz of G",MAT_get_nnz(PROB_get_G(p)) == Gnnz-num_vars);
+  Assert("error - bad number of extra vars",PROB_get_num_extra_vars(p) == num_extra_vars);
+  x_l = PROB_get_x_l(p);
+  x_u = PROB_get_x_u(p);
+  Assert("error - NULL simple bounds",x_l != NULL && x_u != NULL);
+  Assert("error - bad size of simple bounds",VEC_get_size(x_l) == num_vars+num_extra_vars);
+  Assert("error - bad size of simple bounds",VEC_get_size(x_u) == num_vars+num_extra_vars);
+  for (i = 0; i < num_vars+num_extra_vars; i++) {
+    if (!bounded[i])
+      continue;
+    Assert("error - bad lower bound",VEC_get(x_l,i) == l_ref[i]);
+    Assert("error - bad upper bound",VEC_get(x_u,i) == u_ref[i]);
+  }
+
+  // Update data
+  LOAD_set_P_max(NET_get_load(net,0),LOAD_get_P_max(NET_get_load(net,0),1)+1.,1);
+  PROB_update_data(p);
+  Assert("error - problem update failed",!PROB_has_error(p));
+  Assert("error - bad upper bound",
+	 VEC_get(PROB_get_x_u(p),LOAD_get_index_P(NET_get_load(net,0),1)) ==
+	 LOAD_get_P_max(NET_get_load(net,0),1));
+
+  // Back to rows of G
+  PROB_set_simple_bounds(p,FALSE);
+  PROB_analyze(p);
+  Assert("error - bad number of rows of G",MAT_get_size1(PROB_get_G(p)) == Grow);
+  Assert("error - bad simple bounds",PROB_get_x_l(p) == NULL);
+
+  free(l_ref);
+  free(u_ref);
+  free(bounded);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_Jv() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Mat* J;
+  Vec* x;
+  Vec* v;
+  Vec* y;
+  Vec* Jv;
+  Vec* JTy;
+  REAL* Jv_ref;
+  REAL* JTy_ref;
+  int num_primal;
+  int num_rows;
+  int i;
+  int k;
+
+  printf("test_problem_Jv ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_ANY,GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_TAP_CHANGER,BRANCH_VAR_RATIO);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_PHASE_SHIFTER,BRANCH_VAR_PHASE);
+  NET_set_flags(net,OBJ_SHUNT,FLAG_VARS,SHUNT_PROP_SWITCHED_V,SHUNT_VAR_SUSC);
+  NET_set_flags(net,OBJ_LOAD,FLAG_VARS,LOAD_PROP_ANY,LOAD_VAR_P);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  num_primal = PROB_get_num_primal_variables(p);
+  num_rows = MAT_get_size1(PROB_get_J(p));
+
+  // Point and directions
+  x = PROB_get_init_point(p);
+  v = VEC_new(num_primal);
+  y = VEC_new(num_rows);
+  for (i = 0; i < num_primal; i++) {
+    VEC_add_to_entry(x,i,0.01*((i%5)-2));
+    VEC_set(v,i,1.+(i%7));
+  }
+  for (i = 0; i < num_rows; i++)
+    VEC_set(y,i,1.-(i%3));
+
+  // Reference with J
+  PROB_eval(p,x);
+  J = PROB_get_J(p);
+  Jv_ref = (REAL*)calloc(num_rows,sizeof(REAL));
+  JTy_ref = (REAL*)calloc(num_primal,sizeof(REAL));
+  for (k = 0; k < MAT_get_nnz(J); k++) {
+    Jv_ref[MAT_get_i(J,k)] += MAT_get_d(J,k)*VEC_get(v,MAT_get_j(J,k));
+    JTy_ref[MAT_get_j(J,k)] += MAT_get_d(J,k)*VEC_get(y,MAT_get_i(J,k));
+  }
+
+  // Products
+  Jv = PROB_Jv(p,x,v);
+  JTy = PROB_JTy(p,x,y);
+  Assert("error - products failed",!PROB_has_error(p));
+  Assert("error - bad size of Jv",VEC_get_size(Jv) == num_rows);
+  Assert("error - bad size of JTy",VEC_get_size(JTy) == num_primal);
+  for (i = 0; i < num_rows; i++)
+    Assert("error - bad Jv",fabs(VEC_get(Jv,i)-Jv_ref[i]) < 1e-8*(1.+fabs(Jv_ref[i])));
+  for (i = 0; i < num_primal; i++)
+    Assert("error - bad JTy",fabs(VEC_get(JTy,i)-JTy_ref[i]) < 1e-8*(1.+fabs(JTy_ref[i])));
+
+  // Bad sizes
+  Assert("error - bad Jv",PROB_Jv(p,x,y) == NULL);
+  Assert("error - no error",PROB_has_error(p));
+  PROB_clear_error(p);
+
+  free(Jv_ref);
+  free(JTy_ref);
+  VEC_del(x);
+  VEC_del(v);
+  VEC_del(y);
+  VEC_del(Jv);
+  VEC_del(JTy);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_Hv() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Mat* H[2];
+  Vec* x;
+  Vec* lam;
+  Vec* v;
+  Vec* Hv;
+  REAL* Hv_ref;
+  int num_primal;
+  int num_rows;
+  int i;
+  int j;
+  int k;
+  int m;
+
+  printf("test_problem_Hv ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS|FLAG_BOUNDED,BUS_PROP_ANY,BUS_VAR_VMAG);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS|FLAG_BOUNDED,GEN_PROP_ANY,GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS|FLAG_BOUNDED,BRANCH_PROP_ANY,BRANCH_VAR_RATIO);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_ANY,BRANCH_VAR_PHASE);
+  NET_set_flags(net,OBJ_SHUNT,FLAG_VARS,SHUNT_PROP_ANY,SHUNT_VAR_SUSC);
+  NET_set_flags(net,OBJ_LOAD,FLAG_VARS,LOAD_PROP_ANY,LOAD_VAR_P);
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    if (BRANCH_get_ratingA(NET_get_branch(net,i)) == 0.)
+      BRANCH_set_ratingA(NET_get_branch(net,i),1.);
+  }
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_constr(p,CONSTR_NBOUND_new(net));
+  PROB_add_constr(p,CONSTR_REG_GEN_new(net));
+  PROB_add_constr(p,CONSTR_REG_TRAN_new(net)); // no native product
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_LOAD_UTIL_new(0.5,net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(2.,net));
+  PROB_add_func(p,FUNC_REG_VANG_new(3.,net));
+  PROB_add_func(p,FUNC_REG_PQ_new(4.,net));    // no native product
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  num_primal = PROB_get_num_primal_variables(p);
+  num_rows = MAT_get_size1(PROB_get_J(p));
+
+  // Point, multipliers and direction
+  x = PROB_get_init_point(p);
+  lam = VEC_new(num_rows);
+  v = VEC_new(num_primal);
+  for (i = 0; i < num_primal; i++) {
+    VEC_add_to_entry(x,i,0.01*((i%5)-2));
+    VEC_set(v,i,1.+(i%7));
+  }
+  for (i = 0; i < num_rows; i++)
+    VEC_set(lam,i,1.-(i%3));
+
+  // Reference with Hphi and H_combined
+  PROB_eval(p,x);
+  PROB_combine_H(p,lam,FALSE);
+  Assert("error - problem eval failed",!PROB_has_error(p));
+  H[0] = PROB_get_Hphi(p);
+  H[1] = PROB_get_H_combined(p);
+  Hv_ref = (REAL*)calloc(num_primal,sizeof(REAL));
+  for (m = 0; m < 2; m++) {
+    for (k = 0; k < MAT_get_nnz(H[m]); k++) {
+      i = MAT_get_i(H[m],k);
+      j = MAT_get_j(H[m],k);
+      Hv_ref[i] += MAT_get_d(H[m],k)*VEC_get(v,j);
+      if (i != j)
+	Hv_ref[j] += MAT_get_d(H[m],k)*VEC_get(v,i);
+    }
+  }
+
+  // Product
+  Hv = PROB_Hv(p,x,lam,v);
+  Assert("error - product failed",!PROB_has_error(p));
+  Assert("error - bad size of Hv",VEC_get_size(Hv) == num_primal);
+  for (i = 0; i < num_primal; i++)
+    Assert("error - bad Hv",fabs(VEC_get(Hv,i)-Hv_ref[i]) < 1e-8*(1.+fabs(Hv_ref[i])));
+
+  // Bad sizes
+  Assert("error - bad Hv",PROB_Hv(p,x,v,v) == NULL);
+  Assert("error - no error",PROB_has_error(p));
+  PROB_clear_error(p);
+
+  free(Hv_ref);
+  VEC_del(x);
+  VEC_del(lam);
+  VEC_del(v);
+  VEC_del(Hv);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_duplicate_compaction() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Mat* M[3];
+  Mat* Mc;
+  Vec* x;
+  Vec* lam;
+  Vec* v;
+  Vec* Jv;
+  Vec* Jv_ref;
+  REAL* Hv;
+  REAL* Hv_ref;
+  int* map;
+  int nnz_ref[3];
+  int num_primal;
+  int num_rows;
+  int i;
+  int m;
+
+  printf("test_problem_duplicate_compaction ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_ANY,GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_ANY,BRANCH_VAR_RATIO|BRANCH_VAR_PHASE);
+  NET_set_flags(net,OBJ_LOAD,FLAG_VARS,LOAD_PROP_ANY,LOAD_VAR_P);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_REG_GEN_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_LOAD_UTIL_new(0.5,net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(2.,net));
+  PROB_add_func(p,FUNC_REG_VANG_new(3.,net));
+
+  // Reference
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  num_primal = PROB_get_num_primal_variables(p);
+  num_rows = MAT_get_size1(PROB_get_J(p));
+  x = PROB_get_init_point(p);
+  lam = VEC_new(num_rows);
+  v = VEC_new(num_primal);
+  for (i = 0; i < num_primal; i++) {
+    VEC_add_to_entry(x,i,0.01*((i%5)-2));
+    VEC_set(v,i,1.+(i%7));
+  }
+  for (i = 0; i < num_rows; i++)
+    VEC_set(lam,i,1.-(i%3));
+  PROB_eval(p,x);
+  PROB_combine_H(p,lam,FALSE);
+  Assert("error - problem eval failed",!PROB_has_error(p));
+  Jv_ref = MAT_rmul_by_vec(PROB_get_J(p),v);
+  Hv_ref = (REAL*)calloc(num_primal,sizeof(REAL));
+  MAT_add_sym_mul_vec(PROB_get_Hphi(p),1.,VEC_get_data(v),Hv_ref);
+  MAT_add_sym_mul_vec(PROB_get_H_combined(p),1.,VEC_get_data(v),Hv_ref);
+  nnz_ref[0] = MAT_get_nnz(PROB_get_J(p));
+  nnz_ref[1] = MAT_get_nnz(PROB_get_Hphi(p));
+  nnz_ref[2] = MAT_get_nnz(PROB_get_H_combined(p));
+
+  // Compacted
+  PROB_set_duplicate_compaction(p,TRUE);
+  PROB_analyze(p);
+  PROB_eval(p,x);
+  PROB_combine_H(p,lam,FALSE);
+  Assert("error - problem eval failed",!PROB_has_error(p));
+  Assert("error - bad size of J",MAT_get_size1(PROB_get_J(p)) == num_rows);
+  Assert("error - bad size of J",MAT_get_size2(PROB_get_J(p)) == num_primal);
+  Assert("error - nnz of H not reduced",MAT_get_nnz(PROB_get_H_combined(p)) < nnz_ref[2]);
+  M[0] = PROB_get_J(p);
+  M[1] = PROB_get_Hphi(p);
+  M[2] = PROB_get_H_combined(p);
+  for (m = 0; m < 3; m++) {
+    Assert("error - bad nnz",MAT_get_nnz(M[m]) <= nnz_ref[m]);
+    map = (int*)malloc(sizeof(int)*MAT_get_nnz(M[m]));
+    Mc = MAT_new_compact(M[m],map);
+    Assert("error - duplicate entries",MAT_get_nnz(Mc) == MAT_get_nnz(M[m]));
+    for (i = 0; i < MAT_get_nnz(M[m]); i++)
+      Assert("error - bad map",map[i] == i);
+    MAT_del(Mc);
+    free(map);
+  }
+
+  // Same products
+  Jv = MAT_rmul_by_vec(PROB_get_J(p),v);
+  for (i = 0; i < num_rows; i++)
+    Assert("error - bad J",fabs(VEC_get(Jv,i)-VEC_get(Jv_ref,i)) < 1e-8*(1.+fabs(VEC_get(Jv_ref,i))));
+  Hv = (REAL*)calloc(num_primal,sizeof(REAL));
+  MAT_add_sym_mul_vec(PROB_get_Hphi(p),1.,VEC_get_data(v),Hv);
+  MAT_add_sym_mul_vec(PROB_get_H_combined(p),1.,VEC_get_data(v),Hv);
+  for (i = 0; i < num_primal; i++)
+    Assert("error - bad H",fabs(Hv[i]-Hv_ref[i]) < 1e-8*(1.+fabs(Hv_ref[i])));
+
+  // Back to duplicates
+  PROB_set_duplicate_compaction(p,FALSE);
+  PROB_analyze(p);
+  Assert("error - bad nnz",MAT_get_nnz(PROB_get_H_combined(p)) == nnz_ref[2]);
+
+  free(Hv);
+  free(Hv_ref);
+  VEC_del(x);
+  VEC_del(lam);
+  VEC_del(v);
+  VEC_del(Jv);
+  VEC_del(Jv_ref);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_estimates() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Mat* Jest;
+  Mat* Hest;
+  Mat* H[2];
+  Vec* x;
+  Vec* lam;
+  Vec* v;
+  REAL* Hv;
+  REAL* Hv_ref;
+  int* colors;
+  int* seen;
+  int num_primal;
+  int num_rows;
+  int i;
+  int j;
+  int k;
+  int m;
+
+  printf("test_problem_estimates ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_ANY,GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,OBJ_BRANCH,FLAG_VARS,BRANCH_PROP_ANY,BRANCH_VAR_RATIO);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_REG_VANG_new(3.,net));
+  PROB_set_coloring(p,TRUE);
+  PROB_set_duplicate_compaction(p,TRUE);
+  PROB_analyze(p);
+  Assert("error - problem analyze failed",!PROB_has_error(p));
+  num_primal = PROB_get_num_primal_variables(p);
+  num_rows = MAT_get_size1(PROB_get_J(p));
+
+  // Colors
+  Assert("error - no colors",PROB_get_J_colors(p) != NULL && PROB_get_H_colors(p) != NULL);
+  Assert("error - bad number of colors",PROB_get_num_J_colors(p) > 0);
+  Assert("error - bad number of colors",PROB_get_num_J_colors(p) < num_primal/4);
+  Assert("error - bad number of colors",PROB_get_num_H_colors(p) > 0);
+  Assert("error - bad number of colors",PROB_get_num_H_colors(p) < num_primal/2);
+  colors = PROB_get_J_colors(p);
+  seen = (int*)malloc(sizeof(int)*num_rows*PROB_get_num_J_colors(p));
+  for (k = 0; k < num_rows*PROB_get_num_J_colors(p); k++)
+    seen[k] = -1;
+  for (k = 0; k < MAT_get_nnz(PROB_get_J(p)); k++) {
+    i = MAT_get_i(PROB_get_J(p),k);
+    j = MAT_get_j(PROB_get_J(p),k);
+    Assert("error - bad color",colors[j] >= 0);
+    Assert("error - bad coloring",(seen[i*PROB_get_num_J_colors(p)+colors[j]] == -1 ||
+				    seen[i*PROB_get_num_J_colors(p)+colors[j]] == j));
+    seen[i*PROB_get_num_J_colors(p)+colors[j]] = j;
+  }
+  free(seen);
+
+  // Point, multipliers and direction
+  x = PROB_get_init_point(p);
+  lam = VEC_new(num_rows);
+  v = VEC_new(num_primal);
+  for (i = 0; i < num_primal; i++) {
+    VEC_add_to_entry(x,i,0.01*((i%5)-2));
+    VEC_set(v,i,1.+(i%7));
+  }
+  for (i = 0; i < num_rows; i++)
+    VEC_set(lam,i,1.-(i%3));
+
+  // Estimates
+  Jest = PROB_estimate_J(p,x,1e-7);
+  Assert("error - estimate failed",Jest != NULL && !PROB_has_error(p));
+  Hest = PROB_estimate_H(p,x,lam,1e-7);
+  Assert("error - estimate failed",Hest != NULL && !PROB_has_error(p));
+  Assert("error - bad nnz",MAT_get_nnz(Jest) == MAT_get_nnz(PROB_get_J(p)));
+
+  // Exact (problem left evaluated at x)
+  PROB_combine_H(p,lam,FALSE);
+  for (k = 0; k < MAT_get_nnz(Jest); k++) {
+    Assert("error - bad J pattern",MAT_get_i(Jest,k) == MAT_get_i(PROB_get_J(p),k));
+    Assert("error - bad J pattern",MAT_get_j(Jest,k) == MAT_get_j(PROB_get_J(p),k));
+    Assert("error - bad J estimate",fabs(MAT_get_d(Jest,k)-MAT_get_d(PROB_get_J(p),k)) < 1e-4*(1.+fabs(MAT_get_d(PROB_get_J(p),k))));
+  }
+  H[0] = PROB_get_Hphi(p);
+  H[1] = PROB_get_H_combined(p);
+  Hv_ref = (REAL*)calloc(num_primal,sizeof(REAL));
+  Hv = (REAL*)calloc(num_primal,sizeof(REAL));
+  for (m = 0; m < 2; m++)
+    MAT_add_sym_mul_vec(H[m],1.,VEC_get_data(v),Hv_ref);
+  MAT_add_sym_mul_vec(Hest,1.,VEC_get_data(v),Hv);
+  for (i = 0; i < num_primal; i++)
+    Assert("error - bad H estimate",fabs(Hv[i]-Hv_ref[i]) < 1e-3*(1.+fabs(Hv_ref[i])));
+
+  // Bad sizes
+  Assert("error - bad estimate",PROB_estimate_H(p,x,v,1e-7) == NULL);
+  Assert("error - no error",PROB_has_error(p));
+  PROB_clear_error(p);
+
+  free(Hv);
+  free(Hv_ref);
+  MAT_del(Jest);
+  MAT_del(Hest);
+  VEC_del(x);
+  VEC_del(lam);
+  VEC_del(v);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}